@@ -0,0 +1,139 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <latch>
+#include <thread>
+
+using namespace std;
+
+BenchmarkRunner::BenchmarkRunner(const string& filter, chrono::milliseconds minTime)
+:   _filter{filter},
+    _minTime{minTime}
+{}
+
+bool BenchmarkRunner::isSelected(const string& name) const
+{
+    return _filter.empty() || name.find(_filter) != string::npos;
+}
+
+void BenchmarkRunner::run(
+    const string& name,
+    const string& parameter,
+    const function<void(long iterations)>& body,
+    long operationsPerIteration)
+{
+    measure(
+        name,
+        parameter,
+        1,
+        [&body](long iterations){
+            auto start = chrono::steady_clock::now();
+            body(iterations);
+            return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+        },
+        operationsPerIteration);
+}
+
+void BenchmarkRunner::runTimed(
+    const string& name,
+    const string& parameter,
+    const function<chrono::nanoseconds(long iterations)>& body,
+    long operationsPerIteration)
+{
+    measure(name, parameter, 1, body, operationsPerIteration);
+}
+
+void BenchmarkRunner::runThreaded(
+    const string& name,
+    int threads,
+    const function<void(int thread, long iterations)>& body,
+    long operationsPerIteration)
+{
+    measure(
+        name,
+        to_string(threads) + ((threads == 1) ? " thread" : " threads"),
+        threads,
+        [&body, threads](long iterations){
+            // Every thread waits on the latch, so none of them gets a head start while the others are created.
+            latch ready{threads + 1};
+            vector<thread> workers{};
+            for (int t=0; t<threads; ++t)
+            {
+                workers.push_back(thread([&body, &ready, t, iterations]{
+                    ready.arrive_and_wait();
+                    body(t, iterations);
+                }));
+            }
+            ready.arrive_and_wait();
+            auto start = chrono::steady_clock::now();
+            for (thread& worker : workers)
+            {
+                worker.join();
+            }
+            return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+        },
+        operationsPerIteration);
+}
+
+const vector<BenchmarkRunner::Result>& BenchmarkRunner::getResults() const
+{
+    return _results;
+}
+
+void BenchmarkRunner::writeCsv(ostream& out) const
+{
+    out << "name,parameter,threads,operations,ns_per_op\n";
+    for (const Result& result : _results)
+    {
+        out << result.name << ","
+            << result.parameter << ","
+            << result.threads << ","
+            << result.operations << ","
+            << result.nanosecondsPerOperation << "\n";
+    }
+}
+
+void BenchmarkRunner::measure(
+    const string& name,
+    const string& parameter,
+    int threads,
+    const function<chrono::nanoseconds(long iterations)>& timedBody,
+    long operationsPerIteration)
+{
+    if (!isSelected(name))
+    {
+        return;
+    }
+
+    // Find an iteration count that takes at least _minTime.
+    long iterations = 1;
+    chrono::nanoseconds elapsed = timedBody(iterations);
+    while (elapsed < _minTime && iterations < (1L << 40))
+    {
+        // Aim a little past _minTime, but never grow by more than 100x at a time.
+        double factor = (elapsed.count() > 0)
+            ? 1.2 * static_cast<double>(chrono::nanoseconds(_minTime).count()) / static_cast<double>(elapsed.count())
+            : 100.0;
+        iterations = max(iterations + 1, static_cast<long>(static_cast<double>(iterations) * min(factor, 100.0)));
+        elapsed = timedBody(iterations);
+    }
+
+    // Keep the fastest of three runs.
+    chrono::nanoseconds best = elapsed;
+    for (int ii=0; ii<2; ++ii)
+    {
+        best = min(best, timedBody(iterations));
+    }
+
+    long operations = iterations * operationsPerIteration;
+    double nanosecondsPerOperation = static_cast<double>(best.count()) / static_cast<double>(operations);
+    _results.push_back(Result{name, parameter, threads, operations * threads, nanosecondsPerOperation});
+    printf(
+        "%-36s %-26s %14.1f ns/op %12.3f Mop/s\n",
+        name.c_str(),
+        parameter.c_str(),
+        nanosecondsPerOperation,
+        1e3 * threads / nanosecondsPerOperation);
+    fflush(stdout);
+}
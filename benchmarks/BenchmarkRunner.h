@@ -0,0 +1,93 @@
+#ifndef BENCHMARKRUNNER__H
+#define BENCHMARKRUNNER__H
+
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+Runs the benchmarks in benchmarks/ and reports their time per operation.
+
+Every benchmark is given a name and a parameter, such as a thread count or a Board size. Running the same name with a series of parameters gives a scaling curve. The number of iterations is raised until one run takes at least the minimum time, and the fastest of three such runs is reported, which filters out most noise from other processes.
+*/
+class BenchmarkRunner
+{
+    public:
+
+    struct Result
+    {
+        std::string name;
+        std::string parameter;
+        int threads;
+        long operations;
+        double nanosecondsPerOperation;
+    };
+
+    /*
+    Only benchmarks whose name contains @filter are run. An empty @filter runs every benchmark.
+    */
+    BenchmarkRunner(const std::string& filter, std::chrono::milliseconds minTime);
+    BenchmarkRunner() = delete;
+    BenchmarkRunner(const BenchmarkRunner& o) = delete;
+    BenchmarkRunner(BenchmarkRunner&& o) noexcept = delete;
+    BenchmarkRunner& operator=(const BenchmarkRunner& o) = delete;
+    BenchmarkRunner& operator=(BenchmarkRunner&& o) noexcept = delete;
+    ~BenchmarkRunner() noexcept = default;
+
+    /*
+    Returns true if the benchmark @name would be run. Lets a benchmark skip its set up when it is filtered out.
+    */
+    bool isSelected(const std::string& name) const;
+
+    /*
+    @body performs @iterations iterations of @operationsPerIteration operations each. The whole call is timed.
+    */
+    void run(
+        const std::string& name,
+        const std::string& parameter,
+        const std::function<void(long iterations)>& body,
+        long operationsPerIteration = 1);
+
+    /*
+    Like run(), but @body times itself and returns the time spent on the measured operations only. Use it when every iteration needs set up that should not be measured.
+    */
+    void runTimed(
+        const std::string& name,
+        const std::string& parameter,
+        const std::function<std::chrono::nanoseconds(long iterations)>& body,
+        long operationsPerIteration = 1);
+
+    /*
+    Starts @threads threads at the same moment. Thread t calls @body(t, iterations). The time is measured from the start until the last thread finishes. The reported time per operation is per thread, so perfect scaling keeps it flat as @threads grows.
+    */
+    void runThreaded(
+        const std::string& name,
+        int threads,
+        const std::function<void(int thread, long iterations)>& body,
+        long operationsPerIteration = 1);
+
+    const std::vector<Result>& getResults() const;
+
+    /*
+    Writes the results as comma separated values with a header line.
+    */
+    void writeCsv(std::ostream& out) const;
+
+
+    private:
+
+    const std::string _filter;
+    const std::chrono::milliseconds _minTime;
+    std::vector<Result> _results{};
+
+    void measure(
+        const std::string& name,
+        const std::string& parameter,
+        int threads,
+        const std::function<std::chrono::nanoseconds(long iterations)>& timedBody,
+        long operationsPerIteration);
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef BENCHMARKS__H
+#define BENCHMARKS__H
+
+#include <memory>
+#include <vector>
+#include "BenchmarkRunner.h"
+#include "../src/Frame.h"
+
+/*
+The benchmark groups. Each one runs its benchmarks on @runner. @maxThreads is the highest thread count of the scaling curves, which double from 1.
+*/
+void benchmarkSpot(BenchmarkRunner& runner, int maxThreads);
+void benchmarkBoard(BenchmarkRunner& runner, int maxThreads);
+void benchmarkRecorder(BenchmarkRunner& runner);
+void benchmarkPrinter(BenchmarkRunner& runner);
+void benchmarkLockstepEngine(BenchmarkRunner& runner, int maxThreads);
+void benchmarkPositionManager(BenchmarkRunner& runner);
+
+/*
+Returns the thread counts 1, 2, 4, ... up to and including @maxThreads.
+*/
+std::vector<int> getThreadCounts(int maxThreads);
+
+/*
+Returns four Frames for a @width x @height Board in which @changes Boxes, Box i in cell i, step through to_arrive, arrive, to_leave, and left. Sending the Frames in a loop always gives valid changes, so a Recorder can be fed from them forever. Boxes are in groups 0 to 3.
+*/
+std::vector<std::shared_ptr<const Frame>> makeCycleFrames(int width, int height, int changes);
+
+#endif
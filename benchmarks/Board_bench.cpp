@@ -0,0 +1,189 @@
+#include "Benchmarks.h"
+
+#include <atomic>
+#include <string>
+#include "../src/Board.h"
+#include "../src/GridIndex.h"
+
+using namespace std;
+
+namespace
+{
+    class NullListener : public BoardListener
+    {
+        public:
+
+        void receiveChanges(const shared_ptr<const Frame>& frame) override
+        {
+            _lastSequence = frame->getSequence();
+        }
+
+        long _lastSequence = -1;
+    };
+
+    vector<Box> makeBoxes(int count)
+    {
+        vector<Box> boxes{};
+        for (int id=0; id<count; ++id)
+        {
+            boxes.push_back(Box{id, id % 4, 1, 1});
+        }
+        return boxes;
+    }
+
+    // Results that are otherwise unused are added here, so the compiler can not drop the work.
+    atomic<long> sink{0};
+
+    const MoveType cycle[4] = {MoveType::to_arrive, MoveType::arrive, MoveType::to_leave, MoveType::left};
+}
+
+void benchmarkBoard(BenchmarkRunner& runner, int maxThreads)
+{
+    int width = 256;
+
+    // Thread t walks Box t along row t, the way Mover_Reg moves a Box: to_arrive at the next cell, to_leave at the current cell, arrive, left. Threads never touch the same cells, so this measures the Board's own locking.
+    if (runner.isSelected("Board::changeSpot disjoint cells"))
+    {
+        for (int threads : getThreadCounts(maxThreads))
+        {
+            Board board{width, threads, makeBoxes(threads)};
+            vector<int> columns(threads, 0);
+            for (int t=0; t<threads; ++t)
+            {
+                board.changeSpot(Position{0, t}, BoardNote{t, MoveType::to_arrive}, false);
+                board.changeSpot(Position{0, t}, BoardNote{t, MoveType::arrive}, false);
+            }
+            runner.runThreaded(
+                "Board::changeSpot disjoint cells",
+                threads,
+                [&board, &columns, width](int thread, long iterations){
+                    int x = columns[thread];
+                    for (long ii=0; ii<iterations; ++ii)
+                    {
+                        Position from{x, thread};
+                        x = (x + 1) % width;
+                        Position to{x, thread};
+                        board.changeSpot(to, BoardNote{thread, MoveType::to_arrive}, true);
+                        board.changeSpot(from, BoardNote{thread, MoveType::to_leave}, true);
+                        board.changeSpot(to, BoardNote{thread, MoveType::arrive}, true);
+                        board.changeSpot(from, BoardNote{thread, MoveType::left}, true);
+                    }
+                    columns[thread] = x;
+                },
+                4);
+        }
+    }
+
+    // Every thread tries to move its Box through the same cell, like Boxes crowding a doorway. An iteration is one to four changeSpot() calls.
+    if (runner.isSelected("Board::changeSpot one cell"))
+    {
+        for (int threads : getThreadCounts(maxThreads))
+        {
+            Board board{16, 16, makeBoxes(threads)};
+            Position doorway{8, 8};
+            runner.runThreaded(
+                "Board::changeSpot one cell",
+                threads,
+                [&board, doorway](int thread, long iterations){
+                    for (long ii=0; ii<iterations; ++ii)
+                    {
+                        if (board.changeSpot(doorway, BoardNote{thread, MoveType::to_arrive}, false))
+                        {
+                            board.changeSpot(doorway, BoardNote{thread, MoveType::arrive}, false);
+                            board.changeSpot(doorway, BoardNote{thread, MoveType::to_leave}, false);
+                            board.changeSpot(doorway, BoardNote{thread, MoveType::left}, false);
+                        }
+                    }
+                });
+        }
+    }
+
+    // Readers scan the Board while nothing changes.
+    if (runner.isSelected("Board::getNoteAt"))
+    {
+        Board board{width, width, makeBoxes(1)};
+        board.changeSpot(Position{3, 3}, BoardNote{0, MoveType::to_arrive}, false);
+        for (int threads : getThreadCounts(maxThreads))
+        {
+            runner.runThreaded(
+                "Board::getNoteAt",
+                threads,
+                [&board, width](int thread, long iterations){
+                    int occupied = 0;
+                    int cell = thread * 97;
+                    for (long ii=0; ii<iterations; ++ii)
+                    {
+                        cell = (cell + 1) % (width * width);
+                        occupied += (board.getNoteAt(Position{cell % width, cell / width}).getBoxId() != -1) ? 1 : 0;
+                    }
+                    sink.fetch_add(occupied, memory_order_relaxed);
+                });
+        }
+    }
+
+    // A Decider's reads: the 3 x 3 cells around a Position, for Positions spread over a Board too big for the caches. Compares the GridLayouts.
+    if (runner.isSelected("Board::getNoteAt 3x3 neighbourhood"))
+    {
+        int size = 512;
+        for (GridLayout layout : {GridLayout::rowMajor, GridLayout::tiled, GridLayout::morton})
+        {
+            Board board{size, size, makeBoxes(1), layout};
+            runner.run(
+                "Board::getNoteAt 3x3 neighbourhood",
+                GridIndex::toString(layout),
+                [&board, size](long iterations){
+                    int occupied = 0;
+                    uint32_t random = 1;
+                    for (long ii=0; ii<iterations; ++ii)
+                    {
+                        random = random * 1664525u + 1013904223u;
+                        int x = static_cast<int>((random >> 8) % (size - 2)) + 1;
+                        int y = static_cast<int>((random >> 20) % (size - 2)) + 1;
+                        for (int dy=-1; dy<=1; ++dy)
+                        {
+                            for (int dx=-1; dx<=1; ++dx)
+                            {
+                                occupied += (board.getNoteAt(Position{x + dx, y + dy}).getBoxId() != -1) ? 1 : 0;
+                            }
+                        }
+                    }
+                    sink.fetch_add(occupied, memory_order_relaxed);
+                });
+        }
+    }
+
+    // Box i sits in cell i and takes one step of its cycle before every Frame, so every Frame has exactly @changes changed Drops. Only sendStateAndChanges() is timed.
+    if (runner.isSelected("Board::sendStateAndChanges"))
+    {
+        for (int size : {100, 400, 1000})
+        {
+            for (int changes : {0, 100, 10000})
+            {
+                int boxCount = max(changes, 1);
+                Board board{size, size, makeBoxes(boxCount)};
+                NullListener listener{};
+                board.registerListener(&listener);
+                int step = 0;
+                runner.runTimed(
+                    "Board::sendStateAndChanges",
+                    to_string(size) + "x" + to_string(size) + " " + to_string(changes) + " changes",
+                    [&board, &step, size, changes](long iterations){
+                        chrono::nanoseconds elapsed{0};
+                        for (long ii=0; ii<iterations; ++ii)
+                        {
+                            for (int box=0; box<changes; ++box)
+                            {
+                                board.changeSpot(Position{box % size, box / size}, BoardNote{box, cycle[step]}, false);
+                            }
+                            step = (step + 1) % 4;
+
+                            auto start = chrono::steady_clock::now();
+                            board.sendStateAndChanges();
+                            elapsed += chrono::steady_clock::now() - start;
+                        }
+                        return elapsed;
+                    });
+            }
+        }
+    }
+}
@@ -0,0 +1,109 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include "../src/Board.h"
+#include "../src/GridIndex.h"
+#include "../src/LockstepEngine.h"
+#include "../src/MainSetup.h"
+#include "../src/Threader.h"
+
+using namespace std;
+
+namespace
+{
+    const int boardSize = 512;
+
+    // One Box in every fourth cell of every fourth row.
+    const int spacing = 4;
+
+    const int boxCount = (boardSize / spacing) * (boardSize / spacing);
+
+    /*
+    Spreads the Boxes evenly over the Board, so every tile has work, and sends each one to one of the in-out-bound Rectangles.
+    */
+    vector<BoxPlan> makePlans()
+    {
+        Threader threader{};
+        vector<Rectangle> exits = MainSetup::getInOutBoundRectangles(boardSize, boardSize);
+        vector<BoxPlan> plans{};
+        plans.reserve(boxCount);
+        for (int id=0; id<boxCount; ++id)
+        {
+            Position start{(id % (boardSize / spacing)) * spacing, (id / (boardSize / spacing)) * spacing};
+            Rectangle exit = exits[id % exits.size()];
+            plans.push_back(BoxPlan{
+                id,
+                0,
+                start,
+                exit,
+                PositionManagerType::diagonal,
+                threader.createPositionManager(PositionManagerType::diagonal, exit, 0, boardSize-1, 0, boardSize-1),
+                DeciderType::safe,
+                threader.createDecider(DeciderType::safe)});
+        }
+        return plans;
+    }
+
+    vector<Box> makeBoxes()
+    {
+        vector<Box> boxes{};
+        boxes.reserve(boxCount);
+        for (int id=0; id<boxCount; ++id)
+        {
+            boxes.push_back(Box{id, id % 4, 1, 1});
+        }
+        return boxes;
+    }
+}
+
+void benchmarkLockstepEngine(BenchmarkRunner& runner, int maxThreads)
+{
+    // An operation is one Box's share of a tick. Only run() is timed, so the time per operation falls as the workers are added, and perfect scaling halves it with every doubling.
+    for (int tileSize : {0, 16})
+    {
+        string name = (tileSize == 0) ? "LockstepEngine tick by Box" : "LockstepEngine tick by 16 x 16 tile";
+        if (!runner.isSelected(name))
+        {
+            continue;
+        }
+        for (int workers : getThreadCounts(maxThreads))
+        {
+            runner.runTimed(
+                name,
+                to_string(workers) + ((workers == 1) ? " worker" : " workers"),
+                [workers, tileSize](long iterations){
+                    Board board{boardSize, boardSize, makeBoxes()};
+                    LockstepEngine engine{board, makePlans(), workers, 1, tileSize};
+                    auto start = chrono::steady_clock::now();
+                    long ticks = engine.run(iterations);
+                    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+
+                    // The run ends early once every Box has exited. Scale its time up to the ticks asked for.
+                    return elapsed * iterations / max(ticks, 1L);
+                },
+                boxCount);
+        }
+    }
+
+    // The same ticks on one worker, with the Board's Spots in each GridLayout.
+    if (runner.isSelected("LockstepEngine tick by Board layout"))
+    {
+        for (GridLayout layout : {GridLayout::rowMajor, GridLayout::tiled, GridLayout::morton})
+        {
+            runner.runTimed(
+                "LockstepEngine tick by Board layout",
+                GridIndex::toString(layout),
+                [layout](long iterations){
+                    Board board{boardSize, boardSize, makeBoxes(), layout};
+                    LockstepEngine engine{board, makePlans(), 1, 1, 16};
+                    auto start = chrono::steady_clock::now();
+                    long ticks = engine.run(iterations);
+                    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+                    return elapsed * iterations / max(ticks, 1L);
+                },
+                boxCount);
+        }
+    }
+}
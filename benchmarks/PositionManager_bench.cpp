@@ -0,0 +1,99 @@
+#include "Benchmarks.h"
+
+#include <atomic>
+#include "../src/NeighbourRanker.h"
+#include "../src/PositionManager_Diagonal.h"
+
+using namespace std;
+
+namespace
+{
+    const int boardSize = 512;
+
+    // Agents ranked in one call of the batch benchmark.
+    const int agentCount = 4096;
+
+    // Results that are otherwise unused are added here, so the compiler can not drop the work.
+    atomic<long> sink{0};
+}
+
+void benchmarkPositionManager(BenchmarkRunner& runner)
+{
+    // One Box walks towards the far corner, so every call ranks eight neighbours on the Board.
+    runner.run(
+        "PositionManager_Diagonal::getFuturePositions",
+        "1 Box",
+        [](long iterations){
+            Position target{boardSize - 1, boardSize - 1};
+            PositionManager_Diagonal positionManager{Rectangle{target, target}, target, 0, boardSize-1, 0, boardSize-1};
+            long total = 0;
+            for (long ii=0; ii<iterations; ++ii)
+            {
+                Position position{static_cast<int>(ii % (boardSize - 2)) + 1, static_cast<int>((ii / 7) % (boardSize - 2)) + 1};
+                total += static_cast<long>(positionManager.getFuturePositions(position).size());
+            }
+            sink += total;
+        });
+
+    // The same, filling one FuturePositions instead of returning a vector, as the lockstep engine does.
+    runner.run(
+        "PositionManager_Diagonal::fillFuturePositions",
+        "1 Box",
+        [](long iterations){
+            Position target{boardSize - 1, boardSize - 1};
+            PositionManager_Diagonal positionManager{Rectangle{target, target}, target, 0, boardSize-1, 0, boardSize-1};
+            FuturePositions positions{};
+            long total = 0;
+            for (long ii=0; ii<iterations; ++ii)
+            {
+                Position position{static_cast<int>(ii % (boardSize - 2)) + 1, static_cast<int>((ii / 7) % (boardSize - 2)) + 1};
+                positionManager.fillFuturePositions(position, positions);
+                total += positions.size();
+            }
+            sink += total;
+        });
+
+    // The table look up that getFuturePositions() now does, without the shuffle and the vector.
+    runner.run(
+        "NeighbourRanker::rankBySector",
+        "1 agent",
+        [](long iterations){
+            constexpr NeighbourRanker::DirectionTable table =
+                NeighbourRanker::makeDirectionTable(NeighbourRanker::Directions{{0, 1, 1, 1, 0, -1, -1, -1}, {1, 1, 0, -1, -1, -1, 0, 1}});
+            const NeighbourRanker::Bounds bounds{0, boardSize - 1, 0, boardSize - 1};
+            Position target{boardSize - 1, boardSize / 3};
+            long total = 0;
+            for (long ii=0; ii<iterations; ++ii)
+            {
+                Position position{static_cast<int>(ii % boardSize), static_cast<int>((ii / 7) % boardSize)};
+                total += NeighbourRanker::rankBySector(position, target, bounds, table).order;
+            }
+            sink += total;
+        });
+
+    // An operation is one agent's ranking, as the lockstep engine ranks the AgentTable rows of each worker every tick.
+    runner.run(
+        "NeighbourRanker::rank",
+        to_string(agentCount) + " agents",
+        [](long iterations){
+            const NeighbourRanker::Directions directions{{0, 1, 1, 1, 0, -1, -1, -1}, {1, 1, 0, -1, -1, -1, 0, 1}};
+            const NeighbourRanker::Bounds bounds{0, boardSize - 1, 0, boardSize - 1};
+            vector<int32_t> xs{}, ys{}, targetXs{}, targetYs{};
+            for (int ii=0; ii<agentCount; ++ii)
+            {
+                xs.push_back((ii * 37) % boardSize);
+                ys.push_back((ii * 91) % boardSize);
+                targetXs.push_back((ii % 2 == 0) ? 0 : boardSize - 1);
+                targetYs.push_back((ii % 3 == 0) ? 0 : boardSize - 1);
+            }
+            vector<NeighbourRanker::Ranking> rankings(agentCount);
+            long total = 0;
+            for (long ii=0; ii<iterations; ++ii)
+            {
+                NeighbourRanker::rank(xs, ys, targetXs, targetYs, bounds, directions, rankings);
+                total += rankings[ii % agentCount].order;
+            }
+            sink += total;
+        },
+        agentCount);
+}
@@ -0,0 +1,56 @@
+#include "Benchmarks.h"
+
+#include <stdexcept>
+#include <string>
+#include <SDL.h>
+#include "../src/MainSetup.h"
+#include "../src/Printer.h"
+#include "../src/Recorder.h"
+
+using namespace std;
+
+void benchmarkPrinter(BenchmarkRunner& runner)
+{
+    // A whole frame as the application processes it: Recorder updates its OccupancyGrid and Printer redraws the Board. Printer draws into a software renderer, so no window or display is needed.
+    if (!runner.isSelected("Recorder+Printer frame"))
+    {
+        return;
+    }
+
+    for (int size : {400, 1000})
+    {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_RGBA32);
+        SDL_Renderer* renderer = (surface == nullptr) ? nullptr : SDL_CreateSoftwareRenderer(surface);
+        if (renderer == nullptr)
+        {
+            throw runtime_error(string("Can not create a software renderer: ") + SDL_GetError());
+        }
+
+        for (int changes : {100, 10000})
+        {
+            Recorder recorder{size, size};
+            Printer printer{renderer};
+            printer.setGroupColors({
+                {0, MainSetup::red()},
+                {1, MainSetup::cyan()},
+                {2, MainSetup::amber()},
+                {3, MainSetup::purple()}});
+            printer.addInOutBoundRectangles(MainSetup::getInOutBoundRectangles(size, size));
+            recorder.registerListener(&printer);
+
+            vector<shared_ptr<const Frame>> frames = makeCycleFrames(size, size, changes);
+            runner.run(
+                "Recorder+Printer frame",
+                to_string(size) + "x" + to_string(size) + " " + to_string(changes) + " changes",
+                [&recorder, &frames](long iterations){
+                    for (long ii=0; ii<iterations; ++ii)
+                    {
+                        recorder.receiveChanges(frames[ii % 4]);
+                    }
+                });
+        }
+
+        SDL_DestroyRenderer(renderer);
+        SDL_FreeSurface(surface);
+    }
+}
@@ -0,0 +1,49 @@
+#include "Benchmarks.h"
+
+#include <string>
+#include "../src/Recorder.h"
+
+using namespace std;
+
+vector<shared_ptr<const Frame>> makeCycleFrames(int width, int height, int changes)
+{
+    const MoveType cycle[4] = {MoveType::to_arrive, MoveType::arrive, MoveType::to_leave, MoveType::left};
+    vector<shared_ptr<const Frame>> frames{};
+    for (int step=0; step<4; ++step)
+    {
+        vector<Drop> drops{};
+        vector<BoxInfo> boxes{};
+        for (int box=0; box<changes && box<width * height; ++box)
+        {
+            drops.push_back(Drop{box % width, box / width, box, cycle[step]});
+            boxes.push_back(BoxInfo{box, box % 4, 1, 1, step});
+        }
+        frames.push_back(make_shared<const Frame>(step, std::move(drops), std::move(boxes)));
+    }
+    return frames;
+}
+
+void benchmarkRecorder(BenchmarkRunner& runner)
+{
+    // Recorder with no RecorderListeners, so only its OccupancyGrid updates are measured.
+    if (runner.isSelected("Recorder::receiveChanges"))
+    {
+        for (int size : {100, 400, 1000})
+        {
+            for (int changes : {100, 10000})
+            {
+                Recorder recorder{size, size};
+                vector<shared_ptr<const Frame>> frames = makeCycleFrames(size, size, changes);
+                runner.run(
+                    "Recorder::receiveChanges",
+                    to_string(size) + "x" + to_string(size) + " " + to_string(changes) + " changes",
+                    [&recorder, &frames](long iterations){
+                        for (long ii=0; ii<iterations; ++ii)
+                        {
+                            recorder.receiveChanges(frames[ii % 4]);
+                        }
+                    });
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#include "Benchmarks.h"
+
+#include "../src/Spot.h"
+
+using namespace std;
+
+void benchmarkSpot(BenchmarkRunner& runner, int maxThreads)
+{
+    // One Box enters and leaves the Spot. Four changeNote() calls per iteration.
+    runner.run(
+        "Spot::changeNote uncontended",
+        "1 thread",
+        [](long iterations){
+            Spot spot{Position{0, 0}};
+            for (long ii=0; ii<iterations; ++ii)
+            {
+                spot.changeNote(BoardNote{0, MoveType::to_arrive});
+                spot.changeNote(BoardNote{0, MoveType::arrive});
+                spot.changeNote(BoardNote{0, MoveType::to_leave});
+                spot.changeNote(BoardNote{0, MoveType::left});
+            }
+        },
+        4);
+
+    // Every thread tries to move its own Box into the same Spot. A thread that gets in also walks its Box out again, so an iteration is one to four changeNote() calls.
+    if (runner.isSelected("Spot::changeNote contended"))
+    {
+        for (int threads : getThreadCounts(maxThreads))
+        {
+            Spot spot{Position{0, 0}};
+            runner.runThreaded(
+                "Spot::changeNote contended",
+                threads,
+                [&spot](int thread, long iterations){
+                    for (long ii=0; ii<iterations; ++ii)
+                    {
+                        if (spot.changeNote(BoardNote{thread, MoveType::to_arrive}).second)
+                        {
+                            spot.changeNote(BoardNote{thread, MoveType::arrive});
+                            spot.changeNote(BoardNote{thread, MoveType::to_leave});
+                            spot.changeNote(BoardNote{thread, MoveType::left});
+                        }
+                    }
+                });
+        }
+    }
+}
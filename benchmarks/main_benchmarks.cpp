@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include "BenchmarkRunner.h"
+#include "Benchmarks.h"
+
+using namespace std;
+
+vector<int> getThreadCounts(int maxThreads)
+{
+    vector<int> counts{};
+    for (int threads=1; threads<maxThreads; threads*=2)
+    {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+/*
+Runs the hot path benchmarks and prints ns/op per benchmark and parameter.
+
+Options:
+    --filter <text>     only run benchmarks whose name contains <text>
+    --min-time <ms>     minimum time of one measured run, 200 by default
+    --threads <n>       highest thread count of the scaling curves, the number of hardware threads by default (at least 4)
+    --csv <file>        also write the results to <file>
+*/
+int main(int argc, char* argv[])
+{
+    string filter{};
+    string csvPath{};
+    int minTime = 200;
+    int maxThreads = max(4, static_cast<int>(thread::hardware_concurrency()));
+    for (int ii=1; ii+1<argc; ++ii)
+    {
+        string option{argv[ii]};
+        if (option == "--filter")
+        {
+            filter = argv[ii+1];
+        }
+        else if (option == "--min-time")
+        {
+            minTime = stoi(argv[ii+1]);
+        }
+        else if (option == "--threads")
+        {
+            maxThreads = max(1, stoi(argv[ii+1]));
+        }
+        else if (option == "--csv")
+        {
+            csvPath = argv[ii+1];
+        }
+    }
+
+    BenchmarkRunner runner{filter, chrono::milliseconds(minTime)};
+    benchmarkSpot(runner, maxThreads);
+    benchmarkBoard(runner, maxThreads);
+    benchmarkRecorder(runner);
+    benchmarkPrinter(runner);
+    benchmarkLockstepEngine(runner, maxThreads);
+    benchmarkPositionManager(runner);
+
+    if (!csvPath.empty())
+    {
+        ofstream csv{csvPath};
+        runner.writeCsv(csv);
+        if (!csv)
+        {
+            fprintf(stderr, "Could not write %s\n", csvPath.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
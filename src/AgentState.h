@@ -0,0 +1,19 @@
+#ifndef AGENTSTATE__H
+#define AGENTSTATE__H
+
+#include <cstdint>
+
+/*
+Where an agent in an AgentTable is in its crossing of the Board.
+entering is waiting to be added at its start Position.
+onBoard is on the Board, moving towards its exit.
+exiting is at its exit and leaves the Board this tick.
+exited has left the Board. AgentTable::compact() removes exited agents.
+*/
+enum class AgentState : uint8_t{
+    entering=0,
+    onBoard=1,
+    exiting=2,
+    exited=3};
+
+#endif
@@ -0,0 +1,262 @@
+#include "AgentTable.h"
+
+using namespace std;
+
+template<typename F>
+void AgentTable::forEachColumn(F&& f)
+{
+    f(_boxIds);
+    f(_planIndexes);
+    f(_xs);
+    f(_ys);
+    f(_nextXs);
+    f(_nextYs);
+    f(_headingXs);
+    f(_headingYs);
+    f(_targetIds);
+    f(_policyIds);
+    f(_states);
+    f(_restTicks);
+    f(_waits);
+    f(_levels);
+    f(_actedTicks);
+}
+
+void AgentTable::reserve(int rowCount)
+{
+    forEachColumn([rowCount](auto& column){ column.reserve(rowCount); });
+}
+
+int AgentTable::add(int boxId, int planIndex, Position position, int targetId, uint8_t policyId)
+{
+    _boxIds.push_back(boxId);
+    _planIndexes.push_back(planIndex);
+    _xs.push_back(position.getX());
+    _ys.push_back(position.getY());
+    _nextXs.push_back(-1);
+    _nextYs.push_back(-1);
+    _headingXs.push_back(-1);
+    _headingYs.push_back(-1);
+    _targetIds.push_back(targetId);
+    _policyIds.push_back(policyId);
+    _states.push_back(AgentState::entering);
+    _restTicks.push_back(0);
+    _waits.push_back(0);
+    _levels.push_back(0);
+    _actedTicks.push_back(-1);
+    return size() - 1;
+}
+
+int AgentTable::size() const
+{
+    return static_cast<int>(_boxIds.size());
+}
+
+vector<int> AgentTable::compact()
+{
+    vector<int> newRows(size(), -1);
+    int kept = 0;
+    for (int row=0; row<size(); ++row)
+    {
+        if (_states[row] != AgentState::exited)
+        {
+            newRows[row] = kept++;
+        }
+    }
+
+    // Every column is moved down in one pass, so each is read and written front to back.
+    forEachColumn([&newRows, kept](auto& column){
+        for (int row=0; row<static_cast<int>(newRows.size()); ++row)
+        {
+            if (newRows[row] >= 0)
+            {
+                column[newRows[row]] = column[row];
+            }
+        }
+        column.resize(kept);
+    });
+    return newRows;
+}
+
+Position AgentTable::getPosition(int row) const
+{
+    return Position{_xs[row], _ys[row]};
+}
+
+void AgentTable::setPosition(int row, Position position)
+{
+    _xs[row] = position.getX();
+    _ys[row] = position.getY();
+}
+
+Position AgentTable::getNext(int row) const
+{
+    return Position{_nextXs[row], _nextYs[row]};
+}
+
+void AgentTable::setNext(int row, Position position)
+{
+    _nextXs[row] = position.getX();
+    _nextYs[row] = position.getY();
+}
+
+Position AgentTable::getHeading(int row) const
+{
+    return Position{_headingXs[row], _headingYs[row]};
+}
+
+void AgentTable::setHeading(int row, Position position)
+{
+    _headingXs[row] = position.getX();
+    _headingYs[row] = position.getY();
+}
+
+span<int32_t> AgentTable::getBoxIds()
+{
+    return _boxIds;
+}
+
+span<const int32_t> AgentTable::getBoxIds() const
+{
+    return _boxIds;
+}
+
+span<int32_t> AgentTable::getPlanIndexes()
+{
+    return _planIndexes;
+}
+
+span<const int32_t> AgentTable::getPlanIndexes() const
+{
+    return _planIndexes;
+}
+
+span<int32_t> AgentTable::getXs()
+{
+    return _xs;
+}
+
+span<const int32_t> AgentTable::getXs() const
+{
+    return _xs;
+}
+
+span<int32_t> AgentTable::getYs()
+{
+    return _ys;
+}
+
+span<const int32_t> AgentTable::getYs() const
+{
+    return _ys;
+}
+
+span<int32_t> AgentTable::getNextXs()
+{
+    return _nextXs;
+}
+
+span<const int32_t> AgentTable::getNextXs() const
+{
+    return _nextXs;
+}
+
+span<int32_t> AgentTable::getNextYs()
+{
+    return _nextYs;
+}
+
+span<const int32_t> AgentTable::getNextYs() const
+{
+    return _nextYs;
+}
+
+span<int32_t> AgentTable::getHeadingXs()
+{
+    return _headingXs;
+}
+
+span<const int32_t> AgentTable::getHeadingXs() const
+{
+    return _headingXs;
+}
+
+span<int32_t> AgentTable::getHeadingYs()
+{
+    return _headingYs;
+}
+
+span<const int32_t> AgentTable::getHeadingYs() const
+{
+    return _headingYs;
+}
+
+span<int32_t> AgentTable::getTargetIds()
+{
+    return _targetIds;
+}
+
+span<const int32_t> AgentTable::getTargetIds() const
+{
+    return _targetIds;
+}
+
+span<uint8_t> AgentTable::getPolicyIds()
+{
+    return _policyIds;
+}
+
+span<const uint8_t> AgentTable::getPolicyIds() const
+{
+    return _policyIds;
+}
+
+span<AgentState> AgentTable::getStates()
+{
+    return _states;
+}
+
+span<const AgentState> AgentTable::getStates() const
+{
+    return _states;
+}
+
+span<int32_t> AgentTable::getRestTicks()
+{
+    return _restTicks;
+}
+
+span<const int32_t> AgentTable::getRestTicks() const
+{
+    return _restTicks;
+}
+
+span<int32_t> AgentTable::getWaits()
+{
+    return _waits;
+}
+
+span<const int32_t> AgentTable::getWaits() const
+{
+    return _waits;
+}
+
+span<int32_t> AgentTable::getLevels()
+{
+    return _levels;
+}
+
+span<const int32_t> AgentTable::getLevels() const
+{
+    return _levels;
+}
+
+span<int64_t> AgentTable::getActedTicks()
+{
+    return _actedTicks;
+}
+
+span<const int64_t> AgentTable::getActedTicks() const
+{
+    return _actedTicks;
+}
@@ -0,0 +1,126 @@
+#ifndef AGENTTABLE__H
+#define AGENTTABLE__H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "AgentState.h"
+#include "Position.h"
+
+/*
+The state of many agents, one row per agent, stored as a structure of arrays: each field is its own contiguous column. An engine that steps every agent reads each column front to back, instead of following a pointer per agent, and a loop over one column can be vectorised.
+
+The columns are:
+boxIds, the agent's Box.
+planIndexes, where the agent's BoxPlan, with its PositionManager and Decider, is kept by the engine.
+xs and ys, the agent's Position.
+nextXs and nextYs, the Position the agent will try next, or -1 if it has none.
+headingXs and headingYs, the Position the agent heads for now: its target, or a waypoint on the way to it, or -1 if it has none yet.
+targetIds, the engine's id for the agent's exit and for how it is steered there.
+policyIds, the agent's DeciderType, or 0 if the agent's own Decider decides.
+states, the agent's AgentState.
+restTicks, the ticks the agent waits before it acts again.
+waits, the times the agent was kept from entering.
+levels, the times the agent found its next Position taken or lost it to another agent.
+actedTicks, the last tick in which the agent acted, or -1.
+
+Rows are added in order and only move when compact() removes the exited agents. Columns are handed out as spans. A span stays valid until the next add() or compact(). Only one thread may add() or compact(), while no other thread uses the table. Different threads may change different rows at the same time.
+*/
+class AgentTable
+{
+    public:
+
+    AgentTable() = default;
+    AgentTable(const AgentTable& o) = delete;
+    AgentTable(AgentTable&& o) noexcept = default;
+    AgentTable& operator=(const AgentTable& o) = delete;
+    AgentTable& operator=(AgentTable&& o) noexcept = default;
+    ~AgentTable() noexcept = default;
+
+    void reserve(int rowCount);
+
+    /*
+    Adds an entering agent at @position with no next Position and no heading, and returns its row.
+    */
+    int add(int boxId, int planIndex, Position position, int targetId, uint8_t policyId);
+
+    int size() const;
+
+    /*
+    Removes the rows whose state is AgentState::exited. The other rows keep their order. Returns the new row of every old row, or -1 for a removed row.
+    */
+    std::vector<int> compact();
+
+    Position getPosition(int row) const;
+    void setPosition(int row, Position position);
+
+    /*
+    Returns {-1, -1} if the agent at @row has no next Position.
+    */
+    Position getNext(int row) const;
+    void setNext(int row, Position position);
+
+    /*
+    Returns {-1, -1} if the agent at @row has no heading.
+    */
+    Position getHeading(int row) const;
+    void setHeading(int row, Position position);
+
+    std::span<int32_t> getBoxIds();
+    std::span<const int32_t> getBoxIds() const;
+    std::span<int32_t> getPlanIndexes();
+    std::span<const int32_t> getPlanIndexes() const;
+    std::span<int32_t> getXs();
+    std::span<const int32_t> getXs() const;
+    std::span<int32_t> getYs();
+    std::span<const int32_t> getYs() const;
+    std::span<int32_t> getNextXs();
+    std::span<const int32_t> getNextXs() const;
+    std::span<int32_t> getNextYs();
+    std::span<const int32_t> getNextYs() const;
+    std::span<int32_t> getHeadingXs();
+    std::span<const int32_t> getHeadingXs() const;
+    std::span<int32_t> getHeadingYs();
+    std::span<const int32_t> getHeadingYs() const;
+    std::span<int32_t> getTargetIds();
+    std::span<const int32_t> getTargetIds() const;
+    std::span<uint8_t> getPolicyIds();
+    std::span<const uint8_t> getPolicyIds() const;
+    std::span<AgentState> getStates();
+    std::span<const AgentState> getStates() const;
+    std::span<int32_t> getRestTicks();
+    std::span<const int32_t> getRestTicks() const;
+    std::span<int32_t> getWaits();
+    std::span<const int32_t> getWaits() const;
+    std::span<int32_t> getLevels();
+    std::span<const int32_t> getLevels() const;
+    std::span<int64_t> getActedTicks();
+    std::span<const int64_t> getActedTicks() const;
+
+
+    private:
+
+    std::vector<int32_t> _boxIds{};
+    std::vector<int32_t> _planIndexes{};
+    std::vector<int32_t> _xs{};
+    std::vector<int32_t> _ys{};
+    std::vector<int32_t> _nextXs{};
+    std::vector<int32_t> _nextYs{};
+    std::vector<int32_t> _headingXs{};
+    std::vector<int32_t> _headingYs{};
+    std::vector<int32_t> _targetIds{};
+    std::vector<uint8_t> _policyIds{};
+    std::vector<AgentState> _states{};
+    std::vector<int32_t> _restTicks{};
+    std::vector<int32_t> _waits{};
+    std::vector<int32_t> _levels{};
+    std::vector<int64_t> _actedTicks{};
+
+    /*
+    Calls @f on every column, to grow or shrink them all alike.
+    */
+    template<typename F>
+    void forEachColumn(F&& f);
+};
+
+#endif
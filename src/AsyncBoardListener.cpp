@@ -0,0 +1,122 @@
+#include "AsyncBoardListener.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+AsyncBoardListener::AsyncBoardListener(
+    BoardListener* listener,
+    int capacity,
+    BackpressurePolicy policy)
+:   _listener{listener},
+    _capacity{capacity},
+    _policy{policy}
+{
+    if (_capacity < 1)
+    {
+        throw invalid_argument("AsyncBoardListener's capacity must be at least 1.");
+    }
+
+    // Start the consumer thread last, once all the attributes are set.
+    _consumer = thread(&AsyncBoardListener::consume, this);
+}
+
+AsyncBoardListener::~AsyncBoardListener() noexcept
+{
+    {
+        lock_guard<mutex> lock(_mux);
+        _stopping = true;
+    }
+    _frameQueued.notify_all();
+    _frameTaken.notify_all();
+    _consumer.join();
+}
+
+void AsyncBoardListener::receiveChanges(const shared_ptr<const Frame>& frame)
+{
+    {
+        unique_lock<mutex> lock(_mux);
+        ++_received;
+        _lastReceivedSequence = frame->getSequence();
+
+        if (static_cast<int>(_queue.size()) < _capacity)
+        {
+            _queue.push_back(frame);
+        }
+        else if (_policy == BackpressurePolicy::block)
+        {
+            _frameTaken.wait(lock, [this]{ return _stopping || static_cast<int>(_queue.size()) < _capacity; });
+            _queue.push_back(frame);
+        }
+        else if (_policy == BackpressurePolicy::drop_oldest)
+        {
+            _queue.pop_front();
+            ++_dropped;
+            _queue.push_back(frame);
+        }
+        else
+        {
+            // Merge into the newest queued Frame, so the listener still receives every change.
+            _queue.back() = Frame::coalesce(*_queue.back(), *frame);
+            ++_coalesced;
+        }
+
+        _maxQueueLength = std::max(_maxQueueLength, static_cast<int>(_queue.size()));
+    }
+    _frameQueued.notify_one();
+}
+
+void AsyncBoardListener::flush()
+{
+    unique_lock<mutex> lock(_mux);
+    _frameTaken.wait(lock, [this]{ return _queue.empty() && !_delivering; });
+}
+
+ListenerStats AsyncBoardListener::getStats() const
+{
+    lock_guard<mutex> lock(_mux);
+    return ListenerStats{
+        _received,
+        _delivered,
+        _dropped,
+        _coalesced,
+        static_cast<int>(_queue.size()),
+        _maxQueueLength,
+        _lastReceivedSequence,
+        _lastDeliveredSequence};
+}
+
+void AsyncBoardListener::consume()
+{
+    while (true)
+    {
+        shared_ptr<const Frame> frame{};
+        {
+            unique_lock<mutex> lock(_mux);
+            _frameQueued.wait(lock, [this]{ return _stopping || !_queue.empty(); });
+
+            // Only stop once the queue has been delivered.
+            if (_queue.empty())
+            {
+                return;
+            }
+
+            frame = std::move(_queue.front());
+            _queue.pop_front();
+            _delivering = true;
+        }
+        _frameTaken.notify_all();
+
+        // The wrapped listener is called without holding _mux, so the Board is never blocked by it.
+        _listener->receiveChanges(frame);
+
+        {
+            lock_guard<mutex> lock(_mux);
+            _delivering = false;
+            ++_delivered;
+            _lastDeliveredSequence = frame->getSequence();
+        }
+        _frameTaken.notify_all();
+    }
+}
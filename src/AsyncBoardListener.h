@@ -0,0 +1,84 @@
+#ifndef ASYNCBOARDLISTENER__H
+#define ASYNCBOARDLISTENER__H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "BackpressurePolicy.h"
+#include "BoardListener.h"
+#include "ListenerStats.h"
+
+/*
+Moves a BoardListener off of the Board's broadcasting thread.
+
+AsyncBoardListener is registered with the Board in place of the wrapped BoardListener. When the Board sends a Frame, AsyncBoardListener only puts the Frame in a bounded queue and returns. Its own consumer thread takes Frames off of the queue and passes them to the wrapped BoardListener. So a slow BoardListener no longer slows down how often the Board collects changes.
+
+When the queue is full, the BackpressurePolicy decides whether the Board waits, the oldest Frame is dropped, or the incoming Frame is merged into the newest queued Frame.
+
+The wrapped BoardListener is only ever called from the consumer thread.
+*/
+class AsyncBoardListener : public BoardListener
+{
+    public:
+
+    /*
+    @listener is the wrapped BoardListener. It must outlive the AsyncBoardListener.
+    @capacity is the most Frames that can wait in the queue. It must be at least 1.
+    */
+    AsyncBoardListener(BoardListener* listener, int capacity, BackpressurePolicy policy);
+    AsyncBoardListener() = delete;
+    AsyncBoardListener(const AsyncBoardListener& o) = delete;
+    AsyncBoardListener(AsyncBoardListener&& o) noexcept = delete;
+    AsyncBoardListener& operator=(const AsyncBoardListener& o) = delete;
+    AsyncBoardListener& operator=(AsyncBoardListener&& o) noexcept = delete;
+
+    /*
+    Delivers the Frames still in the queue, then stops the consumer thread.
+    */
+    ~AsyncBoardListener() noexcept;
+
+    /*
+    Queues @frame for the consumer thread according to the BackpressurePolicy.
+    */
+    void receiveChanges(const std::shared_ptr<const Frame>& frame) override;
+
+    /*
+    Blocks until every queued Frame has been delivered to the wrapped BoardListener.
+    */
+    void flush();
+
+    ListenerStats getStats() const;
+
+
+    private:
+
+    BoardListener* _listener;
+    const int _capacity;
+    const BackpressurePolicy _policy;
+
+    std::deque<std::shared_ptr<const Frame>> _queue{};
+
+    // _delivering is true while the consumer thread is passing a Frame to _listener.
+    bool _delivering = false;
+    bool _stopping = false;
+
+    long _received = 0;
+    long _delivered = 0;
+    long _dropped = 0;
+    long _coalesced = 0;
+    int _maxQueueLength = 0;
+    long _lastReceivedSequence = -1;
+    long _lastDeliveredSequence = -1;
+
+    mutable std::mutex _mux;
+    std::condition_variable _frameQueued;
+    std::condition_variable _frameTaken;
+
+    std::thread _consumer;
+
+    void consume();
+};
+
+#endif
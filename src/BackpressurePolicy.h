@@ -0,0 +1,12 @@
+#ifndef BACKPRESSUREPOLICY__H
+#define BACKPRESSUREPOLICY__H
+
+/*
+What an AsyncBoardListener does when a Frame arrives and its queue is full.
+BackpressurePolicy::block makes the broadcasting thread wait until there is room in the queue.
+BackpressurePolicy::drop_oldest discards the oldest queued Frame. Only use it for listeners that do not accumulate changes, because the discarded Frame's changes are lost.
+BackpressurePolicy::coalesce merges the incoming Frame into the newest queued Frame, so no changes are lost and the listener receives fewer, larger Frames.
+*/
+enum class BackpressurePolicy{block=1, drop_oldest=2, coalesce=3};
+
+#endif
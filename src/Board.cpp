@@ -1,38 +1,55 @@
 #include "Board.h"
 
+#include <algorithm>
+#include "Tracer.h"
+#include "TscClock.h"
+
 using namespace std;
 
 Board::Board(
     int width,
     int height,
-    vector<Box>&& boxes)
+    vector<Box>&& boxes,
+    GridLayout layout)
 :   _width{width},
-    _height{height}
+    _height{height},
+    _gridIndex{width, height, layout},
+    _subscribedCells((static_cast<size_t>(width) * height + 63) / 64),
+    _epochTicks{TscClock::now()}
 {
-    // The number of Spots that _spots contains is height times width.
-    // The number of Drops that both _dropMatrix1 and _dropMatrix2 contain is height x width.
-    _spots = vector<vector<Spot>>(height,vector<Spot>{});
-    _dropMatrix1 = vector<vector<Drop>>(height, vector<Drop>{});
-    _dropMatrix2 = vector<vector<Drop>>(height, vector<Drop>{});
-
-    for(int row=0; row<height; ++row)
+    // _spots, _dropMatrix1, and _dropMatrix2 hold one Spot or Drop per index of _gridIndex, in index order. The cells that only pad out the tiles are never used.
+    int indexCount = _gridIndex.getIndexCount();
+    vector<Position> positionPerIndex(indexCount, Position{0, 0});
+    for(int row=0; row<_gridIndex.getPaddedHeight(); ++row)
     {
-        for(int col=0; col<width; ++col)
+        for(int col=0; col<_gridIndex.getPaddedWidth(); ++col)
         {
-            _spots[row].push_back(Spot{Position{col, row}});
-            _dropMatrix1[row].push_back(Drop{col, row});
-            _dropMatrix2[row].push_back(Drop{col, row});
+            positionPerIndex[_gridIndex.getIndex(col, row)] = Position{col, row};
         }
     }
 
+    _spots.reserve(indexCount);
+    _dropMatrix1.reserve(indexCount);
+    _dropMatrix2.reserve(indexCount);
+    for(Position position : positionPerIndex)
+    {
+        _spots.emplace_back(position);
+        _dropMatrix1.push_back(Drop{position.getX(), position.getY()});
+        _dropMatrix2.push_back(Drop{position.getX(), position.getY()});
+    }
+
     // Set _receivingMatrix to one of the Drop matrices.
     _receivingMatrix = &_dropMatrix1;
 
-    // Move the Boxes from boxes to _boxes.
-    for(const Box& box : boxes)
+    // Move the Boxes from boxes to _boxes and index them by boxId.
+    auto boxIndexPerId = make_shared<unordered_map<int, int>>();
+    _boxes.reserve(boxes.size());
+    for(Box& box : boxes)
     {  
-        _boxes.emplace(pair<int, Box>{box.getId(), std::move(box)});
+        boxIndexPerId->insert({box.getId(), static_cast<int>(_boxes.size())});
+        _boxes.push_back(std::move(box));
     }
+    _boxIndexPerId = std::move(boxIndexPerId);
 }
 
 /*
@@ -44,13 +61,42 @@ A particular Spot and its corresponding Drop in _recevingMatrix should be changi
 */
 bool Board::changeSpot(Position position, BoardNote newNote, bool upLevel)
 {
-    shared_lock<shared_mutex> shLock(_mux);
+#if defined(PLAZA_LOCK_WAIT_LATENCIES) || defined(PLAZA_TRACING)
+    // Timed only when a build asks for it, since this runs on every move.
+    uint64_t lockStart = TscClock::now();
+    ProfiledSharedLock shLock(_mux);
+    uint64_t locked = TscClock::now();
+#ifdef PLAZA_LOCK_WAIT_LATENCIES
+    _latencies.recordTicks(StepPhase::changeSpotLockWait, locked - lockStart);
+#endif
+#ifdef PLAZA_TRACING
+    // Only waits long enough to matter are traced, or the trace would be mostly these.
+    static const uint64_t longLockWait = static_cast<uint64_t>(10000.0 / TscClock::getNanosecondsPerTick());
+    if (locked - lockStart > longLockWait)
+    {
+        PLAZA_TRACE_INTERVAL("changeSpot lock wait", newNote.getBoxId(), lockStart, locked);
+    }
+#endif
+#else
+    ProfiledSharedLock shLock(_mux);
+#endif
+
+    return updateSpot(position, newNote, upLevel, false);
+}
+
+bool Board::changeOwnedSpot(Position position, BoardNote newNote, bool upLevel)
+{
+    return updateSpot(position, newNote, upLevel, true);
+}
 
+bool Board::updateSpot(Position position, BoardNote newNote, bool upLevel, bool owned)
+{
     int posX = position.getX();
     int posY = position.getY();
 
     // Only allow Boxes that are in the _boxes vector to be added to the Board.
-    if(_boxes.find(newNote.getBoxId()) == _boxes.end())
+    auto boxIndex = _boxIndexPerId->find(newNote.getBoxId());
+    if(boxIndex == _boxIndexPerId->end())
     {
         string str = "Trying to add a BoardNote with a boxId of ";
         str.append(to_string(newNote.getBoxId()));
@@ -60,13 +106,16 @@ bool Board::changeSpot(Position position, BoardNote newNote, bool upLevel)
 
     // Try to update Spot at @position.
     // See Spot class' rules to determine if a Box with this boxId and MoveType at @position is allowed. Hint: Put basically, @position has to be empty in order for a Box to enter the Spot. And only a BoardNote with the Spot's current boxId can move the Box out of the Spot.
-    pair<int, bool> success = _spots[posY][posX].changeNote(newNote);
+    int index = _gridIndex.getIndex(posX, posY);
+    pair<int, bool> success = owned ? _spots[index].changeOwnedNote(newNote) : _spots[index].changeNote(newNote);
     
     if (success.second)
     {
+        _metrics.count(SimulationCounter::changeSpotSucceeded);
+
         // Record changes to Spot in _receivedMatrix, which is a matrix of Drops.
-        BoardNote changedBoardNote = _spots[posY][posX].getBoardNote();
-        Drop& drop = (*_receivingMatrix)[posY][posX];
+        BoardNote changedBoardNote = owned ? _spots[index].getOwnedBoardNote() : _spots[index].getBoardNote();
+        Drop& drop = (*_receivingMatrix)[index];
 
         // Record that this Drop has changed.
         drop.setHasChanged(true);
@@ -80,72 +129,121 @@ bool Board::changeSpot(Position position, BoardNote newNote, bool upLevel)
         // Record changed MoveType.
         drop.setMoveType(changedBoardNote.getType());
 
-        // Move was successful. Notify all NoteSubscribers.
-        if (_noteSubscribersPerPos.find(position) != _noteSubscribersPerPos.end())
+        // Move was successful. Notify the NoteSubscribers at @position, if it has any.
+        int cell = posY * _width + posX;
+        if (_subscribedCells[cell >> 6].load(memory_order_acquire) & (uint64_t{1} << (cell & 63)))
+        {
+            notifyNoteSubscribers(cell, newNote);
+        }
+
+        if (!_transitionListeners.empty())
         {
-            _noteSubscribersPerPos.at(position).callback(newNote);
+            notifyTransitionListeners(position, newNote, success.first, false, upLevel);
         }
 
         return true;
     }
     else
     {
-        if(upLevel)
-        {
-            // Movement was not successful. Both boxes' levels are increased by one.
-            _boxes[success.first].upLevel();
-            _boxes[newNote.getBoxId()].upLevel();
-        }
+        collide(position, newNote, boxIndex->second, success.first, upLevel);
         return false; 
     }
 }
 
+void Board::recordOwnedCollision(Position position, BoardNote newNote, int otherBoxId)
+{
+    if (position.getX() < 0 || position.getX() >= _width || position.getY() < 0 || position.getY() >= _height)
+    {
+        throw invalid_argument("Trying to record a collision at " + position.toString() + ", which is not on the Board.");
+    }
+    auto boxIndex = _boxIndexPerId->find(newNote.getBoxId());
+    if (boxIndex == _boxIndexPerId->end() || _boxIndexPerId->find(otherBoxId) == _boxIndexPerId->end())
+    {
+        string str = "Trying to record a collision between boxIds ";
+        str.append(to_string(newNote.getBoxId()));
+        str.append(" and ");
+        str.append(to_string(otherBoxId));
+        str.append(" when there is no Box with one of them.");
+        throw(invalid_argument(str));
+    }
+    collide(position, newNote, boxIndex->second, otherBoxId, true);
+}
+
+void Board::collide(Position position, BoardNote newNote, int boxIndex, int otherBoxId, bool upLevel)
+{
+    _metrics.count(SimulationCounter::changeSpotFailed);
+
+    if (!_transitionListeners.empty())
+    {
+        notifyTransitionListeners(position, newNote, otherBoxId, true, upLevel);
+    }
+
+    if(upLevel)
+    {
+        _metrics.count(SimulationCounter::collisions);
+
+        // Movement was not successful. Both boxes' levels are increased by one.
+        _boxes[_boxIndexPerId->at(otherBoxId)].upLevel();
+        _boxes[boxIndex].upLevel();
+    }
+}
+
 void Board::sendStateAndChanges()
 {   
     // The uniqueLock, enteringMethodLock, prevents two threads entering the sendStateAndChanges() method at the same time. No other method uses the _enteringMethodMutex.
-    unique_lock<shared_mutex> enteringMethodLock(_enteringMethodMutex);
+    ProfiledUniqueLock enteringMethodLock(_enteringMethodMutex);
+    PLAZA_TRACE_SPAN("sendStateAndChanges", Tracer::boardLane);
 
 
     // changedBoard will point to the current _receivingMatrix.
-    vector<vector<Drop>>* changedBoard = nullptr;
-    unordered_map<int, BoxInfo> copyOfBoxInfo{};
+    vector<Drop>* changedBoard = nullptr;
+    vector<BoxInfo> copyOfBoxInfo{};
+    copyOfBoxInfo.reserve(_boxes.size());
 
     // Braces encapsulate the task of data collection. The data does not change during this task. While 1) toggling _receivedMatrix, 2) assigning changedBoard, and 3) copying _boxes' boxInfos, no new notes are being added due to changeSpot() sharing the _mux mutex that collectDataLock is using.
     {
-        unique_lock<shared_mutex> collectDataLock(_mux);
+        PLAZA_TRACE_SPAN("collect", Tracer::boardLane);
+        ProfiledUniqueLock collectDataLock(_mux);
         
         changedBoard = _receivingMatrix;
         _receivingMatrix = (_receivingMatrix == &_dropMatrix1) ? (&_dropMatrix2) : (&_dropMatrix1);
         
         // Copy BoxInfos to send.
-        for(const auto& p : _boxes)
+        for(const Box& box : _boxes)
         {
-            copyOfBoxInfo.insert({p.first, p.second.getInfo()});
+            copyOfBoxInfo.push_back(box.getInfo());
         }
     }
 
-    // Collect changed Drops from changedBoard.
-    unordered_set<Drop> changedDrops;
+    // Collect changed Drops from changedBoard, a row at a time whatever the GridLayout, so the Frame lists them in the same order.
+    vector<Drop> changedDrops;
 
     for (int row=0; row<_height; ++row)
     {
         for (int col=0; col<_width; ++col)
         {
-            Drop curDrop = (*changedBoard)[row][col];
+            Drop& curDrop = (*changedBoard)[_gridIndex.getIndex(col, row)];
             if (curDrop.hasChanged())
             {
-                changedDrops.insert(curDrop);
-                (*changedBoard)[row][col].setBoxId(-1);
-                (*changedBoard)[row][col].setMoveType(MoveType::left);
-                (*changedBoard)[row][col].setHasChanged(false);
+                changedDrops.push_back(Drop{col, row, curDrop.getBoxId(), curDrop.getMoveType()});
+                curDrop.setBoxId(-1);
+                curDrop.setMoveType(MoveType::left);
+                curDrop.setHasChanged(false);
             }
         }
     }
 
-    // Send changes to Drops and set of BoxInfo to BoardListeners.
+    // Build one immutable Frame and send it to all BoardListeners.
+    shared_ptr<const Frame> frame = make_shared<const Frame>(
+        _frameSequence++,
+        std::move(changedDrops),
+        std::move(copyOfBoxInfo),
+        _boxIndexPerId);
+
+    PLAZA_TRACE_SPAN("notify listeners", Tracer::boardLane);
     for(BoardListener* listener : _listeners)
     {
-        listener->receiveChanges(changedDrops, copyOfBoxInfo);
+        listener->receiveChanges(frame);
     }
 }
 
@@ -154,8 +252,57 @@ Note changes to a Spot (via changeSpot()) can happen at the same time that getNo
 */
 BoardNote Board::getNoteAt(Position position) const
 {
-    shared_lock<shared_mutex> lock(_mux);
-    return _spots[position.getY()][position.getX()].getBoardNote();
+    ProfiledSharedLock lock(_mux);
+    return _spots[_gridIndex.getIndex(position.getX(), position.getY())].getBoardNote();
+}
+
+BoardNote Board::getOwnedNoteAt(Position position) const
+{
+    return _spots[_gridIndex.getIndex(position.getX(), position.getY())].getOwnedBoardNote();
+}
+
+SimulationMetrics& Board::getMetrics()
+{
+    return _metrics;
+}
+
+PhaseLatencies& Board::getLatencies()
+{
+    return _latencies;
+}
+
+DoorwayFlow& Board::getDoorwayFlow()
+{
+    return _doorwayFlow;
+}
+
+void Board::registerTransitionListener(TransitionListener* listener)
+{
+    _nanosecondsPerTick = TscClock::getNanosecondsPerTick();
+    _transitionListeners.push_back(listener);
+}
+
+void Board::notifyTransitionListeners(
+    Position position,
+    BoardNote note,
+    int otherBoxId,
+    bool collision,
+    bool upLevel)
+{
+    SpotTransition transition{};
+    transition.timestamp = static_cast<int64_t>(static_cast<double>(TscClock::now() - _epochTicks) * _nanosecondsPerTick);
+    transition.boxId = note.getBoxId();
+    transition.otherBoxId = otherBoxId;
+    transition.x = static_cast<uint16_t>(position.getX());
+    transition.y = static_cast<uint16_t>(position.getY());
+    transition.type = static_cast<uint8_t>(note.getType());
+    transition.collision = collision ? 1 : 0;
+    transition.upLevel = upLevel ? 1 : 0;
+
+    for (TransitionListener* listener : _transitionListeners)
+    {
+        listener->receiveTransition(transition);
+    }
 }
 
 void Board::registerListener(BoardListener* listener)
@@ -174,9 +321,66 @@ int Board::getHeight() const
     return _height;
 }
 
+GridLayout Board::getLayout() const
+{
+    return _gridIndex.getLayout();
+}
+
 void Board::registerNoteSubscriber(Position pos, NoteSubscriber& subscriber)
 {
-    _noteSubscribersPerPos.insert({pos, subscriber});
+    if (pos.getX() < 0 || pos.getX() >= _width || pos.getY() < 0 || pos.getY() >= _height)
+    {
+        throw invalid_argument("Can not register a NoteSubscriber at " + pos.toString() + ", which is not on the Board.");
+    }
+    int cell = pos.getY() * _width + pos.getX();
+
+    ProfiledUniqueLock lock(_subscriberMux);
+    vector<NoteSubscriber*>& subscribers = _noteSubscribersPerCell[cell];
+    if (find(subscribers.begin(), subscribers.end(), &subscriber) == subscribers.end())
+    {
+        subscribers.push_back(&subscriber);
+    }
+    _subscribedCells[cell >> 6].fetch_or(uint64_t{1} << (cell & 63), memory_order_release);
+}
+
+void Board::unregisterNoteSubscriber(Position pos, NoteSubscriber& subscriber)
+{
+    if (pos.getX() < 0 || pos.getX() >= _width || pos.getY() < 0 || pos.getY() >= _height)
+    {
+        return;
+    }
+    int cell = pos.getY() * _width + pos.getX();
+
+    ProfiledUniqueLock lock(_subscriberMux);
+    auto entry = _noteSubscribersPerCell.find(cell);
+    if (entry == _noteSubscribersPerCell.end())
+    {
+        return;
+    }
+    vector<NoteSubscriber*>& subscribers = entry->second;
+    subscribers.erase(remove(subscribers.begin(), subscribers.end(), &subscriber), subscribers.end());
+    if (subscribers.empty())
+    {
+        _noteSubscribersPerCell.erase(entry);
+        _subscribedCells[cell >> 6].fetch_and(~(uint64_t{1} << (cell & 63)), memory_order_release);
+    }
+}
+
+/*
+The callbacks run under a shared_lock of _subscriberMux, so unregisterNoteSubscriber() waits for any callback that is running. A bit that was cleared after changeSpot() tested it just finds no entry here.
+*/
+void Board::notifyNoteSubscribers(int cell, BoardNote note)
+{
+    ProfiledSharedLock lock(_subscriberMux);
+    auto entry = _noteSubscribersPerCell.find(cell);
+    if (entry == _noteSubscribersPerCell.end())
+    {
+        return;
+    }
+    for (NoteSubscriber* subscriber : entry->second)
+    {
+        subscriber->callback(note);
+    }
 }
 
 BoardProxy Board::getBoardProxy()
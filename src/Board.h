@@ -3,23 +3,36 @@
 
 class BoardProxy;
 
-#include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "BoardListener.h"
 #include "BoardProxy.h"
 #include "Box.h"
+#include "DoorwayFlow.h"
 #include "Drop.h"
+#include "Frame.h"
+#include "GridIndex.h"
 #include "NoteSubscriber.h"
+#include "PhaseLatencies.h"
 #include "Position.h"
+#include "ProfiledSharedMutex.h"
+#include "SimulationMetrics.h"
 #include "Spot.h"
+#include "TransitionListener.h"
 
 /*  
 Conceptually a plane where Boxes are placed and can move in the x and y directions.
 
 The Board class contains a matrix of Spots, and each Spot contains a Position that matches the Spot's x,y position on the Board. In the matrix, the x-direction runs from left to right. The y-direction runs from top to bottom. The origin is in the top left corner of the Board. A Spot at Position {2, 4} is over two to the right and down four from the origin.
 
+The Spots are stored in the order of a GridLayout, row-major by default. In the tiled layouts the Spots around a Position are mostly in one 8 x 8 tile, close together in memory, and Boxes in different parts of the Board use different tiles.
+
 When a Box is placed on the Board, removed from the Board, or moves along the Board, the Board keeps track of these movements by updating its matrix of Spots. Requests to Box movements on the Board are done through the changeSpot() method.
 
 The Board also keeps track of the Boxes and their state.
@@ -31,8 +44,10 @@ class Board
     
     /*
     @boxes contains all the Boxes that Board will every be on the Board. Board is resposible for returning the state of these Boxes in sendStateAndChanges().
+
+    @layout is the order the Spots are stored in. It does not change what the Board does.
     */    
-    Board(int width, int height, std::vector<Box>&& boxes);
+    Board(int width, int height, std::vector<Box>&& boxes, GridLayout layout = GridLayout::rowMajor);
 
     Board(const Board& board) = delete;
     Board(Board&& o) noexcept = delete;
@@ -42,6 +57,7 @@ class Board
 
     int getWidth() const;
     int getHeight() const;
+    GridLayout getLayout() const;
     
     BoardProxy getBoardProxy();
 
@@ -54,54 +70,147 @@ class Board
     */
     bool changeSpot(Position position, BoardNote boardNote, bool upLevel);
 
+    /*
+    Same as changeSpot(), but takes neither the Board's lock nor the Spot's. Only for a caller that owns @position: no other thread may read or change the Spot at @position, and sendStateAndChanges() may not run, until changeOwnedSpot() returns. LockstepEngine owns the Spots it changes this way.
+    */
+    bool changeOwnedSpot(Position position, BoardNote boardNote, bool upLevel);
+
+    /*
+    Does what changeOwnedSpot() does when the Spot at @position is taken by the Box with @otherBoxId and upLevel is true, without reading the Spot: counts the failed change and the collision, passes the collision to the TransitionListeners, and raises both Boxes' levels by one. For an owner that already knows the Box it ran into, as LockstepEngine does when a Box loses its claim on a cell another Box has not moved into yet. sendStateAndChanges() may not run until it returns. Throws an invalid_argument exception if @position is not on the Board or either boxId has no Box.
+    */
+    void recordOwnedCollision(Position position, BoardNote boardNote, int otherBoxId);
+
 
     /*
-    Registers a NoteSubscriber for Position @pos. When the changeSpot() method is successful at @pos, the registered NoteSubscriber is notified through its callback() method. 
+    Registers a NoteSubscriber for Position @pos. When the changeSpot() method is successful at @pos, the registered NoteSubscriber is notified through its callback() method. A Position can have several NoteSubscribers, and registering the same NoteSubscriber twice for a Position has no effect. Throws an invalid_argument exception if @pos is not on the Board.
+
+    NoteSubscribers can be registered and unregistered while Boxes are moving. A callback() must not register or unregister NoteSubscribers.
     */
     void registerNoteSubscriber(Position pos, NoteSubscriber& callBack);
 
+    /*
+    Stops notifying @subscriber of changes at Position @pos. Once this returns, @subscriber's callback() is not running and will not be called for @pos again. Does nothing if @subscriber is not registered for @pos.
+    */
+    void unregisterNoteSubscriber(Position pos, NoteSubscriber& subscriber);
+
+    /*
+    Registers a TransitionListener. Every successful changeSpot() call and every collision (an unsuccessful changeSpot() call) is passed to the TransitionListener as a SpotTransition. Register TransitionListeners before any Box starts moving.
+    */
+    void registerTransitionListener(TransitionListener* listener);
+
     /*
     Register a BoardListener. BoardListeners receive updates when sendStateAndChanges() is called. See sendStateAndChanges() for more info on those sent changes and state.
     */
     void registerListener(BoardListener* listener);
 
     /*
-    Sends 1) the current state of the Boxes and 2) changes to the Spots. The current state of the Boxes is in the form of an unordered_map<int, BoxInfo> of boxIds to Boxes. All Boxes given in the constructor are included. This includes Boxes that have not entered the Board yet or have been removed because they reached their final destination. Changes to Spots are in the form of an unordered_set of Drops. This set contains only the changes since the last time sendStateAndChanges() was called.
+    Sends one Frame to all BoardListeners. The Frame holds 1) the current state of the Boxes and 2) changes to the Spots. The current state of the Boxes is a BoxInfo per Box. All Boxes given in the constructor are included. This includes Boxes that have not entered the Board yet or have been removed because they reached their final destination. Changes to Spots are in the form of Drops. They contain only the changes since the last time sendStateAndChanges() was called.
+
+    The Frame is built once and the same shared Frame is passed to every BoardListener.
     */
     void sendStateAndChanges();
 
     BoardNote getNoteAt(Position position) const;
 
+    /*
+    Same as getNoteAt(), but takes neither the Board's lock nor the Spot's. Only for a caller that owns the Board while it reads: no other thread may change the Spot at @position, and sendStateAndChanges() may not run, until getOwnedNoteAt() returns. LockstepEngine reads this way while no Spot it reads can change.
+    */
+    BoardNote getOwnedNoteAt(Position position) const;
+
+    /*
+    Returns the counters of everything that happens on the Board. changeSpot() counts its calls and collisions. Movers and Threader count entries, exits, moves, and retries.
+    */
+    SimulationMetrics& getMetrics();
+
+    /*
+    Returns the StepPhase histograms of the Boxes on the Board. changeSpot() records how long it waits for the Board's lock, in a build configured with -DPLAZA_LOCK_WAIT_LATENCIES=ON. Movers and Threader record the other StepPhases.
+    */
+    PhaseLatencies& getLatencies();
+
+    /*
+    Returns the flow through the doorways, once they are set with DoorwayFlow::setDoorways(). Movers record entries and exits, and Threader records the Boxes waiting to enter.
+    */
+    DoorwayFlow& getDoorwayFlow();
+
 private:
     const int _width;
     const int _height;
     
+    /*
+    The index of each cell in _spots and in the Drop matrices.
+    */
+    const GridIndex _gridIndex;
+
     /*
     _spots is the master board.
     */
-    std::vector<std::vector<Spot>> _spots;
+    std::vector<Spot> _spots;
 
     /*
     _dropMatrix1 and _dropMatrix2 keep track of the changes to the board that have not been sent out.
     */
-    std::vector<std::vector<Drop>> _dropMatrix1;
-    std::vector<std::vector<Drop>> _dropMatrix2;
+    std::vector<Drop> _dropMatrix1;
+    std::vector<Drop> _dropMatrix2;
     
     /*_receivingMatrix points to either _dropMatrix1 or _dropMatrix2. When sendChangesAndState() is called the matrix that _receivingMatrix points to is toggled from _dropMatrix1 to _dropMatrix2 or vice versa.  Changes are recorded in the matrix that _receivingMatrix currenlty points to.
     */
-    std::vector<std::vector<Drop>>* _receivingMatrix = nullptr;
+    std::vector<Drop>* _receivingMatrix = nullptr;
+
+    /*
+    The Boxes, in the order they were given in the constructor.
+    */
+    std::vector<Box> _boxes{};
 
     /*
-    boxes per boxId
+    Index into _boxes per boxId. It never changes after construction, so all Frames share it.
     */
-    std::unordered_map<int, Box> _boxes{};
+    std::shared_ptr<const std::unordered_map<int, int>> _boxIndexPerId;
 
-    std::unordered_map<Position, NoteSubscriber&> _noteSubscribersPerPos{};
+    /*
+    Sequence number of the next Frame.
+    */
+    long _frameSequence = 0;
+
+    /*
+    One bit per cell (cell = y * width + x), set while the cell has at least one NoteSubscriber. changeSpot() only has to test this bit when no one subscribes to the cell, which is nearly always.
+    */
+    std::vector<std::atomic<uint64_t>> _subscribedCells;
+
+    /*
+    The NoteSubscribers per subscribed cell. Guarded by _subscriberMux.
+    */
+    std::unordered_map<int, std::vector<NoteSubscriber*>> _noteSubscribersPerCell{};
 
     std::unordered_set<BoardListener*> _listeners;
+
+    std::vector<TransitionListener*> _transitionListeners{};
+
+    /*
+    SpotTransition timestamps are measured from _epochTicks, in TscClock ticks. _nanosecondsPerTick is looked up when the first TransitionListener is registered, so a Board without any does not wait for TscClock's calibration.
+    */
+    const uint64_t _epochTicks;
+    double _nanosecondsPerTick = 0.0;
+
+    SimulationMetrics _metrics{};
+    PhaseLatencies _latencies{};
+    DoorwayFlow _doorwayFlow{};
+
+    /*
+    The part of changeSpot() and changeOwnedSpot() after the locks are taken. @owned skips the Spot's lock.
+    */
+    bool updateSpot(Position position, BoardNote newNote, bool upLevel, bool owned);
+
+    /*
+    The part of updateSpot() and recordOwnedCollision() for a Box, at @boxIndex in _boxes, that could not move to @position because the Box with @otherBoxId is there.
+    */
+    void collide(Position position, BoardNote newNote, int boxIndex, int otherBoxId, bool upLevel);
+
+    void notifyTransitionListeners(Position position, BoardNote note, int otherBoxId, bool collision, bool upLevel);
+    void notifyNoteSubscribers(int cell, BoardNote note);
     
-    mutable std::shared_mutex _mux;
-    mutable std::shared_mutex _enteringMethodMutex;
+    mutable ProfiledSharedMutex _mux{"Board::_mux"};
+    mutable ProfiledSharedMutex _enteringMethodMutex{"Board::_enteringMethodMutex"};
+    mutable ProfiledSharedMutex _subscriberMux{"Board::_subscriberMux"};
      
 };
 
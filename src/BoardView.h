@@ -0,0 +1,43 @@
+#ifndef BOARDVIEW__H
+#define BOARDVIEW__H
+
+#include "Board.h"
+
+/*
+What a Decider reads of a Board. A Board converts to a BoardView that reads with the Board's locks, through Board::getNoteAt(), so a Decider can be handed a Board as it always has. An engine that owns the Board while its Deciders read, as LockstepEngine does in a tick, hands them an owned() BoardView instead, which reads through Board::getOwnedNoteAt() without taking a lock.
+*/
+class BoardView
+{
+    public:
+
+    BoardView(const Board& board) : _board{board}, _owned{false} {}
+    BoardView() = delete;
+    BoardView(const BoardView& o) = default;
+    BoardView(BoardView&& o) noexcept = default;
+    BoardView& operator=(const BoardView& o) = delete;
+    BoardView& operator=(BoardView&& o) noexcept = delete;
+    ~BoardView() noexcept = default;
+
+    /*
+    Returns a BoardView that reads @board without its locks. See Board::getOwnedNoteAt() for when that is allowed.
+    */
+    static BoardView owned(const Board& board)
+    {
+        return BoardView{board, true};
+    }
+
+    BoardNote getNoteAt(Position position) const
+    {
+        return _owned ? _board.getOwnedNoteAt(position) : _board.getNoteAt(position);
+    }
+
+
+    private:
+
+    const Board& _board;
+    const bool _owned;
+
+    BoardView(const Board& board, bool owned) : _board{board}, _owned{owned} {}
+};
+
+#endif
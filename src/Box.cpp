@@ -58,18 +58,18 @@ int Box::getWidth() const
 
 int Box::getLevel() const
 {
-    shared_lock<shared_mutex> lock(_mm);
+    ProfiledSharedLock lock(_mm);
     return _level;
 }
 
 void Box::upLevel()
 {
-    unique_lock<shared_mutex> lock(_mm);
+    ProfiledUniqueLock lock(_mm);
     ++_level;
 }
 
 BoxInfo Box::getInfo() const
 {
-    shared_lock<shared_mutex> lock(_mm);
+    ProfiledSharedLock lock(_mm);
     return BoxInfo{_id, _groupid, _width, _height, _level};
 }
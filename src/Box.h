@@ -1,8 +1,8 @@
 #ifndef BOX__H
 #define BOX__H
 
-#include <shared_mutex>
 #include "BoxInfo.h"
+#include "ProfiledSharedMutex.h"
 
 /* Box represents a person on the Board. A box contains a unique id and the group it belongs to. It also contains the width and height of the box. */
 class Box{
@@ -46,7 +46,7 @@ class Box{
     int _level  = 0;
     int _width  = -1; 
     int _height = -1;
-    mutable std::shared_mutex _mm;
+    mutable ProfiledSharedMutex _mm{"Box::_mm"};
 };
 
 
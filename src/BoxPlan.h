@@ -0,0 +1,30 @@
+#ifndef BOXPLAN__H
+#define BOXPLAN__H
+
+#include <memory>
+#include "Decider.h"
+#include "DeciderType.h"
+#include "Position.h"
+#include "PositionManager.h"
+#include "PositionManagerType.h"
+#include "Rectangle.h"
+
+/*
+Everything a Box needs to cross the Board: where it starts, the Rectangle it exits through, and the PositionManager and Decider that steer it. Threader makes BoxPlans and gives each one to a thread. VirtualTimeRunner runs them without threads.
+*/
+struct BoxPlan
+{
+    int boxId;
+
+    // The batch the Box was created in. Its Boxes share a start Rectangle, PositionManagerType, and DeciderType.
+    int batch;
+
+    Position start;
+    Rectangle exit;
+    PositionManagerType positionManagerType;
+    std::unique_ptr<PositionManager> positionManager;
+    DeciderType deciderType;
+    std::unique_ptr<Decider> decider;
+};
+
+#endif
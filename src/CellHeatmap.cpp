@@ -0,0 +1,123 @@
+#include "CellHeatmap.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    atomic<int> nextThreadShard{0};
+
+    // The same for every CellHeatmap, so a thread uses the same shard in each.
+    thread_local int threadShard = -1;
+}
+
+double CellHeatmap::Grid::get(HeatmapLayer layer, int x, int y) const
+{
+    return layers[static_cast<size_t>(layer)][y * width + x];
+}
+
+CellHeatmap::CellHeatmap(int width, int height, int shardCount)
+:   _width{width},
+    _height{height},
+    _shardCount{shardCount}
+{
+    if (width <= 0 || height <= 0 || shardCount <= 0)
+    {
+        throw invalid_argument("CellHeatmap needs a positive width, height, and shardCount, not " +
+            to_string(width) + ", " + to_string(height) + ", and " + to_string(shardCount) + ".");
+    }
+
+    size_t cells = static_cast<size_t>(width) * height;
+    for (int ii=0; ii<shardCount; ++ii)
+    {
+        _shards.push_back(make_unique<Cell[]>(cells));
+    }
+    _arrivedAt = make_unique<atomic<int64_t>[]>(cells);
+    for (size_t cell=0; cell<cells; ++cell)
+    {
+        _arrivedAt[cell].store(-1, memory_order_relaxed);
+    }
+}
+
+void CellHeatmap::receiveTransition(const SpotTransition& transition)
+{
+    if (transition.x >= _width || transition.y >= _height)
+    {
+        return;
+    }
+    int cell = transition.y * _width + transition.x;
+    Cell& counts = getShardForThisThread()[cell];
+
+    if (transition.isCollision())
+    {
+        counts.collisions.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    switch (transition.getMoveType())
+    {
+        case MoveType::arrive:
+            counts.traversals.fetch_add(1, memory_order_relaxed);
+            _arrivedAt[cell].store(transition.timestamp, memory_order_relaxed);
+            break;
+        case MoveType::left:
+        {
+            int64_t arrivedAt = _arrivedAt[cell].exchange(-1, memory_order_relaxed);
+            // A Box that never arrived, like one whose move was taken back, has no dwell time.
+            if (arrivedAt >= 0 && transition.timestamp >= arrivedAt)
+            {
+                counts.dwellNanoseconds.fetch_add(static_cast<uint64_t>(transition.timestamp - arrivedAt), memory_order_relaxed);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+CellHeatmap::Grid CellHeatmap::getGrid() const
+{
+    size_t cells = static_cast<size_t>(_width) * _height;
+    Grid grid{};
+    grid.width = _width;
+    grid.height = _height;
+    for (vector<double>& layer : grid.layers)
+    {
+        layer.assign(cells, 0.0);
+    }
+
+    vector<double>& traversals = grid.layers[static_cast<size_t>(HeatmapLayer::traversals)];
+    vector<double>& collisions = grid.layers[static_cast<size_t>(HeatmapLayer::collisions)];
+    vector<double>& dwellSeconds = grid.layers[static_cast<size_t>(HeatmapLayer::dwellSeconds)];
+    for (const auto& shard : _shards)
+    {
+        for (size_t cell=0; cell<cells; ++cell)
+        {
+            traversals[cell] += shard[cell].traversals.load(memory_order_relaxed);
+            collisions[cell] += shard[cell].collisions.load(memory_order_relaxed);
+            dwellSeconds[cell] += static_cast<double>(shard[cell].dwellNanoseconds.load(memory_order_relaxed)) / 1e9;
+        }
+    }
+    return grid;
+}
+
+int CellHeatmap::getWidth() const
+{
+    return _width;
+}
+
+int CellHeatmap::getHeight() const
+{
+    return _height;
+}
+
+CellHeatmap::Cell* CellHeatmap::getShardForThisThread()
+{
+    if (threadShard < 0)
+    {
+        threadShard = nextThreadShard.fetch_add(1, memory_order_relaxed);
+    }
+    return _shards[threadShard % _shardCount].get();
+}
@@ -0,0 +1,75 @@
+#ifndef CELLHEATMAP__H
+#define CELLHEATMAP__H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "HeatmapLayer.h"
+#include "TransitionListener.h"
+
+/*
+Counts, for every Position of the Board, how many Boxes arrived there, how many collided there, and how long Boxes stayed there. Register it with Board::registerTransitionListener() before the Boxes start moving. HeatmapExporter writes the counts as CSV grids or heatmap images, for example to find the bottlenecks around the entrance Rectangles.
+
+A Box's dwell time on a cell runs from its MoveType::arrive to its MoveType::left. Only the Box that holds a Spot changes it, so the cell's arrival time needs no lock.
+
+Boxes next to each other count into neighbouring cells, which share cache lines. So the counters are split into shards, and each thread counts into one shard, picked round robin when it first counts. getGrid() adds up the shards. Counting is a relaxed atomic add.
+*/
+class CellHeatmap : public TransitionListener
+{
+    public:
+
+    /*
+    The counts of every cell, added up over the shards. The value of Position {x, y} is at index y * width + x.
+    */
+    struct Grid
+    {
+        int width = 0;
+        int height = 0;
+        std::array<std::vector<double>, heatmapLayerCount> layers{};
+
+        double get(HeatmapLayer layer, int x, int y) const;
+    };
+
+    /*
+    Throws an invalid_argument exception if @width, @height, or @shardCount is not positive.
+    */
+    CellHeatmap(int width, int height, int shardCount = 4);
+    CellHeatmap() = delete;
+    CellHeatmap(const CellHeatmap& o) = delete;
+    CellHeatmap(CellHeatmap&& o) noexcept = delete;
+    CellHeatmap& operator=(const CellHeatmap& o) = delete;
+    CellHeatmap& operator=(CellHeatmap&& o) noexcept = delete;
+    ~CellHeatmap() noexcept = default;
+
+    void receiveTransition(const SpotTransition& transition) override;
+
+    Grid getGrid() const;
+
+    int getWidth() const;
+    int getHeight() const;
+
+
+    private:
+
+    struct Cell
+    {
+        std::atomic<uint32_t> traversals{0};
+        std::atomic<uint32_t> collisions{0};
+        std::atomic<uint64_t> dwellNanoseconds{0};
+    };
+
+    const int _width;
+    const int _height;
+    const int _shardCount;
+
+    std::vector<std::unique_ptr<Cell[]>> _shards{};
+
+    // Per cell: the timestamp of the MoveType::arrive of the Box on it, or -1.
+    std::unique_ptr<std::atomic<int64_t>[]> _arrivedAt;
+
+    Cell* getShardForThisThread();
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "CompressedTraceReader.h"
+
+#include <cstring>
+#include <stdexcept>
+#include "TraceFormat.h"
+
+using namespace std;
+
+CompressedTraceReader::CompressedTraceReader(const string& path)
+:   _file{path, ios::binary}
+{
+    if (!_file)
+    {
+        throw invalid_argument("CompressedTraceReader can not open " + path + ".");
+    }
+
+    char magic[sizeof(compressedTraceMagic)];
+    uint32_t version = 0;
+    _file.read(magic, sizeof(magic));
+    _file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!_file || memcmp(magic, compressedTraceMagic, sizeof(magic)) != 0)
+    {
+        throw invalid_argument(path + " is not a compressed trace file.");
+    }
+    if (version != compressedTraceVersion)
+    {
+        throw invalid_argument(path + " is compressed trace version " + to_string(version) + ", expected version " + to_string(compressedTraceVersion) + ".");
+    }
+
+    _width = readTraceInt(_file);
+    _height = readTraceInt(_file);
+    int boxCount = readTraceInt(_file);
+    if (!_file || boxCount < 0)
+    {
+        throw invalid_argument(path + " has a damaged header.");
+    }
+    _boxInfos.reserve(boxCount);
+    for (int ii=0; ii<boxCount; ++ii)
+    {
+        int id = readTraceInt(_file);
+        int group = readTraceInt(_file);
+        int width = readTraceInt(_file);
+        int height = readTraceInt(_file);
+        _boxInfos.push_back(BoxInfo{id, group, width, height, 0});
+    }
+    int boxIdLimit = readTraceInt(_file);
+    if (!_file || boxIdLimit < 0)
+    {
+        throw invalid_argument(path + " has a damaged header.");
+    }
+    _codec = make_unique<TraceBlockCodec>(boxIdLimit);
+
+    // The footer holds the offset of the block index.
+    _file.seekg(-static_cast<streamoff>(sizeof(int64_t)), ios::end);
+    int64_t indexOffset = readTraceLong(_file);
+    if (!_file || indexOffset <= 0)
+    {
+        throw invalid_argument(path + " has no block index. It may not have been closed.");
+    }
+    _file.seekg(indexOffset);
+    int blockCount = readTraceInt(_file);
+    for (int ii=0; ii<blockCount && _file; ++ii)
+    {
+        BlockEntry block{};
+        block.offset = readTraceLong(_file);
+        block.size = readTraceLong(_file);
+        block.firstRecord = readTraceLong(_file);
+        block.recordCount = readTraceInt(_file);
+        block.smallestTimestamp = readTraceLong(_file);
+        block.largestTimestamp = readTraceLong(_file);
+        _blocks.push_back(block);
+        _recordCount += block.recordCount;
+    }
+    if (!_file)
+    {
+        throw invalid_argument(path + " has a damaged block index.");
+    }
+}
+
+int CompressedTraceReader::getWidth() const
+{
+    return _width;
+}
+
+int CompressedTraceReader::getHeight() const
+{
+    return _height;
+}
+
+const vector<BoxInfo>& CompressedTraceReader::getBoxInfos() const
+{
+    return _boxInfos;
+}
+
+long CompressedTraceReader::getRecordCount() const
+{
+    return _recordCount;
+}
+
+int CompressedTraceReader::getBlockCount() const
+{
+    return static_cast<int>(_blocks.size());
+}
+
+int CompressedTraceReader::readBlock(int block, vector<SpotTransition>& out)
+{
+    const BlockEntry& entry = _blocks.at(block);
+    _bytes.resize(static_cast<size_t>(entry.size));
+    _file.clear();
+    _file.seekg(entry.offset);
+    _file.read(reinterpret_cast<char*>(_bytes.data()), static_cast<streamsize>(entry.size));
+    if (!_file)
+    {
+        throw invalid_argument("Block " + to_string(block) + " of the compressed trace is cut short.");
+    }
+    ++_blocksDecoded;
+    return _codec->decode(_bytes.data(), _bytes.size(), out);
+}
+
+long CompressedTraceReader::readRange(int64_t from, int64_t to, vector<SpotTransition>& out)
+{
+    long appended = 0;
+    for (int block=0; block<static_cast<int>(_blocks.size()); ++block)
+    {
+        const BlockEntry& entry = _blocks[block];
+        if (entry.largestTimestamp < from || entry.smallestTimestamp > to)
+        {
+            continue;
+        }
+
+        _decoded.clear();
+        readBlock(block, _decoded);
+        for (const SpotTransition& record : _decoded)
+        {
+            if (record.timestamp >= from && record.timestamp <= to)
+            {
+                out.push_back(record);
+                ++appended;
+            }
+        }
+    }
+    return appended;
+}
+
+long CompressedTraceReader::getBlocksDecoded() const
+{
+    return _blocksDecoded;
+}
@@ -0,0 +1,86 @@
+#ifndef COMPRESSEDTRACEREADER__H
+#define COMPRESSEDTRACEREADER__H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BoxInfo.h"
+#include "SpotTransition.h"
+#include "TraceBlockCodec.h"
+
+/*
+Reads a compressed trace file written by CompressedTraceWriter. See TraceFormat.h for the file layout.
+
+The block index is read when the file is opened. A time range is read by decoding only the blocks whose timestamps overlap the range.
+*/
+class CompressedTraceReader
+{
+    public:
+
+    /*
+    Opens the compressed trace at @path and reads its header and block index. Throws an invalid_argument exception if the file can not be opened, is not a compressed trace of this version, or was not closed by its writer.
+    */
+    explicit CompressedTraceReader(const std::string& path);
+    CompressedTraceReader() = delete;
+    CompressedTraceReader(const CompressedTraceReader& o) = delete;
+    CompressedTraceReader(CompressedTraceReader&& o) noexcept = delete;
+    CompressedTraceReader& operator=(const CompressedTraceReader& o) = delete;
+    CompressedTraceReader& operator=(CompressedTraceReader&& o) noexcept = delete;
+    ~CompressedTraceReader() noexcept = default;
+
+    int getWidth() const;
+    int getHeight() const;
+
+    /*
+    Returns the Boxes in the header. Their levels are 0.
+    */
+    const std::vector<BoxInfo>& getBoxInfos() const;
+
+    long getRecordCount() const;
+    int getBlockCount() const;
+
+    /*
+    Appends the records of block @block to @out, in the order they were written. Returns the number of records appended.
+    */
+    int readBlock(int block, std::vector<SpotTransition>& out);
+
+    /*
+    Appends every record with a timestamp from @from to @to (both included) to @out, in the order they were written. Returns the number of records appended.
+    */
+    long readRange(int64_t from, int64_t to, std::vector<SpotTransition>& out);
+
+    /*
+    Returns the number of blocks decoded so far.
+    */
+    long getBlocksDecoded() const;
+
+
+    private:
+
+    struct BlockEntry
+    {
+        int64_t offset;
+        int64_t size;
+        int64_t firstRecord;
+        int32_t recordCount;
+        int64_t smallestTimestamp;
+        int64_t largestTimestamp;
+    };
+
+    std::ifstream _file;
+    int _width = 0;
+    int _height = 0;
+    std::vector<BoxInfo> _boxInfos{};
+    std::vector<BlockEntry> _blocks{};
+    long _recordCount = 0;
+    long _blocksDecoded = 0;
+
+    // Created once the header has been read, since it needs the boxIdLimit.
+    std::unique_ptr<TraceBlockCodec> _codec{};
+    std::vector<uint8_t> _bytes{};
+    std::vector<SpotTransition> _decoded{};
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "CompressedTraceWriter.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include "TraceFormat.h"
+#include "TraceReader.h"
+
+using namespace std;
+
+namespace
+{
+    int getBoxIdLimit(const vector<BoxInfo>& boxes)
+    {
+        int limit = 0;
+        for (const BoxInfo& box : boxes)
+        {
+            if (box.getId() < 0)
+            {
+                throw invalid_argument("CompressedTraceWriter can not write negative boxIds.");
+            }
+            limit = std::max(limit, box.getId() + 1);
+        }
+        return limit;
+    }
+}
+
+CompressedTraceWriter::CompressedTraceWriter(
+    const string& path,
+    int width,
+    int height,
+    const vector<BoxInfo>& boxes,
+    int blockSize)
+:   _file{path, ios::binary | ios::trunc},
+    _blockSize{blockSize},
+    _codec{getBoxIdLimit(boxes)}
+{
+    if (!_file)
+    {
+        throw invalid_argument("CompressedTraceWriter can not open " + path + ".");
+    }
+    if (_blockSize < 1)
+    {
+        throw invalid_argument("CompressedTraceWriter's blockSize must be at least 1.");
+    }
+
+    // Header. See TraceFormat.h.
+    _file.write(compressedTraceMagic, sizeof(compressedTraceMagic));
+    uint32_t version = compressedTraceVersion;
+    _file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    writeTraceInt(_file, width);
+    writeTraceInt(_file, height);
+    writeTraceInt(_file, static_cast<int32_t>(boxes.size()));
+    for (const BoxInfo& box : boxes)
+    {
+        writeTraceInt(_file, box.getId());
+        writeTraceInt(_file, box.getGroupId());
+        writeTraceInt(_file, box.getWidth());
+        writeTraceInt(_file, box.getHeight());
+    }
+    writeTraceInt(_file, getBoxIdLimit(boxes));
+    _byteCount = static_cast<long>(_file.tellp());
+
+    _pending.reserve(_blockSize);
+}
+
+CompressedTraceWriter::~CompressedTraceWriter() noexcept
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void CompressedTraceWriter::append(const SpotTransition& transition)
+{
+    if (_closed)
+    {
+        throw invalid_argument("Can not append to a closed CompressedTraceWriter.");
+    }
+    _pending.push_back(transition);
+    ++_recordCount;
+    if (static_cast<int>(_pending.size()) == _blockSize)
+    {
+        writeBlock();
+    }
+}
+
+void CompressedTraceWriter::close()
+{
+    if (_closed)
+    {
+        return;
+    }
+    _closed = true;
+
+    if (!_pending.empty())
+    {
+        writeBlock();
+    }
+
+    int64_t indexOffset = _byteCount;
+    writeTraceInt(_file, static_cast<int32_t>(_blocks.size()));
+    for (const BlockEntry& block : _blocks)
+    {
+        writeTraceLong(_file, block.offset);
+        writeTraceLong(_file, block.size);
+        writeTraceLong(_file, block.firstRecord);
+        writeTraceInt(_file, block.recordCount);
+        writeTraceLong(_file, block.smallestTimestamp);
+        writeTraceLong(_file, block.largestTimestamp);
+    }
+    writeTraceLong(_file, indexOffset);
+    _byteCount = static_cast<long>(_file.tellp());
+    _file.close();
+}
+
+long CompressedTraceWriter::getRecordCount() const
+{
+    return _recordCount;
+}
+
+long CompressedTraceWriter::getByteCount() const
+{
+    return _byteCount;
+}
+
+void CompressedTraceWriter::compress(const string& tracePath, const string& compressedPath, int blockSize)
+{
+    TraceReader reader{tracePath};
+    CompressedTraceWriter writer{compressedPath, reader.getWidth(), reader.getHeight(), reader.getBoxInfos(), blockSize};
+
+    vector<SpotTransition> records{};
+    long first = 0;
+    while (reader.readRecords(first, blockSize, records) > 0)
+    {
+        for (const SpotTransition& record : records)
+        {
+            writer.append(record);
+        }
+        first += static_cast<long>(records.size());
+    }
+    writer.close();
+}
+
+void CompressedTraceWriter::writeBlock()
+{
+    auto [smallest, largest] = minmax_element(
+        _pending.begin(),
+        _pending.end(),
+        [](const SpotTransition& a, const SpotTransition& b){ return a.timestamp < b.timestamp; });
+
+    BlockEntry block{};
+    block.offset = _byteCount;
+    block.firstRecord = _recordCount - static_cast<long>(_pending.size());
+    block.recordCount = static_cast<int32_t>(_pending.size());
+    block.smallestTimestamp = smallest->timestamp;
+    block.largestTimestamp = largest->timestamp;
+
+    _encoded.clear();
+    _codec.encode(_pending.data(), static_cast<int>(_pending.size()), _encoded);
+    _file.write(reinterpret_cast<const char*>(_encoded.data()), static_cast<streamsize>(_encoded.size()));
+
+    block.size = static_cast<int64_t>(_encoded.size());
+    _byteCount += static_cast<long>(_encoded.size());
+    _blocks.push_back(block);
+    _pending.clear();
+}
@@ -0,0 +1,88 @@
+#ifndef COMPRESSEDTRACEWRITER__H
+#define COMPRESSEDTRACEWRITER__H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "BoxInfo.h"
+#include "SpotTransition.h"
+#include "TraceBlockCodec.h"
+
+/*
+Writes SpotTransitions to a compressed trace file. See TraceFormat.h for the file layout and TraceBlockCodec for how each block is encoded.
+
+Records are collected into blocks of a fixed number of records. Each full block is encoded and appended to the file. The block index, which lets CompressedTraceReader decode only the blocks of a time range, is written by close().
+*/
+class CompressedTraceWriter
+{
+    public:
+
+    /*
+    Creates (or truncates) the file at @path and writes the header. Throws an invalid_argument exception if the file can not be opened, or if @blockSize is less than 1.
+
+    @boxes are the Boxes that were given to the Board. boxIds must not be negative.
+    */
+    CompressedTraceWriter(
+        const std::string& path,
+        int width,
+        int height,
+        const std::vector<BoxInfo>& boxes,
+        int blockSize = 65536);
+    CompressedTraceWriter() = delete;
+    CompressedTraceWriter(const CompressedTraceWriter& o) = delete;
+    CompressedTraceWriter(CompressedTraceWriter&& o) noexcept = delete;
+    CompressedTraceWriter& operator=(const CompressedTraceWriter& o) = delete;
+    CompressedTraceWriter& operator=(CompressedTraceWriter&& o) noexcept = delete;
+
+    /*
+    Calls close() if it has not been called.
+    */
+    ~CompressedTraceWriter() noexcept;
+
+    void append(const SpotTransition& transition);
+
+    /*
+    Writes the last, partly filled block and the block index, then closes the file. Nothing can be appended afterwards.
+    */
+    void close();
+
+    long getRecordCount() const;
+
+    /*
+    Returns the number of bytes written to the file so far.
+    */
+    long getByteCount() const;
+
+    /*
+    Writes the trace at @tracePath (written by TraceRecorder) to a compressed trace at @compressedPath.
+    */
+    static void compress(const std::string& tracePath, const std::string& compressedPath, int blockSize = 65536);
+
+
+    private:
+
+    struct BlockEntry
+    {
+        int64_t offset;
+        int64_t size;
+        int64_t firstRecord;
+        int32_t recordCount;
+        int64_t smallestTimestamp;
+        int64_t largestTimestamp;
+    };
+
+    std::ofstream _file;
+    const int _blockSize;
+    TraceBlockCodec _codec;
+    std::vector<SpotTransition> _pending{};
+    std::vector<uint8_t> _encoded{};
+    std::vector<BlockEntry> _blocks{};
+    long _recordCount = 0;
+    long _byteCount = 0;
+    bool _closed = false;
+
+    void writeBlock();
+};
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef DECIDER__H
 #define DECIDER__H
 
-#include <vector>
-#include "Board.h"
+#include <optional>
+#include <span>
+#include <utility>
+#include "BoardView.h"
+#include "DeciderType.h"
 
 /*
 Returns a decision on whether a Box should move to Position, or chooses which is the best Position to move to.
@@ -17,14 +20,24 @@ class Decider
     /*
     Returns a decistion on whether the user should move to @position, given @position and @board.
     */
-    virtual bool suggestMoveTo(Position position, const Board& board) = 0;
+    virtual bool suggestMoveTo(Position position, const BoardView& board) = 0;
 
     /*
     Retuns the suggested Position to move to given @possiblePositions and @board. Also returns the number of millisecondsto wait before moving to the returned Position.
+
+    @possiblePositions is a span, so it can be a std::vector or a FuturePositions. A Board can be passed as @board, and is read with its locks.
     */
     virtual std::pair<Position, int> getNext(
-        const std::vector<Position> possiblePositions,
-        const Board& board) = 0;
+        std::span<const Position> possiblePositions,
+        const BoardView& board) = 0;
+
+    /*
+    Returns the DeciderType whose rules this Decider follows, so that an engine stepping many Boxes can follow them itself, without calling each Box's Decider. Returns nothing if the Decider has rules of its own.
+    */
+    virtual std::optional<DeciderType> getType() const
+    {
+        return std::nullopt;
+    }
 
 };
 
@@ -5,16 +5,33 @@
 
 using namespace std;
 
-bool Decider_Risk1::suggestMoveTo(Position position, const Board& board)
+bool Decider_Risk1::suggestMoveTo(Position position, const BoardView& board)
+{
+    return allowsMoveTo(position, board);
+}
+
+pair<Position, int> Decider_Risk1::getNext(
+    span<const Position> possiblePositions,
+    const BoardView& board)
+{
+    return chooseNext(possiblePositions, board);
+}
+
+optional<DeciderType> Decider_Risk1::getType() const
+{
+    return DeciderType::risk1;
+}
+
+bool Decider_Risk1::allowsMoveTo(Position position, const BoardView& board)
 {
     BoardNote note = board.getNoteAt(position);
     return ((note.getType() == MoveType::left) ||
            (note.getType() == MoveType::to_leave));
 }
 
-pair<Position, int> Decider_Risk1::getNext(
-    const vector<Position> possiblePositions,
-    const Board& board
+pair<Position, int> Decider_Risk1::chooseNext(
+    span<const Position> possiblePositions,
+    const BoardView& board
     )
 {
     // Take each position in possiblePositions
@@ -17,15 +17,26 @@ class Decider_Risk1 : public Decider
     /*
     Returns true if @position contains a MoveType of MoveType::to_leave or MoveType::left
     */
-    bool suggestMoveTo(Position position, const Board& board) override;
+    bool suggestMoveTo(Position position, const BoardView& board) override;
 
    
     /*
     Returns the first Position that contiains a MoveType::to_leave or MoveType::left. If the Position contains MoveType::to_leave, then a time-to-arrival of 7 is returned. If the Position contains MoveType::left, then a time-to-arrival of 0 is returned.
     */
     std::pair<Position, int> getNext(
-        const std::vector<Position> possiblePositions,
-        const Board& board) override;
+        std::span<const Position> possiblePositions,
+        const BoardView& board) override;
+
+    /*
+    Returns DeciderType::risk1.
+    */
+    std::optional<DeciderType> getType() const override;
+
+    /*
+    The rules of suggestMoveTo() and getNext(), for a caller that follows them without a Decider_Risk1.
+    */
+    static bool allowsMoveTo(Position position, const BoardView& board);
+    static std::pair<Position, int> chooseNext(std::span<const Position> possiblePositions, const BoardView& board);
 };
 
 #endif
@@ -5,14 +5,31 @@
 
 using namespace std;
 
-bool Decider_Safe::suggestMoveTo(Position position, const Board& board)
+bool Decider_Safe::suggestMoveTo(Position position, const BoardView& board)
 {
-    return board.getNoteAt(position).getType() == MoveType::left;
+    return allowsMoveTo(position, board);
 }
 
 pair<Position, int> Decider_Safe::getNext(
-    const vector<Position> possiblePositions,
-    const Board& board)
+    span<const Position> possiblePositions,
+    const BoardView& board)
+{
+    return chooseNext(possiblePositions, board);
+}
+
+optional<DeciderType> Decider_Safe::getType() const
+{
+    return DeciderType::safe;
+}
+
+bool Decider_Safe::allowsMoveTo(Position position, const BoardView& board)
+{
+    return board.getNoteAt(position).getType() == MoveType::left;
+}
+
+pair<Position, int> Decider_Safe::chooseNext(
+    span<const Position> possiblePositions,
+    const BoardView& board)
 {
     for (const Position& position : possiblePositions)
     {
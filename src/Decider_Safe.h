@@ -13,14 +13,25 @@ class Decider_Safe : public Decider
     /*
     Only returns true, signalling it is okay to move to @position if @position is empty on Board. Returns true if Spot at @position has a MoveType of MoveType::left. Otherwise returns false.
     */
-    bool suggestMoveTo(Position position, const Board& board) override;
+    bool suggestMoveTo(Position position, const BoardView& board) override;
 
     /*
     Will return the first Position in @possiblePositions that has a MoveType of MoveType::left. Along with the Position will return a time to wait of zero. If no Position has a MoveType of MoveType::left, then returns a Position of {-1, -1} and a time of -1.
     */
     std::pair<Position, int> getNext(
-        const std::vector<Position> possiblePositions,
-        const Board& board) override;
+        std::span<const Position> possiblePositions,
+        const BoardView& board) override;
+
+    /*
+    Returns DeciderType::safe.
+    */
+    std::optional<DeciderType> getType() const override;
+
+    /*
+    The rules of suggestMoveTo() and getNext(), for a caller that follows them without a Decider_Safe.
+    */
+    static bool allowsMoveTo(Position position, const BoardView& board);
+    static std::pair<Position, int> chooseNext(std::span<const Position> possiblePositions, const BoardView& board);
 };
 
 
@@ -0,0 +1,176 @@
+#include "DoorwayFlow.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    void dropBefore(deque<DoorwayFlow::Clock::time_point>& times, DoorwayFlow::Clock::time_point oldest)
+    {
+        while (!times.empty() && times.front() < oldest)
+        {
+            times.pop_front();
+        }
+    }
+
+    size_t countSince(const deque<DoorwayFlow::Clock::time_point>& times, DoorwayFlow::Clock::time_point oldest)
+    {
+        return static_cast<size_t>(times.end() - lower_bound(times.begin(), times.end(), oldest));
+    }
+}
+
+DoorwayFlow::DoorwayFlow(chrono::milliseconds window)
+:   _window{window},
+    _start{Clock::now()}
+{
+    if (window <= chrono::milliseconds{0})
+    {
+        throw invalid_argument("DoorwayFlow needs a positive window, not " + to_string(window.count()) + " ms.");
+    }
+}
+
+void DoorwayFlow::setDoorways(const vector<Rectangle>& doorways)
+{
+    _doorways.clear();
+    for (const Rectangle& rectangle : doorways)
+    {
+        _doorways.push_back(make_unique<Doorway>(rectangle));
+    }
+    _start = Clock::now();
+}
+
+int DoorwayFlow::getDoorway(Position position) const
+{
+    for (size_t ii=0; ii<_doorways.size(); ++ii)
+    {
+        if (_doorways[ii]->rectangle.isInside(position))
+        {
+            return static_cast<int>(ii);
+        }
+    }
+    return -1;
+}
+
+void DoorwayFlow::recordEntry(Position position, Clock::time_point now)
+{
+    record(position, now, true);
+}
+
+void DoorwayFlow::recordExit(Position position, Clock::time_point now)
+{
+    record(position, now, false);
+}
+
+void DoorwayFlow::startWaiting(Position position)
+{
+    int index = getDoorway(position);
+    if (index < 0)
+    {
+        return;
+    }
+    Doorway& doorway = *_doorways[index];
+    int waiting = doorway.waiting.fetch_add(1, memory_order_relaxed) + 1;
+    int maxWaiting = doorway.maxWaiting.load(memory_order_relaxed);
+    while (waiting > maxWaiting && !doorway.maxWaiting.compare_exchange_weak(maxWaiting, waiting, memory_order_relaxed))
+    {}
+}
+
+void DoorwayFlow::stopWaiting(Position position)
+{
+    int index = getDoorway(position);
+    if (index >= 0)
+    {
+        _doorways[index]->waiting.fetch_sub(1, memory_order_relaxed);
+    }
+}
+
+vector<DoorwayFlow::Rates> DoorwayFlow::getRates(Clock::time_point now) const
+{
+    // Before a whole window has passed, rates are over the time since _start.
+    Clock::duration window = min(_window, max(now - _start, Clock::duration{1}));
+    double seconds = chrono::duration<double>(window).count();
+    Clock::time_point oldest = now - window;
+
+    vector<Rates> rates{};
+    for (const auto& doorway : _doorways)
+    {
+        lock_guard<mutex> lock(doorway->mux);
+        rates.push_back(Rates{
+            doorway->rectangle,
+            doorway->entries,
+            doorway->exits,
+            static_cast<double>(countSince(doorway->entryTimes, oldest)) / seconds,
+            static_cast<double>(countSince(doorway->exitTimes, oldest)) / seconds,
+            doorway->waiting.load(memory_order_relaxed),
+            doorway->maxWaiting.load(memory_order_relaxed)});
+    }
+    return rates;
+}
+
+vector<string> DoorwayFlow::getSummaryLines(const vector<Rates>& rates)
+{
+    auto format = [](double value){
+        ostringstream text{};
+        text << fixed << setprecision(1) << value;
+        return text.str();
+    };
+
+    vector<string> lines{};
+    for (size_t ii=0; ii<rates.size(); ++ii)
+    {
+        const Rates& r = rates[ii];
+        lines.push_back("door " + to_string(ii) +
+            " in/s " + format(r.entriesPerSecond) +
+            ", out/s " + format(r.exitsPerSecond) +
+            ", waiting " + to_string(r.waiting) + " (max " + to_string(r.maxWaiting) + ")");
+    }
+    return lines;
+}
+
+void DoorwayFlow::writeCsvHeader(ostream& out)
+{
+    out << "doorway,top_left_x,top_left_y,bottom_right_x,bottom_right_y,entries,exits,entries_per_s,exits_per_s,waiting,max_waiting\n";
+}
+
+void DoorwayFlow::writeCsvRows(ostream& out, const vector<Rates>& rates)
+{
+    for (size_t ii=0; ii<rates.size(); ++ii)
+    {
+        const Rates& r = rates[ii];
+        Position topLeft = r.rectangle.getTopLeft();
+        Position bottomRight = r.rectangle.getBottomRight();
+        out << ii << ","
+            << topLeft.getX() << "," << topLeft.getY() << ","
+            << bottomRight.getX() << "," << bottomRight.getY() << ","
+            << r.entries << "," << r.exits << ","
+            << r.entriesPerSecond << "," << r.exitsPerSecond << ","
+            << r.waiting << "," << r.maxWaiting << "\n";
+    }
+}
+
+void DoorwayFlow::record(Position position, Clock::time_point now, bool entry)
+{
+    int index = getDoorway(position);
+    if (index < 0)
+    {
+        return;
+    }
+    Doorway& doorway = *_doorways[index];
+    lock_guard<mutex> lock(doorway.mux);
+    deque<Clock::time_point>& times = entry ? doorway.entryTimes : doorway.exitTimes;
+    // Times from different threads can arrive slightly out of order. Keep them sorted for countSince().
+    times.insert(upper_bound(times.begin(), times.end(), now), now);
+    dropBefore(times, now - _window);
+    if (entry)
+    {
+        ++doorway.entries;
+    }
+    else
+    {
+        ++doorway.exits;
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef DOORWAYFLOW__H
+#define DOORWAYFLOW__H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Position.h"
+#include "Rectangle.h"
+
+/*
+Measures the flow through each doorway, the in-bound and out-bound Rectangles Boxes enter and leave the Board through. Board owns one, with no doorways until setDoorways() is called.
+
+For each doorway it counts the Boxes that entered (Mover::addBox() succeeded) and exited (Mover::removeBox()), their rates over a sliding window, and the queue: how many Boxes are waiting to enter through it right now, and the longest that queue has been. A doorway whose queue keeps growing while its entry rate stays flat is saturated.
+
+A Position belongs to the first doorway that it is inside of. Positions outside of every doorway are not counted.
+
+Entries and exits are a few hundred per second at most, so each doorway keeps the times of the entries and exits in its window under its own lock. The queue is an atomic counter.
+*/
+class DoorwayFlow
+{
+    public:
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Rates
+    {
+        Rectangle rectangle;
+        uint64_t entries;
+        uint64_t exits;
+        double entriesPerSecond;
+        double exitsPerSecond;
+        int waiting;
+        int maxWaiting;
+    };
+
+    /*
+    Rates are measured over the last @window. Throws an invalid_argument exception if @window is not positive.
+    */
+    explicit DoorwayFlow(std::chrono::milliseconds window = std::chrono::seconds{10});
+    DoorwayFlow(const DoorwayFlow& o) = delete;
+    DoorwayFlow(DoorwayFlow&& o) noexcept = delete;
+    DoorwayFlow& operator=(const DoorwayFlow& o) = delete;
+    DoorwayFlow& operator=(DoorwayFlow&& o) noexcept = delete;
+    ~DoorwayFlow() noexcept = default;
+
+    /*
+    Replaces the doorways and their counts with @doorways. Not thread safe: call it before the Boxes start moving.
+    */
+    void setDoorways(const std::vector<Rectangle>& doorways);
+
+    /*
+    Returns the index of the doorway @position is inside of, or -1.
+    */
+    int getDoorway(Position position) const;
+
+    void recordEntry(Position position, Clock::time_point now = Clock::now());
+    void recordExit(Position position, Clock::time_point now = Clock::now());
+
+    /*
+    A Box starts or stops waiting to enter at @position. Every startWaiting() must be followed by one stopWaiting() with the same @position.
+    */
+    void startWaiting(Position position);
+    void stopWaiting(Position position);
+
+    /*
+    Returns the Rates of every doorway, in the order of setDoorways(). Until a whole window has passed since setDoorways(), rates are over the time since then.
+    */
+    std::vector<Rates> getRates(Clock::time_point now = Clock::now()) const;
+
+    /*
+    Returns a line of text per doorway, for MetricsHud.
+    */
+    static std::vector<std::string> getSummaryLines(const std::vector<Rates>& rates);
+
+    /*
+    Writes one CSV row per doorway. The doorway column is its index.
+    */
+    static void writeCsvHeader(std::ostream& out);
+    static void writeCsvRows(std::ostream& out, const std::vector<Rates>& rates);
+
+
+    private:
+
+    struct Doorway
+    {
+        explicit Doorway(const Rectangle& r)
+        :   rectangle{r}
+        {}
+
+        const Rectangle rectangle;
+        mutable std::mutex mux;
+        std::deque<Clock::time_point> entryTimes{};
+        std::deque<Clock::time_point> exitTimes{};
+        uint64_t entries = 0;
+        uint64_t exits = 0;
+        std::atomic<int> waiting{0};
+        std::atomic<int> maxWaiting{0};
+    };
+
+    const Clock::duration _window;
+    Clock::time_point _start;
+    std::vector<std::unique_ptr<Doorway>> _doorways{};
+
+    void record(Position position, Clock::time_point now, bool entry);
+};
+
+#endif
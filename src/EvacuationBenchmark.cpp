@@ -0,0 +1,241 @@
+#include "EvacuationBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include "Board.h"
+#include "MainSetup.h"
+#include "Threader.h"
+#include "Util.h"
+#include "VirtualTimeRunner.h"
+
+using namespace std;
+
+namespace
+{
+    /*
+    Returns the value at @fraction through the sorted @values.
+    */
+    double getPercentile(const vector<double>& values, double fraction)
+    {
+        size_t index = static_cast<size_t>(ceil(fraction * static_cast<double>(values.size())));
+        return values[min(values.size() - 1, (index == 0) ? 0 : index - 1)];
+    }
+}
+
+EvacuationBenchmark::Result EvacuationBenchmark::run(const Scenario& scenario, uint32_t seed)
+{
+    auto wallStart = chrono::steady_clock::now();
+    Util::setSeed(seed);
+
+    vector<Rectangle> rectangles = MainSetup::getInOutBoundRectangles(scenario.width, scenario.height);
+    if (scenario.batchCount < 1 || scenario.batchCount > static_cast<int>(rectangles.size()))
+    {
+        throw invalid_argument("An EvacuationBenchmark needs between 1 and " + to_string(rectangles.size()) + " batches.");
+    }
+
+    int boxCount = scenario.boxesPerBatch * scenario.batchCount;
+    vector<Box> boxes{};
+    for (int batch=0; batch<scenario.batchCount; ++batch)
+    {
+        MainSetup::addAGroupOfBoxes(boxes, batch * scenario.boxesPerBatch, batch % 4, scenario.boxesPerBatch);
+    }
+    Board board{scenario.width, scenario.height, std::move(boxes), scenario.layout};
+
+    Threader threader{};
+    VirtualTimeRunner runner{
+        board,
+        threader.planBatches(scenario.boxesPerBatch, scenario.batchCount, rectangles, scenario.width, scenario.height)};
+    double clearanceMs = static_cast<double>(runner.run(scenario.limitMs));
+
+    Result result{};
+    result.seed = seed;
+    result.boxCount = boxCount;
+    result.exitedCount = runner.getExitedCount();
+    result.metrics.push_back(Metric{"clearance_ms", clearanceMs, false});
+
+    // Time to exit per batch, counted from when the Box was added to the Board.
+    vector<vector<double>> timesPerBatch(scenario.batchCount);
+    vector<int> exitsPerRectangle(rectangles.size(), 0);
+    for (int ii=0; ii<runner.getBoxCount(); ++ii)
+    {
+        if (runner.getExitTime(ii) == -1)
+        {
+            continue;
+        }
+        const BoxPlan& plan = runner.getPlan(ii);
+        timesPerBatch[plan.batch].push_back(static_cast<double>(runner.getExitTime(ii) - runner.getEntryTime(ii)));
+        for (size_t rr=0; rr<rectangles.size(); ++rr)
+        {
+            if (rectangles[rr] == plan.exit)
+            {
+                ++exitsPerRectangle[rr];
+            }
+        }
+    }
+
+    for (int batch=0; batch<scenario.batchCount; ++batch)
+    {
+        vector<double>& times = timesPerBatch[batch];
+        sort(times.begin(), times.end());
+        double mean = 0.0;
+        for (double time : times)
+        {
+            mean += time / static_cast<double>(times.size());
+        }
+        string prefix = "batch" + to_string(batch);
+        result.metrics.push_back(Metric{prefix + "_mean_ms", mean, false});
+        result.metrics.push_back(Metric{prefix + "_p90_ms", times.empty() ? 0.0 : getPercentile(times, 0.9), false});
+    }
+
+    for (size_t rr=0; rr<rectangles.size(); ++rr)
+    {
+        double perSecond = (clearanceMs > 0) ? exitsPerRectangle[rr] / (clearanceMs / 1000.0) : 0.0;
+        result.metrics.push_back(Metric{"exit" + to_string(rr) + "_boxes_per_s", perSecond, true});
+    }
+
+    result.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+    result.events = runner.getEventCount();
+    return result;
+}
+
+vector<EvacuationBenchmark::Baseline> EvacuationBenchmark::summarize(const vector<Result>& results)
+{
+    vector<Baseline> baselines{};
+    if (results.empty())
+    {
+        return baselines;
+    }
+
+    for (size_t mm=0; mm<results[0].metrics.size(); ++mm)
+    {
+        const Metric& first = results[0].metrics[mm];
+        double mean = 0.0;
+        for (const Result& result : results)
+        {
+            if (result.metrics.size() != results[0].metrics.size() || result.metrics[mm].name != first.name)
+            {
+                throw invalid_argument("EvacuationBenchmark can only summarize Results with the same Metrics.");
+            }
+            mean += result.metrics[mm].value;
+        }
+        int samples = static_cast<int>(results.size());
+        mean /= samples;
+
+        double squares = 0.0;
+        for (const Result& result : results)
+        {
+            double difference = result.metrics[mm].value - mean;
+            squares += difference * difference;
+        }
+        double stddev = (samples > 1) ? sqrt(squares / (samples - 1)) : 0.0;
+        baselines.push_back(Baseline{first.name, mean, stddev, samples, first.higherIsBetter});
+    }
+    return baselines;
+}
+
+vector<EvacuationBenchmark::Regression> EvacuationBenchmark::compare(
+    const vector<Baseline>& baseline,
+    const vector<Baseline>& current,
+    double minWorsening)
+{
+    map<string, const Baseline*> baselinePerName{};
+    for (const Baseline& b : baseline)
+    {
+        baselinePerName[b.name] = &b;
+    }
+
+    vector<Regression> regressions{};
+    for (const Baseline& now : current)
+    {
+        auto found = baselinePerName.find(now.name);
+        if (found == baselinePerName.end())
+        {
+            continue;
+        }
+        const Baseline& before = *found->second;
+
+        // Positive when worse, whichever direction is better.
+        double difference = before.higherIsBetter ? (before.mean - now.mean) : (now.mean - before.mean);
+        double worsening = (before.mean != 0.0) ? difference / fabs(before.mean) : ((difference > 0) ? 1.0 : 0.0);
+        if (worsening <= minWorsening)
+        {
+            continue;
+        }
+
+        double varianceBefore = before.stddev * before.stddev / before.samples;
+        double varianceNow = now.stddev * now.stddev / now.samples;
+        double standardError = sqrt(varianceBefore + varianceNow);
+        if (standardError == 0.0)
+        {
+            regressions.push_back(Regression{now.name, before.mean, now.mean, worsening, INFINITY});
+            continue;
+        }
+
+        double t = difference / standardError;
+        // Welch-Satterthwaite degrees of freedom. A side with one sample adds no variance estimate.
+        double denominator =
+            ((before.samples > 1) ? varianceBefore * varianceBefore / (before.samples - 1) : 0.0) +
+            ((now.samples > 1) ? varianceNow * varianceNow / (now.samples - 1) : 0.0);
+        double degreesOfFreedom = (denominator > 0) ? pow(varianceBefore + varianceNow, 2) / denominator : 1.0;
+        if (t > getCriticalT(degreesOfFreedom))
+        {
+            regressions.push_back(Regression{now.name, before.mean, now.mean, worsening, t});
+        }
+    }
+    return regressions;
+}
+
+void EvacuationBenchmark::writeBaselines(ostream& out, const vector<Baseline>& baselines)
+{
+    out << "# name mean stddev samples higher|lower\n";
+    for (const Baseline& b : baselines)
+    {
+        out << b.name << " " << b.mean << " " << b.stddev << " " << b.samples << " "
+            << (b.higherIsBetter ? "higher" : "lower") << "\n";
+    }
+}
+
+vector<EvacuationBenchmark::Baseline> EvacuationBenchmark::readBaselines(istream& in)
+{
+    vector<Baseline> baselines{};
+    string line{};
+    while (getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        stringstream fields{line};
+        Baseline b{};
+        string direction{};
+        if (!(fields >> b.name >> b.mean >> b.stddev >> b.samples >> direction) ||
+            (direction != "higher" && direction != "lower") ||
+            b.samples < 1)
+        {
+            throw invalid_argument("Can not read the baseline line: " + line);
+        }
+        b.higherIsBetter = (direction == "higher");
+        baselines.push_back(b);
+    }
+    return baselines;
+}
+
+double EvacuationBenchmark::getCriticalT(double degreesOfFreedom)
+{
+    // One-sided 1% critical values for 1 to 30 degrees of freedom. Beyond that, the normal distribution's.
+    static const double table[30] = {
+        31.821, 6.965, 4.541, 3.747, 3.365, 3.143, 2.998, 2.896, 2.821, 2.764,
+        2.718, 2.681, 2.650, 2.624, 2.602, 2.583, 2.567, 2.552, 2.539, 2.528,
+        2.518, 2.508, 2.500, 2.492, 2.485, 2.479, 2.473, 2.467, 2.462, 2.457};
+    if (degreesOfFreedom > 30)
+    {
+        return 2.326;
+    }
+    // Rounding down keeps the test on the cautious side.
+    int index = max(1, static_cast<int>(floor(degreesOfFreedom)));
+    return table[index - 1];
+}
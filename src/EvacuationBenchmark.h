@@ -0,0 +1,111 @@
+#ifndef EVACUATIONBENCHMARK__H
+#define EVACUATIONBENCHMARK__H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "GridLayout.h"
+
+/*
+Measures how long the standard layout takes to clear: every Box that Threader would create, from the MainSetup in-out-bound Rectangles, has to reach its exit. The run is done in virtual time with VirtualTimeRunner, so it does not take the minutes the application would, and a given seed always gives the same result.
+
+Each run is summarised as metrics: the clearance time, the mean and 90th percentile time to exit per batch (a batch shares its start, PositionManagerType, and DeciderType), and the Boxes per second that leave through each exit. Metrics from several seeds are summarised as Baselines, and compare() flags every metric that got worse by a statistically significant amount.
+*/
+class EvacuationBenchmark
+{
+    public:
+
+    struct Scenario
+    {
+        int width = 600;
+        int height = 600;
+        int boxesPerBatch = 200;
+        int batchCount = 7;
+        // Boxes that have not exited after this much virtual time are counted as not clearing.
+        long limitMs = 30 * 60 * 1000;
+        // The order the Board stores its Spots in.
+        GridLayout layout = GridLayout::rowMajor;
+    };
+
+    struct Metric
+    {
+        std::string name;
+        double value;
+        bool higherIsBetter;
+    };
+
+    struct Result
+    {
+        uint32_t seed;
+        int boxCount;
+        int exitedCount;
+        std::vector<Metric> metrics;
+        // How long the run took for real, and how many steps it took.
+        double wallSeconds;
+        long events;
+    };
+
+    /*
+    The mean, standard deviation, and number of samples of one Metric over several runs.
+    */
+    struct Baseline
+    {
+        std::string name;
+        double mean;
+        double stddev;
+        int samples;
+        bool higherIsBetter;
+    };
+
+    struct Regression
+    {
+        std::string name;
+        double baselineMean;
+        double currentMean;
+        // Relative change, positive when the Metric got worse.
+        double worsening;
+        double t;
+    };
+
+    EvacuationBenchmark() = delete;
+
+    /*
+    Runs @scenario with Util seeded with @seed.
+    */
+    static Result run(const Scenario& scenario, uint32_t seed);
+
+    /*
+    Summarises the Metrics of @results by name. Every Result must have the same Metrics.
+    */
+    static std::vector<Baseline> summarize(const std::vector<Result>& results);
+
+    /*
+    Returns the Metrics in @current that are worse than in @baseline by more than @minWorsening (a fraction of the baseline mean) and by a one-sided Welch t-test at the 1% level. When neither side varies the t-test can not be used, and the change alone decides. Metrics missing from either side are skipped.
+    */
+    static std::vector<Regression> compare(
+        const std::vector<Baseline>& baseline,
+        const std::vector<Baseline>& current,
+        double minWorsening);
+
+    /*
+    Baselines are stored one per line as: name mean stddev samples higher|lower. Lines starting with # are comments.
+    */
+    static void writeBaselines(std::ostream& out, const std::vector<Baseline>& baselines);
+
+    /*
+    Throws an invalid_argument exception if a line can not be read.
+    */
+    static std::vector<Baseline> readBaselines(std::istream& in);
+
+
+    private:
+
+    /*
+    Returns the one-sided 1% critical value of Student's t distribution with @degreesOfFreedom.
+    */
+    static double getCriticalT(double degreesOfFreedom);
+};
+
+#endif
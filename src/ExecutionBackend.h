@@ -0,0 +1,9 @@
+#ifndef EXECUTIONBACKEND__H
+#define EXECUTIONBACKEND__H
+
+/*
+How the Boxes of a run are driven. threads gives every Box its own thread (see Threader), as the application does. lockstep moves all the Boxes in ticks, on a fixed number of worker threads (see LockstepEngine).
+*/
+enum class ExecutionBackend{threads=1, lockstep=2};
+
+#endif
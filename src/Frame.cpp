@@ -0,0 +1,96 @@
+#include "Frame.h"
+
+#include <unordered_map>
+#include "Position.h"
+
+using namespace std;
+
+namespace
+{
+    shared_ptr<const unordered_map<int, int>> indexBoxInfos(const vector<BoxInfo>& boxInfos)
+    {
+        auto boxIndexPerId = make_shared<unordered_map<int, int>>();
+        for (int ii=0; ii<static_cast<int>(boxInfos.size()); ++ii)
+        {
+            boxIndexPerId->insert({boxInfos[ii].getId(), ii});
+        }
+        return boxIndexPerId;
+    }
+}
+
+Frame::Frame(
+    long sequence,
+    vector<Drop>&& changedDrops,
+    vector<BoxInfo>&& boxInfos,
+    shared_ptr<const unordered_map<int, int>> boxIndexPerId)
+:   _sequence{sequence},
+    _changedDrops{std::move(changedDrops)},
+    _boxInfos{std::move(boxInfos)},
+    _boxIndexPerId{std::move(boxIndexPerId)}
+{}
+
+Frame::Frame(
+    long sequence,
+    vector<Drop>&& changedDrops,
+    vector<BoxInfo>&& boxInfos)
+:   _sequence{sequence},
+    _changedDrops{std::move(changedDrops)},
+    _boxInfos{std::move(boxInfos)},
+    _boxIndexPerId{indexBoxInfos(_boxInfos)}
+{}
+
+long Frame::getSequence() const
+{
+    return _sequence;
+}
+
+const vector<Drop>& Frame::getChangedDrops() const
+{
+    return _changedDrops;
+}
+
+const vector<BoxInfo>& Frame::getBoxInfos() const
+{
+    return _boxInfos;
+}
+
+const BoxInfo& Frame::getBoxInfo(int boxId) const
+{
+    return _boxInfos[_boxIndexPerId->at(boxId)];
+}
+
+bool Frame::hasBox(int boxId) const
+{
+    return _boxIndexPerId->find(boxId) != _boxIndexPerId->end();
+}
+
+const shared_ptr<const unordered_map<int, int>>& Frame::getBoxIndexPerId() const
+{
+    return _boxIndexPerId;
+}
+
+shared_ptr<const Frame> Frame::coalesce(const Frame& older, const Frame& newer)
+{
+    // Start with @newer's Drops, then add the Drops of @older whose Positions @newer did not change.
+    vector<Drop> changedDrops(newer._changedDrops.begin(), newer._changedDrops.end());
+
+    unordered_map<Position, int> newerIndexPerPosition{};
+    for (int ii=0; ii<static_cast<int>(changedDrops.size()); ++ii)
+    {
+        newerIndexPerPosition.insert({changedDrops[ii].getPosition(), ii});
+    }
+
+    for (const Drop& drop : older._changedDrops)
+    {
+        if (newerIndexPerPosition.find(drop.getPosition()) == newerIndexPerPosition.end())
+        {
+            changedDrops.push_back(drop);
+        }
+    }
+
+    return make_shared<const Frame>(
+        newer._sequence,
+        std::move(changedDrops),
+        vector<BoxInfo>(newer._boxInfos.begin(), newer._boxInfos.end()),
+        newer._boxIndexPerId);
+}
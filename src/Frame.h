@@ -0,0 +1,85 @@
+#ifndef FRAME__H
+#define FRAME__H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "BoxInfo.h"
+#include "Drop.h"
+
+/*
+One broadcast from the Board. A Frame contains 1) the Drops that changed since the previous Frame and 2) the state of every Box at the time of the broadcast.
+
+A Frame is immutable once it is constructed. Board creates one Frame per call to sendStateAndChanges() and hands the same shared Frame to every BoardListener, so adding a BoardListener does not add a copy of the changes or of the Boxes.
+*/
+class Frame
+{
+    public:
+
+    /*
+    @sequence is the Frame's number. Board numbers its Frames 0, 1, 2, ... in the order they are sent.
+    @changedDrops are the Drops that changed since the previous Frame, one Drop per Position.
+    @boxInfos are the states of all the Boxes.
+    @boxIndexPerId maps a boxId to the index of its BoxInfo in @boxInfos. Board shares the same map between all its Frames.
+    */
+    Frame(
+        long sequence,
+        std::vector<Drop>&& changedDrops,
+        std::vector<BoxInfo>&& boxInfos,
+        std::shared_ptr<const std::unordered_map<int, int>> boxIndexPerId);
+
+    /*
+    Same as above, but builds the boxIndexPerId map from @boxInfos.
+    */
+    Frame(
+        long sequence,
+        std::vector<Drop>&& changedDrops,
+        std::vector<BoxInfo>&& boxInfos);
+
+    Frame() = delete;
+    Frame(const Frame& o) = delete;
+    Frame(Frame&& o) noexcept = delete;
+    Frame& operator=(const Frame& o) = delete;
+    Frame& operator=(Frame&& o) noexcept = delete;
+    ~Frame() noexcept = default;
+
+    long getSequence() const;
+
+    /*
+    Returns the Drops that changed since the previous Frame. A Drop with MoveType::left means its Position no longer contains a Box.
+    */
+    const std::vector<Drop>& getChangedDrops() const;
+
+    /*
+    Returns the states of all the Boxes, even Boxes that have not entered the Board yet or have been removed because they reached their final destination.
+    */
+    const std::vector<BoxInfo>& getBoxInfos() const;
+
+    /*
+    Returns the BoxInfo of the Box with id @boxId. Throws an out_of_range exception if there is no such Box.
+    */
+    const BoxInfo& getBoxInfo(int boxId) const;
+
+    bool hasBox(int boxId) const;
+
+    /*
+    Returns one Frame that has the same effect as receiving @older and then @newer. Its changed Drops are the union of both Frames' changed Drops, and where both Frames changed the same Position the Drop from @newer is used. Its BoxInfos and sequence number are taken from @newer.
+    */
+    static std::shared_ptr<const Frame> coalesce(const Frame& older, const Frame& newer);
+
+    /*
+    Returns the map of boxId to index in getBoxInfos().
+    */
+    const std::shared_ptr<const std::unordered_map<int, int>>& getBoxIndexPerId() const;
+
+
+    private:
+
+    const long _sequence;
+    const std::vector<Drop> _changedDrops;
+    const std::vector<BoxInfo> _boxInfos;
+    const std::shared_ptr<const std::unordered_map<int, int>> _boxIndexPerId;
+
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "FrameStreamClient.h"
+
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "StreamSocket.h"
+
+using namespace std;
+
+FrameStreamClient::FrameStreamClient(const string& address)
+:   _fd{StreamSocket::connectTo(address)}
+{}
+
+FrameStreamClient::~FrameStreamClient() noexcept
+{
+    close(_fd);
+}
+
+bool FrameStreamClient::receive(chrono::milliseconds timeout)
+{
+    auto deadline = chrono::steady_clock::now() + timeout;
+    uint8_t chunk[65536];
+
+    while (!applyBuffered())
+    {
+        auto left = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now());
+        if (left.count() < 0)
+        {
+            return false;
+        }
+        pollfd fd{_fd, POLLIN, 0};
+        if (poll(&fd, 1, static_cast<int>(left.count())) <= 0)
+        {
+            continue;
+        }
+        ssize_t received = recv(_fd, chunk, sizeof(chunk), 0);
+        if (received <= 0)
+        {
+            throw runtime_error("The FrameStreamServer closed the connection.");
+        }
+        _buffer.insert(_buffer.end(), chunk, chunk + received);
+    }
+    return true;
+}
+
+const FrameStreamState& FrameStreamClient::getState() const
+{
+    return _state;
+}
+
+long FrameStreamClient::getKeyframeCount() const
+{
+    return _keyframes;
+}
+
+long FrameStreamClient::getMessageCount() const
+{
+    return _messages;
+}
+
+bool FrameStreamClient::applyBuffered()
+{
+    const size_t prefix = FrameStreamState::lengthPrefixSize;
+    if (_buffer.size() < prefix)
+    {
+        return false;
+    }
+    size_t length =
+        static_cast<size_t>(_buffer[0]) |
+        (static_cast<size_t>(_buffer[1]) << 8) |
+        (static_cast<size_t>(_buffer[2]) << 16) |
+        (static_cast<size_t>(_buffer[3]) << 24);
+    if (_buffer.size() < prefix + length)
+    {
+        return false;
+    }
+
+    _state.applyMessage(_buffer.data() + prefix, length);
+    if (length > 0 && _buffer[prefix] == FrameStreamState::keyframeKind)
+    {
+        ++_keyframes;
+    }
+    ++_messages;
+    _buffer.erase(_buffer.begin(), _buffer.begin() + prefix + length);
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef FRAMESTREAMCLIENT__H
+#define FRAMESTREAMCLIENT__H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FrameStreamState.h"
+
+/*
+Connects to a FrameStreamServer and keeps a FrameStreamState up to date from the messages it receives.
+*/
+class FrameStreamClient
+{
+    public:
+
+    /*
+    Connects to @address. Throws like StreamSocket::connectTo().
+    */
+    FrameStreamClient(const std::string& address);
+    FrameStreamClient() = delete;
+    FrameStreamClient(const FrameStreamClient& o) = delete;
+    FrameStreamClient(FrameStreamClient&& o) noexcept = delete;
+    FrameStreamClient& operator=(const FrameStreamClient& o) = delete;
+    FrameStreamClient& operator=(FrameStreamClient&& o) noexcept = delete;
+    ~FrameStreamClient() noexcept;
+
+    /*
+    Waits up to @timeout for one whole message and applies it to the state. Returns false if no whole message arrived in time. Throws a runtime_error if the server closed the connection.
+    */
+    bool receive(std::chrono::milliseconds timeout);
+
+    const FrameStreamState& getState() const;
+
+    /*
+    Returns the number of keyframes received. The first one is sent on connecting, later ones mean the client was resynced.
+    */
+    long getKeyframeCount() const;
+    long getMessageCount() const;
+
+
+    private:
+
+    int _fd = -1;
+    FrameStreamState _state{};
+    std::vector<uint8_t> _buffer{};
+    long _keyframes = 0;
+    long _messages = 0;
+
+    // Applies the first message in _buffer if it is complete.
+    bool applyBuffered();
+};
+
+#endif
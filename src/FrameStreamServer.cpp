@@ -0,0 +1,296 @@
+#include "FrameStreamServer.h"
+
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "StreamSocket.h"
+
+using namespace std;
+
+FrameStreamServer::FrameStreamServer(
+    const string& address,
+    int width,
+    int height,
+    size_t maxQueuedBytes)
+:   _address{address},
+    _maxQueuedBytes{maxQueuedBytes},
+    _state{width, height}
+{
+    _listenFd = StreamSocket::listenOn(address, _port);
+    if (pipe(_wakeFds) == -1)
+    {
+        close(_listenFd);
+        throw runtime_error("FrameStreamServer can not create its wake up pipe.");
+    }
+    StreamSocket::setNonBlocking(_wakeFds[0]);
+    StreamSocket::setNonBlocking(_wakeFds[1]);
+
+    // Start the server's thread last, once all the attributes are set.
+    _io = thread(&FrameStreamServer::serve, this);
+}
+
+FrameStreamServer::~FrameStreamServer() noexcept
+{
+    _stopping = true;
+    wake();
+    _io.join();
+
+    for (auto& client : _clients)
+    {
+        close(client->fd);
+    }
+    close(_listenFd);
+    close(_wakeFds[0]);
+    close(_wakeFds[1]);
+    if (_port == -1)
+    {
+        unlink(_address.c_str());
+    }
+}
+
+void FrameStreamServer::receiveChanges(const shared_ptr<const Frame>& frame)
+{
+    {
+        lock_guard<mutex> lock(_mux);
+
+        auto delta = make_shared<vector<uint8_t>>();
+        _state.applyFrame(*frame, *delta);
+        bool isKeyframe = ((*delta)[FrameStreamState::lengthPrefixSize] == FrameStreamState::keyframeKind);
+        Message message{std::move(delta), isKeyframe};
+
+        // Made at most once per Frame, and only if a client needs it.
+        shared_ptr<const vector<uint8_t>> keyframe{};
+        for (auto& client : _clients)
+        {
+            if (client->dropped)
+            {
+                continue;
+            }
+            enqueue(*client, message);
+            if (client->queuedBytes > _maxQueuedBytes)
+            {
+                if (client->resyncing)
+                {
+                    // It has not even taken the last keyframe.
+                    client->dropped = true;
+                    client->queue.clear();
+                    client->queuedBytes = 0;
+                    ++_dropped;
+                    continue;
+                }
+                if (!keyframe)
+                {
+                    keyframe = makeKeyframe();
+                }
+                resync(*client, keyframe);
+            }
+        }
+    }
+    wake();
+}
+
+int FrameStreamServer::getPort() const
+{
+    return _port;
+}
+
+int FrameStreamServer::getClientCount() const
+{
+    lock_guard<mutex> lock(_mux);
+    int count = 0;
+    for (const auto& client : _clients)
+    {
+        count += client->dropped ? 0 : 1;
+    }
+    return count;
+}
+
+long FrameStreamServer::getResyncCount() const
+{
+    lock_guard<mutex> lock(_mux);
+    return _resyncs;
+}
+
+long FrameStreamServer::getDroppedCount() const
+{
+    lock_guard<mutex> lock(_mux);
+    return _dropped;
+}
+
+void FrameStreamServer::serve()
+{
+    vector<pollfd> fds{};
+    char scratch[4096];
+
+    while (!_stopping)
+    {
+        // Build the poll list: the wake up pipe, the listening socket, then one entry per client.
+        fds.clear();
+        fds.push_back(pollfd{_wakeFds[0], POLLIN, 0});
+        fds.push_back(pollfd{_listenFd, POLLIN, 0});
+        {
+            lock_guard<mutex> lock(_mux);
+
+            // Close the clients that were dropped or disconnected.
+            for (size_t ii=0; ii<_clients.size();)
+            {
+                if (_clients[ii]->dropped)
+                {
+                    close(_clients[ii]->fd);
+                    _clients[ii] = std::move(_clients.back());
+                    _clients.pop_back();
+                }
+                else
+                {
+                    ++ii;
+                }
+            }
+
+            for (const auto& client : _clients)
+            {
+                short events = POLLIN;
+                if (!client->queue.empty())
+                {
+                    events |= POLLOUT;
+                }
+                fds.push_back(pollfd{client->fd, events, 0});
+            }
+        }
+
+        if (poll(fds.data(), fds.size(), 100) <= 0)
+        {
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            while (read(_wakeFds[0], scratch, sizeof(scratch)) > 0)
+            {}
+        }
+        if (fds[1].revents & POLLIN)
+        {
+            accept();
+        }
+
+        lock_guard<mutex> lock(_mux);
+        for (size_t ii=2; ii<fds.size(); ++ii)
+        {
+            // Clients are only removed by this thread, so the order still matches fds.
+            Client& client = *_clients[ii - 2];
+            if (client.dropped)
+            {
+                continue;
+            }
+            if (fds[ii].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                // Clients don't send anything. Reading only detects that they hung up.
+                ssize_t received = recv(client.fd, scratch, sizeof(scratch), 0);
+                if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+                {
+                    client.dropped = true;
+                    continue;
+                }
+            }
+            if (fds[ii].revents & POLLOUT)
+            {
+                if (!flush(client))
+                {
+                    client.dropped = true;
+                }
+            }
+        }
+    }
+}
+
+void FrameStreamServer::wake()
+{
+    char byte = 0;
+    ssize_t written = write(_wakeFds[1], &byte, 1);
+    (void) written;
+}
+
+void FrameStreamServer::accept()
+{
+    while (true)
+    {
+        int fd = ::accept(_listenFd, nullptr, nullptr);
+        if (fd == -1)
+        {
+            return;
+        }
+        StreamSocket::setNonBlocking(fd);
+
+        lock_guard<mutex> lock(_mux);
+        auto client = make_unique<Client>();
+        client->fd = fd;
+        enqueue(*client, Message{makeKeyframe(), true});
+        _clients.push_back(std::move(client));
+    }
+}
+
+void FrameStreamServer::resync(Client& client, const shared_ptr<const vector<uint8_t>>& keyframe)
+{
+    // A message that is partly written has to be finished, or the stream would be cut mid-message.
+    if (client.sentOfFront > 0)
+    {
+        Message front = client.queue.front();
+        client.queue.clear();
+        client.queue.push_back(front);
+        client.queuedBytes = front.bytes->size() - client.sentOfFront;
+    }
+    else
+    {
+        client.queue.clear();
+        client.queuedBytes = 0;
+    }
+    enqueue(client, Message{keyframe, true});
+    client.resyncing = true;
+    ++_resyncs;
+}
+
+void FrameStreamServer::enqueue(Client& client, const Message& message)
+{
+    client.queue.push_back(message);
+    client.queuedBytes += message.bytes->size();
+}
+
+bool FrameStreamServer::flush(Client& client)
+{
+    while (!client.queue.empty())
+    {
+        const Message& front = client.queue.front();
+        const vector<uint8_t>& bytes = *front.bytes;
+        ssize_t sent = send(
+            client.fd,
+            bytes.data() + client.sentOfFront,
+            bytes.size() - client.sentOfFront,
+            MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        client.sentOfFront += static_cast<size_t>(sent);
+        client.queuedBytes -= static_cast<size_t>(sent);
+        if (client.sentOfFront < bytes.size())
+        {
+            return true;
+        }
+
+        if (front.keyframe)
+        {
+            client.resyncing = false;
+        }
+        client.sentOfFront = 0;
+        client.queue.pop_front();
+    }
+    return true;
+}
+
+shared_ptr<const vector<uint8_t>> FrameStreamServer::makeKeyframe() const
+{
+    auto keyframe = make_shared<vector<uint8_t>>();
+    _state.writeKeyframe(*keyframe);
+    return keyframe;
+}
@@ -0,0 +1,108 @@
+#ifndef FRAMESTREAMSERVER__H
+#define FRAMESTREAMSERVER__H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BoardListener.h"
+#include "FrameStreamState.h"
+
+/*
+Streams the Board to any number of viewers over a Unix socket or TCP. See StreamSocket for addresses and FrameStreamState for the messages.
+
+Each Frame from the Board is encoded once, as a delta of the changed cells and changed levels, and the same encoded message is queued for every client. A new client first receives a keyframe with the whole Board. The server's own thread accepts clients and writes the queues to the sockets without blocking.
+
+receiveChanges() never waits on a client. When a client's queue grows past maxQueuedBytes, its queue is thrown away and replaced by a keyframe of the current Board (a resync). A client that falls behind again before it has received that keyframe is disconnected.
+*/
+class FrameStreamServer : public BoardListener
+{
+    public:
+
+    /*
+    Starts listening on @address for a @width x @height Board. Throws like StreamSocket::listenOn().
+
+    @maxQueuedBytes is how many bytes may wait to be sent to one client before it is resynced.
+    */
+    FrameStreamServer(const std::string& address, int width, int height, size_t maxQueuedBytes = 8 * 1024 * 1024);
+    FrameStreamServer() = delete;
+    FrameStreamServer(const FrameStreamServer& o) = delete;
+    FrameStreamServer(FrameStreamServer&& o) noexcept = delete;
+    FrameStreamServer& operator=(const FrameStreamServer& o) = delete;
+    FrameStreamServer& operator=(FrameStreamServer&& o) noexcept = delete;
+
+    /*
+    Stops the server's thread and closes every connection. Messages that were not sent yet are lost.
+    */
+    ~FrameStreamServer() noexcept;
+
+    void receiveChanges(const std::shared_ptr<const Frame>& frame) override;
+
+    /*
+    Returns the TCP port the server listens on, or -1 for a Unix socket.
+    */
+    int getPort() const;
+
+    int getClientCount() const;
+
+    /*
+    Returns the number of times a slow client's queue was replaced by a keyframe.
+    */
+    long getResyncCount() const;
+
+    /*
+    Returns the number of clients that were disconnected for being too slow.
+    */
+    long getDroppedCount() const;
+
+
+    private:
+
+    struct Message
+    {
+        std::shared_ptr<const std::vector<uint8_t>> bytes;
+        bool keyframe;
+    };
+
+    struct Client
+    {
+        int fd;
+        std::deque<Message> queue{};
+        size_t queuedBytes = 0;
+        // Bytes of the front Message already written to the socket.
+        size_t sentOfFront = 0;
+        // True from a resync until its keyframe has been written.
+        bool resyncing = false;
+        bool dropped = false;
+    };
+
+    const std::string _address;
+    const size_t _maxQueuedBytes;
+    int _port = -1;
+    int _listenFd = -1;
+    int _wakeFds[2] = {-1, -1};
+
+    FrameStreamState _state;
+    std::vector<std::unique_ptr<Client>> _clients{};
+    long _resyncs = 0;
+    long _dropped = 0;
+    mutable std::mutex _mux;
+
+    std::atomic<bool> _stopping{false};
+    std::thread _io;
+
+    void serve();
+    void wake();
+    void accept();
+    void resync(Client& client, const std::shared_ptr<const std::vector<uint8_t>>& keyframe);
+    void enqueue(Client& client, const Message& message);
+    bool flush(Client& client);
+    std::shared_ptr<const std::vector<uint8_t>> makeKeyframe() const;
+};
+
+#endif
@@ -0,0 +1,278 @@
+#include "FrameStreamState.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "Varint.h"
+
+using namespace std;
+
+FrameStreamState::FrameStreamState()
+{}
+
+FrameStreamState::FrameStreamState(int width, int height)
+{
+    resize(width, height);
+    _hasKeyframe = true;
+}
+
+void FrameStreamState::applyFrame(const Frame& frame, vector<uint8_t>& out)
+{
+    _frameSequence = frame.getSequence();
+
+    _changedCells.clear();
+    for (const Drop& drop : frame.getChangedDrops())
+    {
+        Position position = drop.getPosition();
+        int cell = position.getY() * _width + position.getX();
+        bool left = (drop.getMoveType() == MoveType::left);
+        setCell(cell, left ? -1 : drop.getBoxId(), static_cast<uint8_t>(drop.getMoveType()));
+        _changedCells.push_back(cell);
+    }
+
+    // Deltas only carry levels. If the Boxes themselves differ, send everything.
+    const vector<BoxInfo>& boxInfos = frame.getBoxInfos();
+    bool sameBoxes = (boxInfos.size() == _boxTableIds.size());
+    for (size_t ii=0; sameBoxes && ii<boxInfos.size(); ++ii)
+    {
+        sameBoxes = (boxInfos[ii].getId() == _boxTableIds[ii]) && (boxInfos[ii].getGroupId() == _boxTableGroups[ii]);
+    }
+    if (!sameBoxes)
+    {
+        _boxTableIds.clear();
+        _boxTableGroups.clear();
+        _boxTableLevels.clear();
+        for (const BoxInfo& box : boxInfos)
+        {
+            _boxTableIds.push_back(box.getId());
+            _boxTableGroups.push_back(box.getGroupId());
+            _boxTableLevels.push_back(box.getLevel());
+        }
+        writeKeyframe(out);
+        return;
+    }
+
+    _changedLevels.clear();
+    for (size_t ii=0; ii<boxInfos.size(); ++ii)
+    {
+        if (boxInfos[ii].getLevel() != _boxTableLevels[ii])
+        {
+            _boxTableLevels[ii] = boxInfos[ii].getLevel();
+            _changedLevels.push_back(static_cast<int>(ii));
+        }
+    }
+
+    size_t start = out.size();
+    beginMessage(deltaKind, _frameSequence, out);
+    sort(_changedCells.begin(), _changedCells.end());
+    _changedCells.erase(unique(_changedCells.begin(), _changedCells.end()), _changedCells.end());
+    writeCells(_changedCells, out);
+    writeVarint(out, _changedLevels.size());
+    int previous = 0;
+    for (int index : _changedLevels)
+    {
+        writeVarint(out, static_cast<uint64_t>(index - previous));
+        writeVarint(out, zigZag(_boxTableLevels[index]));
+        previous = index;
+    }
+    endMessage(start, out);
+}
+
+void FrameStreamState::writeKeyframe(vector<uint8_t>& out) const
+{
+    size_t start = out.size();
+    beginMessage(keyframeKind, _frameSequence, out);
+    writeVarint(out, static_cast<uint64_t>(_width));
+    writeVarint(out, static_cast<uint64_t>(_height));
+    writeVarint(out, _boxTableIds.size());
+    for (size_t ii=0; ii<_boxTableIds.size(); ++ii)
+    {
+        writeVarint(out, zigZag(_boxTableIds[ii]));
+        writeVarint(out, zigZag(_boxTableGroups[ii]));
+        writeVarint(out, zigZag(_boxTableLevels[ii]));
+    }
+
+    vector<int> occupied{};
+    for (int cell=0; cell<static_cast<int>(_boxIds.size()); ++cell)
+    {
+        if (_boxIds[cell] != -1)
+        {
+            occupied.push_back(cell);
+        }
+    }
+    writeCells(occupied, out);
+    endMessage(start, out);
+}
+
+void FrameStreamState::applyMessage(const uint8_t* data, size_t size)
+{
+    const uint8_t* pos = data;
+    const uint8_t* end = data + size;
+    if (pos >= end)
+    {
+        throw invalid_argument("The frame stream message is empty.");
+    }
+    uint8_t kind = *pos++;
+    long frameSequence = static_cast<long>(unZigZag(readVarint(pos, end)));
+
+    if (kind == keyframeKind)
+    {
+        int width = static_cast<int>(readVarint(pos, end));
+        int height = static_cast<int>(readVarint(pos, end));
+        uint64_t boxCount = readVarint(pos, end);
+        if (boxCount > size)
+        {
+            throw invalid_argument("The frame stream keyframe has more Boxes than bytes.");
+        }
+        resize(width, height);
+        _boxTableIds.resize(boxCount);
+        _boxTableGroups.resize(boxCount);
+        _boxTableLevels.resize(boxCount);
+        for (uint64_t ii=0; ii<boxCount; ++ii)
+        {
+            _boxTableIds[ii] = static_cast<int32_t>(unZigZag(readVarint(pos, end)));
+            _boxTableGroups[ii] = static_cast<int32_t>(unZigZag(readVarint(pos, end)));
+            _boxTableLevels[ii] = static_cast<int32_t>(unZigZag(readVarint(pos, end)));
+        }
+        readCells(pos, end);
+        _hasKeyframe = true;
+    }
+    else if (kind == deltaKind)
+    {
+        if (!_hasKeyframe)
+        {
+            throw invalid_argument("A frame stream delta arrived before any keyframe.");
+        }
+        readCells(pos, end);
+        uint64_t levelCount = readVarint(pos, end);
+        uint64_t index = 0;
+        for (uint64_t ii=0; ii<levelCount; ++ii)
+        {
+            index += readVarint(pos, end);
+            if (index >= _boxTableLevels.size())
+            {
+                throw invalid_argument("The frame stream delta has a Box outside of the box table.");
+            }
+            _boxTableLevels[index] = static_cast<int32_t>(unZigZag(readVarint(pos, end)));
+        }
+    }
+    else
+    {
+        throw invalid_argument("Unknown frame stream message kind " + to_string(kind) + ".");
+    }
+    _frameSequence = frameSequence;
+}
+
+int FrameStreamState::getWidth() const
+{
+    return _width;
+}
+
+int FrameStreamState::getHeight() const
+{
+    return _height;
+}
+
+long FrameStreamState::getFrameSequence() const
+{
+    return _frameSequence;
+}
+
+bool FrameStreamState::hasKeyframe() const
+{
+    return _hasKeyframe;
+}
+
+int FrameStreamState::getBoxId(int cell) const
+{
+    return _boxIds[cell];
+}
+
+MoveType FrameStreamState::getMoveType(int cell) const
+{
+    return static_cast<MoveType>(_types[cell]);
+}
+
+int FrameStreamState::getBoxCount() const
+{
+    return static_cast<int>(_boxTableIds.size());
+}
+
+int FrameStreamState::getBoxIdAt(int index) const
+{
+    return _boxTableIds[index];
+}
+
+int FrameStreamState::getGroupIdAt(int index) const
+{
+    return _boxTableGroups[index];
+}
+
+int FrameStreamState::getLevelAt(int index) const
+{
+    return _boxTableLevels[index];
+}
+
+void FrameStreamState::resize(int width, int height)
+{
+    if (width < 0 || height < 0)
+    {
+        throw invalid_argument("A frame stream Board can not have a negative size.");
+    }
+    _width = width;
+    _height = height;
+    _boxIds.assign(static_cast<size_t>(width) * static_cast<size_t>(height), -1);
+    _types.assign(static_cast<size_t>(width) * static_cast<size_t>(height), static_cast<uint8_t>(MoveType::left));
+}
+
+void FrameStreamState::setCell(int cell, int boxId, uint8_t type)
+{
+    _boxIds[cell] = boxId;
+    _types[cell] = type;
+}
+
+void FrameStreamState::writeCells(const vector<int>& cells, vector<uint8_t>& out) const
+{
+    writeVarint(out, cells.size());
+    int previous = 0;
+    for (int cell : cells)
+    {
+        writeVarint(out, static_cast<uint64_t>(cell - previous));
+        writeVarint(out, static_cast<uint64_t>(_boxIds[cell] + 1));
+        out.push_back(_types[cell]);
+        previous = cell;
+    }
+}
+
+void FrameStreamState::readCells(const uint8_t*& pos, const uint8_t* end)
+{
+    uint64_t count = readVarint(pos, end);
+    uint64_t cell = 0;
+    for (uint64_t ii=0; ii<count; ++ii)
+    {
+        cell += readVarint(pos, end);
+        int boxId = static_cast<int>(readVarint(pos, end)) - 1;
+        if (cell >= _boxIds.size() || pos >= end)
+        {
+            throw invalid_argument("The frame stream message has a cell outside of the Board.");
+        }
+        setCell(static_cast<int>(cell), boxId, *pos++);
+    }
+}
+
+void FrameStreamState::beginMessage(uint8_t kind, long frameSequence, vector<uint8_t>& out)
+{
+    // The length is filled in by endMessage().
+    out.insert(out.end(), lengthPrefixSize, 0);
+    out.push_back(kind);
+    writeVarint(out, zigZag(frameSequence));
+}
+
+void FrameStreamState::endMessage(size_t start, vector<uint8_t>& out)
+{
+    uint32_t length = static_cast<uint32_t>(out.size() - start - lengthPrefixSize);
+    for (size_t ii=0; ii<lengthPrefixSize; ++ii)
+    {
+        out[start + ii] = static_cast<uint8_t>(length >> (8 * ii));
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef FRAMESTREAMSTATE__H
+#define FRAMESTREAMSTATE__H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Frame.h"
+#include "MoveType.h"
+
+/*
+The Board as seen through a frame stream: the boxId and MoveType per cell and the id, group, and level per Box.
+
+FrameStreamServer keeps one FrameStreamState up to date from the Board's Frames and encodes each change as a delta message. A FrameStreamClient keeps its own FrameStreamState and applies the messages it receives, so both end up with the same state.
+
+Messages (see Varint.h for varints; signed numbers are zig-zag varints):
+    uint32   length of the rest of the message, little-endian
+    uint8    kind: 1 keyframe, 2 delta
+    signed   Frame sequence number
+A keyframe continues with:
+    varint   width, height, number of Boxes
+    Per Box, signed id, signed groupId, signed level
+    Cells, as below, for every occupied cell
+A delta continues with:
+    Cells, as below, for every cell the Frame changed
+    varint   number of Boxes whose level changed
+    Per such Box, varint difference to the previous Box's index (the first is the index itself), signed level
+Cells are:
+    varint   number of cells
+    Per cell, in increasing order, varint difference to the previous cell (the first is the cell itself), varint boxId + 1 (0 for an empty cell), uint8 MoveType
+*/
+class FrameStreamState
+{
+    public:
+
+    /*
+    The number of bytes of the little-endian length at the start of every message. The kind follows at this offset.
+    */
+    static constexpr size_t lengthPrefixSize = 4;
+
+    static constexpr uint8_t keyframeKind = 1;
+    static constexpr uint8_t deltaKind = 2;
+
+    /*
+    An empty state. Its size is set by the first keyframe applied to it.
+    */
+    FrameStreamState();
+
+    /*
+    An empty @width x @height Board with no Boxes yet. The Boxes are set by the first Frame.
+    */
+    FrameStreamState(int width, int height);
+
+    FrameStreamState(const FrameStreamState& o) = delete;
+    FrameStreamState(FrameStreamState&& o) noexcept = delete;
+    FrameStreamState& operator=(const FrameStreamState& o) = delete;
+    FrameStreamState& operator=(FrameStreamState&& o) noexcept = delete;
+    ~FrameStreamState() noexcept = default;
+
+    /*
+    Applies @frame's changed Drops and BoxInfos and appends a delta message with only what changed to @out. If @frame's Boxes are not the Boxes already in the state (the first Frame, for example), a keyframe is appended instead, since deltas only carry levels.
+    */
+    void applyFrame(const Frame& frame, std::vector<uint8_t>& out);
+
+    /*
+    Appends a keyframe message with the whole state to @out.
+    */
+    void writeKeyframe(std::vector<uint8_t>& out) const;
+
+    /*
+    Applies one message without its length prefix (@data starts at the kind). Throws an invalid_argument exception if the message is damaged, or if it is a delta and no keyframe has been applied yet.
+    */
+    void applyMessage(const uint8_t* data, size_t size);
+
+    int getWidth() const;
+    int getHeight() const;
+    long getFrameSequence() const;
+    bool hasKeyframe() const;
+
+    /*
+    Returns the boxId in @cell, or -1 if @cell is empty.
+    */
+    int getBoxId(int cell) const;
+    MoveType getMoveType(int cell) const;
+
+    int getBoxCount() const;
+    int getBoxIdAt(int index) const;
+    int getGroupIdAt(int index) const;
+    int getLevelAt(int index) const;
+
+
+    private:
+
+    int _width = 0;
+    int _height = 0;
+    long _frameSequence = -1;
+    bool _hasKeyframe = false;
+
+    std::vector<int32_t> _boxIds{};
+    std::vector<uint8_t> _types{};
+
+    std::vector<int32_t> _boxTableIds{};
+    std::vector<int32_t> _boxTableGroups{};
+    std::vector<int32_t> _boxTableLevels{};
+
+    // Scratch space for applyFrame().
+    std::vector<int> _changedCells{};
+    std::vector<int> _changedLevels{};
+
+    void resize(int width, int height);
+    void setCell(int cell, int boxId, uint8_t type);
+    void writeCells(const std::vector<int>& cells, std::vector<uint8_t>& out) const;
+    void readCells(const uint8_t*& pos, const uint8_t* end);
+    static void beginMessage(uint8_t kind, long frameSequence, std::vector<uint8_t>& out);
+    static void endMessage(size_t start, std::vector<uint8_t>& out);
+};
+
+#endif
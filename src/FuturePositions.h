@@ -0,0 +1,75 @@
+#ifndef FUTUREPOSITIONS__H
+#define FUTUREPOSITIONS__H
+
+#include <array>
+#include <span>
+#include <stdexcept>
+#include "Position.h"
+
+/*
+The Positions a Box could move to next, most recommended first, kept in place instead of in a std::vector. A Box has at most eight Positions next to it, so a caller can keep one FuturePositions and refill it every step without allocating.
+*/
+class FuturePositions
+{
+    public:
+
+    static constexpr int capacity = 8;
+
+    FuturePositions() = default;
+    FuturePositions(const FuturePositions& o) = default;
+    FuturePositions(FuturePositions&& o) noexcept = default;
+    FuturePositions& operator=(const FuturePositions& o) = default;
+    FuturePositions& operator=(FuturePositions&& o) noexcept = default;
+    ~FuturePositions() noexcept = default;
+
+    /*
+    Throws a length_error if it already holds capacity Positions.
+    */
+    void push_back(Position position)
+    {
+        if (_size == capacity)
+        {
+            throw std::length_error("FuturePositions can not hold more than 8 Positions.");
+        }
+        _positions[_size++] = position;
+    }
+
+    void clear()
+    {
+        _size = 0;
+    }
+
+    int size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    Position operator[](int index) const
+    {
+        return _positions[index];
+    }
+
+    /*
+    Returns the Positions held, valid until the next change.
+    */
+    std::span<const Position> get() const
+    {
+        return std::span<const Position>{_positions.data(), static_cast<size_t>(_size)};
+    }
+
+
+    private:
+
+    // Position has no default constructor, so the unused slots hold {-1, -1}.
+    std::array<Position, capacity> _positions{
+        Position{-1, -1}, Position{-1, -1}, Position{-1, -1}, Position{-1, -1},
+        Position{-1, -1}, Position{-1, -1}, Position{-1, -1}, Position{-1, -1}};
+    int _size = 0;
+};
+
+#endif
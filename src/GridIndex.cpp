@@ -0,0 +1,119 @@
+#include "GridIndex.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    constexpr int tileCells = GridIndex::tileSize * GridIndex::tileSize;
+
+    /*
+    Moves the three bits of @value (0 to 7) to bits 0, 2, and 4, so the bits of x and y can be interleaved.
+    */
+    int spreadBits(int value)
+    {
+        return (value & 1) | ((value & 2) << 1) | ((value & 4) << 2);
+    }
+
+    int roundUpToTiles(int length)
+    {
+        return (length + GridIndex::tileSize - 1) / GridIndex::tileSize * GridIndex::tileSize;
+    }
+}
+
+GridIndex::GridIndex(int width, int height, GridLayout layout)
+:   _layout{layout}
+{
+    if (width < 0 || height < 0)
+    {
+        throw invalid_argument("A GridIndex needs a width and a height of at least 0.");
+    }
+
+    bool tiles = (layout != GridLayout::rowMajor);
+    _paddedWidth = tiles ? roundUpToTiles(width) : width;
+    _paddedHeight = tiles ? roundUpToTiles(height) : height;
+    _xOffsets.resize(_paddedWidth);
+    _yOffsets.resize(_paddedHeight);
+
+    // A row of tiles holds tilesAcross tiles of tileCells cells each.
+    int tilesAcross = _paddedWidth / tileSize;
+    for (int x=0; x<_paddedWidth; ++x)
+    {
+        int inTile = x % tileSize;
+        switch (layout)
+        {
+            case GridLayout::rowMajor:
+                _xOffsets[x] = x;
+                break;
+            case GridLayout::tiled:
+                _xOffsets[x] = (x / tileSize) * tileCells + inTile;
+                break;
+            case GridLayout::morton:
+                _xOffsets[x] = (x / tileSize) * tileCells + spreadBits(inTile);
+                break;
+        }
+    }
+    for (int y=0; y<_paddedHeight; ++y)
+    {
+        int inTile = y % tileSize;
+        switch (layout)
+        {
+            case GridLayout::rowMajor:
+                _yOffsets[y] = y * width;
+                break;
+            case GridLayout::tiled:
+                _yOffsets[y] = (y / tileSize) * tilesAcross * tileCells + inTile * tileSize;
+                break;
+            case GridLayout::morton:
+                _yOffsets[y] = (y / tileSize) * tilesAcross * tileCells + (spreadBits(inTile) << 1);
+                break;
+        }
+    }
+}
+
+int GridIndex::getIndexCount() const
+{
+    return _paddedWidth * _paddedHeight;
+}
+
+GridLayout GridIndex::getLayout() const
+{
+    return _layout;
+}
+
+int GridIndex::getPaddedWidth() const
+{
+    return _paddedWidth;
+}
+
+int GridIndex::getPaddedHeight() const
+{
+    return _paddedHeight;
+}
+
+string GridIndex::toString(GridLayout layout)
+{
+    switch (layout)
+    {
+        case GridLayout::rowMajor:
+            return "row-major";
+        case GridLayout::tiled:
+            return "tiled";
+        case GridLayout::morton:
+            return "morton";
+    }
+    return "unknown";
+}
+
+GridLayout GridIndex::toGridLayout(const string& name)
+{
+    for (GridLayout layout : {GridLayout::rowMajor, GridLayout::tiled, GridLayout::morton})
+    {
+        if (name == toString(layout))
+        {
+            return layout;
+        }
+    }
+    throw invalid_argument("There is no GridLayout named " + name + ".");
+}
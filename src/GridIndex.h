@@ -0,0 +1,69 @@
+#ifndef GRIDINDEX__H
+#define GRIDINDEX__H
+
+#include <string>
+#include <vector>
+#include "GridLayout.h"
+
+/*
+Maps the x,y Position of a cell to its index in storage laid out by a GridLayout.
+
+The index is the sum of an offset per column and an offset per row, so getIndex() is two table look ups and an add for every GridLayout. The tiled layouts round the width and height up to whole tiles, so the storage can hold a few more cells than the Board has. The tiles are in rows, so a Board that is not a power of two across is not padded out to one.
+*/
+class GridIndex
+{
+    public:
+
+    static constexpr int tileSize = 8;
+
+    /*
+    Throws an invalid_argument exception if @width or @height is negative.
+    */
+    GridIndex(int width, int height, GridLayout layout);
+
+    GridIndex() = delete;
+    GridIndex(const GridIndex& o) = default;
+    GridIndex(GridIndex&& o) noexcept = default;
+    GridIndex& operator=(const GridIndex& o) = default;
+    GridIndex& operator=(GridIndex&& o) noexcept = default;
+    ~GridIndex() noexcept = default;
+
+    /*
+    Returns the index of the cell at {@x, @y}, which must be on the grid.
+    */
+    int getIndex(int x, int y) const
+    {
+        return _xOffsets[x] + _yOffsets[y];
+    }
+
+    /*
+    Returns the size of the storage: the number of cells, including the padding of the tiled layouts.
+    */
+    int getIndexCount() const;
+
+    GridLayout getLayout() const;
+
+    /*
+    Returns the width and height of the grid including the padding. Every index below getIndexCount() is the index of exactly one cell inside them.
+    */
+    int getPaddedWidth() const;
+    int getPaddedHeight() const;
+
+    static std::string toString(GridLayout layout);
+
+    /*
+    Throws an invalid_argument exception if @name is not the name of a GridLayout.
+    */
+    static GridLayout toGridLayout(const std::string& name);
+
+
+    private:
+
+    GridLayout _layout;
+    int _paddedWidth;
+    int _paddedHeight;
+    std::vector<int> _xOffsets;
+    std::vector<int> _yOffsets;
+};
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef GRIDLAYOUT__H
+#define GRIDLAYOUT__H
+
+/*
+The order in which the Board stores its Spots. rowMajor stores them a row at a time. tiled stores them in 8 x 8 tiles, a row of cells at a time within a tile, so the cells around a Position are mostly in the same tile. morton is tiled with the cells of a tile in Z-order. See GridIndex.
+*/
+enum class GridLayout{rowMajor=1, tiled=2, morton=3};
+
+#endif
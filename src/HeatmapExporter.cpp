@@ -0,0 +1,136 @@
+#include "HeatmapExporter.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    using Pixel = array<uint8_t, 3>;
+
+    const Pixel outlineColor{0, 255, 255};
+
+    // Black at 0, red at 1/3, yellow at 2/3, and white at 1.
+    Pixel getColor(double fraction)
+    {
+        double scaled = clamp(fraction, 0.0, 1.0) * 3.0;
+        auto channel = [](double value){
+            return static_cast<uint8_t>(lround(clamp(value, 0.0, 1.0) * 255.0));
+        };
+        return Pixel{channel(scaled), channel(scaled - 1.0), channel(scaled - 2.0)};
+    }
+
+    void writeFile(const string& path, const CellHeatmap::Grid& grid, HeatmapLayer layer, const vector<Rectangle>& outlines, bool image)
+    {
+        ofstream out{path, image ? ios::binary : ios::out};
+        if (!out)
+        {
+            throw runtime_error("HeatmapExporter could not open " + path + ".");
+        }
+        if (image)
+        {
+            HeatmapExporter::writePpm(out, grid, layer, outlines);
+        }
+        else
+        {
+            HeatmapExporter::writeCsv(out, grid, layer);
+        }
+    }
+}
+
+string HeatmapExporter::getName(HeatmapLayer layer)
+{
+    switch (layer)
+    {
+        case HeatmapLayer::traversals:
+            return "traversals";
+        case HeatmapLayer::collisions:
+            return "collisions";
+        case HeatmapLayer::dwellSeconds:
+            return "dwell_seconds";
+    }
+    return "";
+}
+
+void HeatmapExporter::writeCsv(ostream& out, const CellHeatmap::Grid& grid, HeatmapLayer layer)
+{
+    for (int y=0; y<grid.height; ++y)
+    {
+        for (int x=0; x<grid.width; ++x)
+        {
+            if (x > 0)
+            {
+                out << ",";
+            }
+            out << grid.get(layer, x, y);
+        }
+        out << "\n";
+    }
+}
+
+void HeatmapExporter::writePpm(
+    ostream& out,
+    const CellHeatmap::Grid& grid,
+    HeatmapLayer layer,
+    const vector<Rectangle>& outlines)
+{
+    const vector<double>& values = grid.layers[static_cast<size_t>(layer)];
+    double max = values.empty() ? 0.0 : *max_element(values.begin(), values.end());
+    double logMax = log1p(max);
+
+    vector<Pixel> pixels(values.size(), Pixel{0, 0, 0});
+    for (size_t cell=0; cell<values.size(); ++cell)
+    {
+        if (values[cell] > 0.0)
+        {
+            pixels[cell] = getColor(log1p(values[cell]) / logMax);
+        }
+    }
+
+    auto setOutline = [&grid, &pixels](int x, int y){
+        if (x >= 0 && x < grid.width && y >= 0 && y < grid.height)
+        {
+            pixels[y * grid.width + x] = outlineColor;
+        }
+    };
+    for (const Rectangle& rectangle : outlines)
+    {
+        Position topLeft = rectangle.getTopLeft();
+        Position bottomRight = rectangle.getBottomRight();
+        for (int x=topLeft.getX(); x<=bottomRight.getX(); ++x)
+        {
+            setOutline(x, topLeft.getY());
+            setOutline(x, bottomRight.getY());
+        }
+        for (int y=topLeft.getY(); y<=bottomRight.getY(); ++y)
+        {
+            setOutline(topLeft.getX(), y);
+            setOutline(bottomRight.getX(), y);
+        }
+    }
+
+    out << "P6\n" << grid.width << " " << grid.height << "\n255\n";
+    for (const Pixel& pixel : pixels)
+    {
+        out.write(reinterpret_cast<const char*>(pixel.data()), pixel.size());
+    }
+}
+
+void HeatmapExporter::writeFiles(
+    const string& prefix,
+    const CellHeatmap::Grid& grid,
+    const vector<Rectangle>& outlines)
+{
+    for (int layer=0; layer<heatmapLayerCount; ++layer)
+    {
+        HeatmapLayer heatmapLayer = static_cast<HeatmapLayer>(layer);
+        string path = prefix + "-" + getName(heatmapLayer);
+        writeFile(path + ".csv", grid, heatmapLayer, outlines, false);
+        writeFile(path + ".ppm", grid, heatmapLayer, outlines, true);
+    }
+}
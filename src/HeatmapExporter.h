@@ -0,0 +1,46 @@
+#ifndef HEATMAPEXPORTER__H
+#define HEATMAPEXPORTER__H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "CellHeatmap.h"
+#include "HeatmapLayer.h"
+#include "Rectangle.h"
+
+/*
+Writes a CellHeatmap::Grid layer as a CSV grid or as a heatmap image.
+
+The CSV grid has one line per row of the Board, top row first, and one value per cell.
+
+The image is a binary PPM (P6), which most image viewers open and which needs no image library. It has one pixel per cell. Empty cells are black, and busier cells go through red and yellow to white. The colour follows the logarithm of the value, so a few very busy cells do not wash out the rest. Rectangles, like the entrance Rectangles, can be outlined in cyan on top.
+*/
+class HeatmapExporter
+{
+    public:
+
+    HeatmapExporter() = delete;
+
+    static std::string getName(HeatmapLayer layer);
+
+    static void writeCsv(std::ostream& out, const CellHeatmap::Grid& grid, HeatmapLayer layer);
+
+    /*
+    Parts of @outlines that are off the Board are not drawn.
+    */
+    static void writePpm(
+        std::ostream& out,
+        const CellHeatmap::Grid& grid,
+        HeatmapLayer layer,
+        const std::vector<Rectangle>& outlines = {});
+
+    /*
+    Writes every layer of @grid to "<@prefix>-<layer name>.csv" and "<@prefix>-<layer name>.ppm". Throws a runtime_error exception if a file can not be opened.
+    */
+    static void writeFiles(
+        const std::string& prefix,
+        const CellHeatmap::Grid& grid,
+        const std::vector<Rectangle>& outlines = {});
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef HEATMAPLAYER__H
+#define HEATMAPLAYER__H
+
+/*
+What a CellHeatmap counts per cell.
+traversals is the number of Boxes that arrived at the cell.
+collisions is the number of Boxes that were refused the cell because another Box was on it.
+dwellSeconds is the total time Boxes spent on the cell, from arriving until leaving.
+*/
+enum class HeatmapLayer{
+    traversals=0,
+    collisions=1,
+    dwellSeconds=2};
+
+constexpr int heatmapLayerCount = 3;
+
+#endif
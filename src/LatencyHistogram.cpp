@@ -0,0 +1,110 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace std;
+
+LatencyHistogram::LatencyHistogram(const array<uint64_t, bucketCount>& counts, double sum, uint64_t max)
+:   _counts{counts},
+    _max{max},
+    _sum{sum}
+{
+    for (uint64_t count : counts)
+    {
+        _count += count;
+    }
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds)
+{
+    ++_counts[getBucket(nanoseconds)];
+    ++_count;
+    _max = max(_max, nanoseconds);
+    _sum += static_cast<double>(nanoseconds);
+}
+
+
+void LatencyHistogram::merge(const LatencyHistogram& o)
+{
+    for (int ii=0; ii<bucketCount; ++ii)
+    {
+        _counts[ii] += o._counts[ii];
+    }
+    _count += o._count;
+    _max = max(_max, o._max);
+    _sum += o._sum;
+}
+
+uint64_t LatencyHistogram::getCount() const
+{
+    return _count;
+}
+
+double LatencyHistogram::getMean() const
+{
+    return (_count == 0) ? 0.0 : _sum / static_cast<double>(_count);
+}
+
+uint64_t LatencyHistogram::getMax() const
+{
+    return _max;
+}
+
+uint64_t LatencyHistogram::getPercentile(double fraction) const
+{
+    if (_count == 0)
+    {
+        return 0;
+    }
+
+    // The rank of the value wanted, counting from 1.
+    uint64_t rank = static_cast<uint64_t>(ceil(clamp(fraction, 0.0, 1.0) * static_cast<double>(_count)));
+    rank = max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (int ii=0; ii<bucketCount; ++ii)
+    {
+        seen += _counts[ii];
+        if (seen >= rank)
+        {
+            // The top of the bucket can be above the largest value recorded.
+            return min(getBucketTop(ii), _max);
+        }
+    }
+    return _max;
+}
+
+int LatencyHistogram::getBucket(uint64_t nanoseconds)
+{
+    if (nanoseconds < subBucketCount)
+    {
+        return static_cast<int>(nanoseconds);
+    }
+
+    int exponent = 63 - countl_zero(nanoseconds);
+    if (exponent > maxExponent)
+    {
+        return bucketCount - 1;
+    }
+    int subBucket = static_cast<int>((nanoseconds >> (exponent - subBucketBits)) & (subBucketCount - 1));
+    return (exponent - subBucketBits + 1) * subBucketCount + subBucket;
+}
+
+uint64_t LatencyHistogram::getBucketTop(int bucket)
+{
+    if (bucket < subBucketCount)
+    {
+        return static_cast<uint64_t>(bucket);
+    }
+    if (bucket == bucketCount - 1)
+    {
+        return UINT64_MAX;
+    }
+
+    int exponent = bucket / subBucketCount + subBucketBits - 1;
+    uint64_t subBucket = static_cast<uint64_t>(bucket % subBucketCount);
+    uint64_t width = uint64_t{1} << (exponent - subBucketBits);
+    return (uint64_t{1} << exponent) + (subBucket + 1) * width - 1;
+}
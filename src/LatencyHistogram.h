@@ -0,0 +1,75 @@
+#ifndef LATENCYHISTOGRAM__H
+#define LATENCYHISTOGRAM__H
+
+#include <array>
+#include <cstdint>
+
+/*
+A histogram of durations in nanoseconds with logarithmic buckets, in the style of an HDR histogram.
+
+Every power of two is split into 16 equal buckets, so a bucket is never wider than 1/16 of the values in it and a percentile is off by at most about 6%. Values below 16 get a bucket each. Values above about 9 minutes share the last bucket. Every LatencyHistogram has the same buckets, so histograms recorded on different threads are merged by adding their counts.
+*/
+class LatencyHistogram
+{
+    public:
+
+    static constexpr int subBucketBits = 4;
+    static constexpr int subBucketCount = 1 << subBucketBits;
+    // The highest power of two that gets its own buckets: 2^39 ns is about 9 minutes.
+    static constexpr int maxExponent = 39;
+    static constexpr int bucketCount = (maxExponent - subBucketBits + 2) * subBucketCount;
+
+    LatencyHistogram() = default;
+
+    /*
+    Builds a LatencyHistogram from counts kept elsewhere: @counts per bucket, the @sum of all values, and the largest value @max.
+    */
+    LatencyHistogram(const std::array<uint64_t, bucketCount>& counts, double sum, uint64_t max);
+
+    LatencyHistogram(const LatencyHistogram& o) = default;
+    LatencyHistogram(LatencyHistogram&& o) noexcept = default;
+    LatencyHistogram& operator=(const LatencyHistogram& o) = default;
+    LatencyHistogram& operator=(LatencyHistogram&& o) noexcept = default;
+    ~LatencyHistogram() noexcept = default;
+
+    void record(uint64_t nanoseconds);
+
+    /*
+    Adds all of @o's values to this LatencyHistogram.
+    */
+    void merge(const LatencyHistogram& o);
+
+    uint64_t getCount() const;
+
+    /*
+    Returns 0 if there are no values. The mean and maximum are exact, not bucketed.
+    */
+    double getMean() const;
+    uint64_t getMax() const;
+
+    /*
+    Returns the value that @fraction of the values are at or below, for example 0.99 for p99. The value returned is the top of the bucket it falls in, so it is never below the exact percentile. Returns 0 if there are no values.
+    */
+    uint64_t getPercentile(double fraction) const;
+
+    /*
+    Returns the bucket @nanoseconds falls in.
+    */
+    static int getBucket(uint64_t nanoseconds);
+
+    /*
+    Returns the largest value in @bucket.
+    */
+    static uint64_t getBucketTop(int bucket);
+
+
+    private:
+
+    std::array<uint64_t, bucketCount> _counts{};
+    uint64_t _count = 0;
+    uint64_t _max = 0;
+    // Kept as a double so long runs can not overflow it.
+    double _sum = 0.0;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "LatencyLogger.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+LatencyLogger::LatencyLogger(
+    const PhaseLatencies& latencies,
+    const string& path,
+    chrono::milliseconds interval)
+:   _latencies{latencies},
+    _interval{interval},
+    _start{chrono::steady_clock::now()},
+    _out{path}
+{
+    if (interval.count() <= 0)
+    {
+        throw invalid_argument("A LatencyLogger's interval must be positive.");
+    }
+    if (!_out)
+    {
+        throw runtime_error("LatencyLogger could not open " + path + ".");
+    }
+    PhaseLatencies::writeCsvHeader(_out);
+
+    // Start the logging thread last, once all the attributes are set.
+    _logger = thread(&LatencyLogger::log, this);
+}
+
+LatencyLogger::~LatencyLogger() noexcept
+{
+    {
+        lock_guard<mutex> lock(_mux);
+        _stopping = true;
+    }
+    _stop.notify_all();
+    _logger.join();
+
+    lock_guard<mutex> lock(_mux);
+    write();
+}
+
+int LatencyLogger::getWrittenCount() const
+{
+    lock_guard<mutex> lock(_mux);
+    return _written;
+}
+
+void LatencyLogger::log()
+{
+    unique_lock<mutex> lock(_mux);
+    while (!_stop.wait_for(lock, _interval, [this]{ return _stopping; }))
+    {
+        write();
+    }
+}
+
+void LatencyLogger::write()
+{
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+    PhaseLatencies::writeCsvRows(_out, seconds, _latencies.getHistograms());
+    _out.flush();
+    ++_written;
+}
@@ -0,0 +1,58 @@
+#ifndef LATENCYLOGGER__H
+#define LATENCYLOGGER__H
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "PhaseLatencies.h"
+
+/*
+Writes the PhaseLatencies histograms to a CSV file at a fixed interval, on its own thread. See PhaseLatencies::writeCsvRows() for the rows. The histograms are cumulative, so the last rows written cover the whole run. A last set of rows is written when the LatencyLogger is destroyed.
+*/
+class LatencyLogger
+{
+    public:
+
+    /*
+    @latencies must outlive the LatencyLogger. Throws a runtime_error exception if @path can not be opened, and an invalid_argument exception if @interval is not positive.
+    */
+    LatencyLogger(const PhaseLatencies& latencies, const std::string& path, std::chrono::milliseconds interval);
+    LatencyLogger() = delete;
+    LatencyLogger(const LatencyLogger& o) = delete;
+    LatencyLogger(LatencyLogger&& o) noexcept = delete;
+    LatencyLogger& operator=(const LatencyLogger& o) = delete;
+    LatencyLogger& operator=(LatencyLogger&& o) noexcept = delete;
+
+    /*
+    Writes the last rows and stops the logging thread.
+    */
+    ~LatencyLogger() noexcept;
+
+    /*
+    Returns how many times rows have been written.
+    */
+    int getWrittenCount() const;
+
+
+    private:
+
+    const PhaseLatencies& _latencies;
+    const std::chrono::milliseconds _interval;
+    const std::chrono::steady_clock::time_point _start;
+    std::ofstream _out;
+
+    int _written = 0;
+    bool _stopping = false;
+    mutable std::mutex _mux;
+    std::condition_variable _stop;
+
+    std::thread _logger;
+
+    void log();
+    void write();
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "ListenerStats.h"
+
+ListenerStats::ListenerStats(
+    long received,
+    long delivered,
+    long dropped,
+    long coalesced,
+    int queueLength,
+    int maxQueueLength,
+    long lastReceivedSequence,
+    long lastDeliveredSequence)
+:   _received{received},
+    _delivered{delivered},
+    _dropped{dropped},
+    _coalesced{coalesced},
+    _queueLength{queueLength},
+    _maxQueueLength{maxQueueLength},
+    _lastReceivedSequence{lastReceivedSequence},
+    _lastDeliveredSequence{lastDeliveredSequence}
+{}
+
+long ListenerStats::getReceived() const
+{
+    return _received;
+}
+
+long ListenerStats::getDelivered() const
+{
+    return _delivered;
+}
+
+long ListenerStats::getDropped() const
+{
+    return _dropped;
+}
+
+long ListenerStats::getCoalesced() const
+{
+    return _coalesced;
+}
+
+int ListenerStats::getQueueLength() const
+{
+    return _queueLength;
+}
+
+int ListenerStats::getMaxQueueLength() const
+{
+    return _maxQueueLength;
+}
+
+long ListenerStats::getLag() const
+{
+    return _lastReceivedSequence - _lastDeliveredSequence;
+}
@@ -0,0 +1,71 @@
+#ifndef LISTENERSTATS__H
+#define LISTENERSTATS__H
+
+/*
+A snapshot of how far an AsyncBoardListener's consumer is falling behind.
+*/
+class ListenerStats
+{
+    public:
+
+    ListenerStats(
+        long received,
+        long delivered,
+        long dropped,
+        long coalesced,
+        int queueLength,
+        int maxQueueLength,
+        long lastReceivedSequence,
+        long lastDeliveredSequence);
+    ListenerStats() = delete;
+    ListenerStats(const ListenerStats& o) = default;
+    ListenerStats(ListenerStats&& o) noexcept = default;
+    ListenerStats& operator=(const ListenerStats& o) = delete;
+    ListenerStats& operator=(ListenerStats&& o) noexcept = delete;
+    ~ListenerStats() noexcept = default;
+
+    /*
+    Number of Frames received from the Board.
+    */
+    long getReceived() const;
+
+    /*
+    Number of Frames handed to the wrapped BoardListener.
+    */
+    long getDelivered() const;
+
+    /*
+    Number of Frames discarded because of BackpressurePolicy::drop_oldest.
+    */
+    long getDropped() const;
+
+    /*
+    Number of Frames merged into a queued Frame because of BackpressurePolicy::coalesce.
+    */
+    long getCoalesced() const;
+
+    /*
+    Number of Frames waiting in the queue, and the most that have ever waited.
+    */
+    int getQueueLength() const;
+    int getMaxQueueLength() const;
+
+    /*
+    Number of Board Frames between the last Frame received and the last Frame delivered. -1 sequences mean no Frame yet.
+    */
+    long getLag() const;
+
+
+    private:
+
+    const long _received;
+    const long _delivered;
+    const long _dropped;
+    const long _coalesced;
+    const int _queueLength;
+    const int _maxQueueLength;
+    const long _lastReceivedSequence;
+    const long _lastDeliveredSequence;
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef LOCKMODE__H
+#define LOCKMODE__H
+
+/*
+How a ProfiledSharedMutex was locked. exclusive is a unique_lock, shared is a shared_lock.
+*/
+enum class LockMode{
+    exclusive=0,
+    shared=1};
+
+constexpr int lockModeCount = 2;
+
+#endif
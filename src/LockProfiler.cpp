@@ -0,0 +1,437 @@
+#include "LockProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include "TscClock.h"
+
+using namespace std;
+
+namespace
+{
+    using Buckets = array<atomic<uint64_t>, LatencyHistogram::bucketCount>;
+
+    // One thread's counts for one lock class and LockMode.
+    struct ModeCounts
+    {
+        atomic<uint64_t> acquisitions{0};
+        atomic<uint64_t> contended{0};
+        Buckets waitBuckets{};
+        atomic<uint64_t> waitSum{0};
+        atomic<uint64_t> waitMax{0};
+        Buckets holdBuckets{};
+        atomic<uint64_t> holdSum{0};
+        atomic<uint64_t> holdMax{0};
+    };
+
+    constexpr int countsPerShard = LockProfiler::maxLockClasses * lockModeCount;
+
+    // One thread's counts for one contended call site. The key is written before used is set, which is released, so a reader that finds used also finds the key. source_location's strings are literals, so the same call site always has the same file pointer.
+    struct SiteCounts
+    {
+        atomic<bool> used{false};
+        int lockClassId = 0;
+        int mode = 0;
+        const char* file = nullptr;
+        uint_least32_t line = 0;
+        const char* function = nullptr;
+        atomic<uint64_t> contended{0};
+        atomic<uint64_t> totalWait{0};
+        atomic<uint64_t> maxWait{0};
+    };
+
+    // An open addressed table of call sites. A thread that contends at more call sites than fit starts the next table.
+    struct SiteTable
+    {
+        static constexpr size_t capacity = 64;
+        array<SiteCounts, capacity> sites{};
+        atomic<SiteTable*> next{nullptr};
+    };
+
+    // Written by one thread at a time. A ModeCounts is only allocated once its lock class and LockMode are used, and a SiteTable once the thread first contends, since most threads only use a few of them.
+    struct Shard
+    {
+        array<atomic<ModeCounts*>, countsPerShard> counts{};
+        vector<unique_ptr<ModeCounts>> owned{};
+        atomic<SiteTable*> sites{nullptr};
+        vector<unique_ptr<SiteTable>> ownedSites{};
+    };
+
+    // Lock class id, LockMode, file, and line.
+    using SiteKey = tuple<int, int, const char*, uint_least32_t>;
+
+    struct Registry
+    {
+        mutex mux;
+        array<const char*, LockProfiler::maxLockClasses> names{};
+        int lockClassCount = 0;
+        vector<unique_ptr<Shard>> shards{};
+        vector<Shard*> freeShards{};
+
+        const double nanosecondsPerTick = TscClock::getNanosecondsPerTick();
+    };
+
+    Registry& getRegistry()
+    {
+        // Never destroyed, so threads that outlive main() can still record.
+        static Registry* registry = new Registry{};
+        return *registry;
+    }
+
+    // Hands the thread's Shard back to the Registry when the thread exits.
+    struct ShardLease
+    {
+        Shard* shard = nullptr;
+
+        ~ShardLease()
+        {
+            if (shard != nullptr)
+            {
+                Registry& registry = getRegistry();
+                lock_guard<mutex> lock(registry.mux);
+                registry.freeShards.push_back(shard);
+            }
+        }
+    };
+
+    thread_local ShardLease shardLease{};
+
+    ModeCounts& getCountsForThisThread(int lockClassId, LockMode mode)
+    {
+        if (shardLease.shard == nullptr)
+        {
+            Registry& registry = getRegistry();
+            lock_guard<mutex> lock(registry.mux);
+            if (registry.freeShards.empty())
+            {
+                registry.shards.push_back(make_unique<Shard>());
+                shardLease.shard = registry.shards.back().get();
+            }
+            else
+            {
+                shardLease.shard = registry.freeShards.back();
+                registry.freeShards.pop_back();
+            }
+        }
+
+        atomic<ModeCounts*>& slot = shardLease.shard->counts[lockClassId * lockModeCount + static_cast<int>(mode)];
+        ModeCounts* counts = slot.load(memory_order_relaxed);
+        if (counts == nullptr)
+        {
+            shardLease.shard->owned.push_back(make_unique<ModeCounts>());
+            counts = shardLease.shard->owned.back().get();
+            // Released, so a reader that finds the pointer also finds the zeroed counts.
+            slot.store(counts, memory_order_release);
+        }
+        return *counts;
+    }
+
+    SiteCounts& getSiteCountsForThisThread(int lockClassId, LockMode mode, const source_location& site)
+    {
+        // getCountsForThisThread() has already taken the thread's Shard.
+        Shard& shard = *shardLease.shard;
+        size_t hash = (reinterpret_cast<uintptr_t>(site.file_name()) >> 3) * 31 + site.line() * lockModeCount * LockProfiler::maxLockClasses
+            + static_cast<size_t>(lockClassId * lockModeCount) + static_cast<size_t>(mode);
+
+        atomic<SiteTable*>* link = &shard.sites;
+        while (true)
+        {
+            SiteTable* table = link->load(memory_order_relaxed);
+            if (table == nullptr)
+            {
+                shard.ownedSites.push_back(make_unique<SiteTable>());
+                table = shard.ownedSites.back().get();
+                // Released, so a reader that finds the table also finds its empty SiteCounts.
+                link->store(table, memory_order_release);
+            }
+
+            for (size_t probe=0; probe<SiteTable::capacity; ++probe)
+            {
+                SiteCounts& counts = table->sites[(hash + probe) % SiteTable::capacity];
+                if (!counts.used.load(memory_order_relaxed))
+                {
+                    counts.lockClassId = lockClassId;
+                    counts.mode = static_cast<int>(mode);
+                    counts.file = site.file_name();
+                    counts.line = site.line();
+                    counts.function = site.function_name();
+                    counts.used.store(true, memory_order_release);
+                    return counts;
+                }
+                if (counts.file == site.file_name() && counts.line == site.line() &&
+                    counts.lockClassId == lockClassId && counts.mode == static_cast<int>(mode))
+                {
+                    return counts;
+                }
+            }
+            link = &table->next;
+        }
+    }
+
+    // Only one thread writes to a shard at a time, so loads and stores are enough.
+    void increment(atomic<uint64_t>& value, uint64_t by)
+    {
+        value.store(value.load(memory_order_relaxed) + by, memory_order_relaxed);
+    }
+
+    void addToHistogram(Buckets& buckets, atomic<uint64_t>& sum, atomic<uint64_t>& max, uint64_t nanoseconds)
+    {
+        increment(buckets[LatencyHistogram::getBucket(nanoseconds)], 1);
+        increment(sum, nanoseconds);
+        if (nanoseconds > max.load(memory_order_relaxed))
+        {
+            max.store(nanoseconds, memory_order_relaxed);
+        }
+    }
+
+    LatencyHistogram toHistogram(
+        const array<uint64_t, LatencyHistogram::bucketCount>& buckets,
+        uint64_t sum,
+        uint64_t max)
+    {
+        return LatencyHistogram{buckets, static_cast<double>(sum), max};
+    }
+
+    uint64_t toNanoseconds(uint64_t ticks)
+    {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * getRegistry().nanosecondsPerTick);
+    }
+
+    double toMicroseconds(uint64_t nanoseconds)
+    {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    }
+
+    const char* getFileName(const char* path)
+    {
+        const char* slash = strrchr(path, '/');
+        return slash == nullptr ? path : slash + 1;
+    }
+}
+
+int LockProfiler::getLockClassId(const char* name)
+{
+    Registry& registry = getRegistry();
+    lock_guard<mutex> lock(registry.mux);
+    int count = registry.lockClassCount;
+    for (int id=0; id<count; ++id)
+    {
+        if (strcmp(registry.names[id], name) == 0)
+        {
+            return id;
+        }
+    }
+    if (count == maxLockClasses)
+    {
+        throw runtime_error("LockProfiler can not register " + string{name} + ". All " + to_string(maxLockClasses) + " lock classes are taken.");
+    }
+    registry.names[count] = name;
+    registry.lockClassCount = count + 1;
+    return count;
+}
+
+void LockProfiler::recordAcquisition(
+    int lockClassId,
+    LockMode mode,
+    uint64_t waitTicks,
+    bool contended,
+    const source_location& site)
+{
+    ModeCounts& counts = getCountsForThisThread(lockClassId, mode);
+    uint64_t waitNanoseconds = toNanoseconds(waitTicks);
+    increment(counts.acquisitions, 1);
+    addToHistogram(counts.waitBuckets, counts.waitSum, counts.waitMax, waitNanoseconds);
+
+    if (contended)
+    {
+        increment(counts.contended, 1);
+
+        SiteCounts& siteCounts = getSiteCountsForThisThread(lockClassId, mode, site);
+        increment(siteCounts.contended, 1);
+        increment(siteCounts.totalWait, waitNanoseconds);
+        if (waitNanoseconds > siteCounts.maxWait.load(memory_order_relaxed))
+        {
+            siteCounts.maxWait.store(waitNanoseconds, memory_order_relaxed);
+        }
+    }
+}
+
+void LockProfiler::recordHold(int lockClassId, LockMode mode, uint64_t holdTicks)
+{
+    ModeCounts& counts = getCountsForThisThread(lockClassId, mode);
+    addToHistogram(counts.holdBuckets, counts.holdSum, counts.holdMax, toNanoseconds(holdTicks));
+}
+
+vector<LockProfiler::LockClassStats> LockProfiler::getLockClassStats()
+{
+    Registry& registry = getRegistry();
+    lock_guard<mutex> lock(registry.mux);
+    int lockClassCount = registry.lockClassCount;
+
+    vector<LockClassStats> stats(lockClassCount);
+    for (int id=0; id<lockClassCount; ++id)
+    {
+        stats[id].name = registry.names[id];
+        for (int mode=0; mode<lockModeCount; ++mode)
+        {
+            array<uint64_t, LatencyHistogram::bucketCount> waitBuckets{};
+            array<uint64_t, LatencyHistogram::bucketCount> holdBuckets{};
+            uint64_t waitSum = 0;
+            uint64_t waitMax = 0;
+            uint64_t holdSum = 0;
+            uint64_t holdMax = 0;
+            ModeStats& modeStats = stats[id].modes[mode];
+
+            for (const auto& shard : registry.shards)
+            {
+                const ModeCounts* counts = shard->counts[id * lockModeCount + mode].load(memory_order_acquire);
+                if (counts == nullptr)
+                {
+                    continue;
+                }
+                modeStats.acquisitions += counts->acquisitions.load(memory_order_relaxed);
+                modeStats.contended += counts->contended.load(memory_order_relaxed);
+                for (int bucket=0; bucket<LatencyHistogram::bucketCount; ++bucket)
+                {
+                    waitBuckets[bucket] += counts->waitBuckets[bucket].load(memory_order_relaxed);
+                    holdBuckets[bucket] += counts->holdBuckets[bucket].load(memory_order_relaxed);
+                }
+                waitSum += counts->waitSum.load(memory_order_relaxed);
+                waitMax = std::max(waitMax, counts->waitMax.load(memory_order_relaxed));
+                holdSum += counts->holdSum.load(memory_order_relaxed);
+                holdMax = std::max(holdMax, counts->holdMax.load(memory_order_relaxed));
+            }
+
+            modeStats.waits = toHistogram(waitBuckets, waitSum, waitMax);
+            modeStats.holds = toHistogram(holdBuckets, holdSum, holdMax);
+        }
+    }
+    return stats;
+}
+
+vector<LockProfiler::SiteStats> LockProfiler::getTopSites(size_t count)
+{
+    Registry& registry = getRegistry();
+    vector<SiteStats> sites{};
+    {
+        // The same call site may be in the SiteTables of many shards.
+        map<SiteKey, SiteStats> merged{};
+        lock_guard<mutex> lock(registry.mux);
+        for (const auto& shard : registry.shards)
+        {
+            for (const SiteTable* table = shard->sites.load(memory_order_acquire); table != nullptr; table = table->next.load(memory_order_acquire))
+            {
+                for (const SiteCounts& counts : table->sites)
+                {
+                    if (!counts.used.load(memory_order_acquire))
+                    {
+                        continue;
+                    }
+                    SiteStats& site = merged[SiteKey{counts.lockClassId, counts.mode, counts.file, counts.line}];
+                    if (site.lockClass.empty())
+                    {
+                        site.lockClass = registry.names[counts.lockClassId];
+                        site.mode = static_cast<LockMode>(counts.mode);
+                        site.file = counts.file;
+                        site.line = static_cast<int>(counts.line);
+                        site.function = counts.function;
+                    }
+                    site.contended += counts.contended.load(memory_order_relaxed);
+                    site.totalWaitNanoseconds += static_cast<double>(counts.totalWait.load(memory_order_relaxed));
+                    site.maxWaitNanoseconds = std::max(site.maxWaitNanoseconds, counts.maxWait.load(memory_order_relaxed));
+                }
+            }
+        }
+        for (const auto& keyAndSite : merged)
+        {
+            sites.push_back(keyAndSite.second);
+        }
+    }
+
+    sort(sites.begin(), sites.end(), [](const SiteStats& a, const SiteStats& b){
+        return a.totalWaitNanoseconds > b.totalWaitNanoseconds;
+    });
+    if (sites.size() > count)
+    {
+        sites.resize(count);
+    }
+    return sites;
+}
+
+string LockProfiler::getName(LockMode mode)
+{
+    switch (mode)
+    {
+        case LockMode::exclusive:
+            return "exclusive";
+        case LockMode::shared:
+            return "shared";
+    }
+    return "";
+}
+
+void LockProfiler::writeReport(ostream& out, size_t siteCount)
+{
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << fixed << setprecision(2);
+
+    out << "Lock contention report";
+    if (!isCompiledIn())
+    {
+        out << " (lock profiling is not compiled in, configure with -DPLAZA_LOCK_PROFILING=ON)";
+    }
+    out << "\n\n";
+
+    out << left << setw(30) << "lock" << setw(11) << "mode" << right
+        << setw(14) << "acquisitions" << setw(12) << "contended" << setw(13) << "contended_%"
+        << setw(13) << "wait_p50_us" << setw(13) << "wait_p99_us" << setw(13) << "wait_max_us"
+        << setw(15) << "total_wait_ms"
+        << setw(13) << "hold_p50_us" << setw(13) << "hold_p99_us" << setw(13) << "hold_max_us" << "\n";
+
+    for (const LockClassStats& lockClass : getLockClassStats())
+    {
+        for (int mode=0; mode<lockModeCount; ++mode)
+        {
+            const ModeStats& stats = lockClass.modes[mode];
+            if (stats.acquisitions == 0)
+            {
+                continue;
+            }
+            double totalWaitMilliseconds = stats.waits.getMean() * static_cast<double>(stats.waits.getCount()) / 1000000.0;
+            out << left << setw(30) << lockClass.name << setw(11) << getName(static_cast<LockMode>(mode)) << right
+                << setw(14) << stats.acquisitions
+                << setw(12) << stats.contended
+                << setw(13) << 100.0 * static_cast<double>(stats.contended) / static_cast<double>(stats.acquisitions)
+                << setw(13) << toMicroseconds(stats.waits.getPercentile(0.5))
+                << setw(13) << toMicroseconds(stats.waits.getPercentile(0.99))
+                << setw(13) << toMicroseconds(stats.waits.getMax())
+                << setw(15) << totalWaitMilliseconds
+                << setw(13) << toMicroseconds(stats.holds.getPercentile(0.5))
+                << setw(13) << toMicroseconds(stats.holds.getPercentile(0.99))
+                << setw(13) << toMicroseconds(stats.holds.getMax()) << "\n";
+        }
+    }
+
+    out << "\nTop contending call sites, by total wait\n\n";
+    out << left << setw(30) << "lock" << setw(11) << "mode" << right
+        << setw(12) << "contended" << setw(15) << "total_wait_ms" << setw(13) << "wait_max_us"
+        << "  call site\n";
+    for (const SiteStats& site : getTopSites(siteCount))
+    {
+        out << left << setw(30) << site.lockClass << setw(11) << getName(site.mode) << right
+            << setw(12) << site.contended
+            << setw(15) << site.totalWaitNanoseconds / 1000000.0
+            << setw(13) << toMicroseconds(site.maxWaitNanoseconds)
+            << "  " << getFileName(site.file.c_str()) << ":" << site.line << " " << site.function << "\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,107 @@
+#ifndef LOCKPROFILER__H
+#define LOCKPROFILER__H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <source_location>
+#include <string>
+#include <vector>
+#include "LatencyHistogram.h"
+#include "LockMode.h"
+
+/*
+Collects how the Board's, Spots', and Boxes' locks are used, and writes a contention report, to find out which locks are worth removing first.
+
+Locks are grouped into lock classes by name, like "Board::_mux" or "Spot::_mm", so the Board's 360,000 Spot mutexes add up to one row. For each lock class and LockMode it records the number of acquisitions, how many of them were contended (the lock was not free at the first try), a histogram of the time spent waiting, and a histogram of the time the lock was held. For every contended acquisition it also records the call site, so the report can list the call sites that waited the longest in total.
+
+Recordings come from ProfiledUniqueLock and ProfiledSharedLock, which only record in a build configured with -DPLAZA_LOCK_PROFILING=ON. In other builds the locks pay nothing and the report is empty.
+
+Like PhaseLatencies, each thread records into its own shard without a lock. A thread's shard is handed to the next new thread when it exits, so a run that starts a thread per Box keeps only as many shards as there were threads at one time. Contended call sites are counted in the same shard, in a small table keyed by call site, and getTopSites() merges the tables of all the shards.
+*/
+class LockProfiler
+{
+    public:
+
+    // The most lock classes that can be registered.
+    static constexpr int maxLockClasses = 16;
+
+    struct ModeStats
+    {
+        uint64_t acquisitions = 0;
+        uint64_t contended = 0;
+        LatencyHistogram waits{};
+        LatencyHistogram holds{};
+    };
+
+    struct LockClassStats
+    {
+        std::string name{};
+        std::array<ModeStats, lockModeCount> modes{};
+    };
+
+    struct SiteStats
+    {
+        std::string lockClass{};
+        LockMode mode = LockMode::exclusive;
+        std::string file{};
+        int line = 0;
+        std::string function{};
+        uint64_t contended = 0;
+        double totalWaitNanoseconds = 0.0;
+        uint64_t maxWaitNanoseconds = 0;
+    };
+
+    LockProfiler() = delete;
+
+    /*
+    Returns true if ProfiledUniqueLock and ProfiledSharedLock record in this build.
+    */
+    static constexpr bool isCompiledIn()
+    {
+#ifdef PLAZA_LOCK_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*
+    Returns the id of the lock class @name, registering it the first time. @name must be a string literal or otherwise outlive the LockProfiler. Throws a runtime_error if more than maxLockClasses lock classes are registered.
+    */
+    static int getLockClassId(const char* name);
+
+    /*
+    Records one acquisition of a lock of class @lockClassId in @mode after waiting @waitTicks, measured with TscClock. If @contended, the wait is also counted towards the call site @site.
+    */
+    static void recordAcquisition(
+        int lockClassId,
+        LockMode mode,
+        uint64_t waitTicks,
+        bool contended,
+        const std::source_location& site);
+
+    /*
+    Records that a lock of class @lockClassId was held in @mode for @holdTicks, measured with TscClock.
+    */
+    static void recordHold(int lockClassId, LockMode mode, uint64_t holdTicks);
+
+    /*
+    Returns the statistics of every registered lock class, merged over all threads, in the order they were registered.
+    */
+    static std::vector<LockClassStats> getLockClassStats();
+
+    /*
+    Returns up to @count call sites with the longest total wait, longest first.
+    */
+    static std::vector<SiteStats> getTopSites(size_t count);
+
+    static std::string getName(LockMode mode);
+
+    /*
+    Writes a table with a row per lock class and LockMode that was acquired at least once, followed by the @siteCount call sites with the longest total wait. Times are in microseconds, total waits in milliseconds.
+    */
+    static void writeReport(std::ostream& out, size_t siteCount = 10);
+};
+
+#endif
@@ -0,0 +1,713 @@
+#include "LockstepEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include "Decider_Risk1.h"
+#include "Decider_Safe.h"
+#include "NeighbourRanker.h"
+#include "Util.h"
+
+using namespace std;
+
+namespace
+{
+    // Every field of a Target, so Boxes only share a targetId if they are steered alike.
+    using TargetKey = array<intptr_t, 14>;
+
+    TargetKey getTargetKey(const Rectangle& end, const optional<PositionManager::RankingRule>& rule)
+    {
+        TargetKey key{
+            end.getTopLeft().getX(),
+            end.getTopLeft().getY(),
+            end.getBottomRight().getX(),
+            end.getBottomRight().getY()};
+        if (rule)
+        {
+            key[4] = 1;
+            key[5] = reinterpret_cast<intptr_t>(rule->table);
+            key[6] = rule->bounds.minX;
+            key[7] = rule->bounds.maxX;
+            key[8] = rule->bounds.minY;
+            key[9] = rule->bounds.maxY;
+            key[10] = rule->target.getX();
+            key[11] = rule->target.getY();
+            key[12] = reinterpret_cast<intptr_t>(rule->getWaypoint);
+            key[13] = rule->keptCount;
+        }
+        return key;
+    }
+
+    /*
+    NeighbourRanker::rank() needs the neighbours on the Board to be at most maxDistance from their target. They are if the target is inside Bounds that are at most maxDistance + 1 cells each way, and so are the waypoints on the way to it.
+    */
+    bool fitsRank(const PositionManager::RankingRule& rule)
+    {
+        const NeighbourRanker::Bounds& bounds = rule.bounds;
+        return static_cast<int64_t>(bounds.maxX) - bounds.minX <= NeighbourRanker::maxDistance
+            && static_cast<int64_t>(bounds.maxY) - bounds.minY <= NeighbourRanker::maxDistance
+            && rule.target.getX() >= bounds.minX && rule.target.getX() <= bounds.maxX
+            && rule.target.getY() >= bounds.minY && rule.target.getY() <= bounds.maxY;
+    }
+}
+
+double LockstepEngine::Stats::getAgentStepsPerSecond() const
+{
+    return (seconds > 0) ? static_cast<double>(agentSteps) / seconds : 0.0;
+}
+
+LockstepEngine::LockstepEngine(Board& board, vector<BoxPlan>&& plans, int workerCount, uint32_t seed, int tileSize)
+:   _board{board},
+    _workerCount{workerCount},
+    _seed{seed},
+    _tileSize{tileSize},
+    _workerStats(max(workerCount, 1))
+{
+    if (workerCount < 1)
+    {
+        throw invalid_argument("A LockstepEngine needs at least one worker.");
+    }
+    if (tileSize < 0 || tileSize == 1)
+    {
+        throw invalid_argument("A LockstepEngine's tile size must be 0, or 2 or more.");
+    }
+
+    _plans = std::move(plans);
+    _entryTicks.assign(_plans.size(), -1);
+    _exitTicks.assign(_plans.size(), -1);
+    _agents.reserve(static_cast<int>(_plans.size()));
+    map<TargetKey, int> targetIds{};
+    for (int index=0; index<static_cast<int>(_plans.size()); ++index)
+    {
+        const BoxPlan& plan = _plans[index];
+        Target target{plan.positionManager->getEndRect(), plan.positionManager->getRankingRule()};
+        if (target.rule && !fitsRank(*target.rule))
+        {
+            // The Box's own PositionManager ranks its neighbours instead.
+            target.rule.reset();
+        }
+        auto targetId = targetIds.try_emplace(getTargetKey(target.end, target.rule), static_cast<int>(_targets.size())).first;
+        if (targetId->second == static_cast<int>(_targets.size()))
+        {
+            _targets.push_back(target);
+        }
+
+        // 0 is not a DeciderType, and stands for the Box's own Decider.
+        optional<DeciderType> policy = plan.decider->getType();
+
+        _board.getDoorwayFlow().startWaiting(plan.start);
+        int row = _agents.add(
+            plan.boxId,
+            index,
+            plan.start,
+            targetId->second,
+            policy ? static_cast<uint8_t>(*policy) : uint8_t{0});
+        if (target.rule)
+        {
+            // The PositionManager would set its first waypoint at the start Position too.
+            const PositionManager::RankingRule& rule = *target.rule;
+            _agents.setHeading(row, rule.getWaypoint ? rule.getWaypoint(plan.start, rule.target) : rule.target);
+        }
+    }
+    fetchColumns();
+
+    if (_tileSize == 0)
+    {
+        int cellCount = board.getWidth() * board.getHeight();
+        _claims = make_unique<atomic<int>[]>(cellCount);
+        for (int cell=0; cell<cellCount; ++cell)
+        {
+            _claims[cell].store(unclaimed, memory_order_relaxed);
+        }
+        return;
+    }
+
+    _tilesAcross = (board.getWidth() + _tileSize - 1) / _tileSize;
+    _tilesDown = (board.getHeight() + _tileSize - 1) / _tileSize;
+    _tiles.resize(static_cast<size_t>(_tilesAcross) * _tilesDown);
+    for (int tile=0; tile<static_cast<int>(_tiles.size()); ++tile)
+    {
+        int colour = (tile % _tilesAcross) % 2 + 2 * ((tile / _tilesAcross) % 2);
+        _tilesPerColour[colour].push_back(tile);
+    }
+    for (int row=0; row<_agents.size(); ++row)
+    {
+        _tiles[getTile(_agents.getPosition(row))].agents.push_back(row);
+    }
+    for (Tile& tile : _tiles)
+    {
+        sortByBoxId(tile.agents);
+    }
+}
+
+LockstepEngine::~LockstepEngine() noexcept
+{
+    for (int row=0; row<_agents.size(); ++row)
+    {
+        if (_columns.states[row] == AgentState::entering)
+        {
+            _board.getDoorwayFlow().stopWaiting(_agents.getPosition(row));
+        }
+    }
+}
+
+long LockstepEngine::run(long tickLimit, const function<bool(long)>& afterTick)
+{
+    if (_exitedCount.load() == getBoxCount() || _tick >= tickLimit)
+    {
+        return _tick;
+    }
+
+    auto start = chrono::steady_clock::now();
+    bool stop = false;
+    _nextTile.store(0);
+    barrier<PhaseEnd> phaseDone{_workerCount, PhaseEnd{*this, tickLimit, afterTick, stop, 0}};
+
+    // The calling thread is worker 0.
+    vector<thread> workers{};
+    for (int worker=1; worker<_workerCount; ++worker)
+    {
+        workers.emplace_back(
+            &LockstepEngine::runWorker, this, worker, std::ref(phaseDone), std::cref(stop));
+    }
+    runWorker(0, phaseDone, stop);
+    for (thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    _seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return _tick;
+}
+
+long LockstepEngine::getTick() const
+{
+    return _tick;
+}
+
+int LockstepEngine::getBoxCount() const
+{
+    return static_cast<int>(_plans.size());
+}
+
+int LockstepEngine::getExitedCount() const
+{
+    return _exitedCount.load();
+}
+
+int LockstepEngine::getWorkerCount() const
+{
+    return _workerCount;
+}
+
+int LockstepEngine::getTileSize() const
+{
+    return _tileSize;
+}
+
+LockstepEngine::Stats LockstepEngine::getStats() const
+{
+    Stats stats{};
+    stats.ticks = _tick;
+    stats.seconds = _seconds;
+    for (const WorkerStats& worker : _workerStats)
+    {
+        stats.agentSteps += worker.agentSteps;
+        stats.moves += worker.moves;
+        stats.entries += worker.entries;
+        stats.exits += worker.exits;
+        stats.conflicts += worker.conflicts;
+        stats.blocked += worker.blocked;
+        stats.handoffs += worker.handoffs;
+    }
+    return stats;
+}
+
+const AgentTable& LockstepEngine::getAgents() const
+{
+    return _agents;
+}
+
+Rectangle LockstepEngine::getTarget(int targetId) const
+{
+    return _targets.at(targetId).end;
+}
+
+long LockstepEngine::getEntryTick(int index) const
+{
+    return _entryTicks.at(index);
+}
+
+long LockstepEngine::getExitTick(int index) const
+{
+    return _exitTicks.at(index);
+}
+
+void LockstepEngine::PhaseEnd::operator()() noexcept
+{
+    engine._nextTile.store(0, memory_order_relaxed);
+    if (++phase < engine.getPhasesPerTick())
+    {
+        return;
+    }
+    phase = 0;
+    ++engine._tick;
+    engine.compactAgents();
+    stop = engine._exitedCount.load() == engine.getBoxCount()
+        || engine._tick >= tickLimit
+        || (afterTick && !afterTick(engine._tick));
+}
+
+int LockstepEngine::getPhasesPerTick() const
+{
+    return (_tileSize == 0) ? 2 : colourCount;
+}
+
+void LockstepEngine::runWorker(int worker, barrier<PhaseEnd>& phaseDone, const bool& stop)
+{
+    WorkerStats& stats = _workerStats[worker];
+
+    if (_tileSize > 0)
+    {
+        while (!stop)
+        {
+            // Workers take the tiles of a colour one at a time, so a crowded tile does not hold up a whole share.
+            for (const vector<int>& tiles : _tilesPerColour)
+            {
+                int tileCount = static_cast<int>(tiles.size());
+                for (int next = _nextTile.fetch_add(1); next < tileCount; next = _nextTile.fetch_add(1))
+                {
+                    runTile(tiles[next], stats);
+                }
+                phaseDone.arrive_and_wait();
+            }
+        }
+        return;
+    }
+
+    vector<NeighbourRanker::Ranking> rankings{};
+    while (!stop)
+    {
+        // The slices shrink when the table is compacted.
+        int rowCount = _agents.size();
+        int first = static_cast<int>(static_cast<long>(rowCount) * worker / _workerCount);
+        int last = static_cast<int>(static_cast<long>(rowCount) * (worker + 1) / _workerCount);
+
+        // The cells this worker's Boxes won last tick. Their winners stand on them until the apply phase, so no Box claims them in the meantime.
+        for (int cell : stats.wonCells)
+        {
+            _claims[cell].store(unclaimed, memory_order_relaxed);
+        }
+        stats.wonCells.clear();
+
+        Util::setSeed(_seed + static_cast<uint32_t>(_tick * _workerCount + worker));
+        rankRows(first, last, rankings);
+        for (int row=first; row<last; ++row)
+        {
+            propose(row, stats, &rankings[row - first]);
+        }
+        phaseDone.arrive_and_wait();
+
+        for (int row=first; row<last; ++row)
+        {
+            apply(row, stats);
+        }
+        phaseDone.arrive_and_wait();
+    }
+}
+
+void LockstepEngine::runTile(int tile, WorkerStats& stats)
+{
+    Tile& t = _tiles[tile];
+    bool handedOver = false;
+    for (vector<int>& slot : t.inbox)
+    {
+        if (!slot.empty())
+        {
+            t.agents.insert(t.agents.end(), slot.begin(), slot.end());
+            slot.clear();
+            handedOver = true;
+        }
+    }
+    if (handedOver)
+    {
+        sortByBoxId(t.agents);
+    }
+    if (t.agents.empty())
+    {
+        return;
+    }
+
+    Util::setSeed(_seed + static_cast<uint32_t>(_tick * static_cast<long>(_tiles.size()) + tile));
+    size_t kept = 0;
+    for (int row : t.agents)
+    {
+        // A Box handed over earlier in this tick has already acted.
+        if (_columns.actedTicks[row] != _tick)
+        {
+            propose(row, stats, nullptr);
+            apply(row, stats);
+            if (_columns.states[row] == AgentState::exited)
+            {
+                continue;
+            }
+
+            int to = getTile(_agents.getPosition(row));
+            if (to != tile)
+            {
+                // The slot is the direction this tile lies in, seen from tile @to.
+                int deltaX = (tile % _tilesAcross) - (to % _tilesAcross);
+                int deltaY = (tile / _tilesAcross) - (to / _tilesAcross);
+                int direction = (deltaY + 1) * 3 + (deltaX + 1);
+                _tiles[to].inbox[(direction < 4) ? direction : direction - 1].push_back(row);
+                ++stats.handoffs;
+                continue;
+            }
+        }
+        t.agents[kept++] = row;
+    }
+    t.agents.resize(kept);
+}
+
+void LockstepEngine::propose(int row, WorkerStats& stats, const NeighbourRanker::Ranking* ranking)
+{
+    const Columns& c = _columns;
+    if (c.states[row] == AgentState::exited)
+    {
+        return;
+    }
+    if (c.restTicks[row] > 0)
+    {
+        --c.restTicks[row];
+        return;
+    }
+    ++stats.agentSteps;
+    c.actedTicks[row] = _tick;
+
+    Position current = _agents.getPosition(row);
+
+    if (c.states[row] == AgentState::entering)
+    {
+        // Threader::funcMoveBox(): ask the Decider, then try to add the Box.
+        if (!suggestMoveTo(row, current))
+        {
+            _board.getMetrics().count(SimulationCounter::entryRetries);
+            c.restTicks[row] = ++c.waits[row];
+        }
+        else if (!claim(row, current))
+        {
+            _board.getMetrics().count(SimulationCounter::entryRetries);
+            ++stats.blocked;
+        }
+        return;
+    }
+
+    // The Box has rested as its Decider asked. Now it tries the Position the Decider chose.
+    if (c.nextXs[row] >= 0)
+    {
+        Position next = _agents.getNext(row);
+        if (!claim(row, next))
+        {
+            collide(row, next, _board.getOwnedNoteAt(next).getBoxId());
+            ++stats.blocked;
+        }
+        return;
+    }
+
+    if (atEnd(row, current))
+    {
+        c.states[row] = AgentState::exiting;
+        return;
+    }
+
+    FuturePositions futurePositions{};
+    fillFuturePositions(row, current, ranking, futurePositions);
+    pair<Position, int> next = getNext(row, futurePositions.get());
+    if (next.first == Position{-1, -1})
+    {
+        _board.getMetrics().count(SimulationCounter::deciderNoMove);
+        ++stats.blocked;
+    }
+    else if (next.second > 0)
+    {
+        _agents.setNext(row, next.first);
+        c.restTicks[row] = (next.second + tickMs - 1) / tickMs;
+    }
+    else if (!claim(row, next.first))
+    {
+        collide(row, next.first, _board.getOwnedNoteAt(next.first).getBoxId());
+        ++stats.blocked;
+    }
+}
+
+void LockstepEngine::apply(int row, WorkerStats& stats)
+{
+    const Columns& c = _columns;
+    int planIndex = c.planIndexes[row];
+    int boxId = c.boxIds[row];
+    Position current = _agents.getPosition(row);
+
+    if (c.states[row] == AgentState::exiting)
+    {
+        // Mover::removeBox().
+        _board.changeOwnedSpot(current, BoardNote{boxId, MoveType::to_leave}, true);
+        _board.changeOwnedSpot(current, BoardNote{boxId, MoveType::left}, true);
+        _board.getMetrics().count(SimulationCounter::boxesExited);
+        _board.getDoorwayFlow().recordExit(current);
+        c.states[row] = AgentState::exited;
+        _exitTicks[planIndex] = _tick;
+        _exitedCount.fetch_add(1);
+        ++stats.exits;
+        return;
+    }
+
+    // A Box that is resting keeps its next Position until it has rested.
+    if (c.actedTicks[row] != _tick || c.restTicks[row] > 0 || c.nextXs[row] < 0)
+    {
+        return;
+    }
+    Position target = _agents.getNext(row);
+    _agents.setNext(row, Position{-1, -1});
+
+    if (_claims)
+    {
+        int cell = target.getY() * _board.getWidth() + target.getX();
+        int winner = _claims[cell].load(memory_order_relaxed);
+        if (winner != boxId)
+        {
+            collide(row, target, winner);
+            ++stats.conflicts;
+            return;
+        }
+        // The claim is cleared when this worker next proposes, so every loser still reads the winner's boxId.
+        stats.wonCells.push_back(cell);
+    }
+
+    if (c.states[row] == AgentState::entering)
+    {
+        // Mover::addBox(). The Position was empty when it was claimed, and no other Box can take it in the meantime.
+        _board.changeOwnedSpot(target, BoardNote{boxId, MoveType::to_arrive}, false);
+        _board.getMetrics().count(SimulationCounter::boxesEntered);
+        _board.getDoorwayFlow().recordEntry(target);
+        _board.getDoorwayFlow().stopWaiting(target);
+        _board.changeOwnedSpot(target, BoardNote{boxId, MoveType::arrive}, true);
+        c.states[row] = AgentState::onBoard;
+        _entryTicks[planIndex] = _tick;
+        ++stats.entries;
+        return;
+    }
+
+    // Mover::moveBox().
+    _board.changeOwnedSpot(target, BoardNote{boxId, MoveType::to_arrive}, true);
+    _board.changeOwnedSpot(current, BoardNote{boxId, MoveType::to_leave}, true);
+    int deltaX = current.getX() - target.getX();
+    int deltaY = current.getY() - target.getY();
+    bool diagonal = ((deltaX * deltaX) + (deltaY * deltaY)) == 2;
+    _board.getMetrics().count(diagonal ? SimulationCounter::diagonalMoves : SimulationCounter::lateralMoves);
+    _board.changeOwnedSpot(target, BoardNote{boxId, MoveType::arrive}, true);
+    _board.changeOwnedSpot(current, BoardNote{boxId, MoveType::left}, true);
+    _agents.setPosition(row, target);
+    updateHeading(row, target);
+    ++stats.moves;
+}
+
+void LockstepEngine::collide(int row, Position position, int otherBoxId)
+{
+    // Mover::moveBox(): the Box runs into the Box at @position, and both go up a level.
+    ++_columns.levels[row];
+    _board.recordOwnedCollision(position, BoardNote{_columns.boxIds[row], MoveType::to_arrive}, otherBoxId);
+}
+
+bool LockstepEngine::claim(int row, Position position)
+{
+    if (!isEmpty(position))
+    {
+        _agents.setNext(row, Position{-1, -1});
+        return false;
+    }
+    _agents.setNext(row, position);
+    if (!_claims)
+    {
+        return true;
+    }
+
+    // Keeps the lowest boxId that claims the cell.
+    int boxId = _columns.boxIds[row];
+    atomic<int>& cellClaim = _claims[position.getY() * _board.getWidth() + position.getX()];
+    int claimed = cellClaim.load(memory_order_relaxed);
+    while (boxId < claimed && !cellClaim.compare_exchange_weak(claimed, boxId, memory_order_relaxed))
+    {
+    }
+    return true;
+}
+
+void LockstepEngine::rankRows(int first, int last, vector<NeighbourRanker::Ranking>& rankings) const
+{
+    rankings.resize(last - first);
+    const Columns& c = _columns;
+    int runFirst = first;
+    while (runFirst < last)
+    {
+        const optional<PositionManager::RankingRule>& rule = _targets[c.targetIds[runFirst]].rule;
+        if (!rule)
+        {
+            ++runFirst;
+            continue;
+        }
+
+        // Boxes are planned in batches, so long runs of rows share a table and bounds.
+        int runLast = runFirst + 1;
+        for (; runLast < last; ++runLast)
+        {
+            const optional<PositionManager::RankingRule>& next = _targets[c.targetIds[runLast]].rule;
+            if (!next || next->table != rule->table || !(next->bounds == rule->bounds))
+            {
+                break;
+            }
+        }
+
+        size_t count = static_cast<size_t>(runLast - runFirst);
+        NeighbourRanker::rank(
+            c.xs.subspan(runFirst, count),
+            c.ys.subspan(runFirst, count),
+            c.headingXs.subspan(runFirst, count),
+            c.headingYs.subspan(runFirst, count),
+            rule->bounds,
+            rule->table->directions,
+            span<NeighbourRanker::Ranking>(rankings).subspan(runFirst - first, count));
+        runFirst = runLast;
+    }
+}
+
+void LockstepEngine::fillFuturePositions(
+    int row,
+    Position current,
+    const NeighbourRanker::Ranking* ranking,
+    FuturePositions& positions)
+{
+    const Target& target = _targets[_columns.targetIds[row]];
+    if (!target.rule)
+    {
+        _plans[_columns.planIndexes[row]].positionManager->fillFuturePositions(current, positions);
+        return;
+    }
+
+    // What the PositionManager would do, with the Box's heading kept in the AgentTable.
+    const PositionManager::RankingRule& rule = *target.rule;
+    NeighbourRanker::Ranking ranked = (ranking != nullptr)
+        ? *ranking
+        : NeighbourRanker::rankBySector(current, _agents.getHeading(row), rule.bounds, *rule.table);
+    NeighbourRanker::shuffleAfter(ranked, rule.keptCount, Util::getGenerator());
+    NeighbourRanker::getPositions(current, ranked, rule.table->directions, positions);
+}
+
+void LockstepEngine::updateHeading(int row, Position position)
+{
+    const optional<PositionManager::RankingRule>& rule = _targets[_columns.targetIds[row]].rule;
+    if (rule && rule->getWaypoint != nullptr && position == _agents.getHeading(row))
+    {
+        _agents.setHeading(row, rule->getWaypoint(position, rule->target));
+    }
+}
+
+bool LockstepEngine::suggestMoveTo(int row, Position position) const
+{
+    // The Spots next to a Box do not change while it decides.
+    BoardView board = BoardView::owned(_board);
+    switch (static_cast<DeciderType>(_columns.policyIds[row]))
+    {
+        case DeciderType::risk1:
+            return Decider_Risk1::allowsMoveTo(position, board);
+        case DeciderType::safe:
+            return Decider_Safe::allowsMoveTo(position, board);
+    }
+    return _plans[_columns.planIndexes[row]].decider->suggestMoveTo(position, board);
+}
+
+pair<Position, int> LockstepEngine::getNext(int row, span<const Position> possiblePositions) const
+{
+    BoardView board = BoardView::owned(_board);
+    switch (static_cast<DeciderType>(_columns.policyIds[row]))
+    {
+        case DeciderType::risk1:
+            return Decider_Risk1::chooseNext(possiblePositions, board);
+        case DeciderType::safe:
+            return Decider_Safe::chooseNext(possiblePositions, board);
+    }
+    return _plans[_columns.planIndexes[row]].decider->getNext(possiblePositions, board);
+}
+
+bool LockstepEngine::atEnd(int row, Position position) const
+{
+    const Target& target = _targets[_columns.targetIds[row]];
+    return target.rule ? target.end.isInside(position) : _plans[_columns.planIndexes[row]].positionManager->atEnd(position);
+}
+
+void LockstepEngine::compactAgents()
+{
+    int exited = _exitedCount.load(memory_order_relaxed);
+    int uncompacted = exited - _compactedExits;
+    if (uncompacted == 0 || uncompacted * 8 < _agents.size())
+    {
+        return;
+    }
+
+    vector<int> newRows = _agents.compact();
+    _compactedExits = exited;
+    fetchColumns();
+
+    // Exited Boxes have already left their tiles, and the rows keep their order, so each tile stays sorted.
+    for (Tile& tile : _tiles)
+    {
+        for (int& row : tile.agents)
+        {
+            row = newRows[row];
+        }
+        for (vector<int>& slot : tile.inbox)
+        {
+            for (int& row : slot)
+            {
+                row = newRows[row];
+            }
+        }
+    }
+}
+
+void LockstepEngine::fetchColumns()
+{
+    _columns = Columns{
+        _agents.getBoxIds(),
+        _agents.getPlanIndexes(),
+        _agents.getXs(),
+        _agents.getYs(),
+        _agents.getNextXs(),
+        _agents.getHeadingXs(),
+        _agents.getHeadingYs(),
+        _agents.getTargetIds(),
+        _agents.getPolicyIds(),
+        _agents.getStates(),
+        _agents.getRestTicks(),
+        _agents.getWaits(),
+        _agents.getLevels(),
+        _agents.getActedTicks()};
+}
+
+void LockstepEngine::sortByBoxId(vector<int>& rows) const
+{
+    span<const int32_t> boxIds = _agents.getBoxIds();
+    sort(rows.begin(), rows.end(), [boxIds](int a, int b){
+        return boxIds[a] < boxIds[b];
+    });
+}
+
+bool LockstepEngine::isEmpty(Position position) const
+{
+    return _board.getOwnedNoteAt(position).getBoxId() == -1;
+}
+
+int LockstepEngine::getTile(Position position) const
+{
+    return (position.getY() / _tileSize) * _tilesAcross + position.getX() / _tileSize;
+}
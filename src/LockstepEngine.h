@@ -0,0 +1,254 @@
+#ifndef LOCKSTEPENGINE__H
+#define LOCKSTEPENGINE__H
+
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+#include "AgentTable.h"
+#include "Board.h"
+#include "BoxPlan.h"
+#include "FuturePositions.h"
+#include "PositionManager.h"
+#include "Rectangle.h"
+
+/*
+Runs Boxes on a Board in ticks, on a fixed number of worker threads, instead of one free running thread per Box. The work of a tick is split between the workers in one of two ways.
+
+By Box, when the tile size is 0. Every tick has two phases, and all workers finish a phase before any starts the next:
+1) Propose. Every Box that is not resting asks its Decider, with its PositionManager's future Positions, for the Position it wants next, the way Threader::funcMoveBox() does. A Box that has not entered proposes its start Position. Only Positions that are empty at the start of the tick can be proposed. A proposal claims the Position's cell.
+2) Apply. When two Boxes claim the same cell, the Box with the lowest boxId wins. Every winner makes its move on the Board, as a Mover would, and Boxes at their end leave the Board. The losers try again next tick.
+A Box that proposes a taken Position, or loses its claim, runs into the Box that has the cell, as a Mover's failed move would: Board::recordOwnedCollision() counts the collision and raises both Boxes' levels. The Spots do not change during the propose phase, and the apply phase only touches cells that one Box won, so the result of a tick does not depend on the order the workers run in. Each worker owns a contiguous slice of the Boxes and seeds its Util generator every tick from the seed, the tick, and its index, so a run is repeated exactly by the same seed and worker count. Before it proposes, a worker ranks the neighbours of the Boxes in its slice with NeighbourRanker::rank(), straight from the AgentTable's columns, one run of rows with the same RankingRule table and bounds at a time.
+
+By tile, when the tile size is 2 or more. The Board is cut into square tiles, coloured with four colours so that no two tiles of a colour touch, not even at a corner. A tick has four phases, one per colour, and in each phase the workers share out the tiles of that colour. A Box only looks at and moves to the cells next to it, so the tiles of one phase never reach the same cells. The Boxes in a tile act one after another, in boxId order, each deciding and moving before the next, so there are no claims to resolve. A Box that moves into another tile is handed to it through an inbox with a slot per neighbour, and only that neighbour writes the slot. A Box acts once per tick, even if it is handed to a tile whose colour comes later. Util is seeded for each tile every tick, so a run is repeated exactly by the same seed and tile size, whatever the worker count.
+
+The Boxes' state is kept in an AgentTable, a row per Box, which the workers step through in order. Once an eighth of the rows belong to Boxes that have exited, the table is compacted between ticks. The engine steers a Box from the table where it can. If the Box's PositionManager has a RankingRule that NeighbourRanker::rank() can follow on its Board, it is kept in a table of targets under the Box's targetId, and the engine ranks the Box's neighbours with it, heading for the Box's heading. If the Box's Decider follows the rules of a DeciderType, the engine follows them by the Box's policyId. Otherwise it asks the PositionManager or Decider, which stay in the BoxPlans. Either way the Box makes the same moves, and draws the same random numbers.
+
+Either way, the Board's Spots are read with Board::getOwnedNoteAt(), and a Decider is handed an owned BoardView, and they are changed with Board::changeOwnedSpot(). None of these take locks. Call Board::sendStateAndChanges() only between ticks, from afterTick.
+
+A tick stands for the 10ms between a Box's moves. A Decider's suggested wait makes the Box rest that many ticks, rounded up, before it tries the Position the Decider chose. The nth time a Decider keeps a Box from entering, the Box rests n ticks.
+*/
+class LockstepEngine
+{
+    public:
+
+    static constexpr int tickMs = 10;
+    static constexpr int colourCount = 4;
+
+    struct Stats
+    {
+        long ticks;
+        // One per Box per tick in which the Box proposed or left the Board.
+        long agentSteps;
+        long moves;
+        long entries;
+        long exits;
+        // Claims lost to a Box with a lower boxId. Always 0 when split by tile.
+        long conflicts;
+        // Proposals of no Position or of a Position that was taken.
+        long blocked;
+        // Boxes handed from one tile to another.
+        long handoffs;
+        // Wall clock time spent in run().
+        double seconds;
+
+        double getAgentStepsPerSecond() const;
+    };
+
+    /*
+    @board must contain a Box for every BoxPlan's boxId, and none of them may be on @board yet. A @tileSize of 0 splits the work by Box, and a @tileSize of 2 or more splits it by tiles of @tileSize x @tileSize cells.
+
+    Throws an invalid_argument exception if @workerCount is not positive, or if @tileSize is negative or 1.
+    */
+    LockstepEngine(Board& board, std::vector<BoxPlan>&& plans, int workerCount, uint32_t seed, int tileSize = 0);
+    LockstepEngine() = delete;
+    LockstepEngine(const LockstepEngine& o) = delete;
+    LockstepEngine(LockstepEngine&& o) noexcept = delete;
+    LockstepEngine& operator=(const LockstepEngine& o) = delete;
+    LockstepEngine& operator=(LockstepEngine&& o) noexcept = delete;
+    ~LockstepEngine() noexcept;
+
+    /*
+    Runs ticks until every Box has exited, the tick count reaches @tickLimit, or @afterTick returns false. @afterTick, if given, is called with the tick count after every tick, on one thread, while the workers wait. It must not throw. Returns the tick count. Can be called again with a later limit to continue.
+    */
+    long run(long tickLimit, const std::function<bool(long)>& afterTick = nullptr);
+
+    long getTick() const;
+    int getBoxCount() const;
+    int getExitedCount() const;
+    int getWorkerCount() const;
+    int getTileSize() const;
+
+    Stats getStats() const;
+
+    /*
+    Returns the AgentTable of the Boxes that have not exited, or have exited since its last compaction. Only read it between ticks.
+    */
+    const AgentTable& getAgents() const;
+
+    /*
+    Returns the end Rectangle of the Boxes with @targetId in the AgentTable. Throws an out_of_range exception if there is no @targetId.
+    */
+    Rectangle getTarget(int targetId) const;
+
+    /*
+    Returns the tick in which the Box of BoxPlan @index entered or exited the Board, or -1 if it has not.
+    */
+    long getEntryTick(int index) const;
+    long getExitTick(int index) const;
+
+
+    private:
+
+    // The AgentTable's columns, fetched once after every change in its size.
+    struct Columns
+    {
+        std::span<int32_t> boxIds;
+        std::span<int32_t> planIndexes;
+        std::span<int32_t> xs;
+        std::span<int32_t> ys;
+        std::span<int32_t> nextXs;
+        std::span<int32_t> headingXs;
+        std::span<int32_t> headingYs;
+        std::span<int32_t> targetIds;
+        std::span<uint8_t> policyIds;
+        std::span<AgentState> states;
+        std::span<int32_t> restTicks;
+        std::span<int32_t> waits;
+        std::span<int32_t> levels;
+        std::span<int64_t> actedTicks;
+    };
+
+    // What a targetId stands for: where the Box's PositionManager ends, and how it ranks Positions on the way, if the engine can do that itself.
+    struct Target
+    {
+        Rectangle end;
+        std::optional<PositionManager::RankingRule> rule;
+    };
+
+    struct alignas(64) WorkerStats
+    {
+        long agentSteps = 0;
+        long moves = 0;
+        long entries = 0;
+        long exits = 0;
+        long conflicts = 0;
+        long blocked = 0;
+        long handoffs = 0;
+        // Split by Box: the cells this worker's Boxes won in the last apply phase, whose claims are still set.
+        std::vector<int> wonCells{};
+    };
+
+    struct alignas(64) Tile
+    {
+        // Rows of the AgentTable, in boxId order.
+        std::vector<int> agents{};
+        // Boxes handed over by the eight neighbouring tiles, one slot per direction.
+        std::array<std::vector<int>, 8> inbox{};
+    };
+
+    // Ends a phase, on one thread, once every worker has finished it. The last phase of a tick also ends the tick.
+    struct PhaseEnd
+    {
+        LockstepEngine& engine;
+        long tickLimit;
+        const std::function<bool(long)>& afterTick;
+        bool& stop;
+        int phase;
+
+        void operator()() noexcept;
+    };
+
+    static constexpr int unclaimed = std::numeric_limits<int>::max();
+
+    Board& _board;
+    const int _workerCount;
+    const uint32_t _seed;
+    const int _tileSize;
+    std::vector<WorkerStats> _workerStats;
+
+    // By plan index.
+    std::vector<BoxPlan> _plans{};
+    std::vector<long> _entryTicks{};
+    std::vector<long> _exitTicks{};
+
+    std::vector<Target> _targets{};
+    AgentTable _agents{};
+    Columns _columns{};
+    // The exits already compacted out of _agents.
+    int _compactedExits = 0;
+
+    // Split by Box: the lowest boxId claiming each cell.
+    std::unique_ptr<std::atomic<int>[]> _claims{};
+
+    // Split by tile: the tiles in rows, and the indexes of the tiles of each colour.
+    int _tilesAcross = 0;
+    int _tilesDown = 0;
+    std::vector<Tile> _tiles{};
+    std::array<std::vector<int>, colourCount> _tilesPerColour{};
+    std::atomic<int> _nextTile{0};
+
+    long _tick = 0;
+    std::atomic<int> _exitedCount{0};
+    double _seconds = 0.0;
+
+    int getPhasesPerTick() const;
+    void runWorker(int worker, std::barrier<PhaseEnd>& phaseDone, const bool& stop);
+    void runTile(int tile, WorkerStats& stats);
+    /*
+    @ranking, if not null, is the Box's Ranking from rankRows(), if it has a RankingRule.
+    */
+    void propose(int row, WorkerStats& stats, const NeighbourRanker::Ranking* ranking);
+    void apply(int row, WorkerStats& stats);
+
+    /*
+    Makes @position the next Position of the Box at @row and claims its cell, if @position is empty. Returns false if it is not.
+    */
+    bool claim(int row, Position position);
+
+    /*
+    The Box at @row could not move to @position, which the Box with @otherBoxId took. Counts the collision on the Box's row and on the Board, as a Mover's failed move would.
+    */
+    void collide(int row, Position position, int otherBoxId);
+
+    /*
+    Ranks the neighbours of the Boxes in rows @first to @last that have a RankingRule, into @rankings, which it indexes from @first.
+    */
+    void rankRows(int first, int last, std::vector<NeighbourRanker::Ranking>& rankings) const;
+
+    /*
+    Fills @positions with the Positions the Box at @row, at @current, could move to: from @ranking, or its Target's RankingRule, or its PositionManager.
+    */
+    void fillFuturePositions(int row, Position current, const NeighbourRanker::Ranking* ranking, FuturePositions& positions);
+
+    /*
+    Sets the next waypoint of the Box at @row if it heads for waypoints and has reached its heading at @position.
+    */
+    void updateHeading(int row, Position position);
+
+    /*
+    Follow the rules of the policyId of the Box at @row, or ask its Decider.
+    */
+    bool suggestMoveTo(int row, Position position) const;
+    std::pair<Position, int> getNext(int row, std::span<const Position> possiblePositions) const;
+
+    bool atEnd(int row, Position position) const;
+
+    /*
+    Compacts _agents if enough of its Boxes have exited, and renumbers the rows in the tiles.
+    */
+    void compactAgents();
+
+    void fetchColumns();
+    void sortByBoxId(std::vector<int>& rows) const;
+    bool isEmpty(Position position) const;
+    int getTile(Position position) const;
+};
+
+#endif
@@ -37,9 +37,9 @@ vector<Rectangle> MainSetup::getInOutBoundRectangles(int bW, int bH)
 {
     vector<Rectangle> inOut{};
     inOut.push_back(Rectangle{Position{bW/2-50, 0},       Position{bW/2+50, 10}});     // North wall at center
-    inOut.push_back(Rectangle{Position{0, bW/4-25},       Position{10, bW/4+25}});     // West wall at top 
+    inOut.push_back(Rectangle{Position{0, bH/4-25},       Position{10, bH/4+25}});     // West wall at top 
     inOut.push_back(Rectangle{Position{bW-11, bH/4-25},   Position{bW-1, bH/4+25}});   // East wall at top 
-    inOut.push_back(Rectangle{Position{0, bW*3/4-25},     Position{10, bW*3/4+25}});   // West wall at bottom 
+    inOut.push_back(Rectangle{Position{0, bH*3/4-25},     Position{10, bH*3/4+25}});   // West wall at bottom 
     inOut.push_back(Rectangle{Position{bW-11, bH*3/4-25}, Position{bW-1, bH*3/4+25}}); // East wall at bottom
     inOut.push_back(Rectangle{Position{bW*3/4-25, bH-11}, Position{bW*3/4+25, bH-1}}); // South wall at left
     inOut.push_back(Rectangle{Position{bW/4-25, bH-11},   Position{bW/4+25, bH-1}});   // South wall at right 
@@ -0,0 +1,104 @@
+#include "MetricsHud.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+MetricsHud::MetricsHud(
+    SDL_Renderer* renderer,
+    const string& fontPath,
+    int pointSize,
+    const SimulationMetrics& metrics,
+    chrono::milliseconds refresh)
+:   _renderer{renderer},
+    _font{TTF_OpenFont(fontPath.c_str(), pointSize)},
+    _metrics{metrics},
+    _refresh{refresh},
+    _lastSnapshot{metrics.getSnapshot()},
+    _lastRefresh{chrono::steady_clock::now()}
+{
+    if (_font == nullptr)
+    {
+        throw runtime_error("MetricsHud could not open the font " + fontPath + ".");
+    }
+}
+
+MetricsHud::~MetricsHud() noexcept
+{
+    clearLines();
+    TTF_CloseFont(_font);
+}
+
+void MetricsHud::render()
+{
+    if (_lines.empty() || chrono::steady_clock::now() - _lastRefresh >= _refresh)
+    {
+        refresh();
+    }
+
+    // A translucent panel behind the text keeps it readable over the Boxes.
+    int width = 0;
+    int height = 0;
+    for (const Line& line : _lines)
+    {
+        width = max(width, line.width);
+        height += line.height;
+    }
+    SDL_Rect panel{0, 0, width + 8, height + 8};
+    SDL_SetRenderDrawBlendMode(_renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(_renderer, 0xFF, 0xFF, 0xFF, 0xC0);
+    SDL_RenderFillRect(_renderer, &panel);
+
+    int y = 4;
+    for (const Line& line : _lines)
+    {
+        SDL_Rect destination{4, y, line.width, line.height};
+        SDL_RenderCopy(_renderer, line.texture, nullptr, &destination);
+        y += line.height;
+    }
+}
+
+void MetricsHud::setDoorwayFlow(const DoorwayFlow* doorwayFlow)
+{
+    _doorwayFlow = doorwayFlow;
+}
+
+void MetricsHud::refresh()
+{
+    SimulationMetrics::Snapshot snapshot = _metrics.getSnapshot();
+    vector<string> text = SimulationMetrics::getSummaryLines(_lastSnapshot, snapshot);
+    if (_doorwayFlow != nullptr)
+    {
+        vector<string> doorways = DoorwayFlow::getSummaryLines(_doorwayFlow->getRates());
+        text.insert(text.end(), doorways.begin(), doorways.end());
+    }
+    _lastSnapshot = snapshot;
+    _lastRefresh = chrono::steady_clock::now();
+
+    clearLines();
+    SDL_Color black{0x20, 0x20, 0x20, 0xFF};
+    for (const string& str : text)
+    {
+        SDL_Surface* surface = TTF_RenderText_Blended(_font, str.c_str(), black);
+        if (surface == nullptr)
+        {
+            continue;
+        }
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(_renderer, surface);
+        if (texture != nullptr)
+        {
+            _lines.push_back(Line{texture, surface->w, surface->h});
+        }
+        SDL_FreeSurface(surface);
+    }
+}
+
+void MetricsHud::clearLines()
+{
+    for (Line& line : _lines)
+    {
+        SDL_DestroyTexture(line.texture);
+    }
+    _lines.clear();
+}
@@ -0,0 +1,71 @@
+#ifndef METRICSHUD__H
+#define METRICSHUD__H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "SDL.h"
+#include "SDL_ttf.h"
+#include "DoorwayFlow.h"
+#include "SimulationMetrics.h"
+
+/*
+Draws SimulationMetrics over the Board in the top left corner of the window: moves, collisions, retries, and Decider "no move" outcomes per second, and how many Boxes are on the Board.
+
+The text is only rebuilt when the rates are refreshed, every @refresh, so drawing the HUD on every frame costs a few texture copies. Printer draws it last, before presenting.
+*/
+class MetricsHud
+{
+    public:
+
+    /*
+    @metrics must outlive the MetricsHud. Throws a runtime_error exception if the font at @fontPath can not be opened.
+    */
+    MetricsHud(
+        SDL_Renderer* renderer,
+        const std::string& fontPath,
+        int pointSize,
+        const SimulationMetrics& metrics,
+        std::chrono::milliseconds refresh);
+    MetricsHud() = delete;
+    MetricsHud(const MetricsHud& o) = delete;
+    MetricsHud(MetricsHud&& o) noexcept = delete;
+    MetricsHud& operator=(const MetricsHud& o) = delete;
+    MetricsHud& operator=(MetricsHud&& o) noexcept = delete;
+    ~MetricsHud() noexcept;
+
+    /*
+    Draws the HUD on the renderer. Does not present it.
+    */
+    void render();
+
+    /*
+    Adds a line per doorway of @doorwayFlow under the SimulationMetrics, from the next refresh on. nullptr removes them. @doorwayFlow must outlive the MetricsHud.
+    */
+    void setDoorwayFlow(const DoorwayFlow* doorwayFlow);
+
+
+    private:
+
+    struct Line
+    {
+        SDL_Texture* texture;
+        int width;
+        int height;
+    };
+
+    SDL_Renderer* _renderer;
+    TTF_Font* _font;
+    const SimulationMetrics& _metrics;
+    const std::chrono::milliseconds _refresh;
+    const DoorwayFlow* _doorwayFlow = nullptr;
+
+    SimulationMetrics::Snapshot _lastSnapshot;
+    std::chrono::steady_clock::time_point _lastRefresh;
+    std::vector<Line> _lines{};
+
+    void refresh();
+    void clearLines();
+};
+
+#endif
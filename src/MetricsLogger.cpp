@@ -0,0 +1,74 @@
+#include "MetricsLogger.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+MetricsLogger::MetricsLogger(
+    const SimulationMetrics& metrics,
+    const string& path,
+    chrono::milliseconds interval)
+:   _metrics{metrics},
+    _interval{interval},
+    _json{path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0},
+    _out{path}
+{
+    if (interval.count() <= 0)
+    {
+        throw invalid_argument("A MetricsLogger's interval must be positive.");
+    }
+    if (!_out)
+    {
+        throw runtime_error("MetricsLogger could not open " + path + ".");
+    }
+    if (!_json)
+    {
+        SimulationMetrics::writeCsvHeader(_out);
+    }
+
+    // Start the logging thread last, once all the attributes are set.
+    _logger = thread(&MetricsLogger::log, this);
+}
+
+MetricsLogger::~MetricsLogger() noexcept
+{
+    {
+        lock_guard<mutex> lock(_mux);
+        _stopping = true;
+    }
+    _stop.notify_all();
+    _logger.join();
+
+    lock_guard<mutex> lock(_mux);
+    write();
+}
+
+int MetricsLogger::getWrittenCount() const
+{
+    lock_guard<mutex> lock(_mux);
+    return _written;
+}
+
+void MetricsLogger::log()
+{
+    unique_lock<mutex> lock(_mux);
+    while (!_stop.wait_for(lock, _interval, [this]{ return _stopping; }))
+    {
+        write();
+    }
+}
+
+void MetricsLogger::write()
+{
+    SimulationMetrics::Snapshot snapshot = _metrics.getSnapshot();
+    if (_json)
+    {
+        SimulationMetrics::writeJson(_out, snapshot);
+    }
+    else
+    {
+        SimulationMetrics::writeCsvRow(_out, snapshot);
+    }
+    _out.flush();
+    ++_written;
+}
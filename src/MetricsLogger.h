@@ -0,0 +1,60 @@
+#ifndef METRICSLOGGER__H
+#define METRICSLOGGER__H
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "SimulationMetrics.h"
+
+/*
+Writes a SimulationMetrics Snapshot to a file at a fixed interval, on its own thread.
+
+A file whose name ends in ".json" gets one JSON object per line. Any other file gets CSV with a header row. A last Snapshot is written when the MetricsLogger is destroyed, so the file always ends with the final counts.
+*/
+class MetricsLogger
+{
+    public:
+
+    /*
+    @metrics must outlive the MetricsLogger. Throws a runtime_error exception if @path can not be opened, and an invalid_argument exception if @interval is not positive.
+    */
+    MetricsLogger(const SimulationMetrics& metrics, const std::string& path, std::chrono::milliseconds interval);
+    MetricsLogger() = delete;
+    MetricsLogger(const MetricsLogger& o) = delete;
+    MetricsLogger(MetricsLogger&& o) noexcept = delete;
+    MetricsLogger& operator=(const MetricsLogger& o) = delete;
+    MetricsLogger& operator=(MetricsLogger&& o) noexcept = delete;
+
+    /*
+    Writes the last Snapshot and stops the logging thread.
+    */
+    ~MetricsLogger() noexcept;
+
+    /*
+    Returns how many Snapshots have been written.
+    */
+    int getWrittenCount() const;
+
+
+    private:
+
+    const SimulationMetrics& _metrics;
+    const std::chrono::milliseconds _interval;
+    const bool _json;
+    std::ofstream _out;
+
+    int _written = 0;
+    bool _stopping = false;
+    mutable std::mutex _mux;
+    std::condition_variable _stop;
+
+    std::thread _logger;
+
+    void log();
+    void write();
+};
+
+#endif
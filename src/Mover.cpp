@@ -1,5 +1,7 @@
 #include "Mover.h"
 #include <thread> 
+#include "Tracer.h"
+#include "TscClock.h"
 
 using namespace std;
 
@@ -15,22 +17,26 @@ bool Mover::moveBox(Position oldPosition, Position newPosition)
     bool success = _board->changeSpot(newPosition, BoardNote{_boxId, MoveType::to_arrive}, true);
     if (success)
     {
+        PLAZA_TRACE_SPAN("move", _boxId);
+        uint64_t holdStart = TscClock::now();
         _board->changeSpot(oldPosition, BoardNote{_boxId, MoveType::to_leave}, true);
 
         int deltaX = oldPosition.getX() - newPosition.getX();
         int deltaY = oldPosition.getY() - newPosition.getY(); 
         if( ( (deltaX * deltaX) + (deltaY * deltaY)) == 2 )
         {
+           _board->getMetrics().count(SimulationCounter::diagonalMoves);
            sleepForDiagonalMove(); 
         }
         else
         {
+           _board->getMetrics().count(SimulationCounter::lateralMoves);
            sleepForLateralMove();
         }
 
         _board->changeSpot(newPosition, BoardNote{_boxId, MoveType::arrive}, true);
         _board->changeSpot(oldPosition, BoardNote{_boxId, MoveType::left}, true);
-    
+        _board->getLatencies().recordSince(StepPhase::holdingTwoSpots, holdStart);
     }
    
     return success;
@@ -42,6 +48,9 @@ bool Mover::addBox(Position position)
 
     if (success)
     {
+        PLAZA_TRACE_SPAN("add", _boxId);
+        _board->getMetrics().count(SimulationCounter::boxesEntered);
+        _board->getDoorwayFlow().recordEntry(position);
         this_thread::sleep_for(5ms);
         _board->changeSpot(position, BoardNote{_boxId, MoveType::arrive}, true);
     }
@@ -55,6 +64,11 @@ bool Mover::removeBox(Position position)
 
     success = _board->changeSpot(position, BoardNote{_boxId, MoveType::to_leave}, true);
     success = _board->changeSpot(position, BoardNote{_boxId, MoveType::left}, true);
+    if (success)
+    {
+        _board->getMetrics().count(SimulationCounter::boxesExited);
+        _board->getDoorwayFlow().recordExit(position);
+    }
 
     return success;
 }
@@ -0,0 +1,272 @@
+#include "NeighbourRanker.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+namespace
+{
+    // Agents ranked together. Their keys for one direction fill a few vector registers.
+    constexpr int blockSize = 16;
+
+    // The key of a direction that is off the Board, without its index. It sorts after every distance up to maxDistance in x and in y: (2 * 8191^2) << 3 is below 2^30.
+    constexpr int32_t offBoard = int32_t{1} << 30;
+    static_assert(((2 * NeighbourRanker::maxDistance * NeighbourRanker::maxDistance) << 3 | 7) < offBoard);
+
+    // The optimal sorting network for eight keys, in six layers of independent compare and swaps.
+    constexpr array<pair<int, int>, 19> network{{
+        {0, 2}, {1, 3}, {4, 6}, {5, 7},
+        {0, 4}, {1, 5}, {2, 6}, {3, 7},
+        {0, 1}, {2, 3}, {4, 5}, {6, 7},
+        {2, 4}, {3, 5},
+        {1, 4}, {3, 6},
+        {1, 2}, {3, 4}, {5, 6}}};
+
+    /*
+    The rows are constants, so the compiler knows the two rows are different and does the swaps for many agents at once.
+    */
+    template<int first, int second, int count>
+    void compareAndSwap(int32_t (&keys)[NeighbourRanker::directionCount][count])
+    {
+        for (int i=0; i<count; ++i)
+        {
+            int32_t low = min(keys[first][i], keys[second][i]);
+            int32_t high = max(keys[first][i], keys[second][i]);
+            keys[first][i] = low;
+            keys[second][i] = high;
+        }
+    }
+
+    template<int count, size_t... compare>
+    void sortKeys(int32_t (&keys)[NeighbourRanker::directionCount][count], index_sequence<compare...>)
+    {
+        (compareAndSwap<network[compare].first, network[compare].second, count>(keys), ...);
+    }
+
+    /*
+    Ranks @count agents. @count is a constant, so the compiler can unroll and vectorise the loops over the agents: a whole block, or one agent at a time. Returns false if a neighbour on the Board is more than maxDistance from its target in x or in y, in which case the rankings are not valid.
+    */
+    template<int count>
+    bool rankBlock(
+        const int32_t* xs,
+        const int32_t* ys,
+        const int32_t* targetXs,
+        const int32_t* targetYs,
+        const NeighbourRanker::Bounds& bounds,
+        const NeighbourRanker::Directions& directions,
+        NeighbourRanker::Ranking* rankings)
+    {
+        // keys[d][i] is the key of direction d of agent i, and after the network, the key ranked d.
+        int32_t keys[NeighbourRanker::directionCount][count];
+        uint32_t validMasks[count]{};
+        int32_t tooFar = 0;
+        for (int d=0; d<NeighbourRanker::directionCount; ++d)
+        {
+            int32_t dx = directions.dxs[d];
+            int32_t dy = directions.dys[d];
+            for (int i=0; i<count; ++i)
+            {
+                int32_t x = xs[i] + dx;
+                int32_t y = ys[i] + dy;
+                int32_t distX = x - targetXs[i];
+                int32_t distY = y - targetYs[i];
+                int32_t outside = (x < bounds.minX) | (x > bounds.maxX) | (y < bounds.minY) | (y > bounds.maxY);
+                int32_t far = (distX > NeighbourRanker::maxDistance) | (distX < -NeighbourRanker::maxDistance)
+                    | (distY > NeighbourRanker::maxDistance) | (distY < -NeighbourRanker::maxDistance);
+                tooFar |= far & (outside ^ 1);
+                // Unsigned, so the distance of a neighbour that is too far, or off the Board and not used, wraps instead of overflowing.
+                uint32_t unsignedX = static_cast<uint32_t>(distX);
+                uint32_t unsignedY = static_cast<uint32_t>(distY);
+                int32_t onBoardKey = static_cast<int32_t>((unsignedX * unsignedX + unsignedY * unsignedY) << 3);
+                keys[d][i] = (outside ? offBoard : onBoardKey) | d;
+                validMasks[i] |= static_cast<uint32_t>(outside ^ 1) << d;
+            }
+        }
+
+        sortKeys(keys, make_index_sequence<network.size()>{});
+
+        uint32_t orders[count]{};
+        for (int r=0; r<NeighbourRanker::directionCount; ++r)
+        {
+            for (int i=0; i<count; ++i)
+            {
+                orders[i] |= static_cast<uint32_t>(keys[r][i] & 7) << (4 * r);
+            }
+        }
+        for (int i=0; i<count; ++i)
+        {
+            rankings[i] = NeighbourRanker::Ranking{orders[i], static_cast<uint8_t>(validMasks[i])};
+        }
+        return tooFar == 0;
+    }
+
+    void throwTooFar()
+    {
+        throw invalid_argument(
+            "NeighbourRanker::rank() needs every neighbour on the Board to be at most "
+            + to_string(NeighbourRanker::maxDistance) + " cells from its target in x and in y.");
+    }
+}
+
+int NeighbourRanker::Ranking::getCount() const
+{
+    return popcount(validMask);
+}
+
+int NeighbourRanker::Ranking::getDirection(int rank) const
+{
+    return static_cast<int>((order >> (4 * rank)) & 0xF);
+}
+
+void NeighbourRanker::rank(
+    span<const int32_t> xs,
+    span<const int32_t> ys,
+    span<const int32_t> targetXs,
+    span<const int32_t> targetYs,
+    const Bounds& bounds,
+    const Directions& directions,
+    span<Ranking> rankings)
+{
+    size_t count = xs.size();
+    if (ys.size() != count || targetXs.size() != count || targetYs.size() != count || rankings.size() != count)
+    {
+        throw invalid_argument("NeighbourRanker::rank() needs spans of the same size.");
+    }
+
+    bool near = true;
+    size_t first = 0;
+    for (; first+blockSize<=count; first+=blockSize)
+    {
+        near &= rankBlock<blockSize>(
+            xs.data() + first,
+            ys.data() + first,
+            targetXs.data() + first,
+            targetYs.data() + first,
+            bounds,
+            directions,
+            rankings.data() + first);
+    }
+    for (; first<count; ++first)
+    {
+        near &= rankBlock<1>(
+            xs.data() + first,
+            ys.data() + first,
+            targetXs.data() + first,
+            targetYs.data() + first,
+            bounds,
+            directions,
+            rankings.data() + first);
+    }
+    if (!near)
+    {
+        throwTooFar();
+    }
+}
+
+NeighbourRanker::Ranking NeighbourRanker::rank(
+    Position position,
+    Position target,
+    const Bounds& bounds,
+    const Directions& directions)
+{
+    int32_t x = position.getX();
+    int32_t y = position.getY();
+    int32_t targetX = target.getX();
+    int32_t targetY = target.getY();
+    Ranking ranking{};
+    if (!rankBlock<1>(&x, &y, &targetX, &targetY, bounds, directions, &ranking))
+    {
+        throwTooFar();
+    }
+    return ranking;
+}
+
+NeighbourRanker::Ranking NeighbourRanker::rankBySector(
+    Position position,
+    Position target,
+    const Bounds& bounds,
+    const DirectionTable& table)
+{
+    int32_t x = position.getX();
+    int32_t y = position.getY();
+    uint32_t order = table.orders[getSector(target.getX() - x, target.getY() - y)];
+
+    // A direction is on the Board if both its column and its row are.
+    uint32_t columns = 0;
+    uint32_t rows = 0;
+    for (int step=-1; step<=1; ++step)
+    {
+        columns |= (x + step >= bounds.minX && x + step <= bounds.maxX) ? table.columnMasks[step + 1] : 0;
+        rows |= (y + step >= bounds.minY && y + step <= bounds.maxY) ? table.rowMasks[step + 1] : 0;
+    }
+    uint32_t validMask = columns & rows;
+    if (validMask == 0xFF)
+    {
+        return Ranking{order, 0xFF};
+    }
+
+    // Move the directions off the Board to the back, keeping the order of the others.
+    uint32_t onBoardOrder = 0;
+    uint32_t offBoardOrder = 0;
+    int onBoardCount = 0;
+    int offBoardCount = 0;
+    for (int r=0; r<directionCount; ++r)
+    {
+        uint32_t d = (order >> (4 * r)) & 0xF;
+        if ((validMask >> d) & 1)
+        {
+            onBoardOrder |= d << (4 * onBoardCount++);
+        }
+        else
+        {
+            offBoardOrder |= d << (4 * offBoardCount++);
+        }
+    }
+    return Ranking{onBoardOrder | ((offBoardCount > 0) ? offBoardOrder << (4 * onBoardCount) : 0), static_cast<uint8_t>(validMask)};
+}
+
+void NeighbourRanker::shuffleAfter(Ranking& ranking, int keptCount, mt19937& generator)
+{
+    int count = ranking.getCount();
+    if (keptCount >= count)
+    {
+        return;
+    }
+
+    array<uint32_t, directionCount> ranked{};
+    for (int r=0; r<count; ++r)
+    {
+        ranked[r] = static_cast<uint32_t>(ranking.getDirection(r));
+    }
+    shuffle(ranked.begin() + keptCount, ranked.begin() + count, generator);
+    for (int r=keptCount; r<count; ++r)
+    {
+        ranking.order = (ranking.order & ~(uint32_t{0xF} << (4 * r))) | (ranked[r] << (4 * r));
+    }
+}
+
+vector<Position> NeighbourRanker::getPositions(Position position, const Ranking& ranking, const Directions& directions)
+{
+    FuturePositions positions{};
+    getPositions(position, ranking, directions, positions);
+    return vector<Position>(positions.get().begin(), positions.get().end());
+}
+
+void NeighbourRanker::getPositions(
+    Position position,
+    const Ranking& ranking,
+    const Directions& directions,
+    FuturePositions& positions)
+{
+    positions.clear();
+    int count = ranking.getCount();
+    for (int r=0; r<count; ++r)
+    {
+        int d = ranking.getDirection(r);
+        positions.push_back(Position{position.getX() + directions.dxs[d], position.getY() + directions.dys[d]});
+    }
+}
@@ -0,0 +1,206 @@
+#ifndef NEIGHBOURRANKER__H
+#define NEIGHBOURRANKER__H
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+#include "FuturePositions.h"
+#include "Position.h"
+
+/*
+Ranks the eight Positions next to each of many agents by their squared distance to the agent's target, the way PositionManager_Step and PositionManager_Diagonal order their future Positions.
+
+The work is done in blocks of agents, one direction at a time. The squared distances are 32 bit integers, so every neighbour on the Board must be at most maxDistance cells from its agent's target in x and in y, and rank() throws if one is not. That holds for any target inside Bounds of at most maxDistance + 1 cells each way. Each is packed into a key with the direction's index in the low bits, so no two keys of an agent are equal and of two neighbours at the same distance the earlier direction comes first. That tie-break is deliberate and new: the PositionManagers used to call std::sort, which leaves the order of equal distances unspecified. Positions off the Board get keys above all others. The eight keys are then put in order by a fixed sorting network of 19 compare and swaps, each one a min and a max over the whole block, with no branches. The compiler can vectorise every loop.
+
+The ranking of one agent is a Ranking: the directions from nearest to farthest, a nibble each, and a bit mask of the directions that are on the Board. Like the PositionManagers, call shuffleAfter() to put the directions after the top three in a random order. It draws the same numbers from the generator as shuffling the Positions would.
+
+A Directions gives the x and y offset of each direction. The PositionManagers each name their directions in their own order, and that order breaks ties.
+
+The ranking of one agent needs no sort at all. Comparing the squared distances of two neighbours to the target comes down to the sign of a dot product of the vector to the target with one of eight small vectors. Those dot products are 0 on 16 rays, at multiples of the angles of {1, 0}, {2, 1} and {1, 1}. So the whole order is the same for every target in one of 32 sectors: a ray, or the open wedge between two rays. A 33rd sector is a target at the agent's own Position. makeDirectionTable() works out the order of every sector at compile time, and rankBySector() looks it up and drops the neighbours that are off the Board, without floating point or sorting.
+*/
+class NeighbourRanker
+{
+    public:
+
+    static constexpr int directionCount = 8;
+
+    // The furthest, in x or in y, a neighbour on the Board can be from its target for rank().
+    static constexpr int32_t maxDistance = 8191;
+
+    struct Directions
+    {
+        std::array<int32_t, directionCount> dxs;
+        std::array<int32_t, directionCount> dys;
+    };
+
+    // Inclusive, like the PositionManagers' board limits.
+    struct Bounds
+    {
+        int32_t minX;
+        int32_t maxX;
+        int32_t minY;
+        int32_t maxY;
+
+        bool operator==(const Bounds& o) const = default;
+    };
+
+    struct Ranking
+    {
+        // Nibble r is the index of the direction ranked r. The directions off the Board come last.
+        uint32_t order;
+        // Bit d is set if direction d is on the Board.
+        uint8_t validMask;
+
+        int getCount() const;
+        int getDirection(int rank) const;
+    };
+
+    static constexpr int sectorCount = 33;
+
+    // The order of all eight directions for a target in each sector.
+    struct DirectionTable
+    {
+        Directions directions;
+        std::array<uint32_t, sectorCount> orders;
+        // The directions that step -1, 0 and +1 in x, and in y, as bit masks.
+        std::array<uint8_t, 3> columnMasks;
+        std::array<uint8_t, 3> rowMasks;
+    };
+
+    NeighbourRanker() = delete;
+
+    /*
+    Ranks the neighbours of agent i, at {@xs[i], @ys[i]}, by their distance to {@targetXs[i], @targetYs[i]}, and writes the result to @rankings[i]. The columns can be an AgentTable's.
+
+    Throws an invalid_argument exception if the spans are not all the same size, or if a neighbour on the Board is more than maxDistance from its target in x or in y.
+    */
+    static void rank(
+        std::span<const int32_t> xs,
+        std::span<const int32_t> ys,
+        std::span<const int32_t> targetXs,
+        std::span<const int32_t> targetYs,
+        const Bounds& bounds,
+        const Directions& directions,
+        std::span<Ranking> rankings);
+
+    /*
+    Ranks the neighbours of one agent at @position. Throws an invalid_argument exception as rank() does.
+    */
+    static Ranking rank(Position position, Position target, const Bounds& bounds, const Directions& directions);
+
+    /*
+    Returns the sector of a target @dx and @dy away: 2k on ray k, and 2k + 1 between rays k and k + 1, counting the rays anticlockwise from {1, 0}. Returns 32 if @dx and @dy are 0.
+    */
+    static constexpr int getSector(int32_t dx, int32_t dy);
+
+    /*
+    Ranks the directions for a target in each sector. Meant to run at compile time, once per Directions.
+    */
+    static constexpr DirectionTable makeDirectionTable(const Directions& directions);
+
+    /*
+    Returns the same Ranking as rank(), from @table.
+    */
+    static Ranking rankBySector(Position position, Position target, const Bounds& bounds, const DirectionTable& table);
+
+    /*
+    Shuffles the directions of @ranking that come after the first @keptCount valid ones. Directions off the Board stay last.
+    */
+    static void shuffleAfter(Ranking& ranking, int keptCount, std::mt19937& generator);
+
+    /*
+    Returns the Positions next to @position that are on the Board, in the order of @ranking.
+    */
+    static std::vector<Position> getPositions(Position position, const Ranking& ranking, const Directions& directions);
+
+    /*
+    Like getPositions(), but fills @positions instead of allocating a vector.
+    */
+    static void getPositions(Position position, const Ranking& ranking, const Directions& directions, FuturePositions& positions);
+
+
+    private:
+
+    // Rays 0 to 7, anticlockwise from {1, 0}. Rays 8 to 15 point the opposite way.
+    static constexpr std::array<std::array<int32_t, 2>, 8> halfTurnRays{{
+        {1, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 1}, {-1, 2}, {-1, 1}, {-2, 1}}};
+
+    static constexpr std::array<int32_t, 2> getRay(int ray);
+};
+
+constexpr int NeighbourRanker::getSector(int32_t dx, int32_t dy)
+{
+    if (dx == 0 && dy == 0)
+    {
+        return sectorCount - 1;
+    }
+
+    // Turn a target in the lower half a half turn, so it can be compared with rays 0 to 7.
+    bool lower = (dy < 0) || (dy == 0 && dx < 0);
+    int32_t x = lower ? -dx : dx;
+    int32_t y = lower ? -dy : dy;
+    int raysBefore = 0;
+    bool onRay = false;
+    for (const std::array<int32_t, 2>& ray : halfTurnRays)
+    {
+        int64_t cross = static_cast<int64_t>(ray[0]) * y - static_cast<int64_t>(ray[1]) * x;
+        raysBefore += (cross > 0) ? 1 : 0;
+        onRay = onRay || (cross == 0);
+    }
+    return (lower ? 16 : 0) + 2 * raysBefore - (onRay ? 0 : 1);
+}
+
+constexpr std::array<int32_t, 2> NeighbourRanker::getRay(int ray)
+{
+    const std::array<int32_t, 2>& halfTurnRay = halfTurnRays[ray % 8];
+    return (ray < 8) ? halfTurnRay : std::array<int32_t, 2>{-halfTurnRay[0], -halfTurnRay[1]};
+}
+
+constexpr NeighbourRanker::DirectionTable NeighbourRanker::makeDirectionTable(const Directions& directions)
+{
+    DirectionTable table{directions, {}, {}, {}};
+    for (int d=0; d<directionCount; ++d)
+    {
+        table.columnMasks[directions.dxs[d] + 1] |= static_cast<uint8_t>(1 << d);
+        table.rowMasks[directions.dys[d] + 1] |= static_cast<uint8_t>(1 << d);
+    }
+
+    for (int sector=0; sector<sectorCount; ++sector)
+    {
+        // Any target in the sector ranks the directions the same way. Take a ray itself, or the sum of the two rays around a wedge.
+        std::array<int32_t, 2> target{0, 0};
+        if (sector < sectorCount - 1)
+        {
+            std::array<int32_t, 2> ray = getRay(sector / 2);
+            std::array<int32_t, 2> nextRay = getRay((sector / 2 + 1) % 16);
+            target = (sector % 2 == 0) ? ray : std::array<int32_t, 2>{ray[0] + nextRay[0], ray[1] + nextRay[1]};
+        }
+
+        // The keys of rank(), put in order with an insertion sort.
+        std::array<int32_t, directionCount> keys{};
+        for (int d=0; d<directionCount; ++d)
+        {
+            int32_t distX = directions.dxs[d] - target[0];
+            int32_t distY = directions.dys[d] - target[1];
+            int32_t key = ((distX * distX + distY * distY) << 3) | d;
+            int r = d;
+            for (; r>0 && keys[r - 1] > key; --r)
+            {
+                keys[r] = keys[r - 1];
+            }
+            keys[r] = key;
+        }
+
+        uint32_t order = 0;
+        for (int r=0; r<directionCount; ++r)
+        {
+            order |= static_cast<uint32_t>(keys[r] & 7) << (4 * r);
+        }
+        table.orders[sector] = order;
+    }
+    return table;
+}
+
+#endif
@@ -1,16 +1,78 @@
 #include "NoteAccountant.h"
 
+#include <algorithm>
+#include "TscClock.h"
+
 using namespace std;
 
-NoteAccountant::NoteAccountant() {}
+NoteAccountant::Shard::~Shard() noexcept
+{
+    Chunk* chunk = head;
+    while (chunk != nullptr)
+    {
+        Chunk* next = chunk->next.load(memory_order_relaxed);
+        delete chunk;
+        chunk = next;
+    }
+}
 
 void NoteAccountant::callback(BoardNote boardNote)
 {
-    _receivedBoardNotes.push_back({std::chrono::high_resolution_clock::now(), boardNote});
+    uint64_t ticks = TscClock::now();
+    append(_shards.getForThisThread(), ticks, boardNote);
 }
 
-std::vector<std::pair< std::chrono::time_point<std::chrono::high_resolution_clock>, BoardNote >> NoteAccountant::getNotes() const
+vector<pair<chrono::time_point<chrono::high_resolution_clock>, BoardNote>> NoteAccountant::getNotes() const
 {
-    return _receivedBoardNotes;
+    vector<Entry> entries{};
+    _shards.visitAll([&entries](const vector<unique_ptr<Shard>>& shards){
+        for (const auto& shard : shards)
+        {
+            size_t size = shard->size.load(memory_order_acquire);
+            const Chunk* chunk = (size > 0) ? shard->head : nullptr;
+            for (size_t ii=0; ii<size; ++ii)
+            {
+                if (ii > 0 && ii % Chunk::capacity == 0)
+                {
+                    chunk = chunk->next.load(memory_order_acquire);
+                }
+                entries.push_back(chunk->entries[ii % Chunk::capacity]);
+            }
+        }
+    });
+
+    // Each shard is already in order, so a stable sort keeps one thread's BoardNotes in the order they were sent.
+    stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b){
+        return a.ticks < b.ticks;
+    });
+
+    vector<pair<chrono::time_point<chrono::high_resolution_clock>, BoardNote>> notes{};
+    notes.reserve(entries.size());
+    for (const Entry& entry : entries)
+    {
+        notes.push_back({TscClock::toTimePoint(entry.ticks), BoardNote{entry.boxId, entry.type}});
+    }
+    return notes;
 }
 
+void NoteAccountant::append(Shard& shard, uint64_t ticks, BoardNote boardNote)
+{
+    size_t size = shard.size.load(memory_order_relaxed);
+    size_t slot = size % Chunk::capacity;
+    if (slot == 0)
+    {
+        Chunk* chunk = new Chunk{};
+        if (shard.tail == nullptr)
+        {
+            // getNotes() only reads head once size is above zero, which is published below.
+            shard.head = chunk;
+        }
+        else
+        {
+            shard.tail->next.store(chunk, memory_order_release);
+        }
+        shard.tail = chunk;
+    }
+    shard.tail->entries[slot] = Entry{ticks, boardNote.getBoxId(), boardNote.getType()};
+    shard.size.store(size + 1, memory_order_release);
+}
@@ -1,16 +1,26 @@
 #ifndef NOTEACCOUNTANT__H
 #define NOTEACCOUNTANT__H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include "BoardNote.h"
 #include "NoteSubscriber.h"
+#include "ThreadShards.h"
 
+/*
+A NoteSubscriber that saves every BoardNote it receives with the time it was received.
 
+callback() is called by the Mover threads from inside Board::changeSpot(), so it has to be safe and cheap for many threads at once. Each thread appends to its own shard, which no other thread writes to, and stamps the BoardNote with TscClock. Appending takes no lock. Only the first callback() from a new thread takes a lock, to find that thread's shard. Shards come from ThreadShards, so a thread that exits leaves its shard, and the BoardNotes in it, to the next new thread.
+
+getNotes() may be called at any time. It merges the shards into time order.
+*/
 class NoteAccountant : public NoteSubscriber 
 {
 
     public:
-    NoteAccountant();
+    NoteAccountant() = default;
     NoteAccountant(const NoteAccountant& o) = delete;
     NoteAccountant(NoteAccountant&& o) noexcept = delete;
     NoteAccountant& operator=(const NoteAccountant& o) = delete;
@@ -23,16 +33,46 @@ class NoteAccountant : public NoteSubscriber
     void callback(BoardNote boardNote) override;
 
     /*
-    Returns all the BoardNotes that have been sent so far.
+    Returns all the BoardNotes that have been sent so far, oldest first. BoardNotes from one thread stay in the order that thread sent them.
     */
     std::vector< std::pair< std::chrono::time_point<std::chrono::high_resolution_clock>, BoardNote > > getNotes() const override;
    
  
     private:
 
-    std::vector<std::pair<std::chrono::time_point<std::chrono::high_resolution_clock>, BoardNote>> _receivedBoardNotes; 
+    struct Entry
+    {
+        uint64_t ticks;
+        int32_t boxId;
+        MoveType type;
+    };
+
+    // Entries are stored in fixed size chunks, so appending never moves an entry that getNotes() may be reading.
+    struct Chunk
+    {
+        static constexpr size_t capacity = 256;
+        Entry entries[capacity];
+        std::atomic<Chunk*> next{nullptr};
+    };
+
+    // Written by one thread only. _size is published after the entry is written, so getNotes() reads only finished entries.
+    struct Shard
+    {
+        Chunk* head = nullptr;
+        Chunk* tail = nullptr;
+        std::atomic<size_t> size{0};
 
+        Shard() = default;
+        Shard(const Shard& o) = delete;
+        Shard(Shard&& o) noexcept = delete;
+        Shard& operator=(const Shard& o) = delete;
+        Shard& operator=(Shard&& o) noexcept = delete;
+        ~Shard() noexcept;
+    };
+
+    ThreadShards<Shard> _shards{};
+
+    static void append(Shard& shard, uint64_t ticks, BoardNote boardNote);
 };
 
 #endif
-   
@@ -0,0 +1,91 @@
+#include "OccupancyGrid.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+OccupancyGrid::OccupancyGrid(int width, int height)
+:   _width{width},
+    _height{height},
+    _boxIds(width * height, -1),
+    _types(width * height, MoveType::left),
+    _slots(width * height, -1)
+{}
+
+int OccupancyGrid::getWidth() const
+{
+    return _width;
+}
+
+int OccupancyGrid::getHeight() const
+{
+    return _height;
+}
+
+void OccupancyGrid::update(const Drop& drop)
+{
+    int cell = toCell(drop.getPosition());
+
+    if (drop.getMoveType() == MoveType::left)
+    {
+        // Remove cell from _occupiedCells by moving the last occupied cell into its slot.
+        int slot = _slots[cell];
+        if (slot != -1)
+        {
+            int lastCell = _occupiedCells.back();
+            _occupiedCells[slot] = lastCell;
+            _slots[lastCell] = slot;
+            _occupiedCells.pop_back();
+            _slots[cell] = -1;
+        }
+        _boxIds[cell] = -1;
+        _types[cell] = MoveType::left;
+    }
+    else
+    {
+        if (_slots[cell] == -1)
+        {
+            _slots[cell] = static_cast<int>(_occupiedCells.size());
+            _occupiedCells.push_back(cell);
+        }
+        _boxIds[cell] = drop.getBoxId();
+        _types[cell] = drop.getMoveType();
+    }
+}
+
+Drop OccupancyGrid::getDropAt(Position position) const
+{
+    int cell = toCell(position);
+    return Drop{position.getX(), position.getY(), _boxIds[cell], _types[cell]};
+}
+
+int OccupancyGrid::getBoxId(int cell) const
+{
+    return _boxIds[cell];
+}
+
+MoveType OccupancyGrid::getMoveType(int cell) const
+{
+    return _types[cell];
+}
+
+Position OccupancyGrid::getPosition(int cell) const
+{
+    return Position{cell % _width, cell / _width};
+}
+
+const vector<int>& OccupancyGrid::getOccupiedCells() const
+{
+    return _occupiedCells;
+}
+
+int OccupancyGrid::toCell(Position position) const
+{
+    int x = position.getX();
+    int y = position.getY();
+    if (x < 0 || x >= _width || y < 0 || y >= _height)
+    {
+        throw invalid_argument(position.toString() + " is not inside of the OccupancyGrid.");
+    }
+    return y * _width + x;
+}
@@ -0,0 +1,79 @@
+#ifndef OCCUPANCYGRID__H
+#define OCCUPANCYGRID__H
+
+#include <vector>
+#include "Drop.h"
+#include "MoveType.h"
+#include "Position.h"
+
+/*
+A dense record of which Box (if any) is at each Position of a width x height Board, and that Box's MoveType.
+
+Each Position is stored in a cell. Cells are numbered row by row, so the cell of Position {x, y} is y * width + x.
+
+Alongside the per-cell arrays, OccupancyGrid keeps a list of the cells that currently contain a Box. A cell is added to the list when it becomes occupied and is removed (by swapping in the last entry) when its Box leaves. So updating a cell costs the same no matter how large the Board is, and iterating over the occupied cells only touches cells that contain a Box.
+*/
+class OccupancyGrid
+{
+    public:
+
+    OccupancyGrid(int width, int height);
+    OccupancyGrid() = delete;
+    OccupancyGrid(const OccupancyGrid& o) = default;
+    OccupancyGrid(OccupancyGrid&& o) noexcept = default;
+    OccupancyGrid& operator=(const OccupancyGrid& o) = delete;
+    OccupancyGrid& operator=(OccupancyGrid&& o) noexcept = delete;
+    ~OccupancyGrid() noexcept = default;
+
+    int getWidth() const;
+    int getHeight() const;
+
+    /*
+    Records @drop's boxId and MoveType at @drop's Position. A Drop with MoveType::left empties the cell. Throws an invalid_argument exception if @drop's Position is not on the Board.
+    */
+    void update(const Drop& drop);
+
+    /*
+    Returns a Drop with the boxId and MoveType at @position. If there is no Box at @position, then the Drop has a boxId of -1 and MoveType::left. The returned Drop's hasChanged() is false.
+    */
+    Drop getDropAt(Position position) const;
+
+    /*
+    Returns the boxId in @cell, or -1 if @cell is empty.
+    */
+    int getBoxId(int cell) const;
+
+    /*
+    Returns the MoveType in @cell, or MoveType::left if @cell is empty.
+    */
+    MoveType getMoveType(int cell) const;
+
+    /*
+    Returns the Position of @cell.
+    */
+    Position getPosition(int cell) const;
+
+    /*
+    Returns the cells that contain a Box. The cells are in no particular order. The returned reference is only valid until the next call to update().
+    */
+    const std::vector<int>& getOccupiedCells() const;
+
+
+    private:
+
+    const int _width;
+    const int _height;
+
+    // Per cell: the boxId (-1 if empty) and MoveType.
+    std::vector<int> _boxIds{};
+    std::vector<MoveType> _types{};
+
+    // Per cell: the index of the cell inside _occupiedCells, or -1 if the cell is empty.
+    std::vector<int> _slots{};
+
+    std::vector<int> _occupiedCells{};
+
+    int toCell(Position position) const;
+};
+
+#endif
@@ -0,0 +1,226 @@
+#include "PhaseLatencies.h"
+
+#include <algorithm>
+#include "TscClock.h"
+
+using namespace std;
+
+namespace
+{
+    string toString(DeciderType decider)
+    {
+        switch (decider)
+        {
+            case DeciderType::risk1:
+                return "risk1";
+            case DeciderType::safe:
+                return "safe";
+        }
+        return "none";
+    }
+
+    string toString(PositionManagerType positionManager)
+    {
+        switch (positionManager)
+        {
+            case PositionManagerType::diagonal:
+                return "diagonal";
+            case PositionManagerType::down:
+                return "down";
+            case PositionManagerType::up:
+                return "up";
+            case PositionManagerType::step:
+                return "step";
+        }
+        return "none";
+    }
+
+    void writeRows(
+        ostream& out,
+        double seconds,
+        const string& decider,
+        const string& positionManager,
+        const PhaseLatencies::Histograms& histograms)
+    {
+        for (int phase=0; phase<stepPhaseCount; ++phase)
+        {
+            const LatencyHistogram& h = histograms[phase];
+            if (h.getCount() == 0)
+            {
+                continue;
+            }
+            out << seconds << "," << decider << "," << positionManager << ","
+                << PhaseLatencies::getName(static_cast<StepPhase>(phase)) << ","
+                << h.getCount() << ","
+                << h.getMean() / 1000.0 << ","
+                << static_cast<double>(h.getPercentile(0.5)) / 1000.0 << ","
+                << static_cast<double>(h.getPercentile(0.99)) / 1000.0 << ","
+                << static_cast<double>(h.getPercentile(0.999)) / 1000.0 << ","
+                << static_cast<double>(h.getMax()) / 1000.0 << "\n";
+        }
+    }
+}
+
+PhaseLatencies::PhaseLatencies()
+:   _nanosecondsPerTick{TscClock::getNanosecondsPerTick()},
+    _shards{[]{ return make_unique<Shard>(); }, [this](Shard& shard){ retire(shard); }}
+{}
+
+void PhaseLatencies::setGroupForThisThread(DeciderType decider, PositionManagerType positionManager)
+{
+    Shard& shard = _shards.getForThisThread();
+    shard.decider.store(static_cast<int>(decider), memory_order_relaxed);
+    shard.positionManager.store(static_cast<int>(positionManager), memory_order_relaxed);
+}
+
+void PhaseLatencies::record(StepPhase phase, uint64_t nanoseconds)
+{
+    // Only this thread writes to its shard, so loads and stores are enough.
+    PhaseCounts& counts = _shards.getForThisThread().phases[static_cast<size_t>(phase)];
+    atomic<uint32_t>& bucket = counts.buckets[LatencyHistogram::getBucket(nanoseconds)];
+    bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    counts.sum.store(counts.sum.load(memory_order_relaxed) + nanoseconds, memory_order_relaxed);
+    if (nanoseconds > counts.max.load(memory_order_relaxed))
+    {
+        counts.max.store(nanoseconds, memory_order_relaxed);
+    }
+}
+
+void PhaseLatencies::recordTicks(StepPhase phase, uint64_t ticks)
+{
+    record(phase, static_cast<uint64_t>(static_cast<double>(ticks) * _nanosecondsPerTick));
+}
+
+void PhaseLatencies::recordSince(StepPhase phase, uint64_t startTicks)
+{
+    recordTicks(phase, TscClock::now() - startTicks);
+}
+
+map<PhaseLatencies::Group, PhaseLatencies::Histograms> PhaseLatencies::getHistograms() const
+{
+    map<Group, Histograms> perGroup{};
+    _shards.visitAll([this, &perGroup](const vector<unique_ptr<Shard>>& shards){
+        perGroup = _retired;
+        for (const auto& shard : shards)
+        {
+            Histograms histograms{};
+            if (!readShard(*shard, histograms))
+            {
+                continue;
+            }
+            Histograms& merged = perGroup[getGroup(*shard)];
+            for (int phase=0; phase<stepPhaseCount; ++phase)
+            {
+                merged[phase].merge(histograms[phase]);
+            }
+        }
+    });
+    return perGroup;
+}
+
+map<DeciderType, PhaseLatencies::Histograms> PhaseLatencies::mergePerDecider(const map<Group, Histograms>& perGroup)
+{
+    map<DeciderType, Histograms> perDecider{};
+    for (const auto& groupAndHistograms : perGroup)
+    {
+        Histograms& merged = perDecider[groupAndHistograms.first.first];
+        for (int phase=0; phase<stepPhaseCount; ++phase)
+        {
+            merged[phase].merge(groupAndHistograms.second[phase]);
+        }
+    }
+    return perDecider;
+}
+
+string PhaseLatencies::getName(StepPhase phase)
+{
+    switch (phase)
+    {
+        case StepPhase::waitingToEnter:
+            return "waiting_to_enter";
+        case StepPhase::deciding:
+            return "deciding";
+        case StepPhase::blocked:
+            return "blocked";
+        case StepPhase::holdingTwoSpots:
+            return "holding_two_spots";
+        case StepPhase::changeSpotLockWait:
+            return "change_spot_lock_wait";
+    }
+    return "unknown";
+}
+
+void PhaseLatencies::writeCsvHeader(ostream& out)
+{
+    out << "seconds,decider,position_manager,phase,count,mean_us,p50_us,p99_us,p999_us,max_us\n";
+}
+
+void PhaseLatencies::writeCsvRows(ostream& out, double seconds, const map<Group, Histograms>& perGroup)
+{
+    for (const auto& groupAndHistograms : perGroup)
+    {
+        writeRows(
+            out,
+            seconds,
+            toString(groupAndHistograms.first.first),
+            toString(groupAndHistograms.first.second),
+            groupAndHistograms.second);
+    }
+    for (const auto& deciderAndHistograms : mergePerDecider(perGroup))
+    {
+        writeRows(out, seconds, toString(deciderAndHistograms.first), "all", deciderAndHistograms.second);
+    }
+}
+
+bool PhaseLatencies::readShard(const Shard& shard, Histograms& histograms)
+{
+    bool any = false;
+    for (int phase=0; phase<stepPhaseCount; ++phase)
+    {
+        const PhaseCounts& counts = shard.phases[phase];
+        array<uint64_t, LatencyHistogram::bucketCount> buckets{};
+        for (int ii=0; ii<LatencyHistogram::bucketCount; ++ii)
+        {
+            buckets[ii] = counts.buckets[ii].load(memory_order_relaxed);
+            any = any || (buckets[ii] != 0);
+        }
+        histograms[phase] = LatencyHistogram{
+            buckets,
+            static_cast<double>(counts.sum.load(memory_order_relaxed)),
+            counts.max.load(memory_order_relaxed)};
+    }
+    return any;
+}
+
+PhaseLatencies::Group PhaseLatencies::getGroup(const Shard& shard)
+{
+    return Group{
+        static_cast<DeciderType>(shard.decider.load(memory_order_relaxed)),
+        static_cast<PositionManagerType>(shard.positionManager.load(memory_order_relaxed))};
+}
+
+void PhaseLatencies::retire(Shard& shard)
+{
+    // The thread that recorded into @shard has exited, so nothing else writes to it.
+    Histograms histograms{};
+    if (readShard(shard, histograms))
+    {
+        Histograms& merged = _retired[getGroup(shard)];
+        for (int phase=0; phase<stepPhaseCount; ++phase)
+        {
+            merged[phase].merge(histograms[phase]);
+        }
+    }
+
+    for (PhaseCounts& counts : shard.phases)
+    {
+        for (atomic<uint32_t>& bucket : counts.buckets)
+        {
+            bucket.store(0, memory_order_relaxed);
+        }
+        counts.sum.store(0, memory_order_relaxed);
+        counts.max.store(0, memory_order_relaxed);
+    }
+    shard.decider.store(0, memory_order_relaxed);
+    shard.positionManager.store(0, memory_order_relaxed);
+}
@@ -0,0 +1,119 @@
+#ifndef PHASELATENCIES__H
+#define PHASELATENCIES__H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include "DeciderType.h"
+#include "LatencyHistogram.h"
+#include "PositionManagerType.h"
+#include "StepPhase.h"
+#include "ThreadShards.h"
+
+/*
+Records how long Boxes spend in each StepPhase, as one LatencyHistogram per StepPhase and per group. A group is a DeciderType and PositionManagerType pair, so Decider_Safe and Decider_Risk1 can be compared on their p50, p99, and p999. Board owns one.
+
+A thread joins a group with setGroupForThisThread(), and everything it records afterwards counts towards that group. Threader does this for each Box's thread. Threads that never join a group, like the one running VirtualTimeRunner, are grouped under DeciderType 0 and PositionManagerType 0.
+
+Like SimulationMetrics, each thread records into its own shard without a lock, and getHistograms() merges the shards. Recording is a bucket lookup and three relaxed atomic stores. When a thread exits, its recordings are moved out of its shard into its group's totals before the next new thread gets the shard, so they stay with the group they were recorded for.
+*/
+class PhaseLatencies
+{
+    public:
+
+    using Group = std::pair<DeciderType, PositionManagerType>;
+    using Histograms = std::array<LatencyHistogram, stepPhaseCount>;
+
+    PhaseLatencies();
+    PhaseLatencies(const PhaseLatencies& o) = delete;
+    PhaseLatencies(PhaseLatencies&& o) noexcept = delete;
+    PhaseLatencies& operator=(const PhaseLatencies& o) = delete;
+    PhaseLatencies& operator=(PhaseLatencies&& o) noexcept = delete;
+    ~PhaseLatencies() noexcept = default;
+
+    /*
+    Returns true if Board::changeSpot() records StepPhase::changeSpotLockWait in this build.
+    */
+    static constexpr bool recordsChangeSpotLockWait()
+    {
+#ifdef PLAZA_LOCK_WAIT_LATENCIES
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*
+    Makes the current thread's recordings, past and future, count towards the group @decider and @positionManager.
+    */
+    void setGroupForThisThread(DeciderType decider, PositionManagerType positionManager);
+
+    void record(StepPhase phase, uint64_t nanoseconds);
+
+    /*
+    Records a time of @ticks, measured with TscClock.
+    */
+    void recordTicks(StepPhase phase, uint64_t ticks);
+
+    /*
+    Records the time since @startTicks, a value from TscClock::now().
+    */
+    void recordSince(StepPhase phase, uint64_t startTicks);
+
+    /*
+    Returns the histograms of every group that has recorded something, merged over its threads.
+    */
+    std::map<Group, Histograms> getHistograms() const;
+
+    /*
+    Merges @perGroup over the PositionManagerTypes, to compare DeciderTypes only.
+    */
+    static std::map<DeciderType, Histograms> mergePerDecider(const std::map<Group, Histograms>& perGroup);
+
+    static std::string getName(StepPhase phase);
+
+    /*
+    Writes one CSV row per group and StepPhase with at least one value, and one row per DeciderType and StepPhase with the PositionManagerType "all". Times are in microseconds. @seconds fills the first column, so rows written at intervals form a time series.
+    */
+    static void writeCsvHeader(std::ostream& out);
+    static void writeCsvRows(std::ostream& out, double seconds, const std::map<Group, Histograms>& perGroup);
+
+
+    private:
+
+    struct PhaseCounts
+    {
+        std::array<std::atomic<uint32_t>, LatencyHistogram::bucketCount> buckets{};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+    };
+
+    struct alignas(64) Shard
+    {
+        std::atomic<int> decider{0};
+        std::atomic<int> positionManager{0};
+        std::array<PhaseCounts, stepPhaseCount> phases{};
+    };
+
+    // Read once up front, since TscClock measures it on first use.
+    const double _nanosecondsPerTick;
+
+    // The recordings of threads that have exited, per group. Only used while holding the lock of _shards.
+    std::map<Group, Histograms> _retired{};
+
+    ThreadShards<Shard> _shards;
+
+    /*
+    Fills @histograms from @shard, and returns false if @shard has no recordings.
+    */
+    static bool readShard(const Shard& shard, Histograms& histograms);
+    static Group getGroup(const Shard& shard);
+    void retire(Shard& shard);
+};
+
+#endif
@@ -0,0 +1,17 @@
+#include "PositionManager.h"
+
+using namespace std;
+
+void PositionManager::fillFuturePositions(Position position, FuturePositions& positions)
+{
+    positions.clear();
+    for (const Position& futurePosition : getFuturePositions(position))
+    {
+        positions.push_back(futurePosition);
+    }
+}
+
+optional<PositionManager::RankingRule> PositionManager::getRankingRule() const
+{
+    return nullopt;
+}
@@ -1,7 +1,10 @@
 #ifndef POSITION_MANAGER__H
 #define POSITION_MANAGER__H
 
+#include <optional>
 #include <vector>
+#include "FuturePositions.h"
+#include "NeighbourRanker.h"
 #include "Position.h"
 #include "Rectangle.h"
 
@@ -23,12 +26,40 @@ class PositionManager
 
     public:
 
+    /*
+    How a PositionManager ranks the Positions next to a Box with NeighbourRanker, so that an engine stepping many Boxes can rank them itself, without calling each Box's PositionManager.
+    */
+    struct RankingRule
+    {
+        // Never null. Points to a table that lives as long as the program.
+        const NeighbourRanker::DirectionTable* table;
+        NeighbourRanker::Bounds bounds;
+        // The Position the Box heads for.
+        Position target;
+        // If set, the Box heads for the waypoints it returns on the way to @target instead of @target itself. A waypoint is set when the Box has none, and again when the Box reaches it.
+        Position (*getWaypoint)(Position position, Position target);
+        // The Positions kept in order. The rest are shuffled, with NeighbourRanker::shuffleAfter() and Util's generator.
+        int keptCount;
+
+        bool operator==(const RankingRule& o) const = default;
+    };
+
     virtual ~PositionManager() noexcept = default;
 
     /*
     Returns a vector of Positions that are recomended for a Box at Position @position. The Positions are in order of most recommended to least recommended. If no Position is recommended, then returns an empty vector.
     */
     virtual std::vector<Position> getFuturePositions(Position position) = 0;
+
+    /*
+    Same as getFuturePositions(), but fills @positions instead of returning a new vector, so a caller that steps many Boxes can reuse one FuturePositions. By default it copies what getFuturePositions() returns. A PositionManager that can fill @positions without allocating should override it.
+    */
+    virtual void fillFuturePositions(Position position, FuturePositions& positions);
+
+    /*
+    Returns the RankingRule fillFuturePositions() follows, or nothing if it does not rank Positions with NeighbourRanker. A PositionManager with a RankingRule is at its end inside getEndRect(). By default returns nothing.
+    */
+    virtual std::optional<RankingRule> getRankingRule() const;
     
     /*
     Returns true if @position is at the PositionManager's end destination.
@@ -1,10 +1,22 @@
 #include "PositionManager_Diagonal.h"
 
 #include <sstream>
+#include "NeighbourRanker.h"
 #include "Util.h"
 
 using namespace std;
 
+namespace
+{
+    // n, nw, w, sw, s, se, e, ne. Of two Positions as close to the target, the first in this order comes first.
+    constexpr NeighbourRanker::Directions directions{
+        {0, 1, 1, 1, 0, -1, -1, -1},
+        {1, 1, 0, -1, -1, -1, 0, 1}};
+
+    // The order of the directions for a target in each sector, worked out by the compiler.
+    constexpr NeighbourRanker::DirectionTable directionTable = NeighbourRanker::makeDirectionTable(directions);
+}
+
 PositionManager_Diagonal::PositionManager_Diagonal(
     Rectangle endRectangle,
     Position targetPosition,
@@ -29,70 +41,30 @@ PositionManager_Diagonal::PositionManager_Diagonal(
 
 vector<Position> PositionManager_Diagonal::getFuturePositions(Position position)
 {
-    vector<Position> returnedPositions{};
-    if (position == _targetPosition)
-    {
-        return returnedPositions;
-    }
-
-    int curX = position.getX();
-    int curY = position.getY();
-
-    // Collect all possible new Positions, that's 8 directions.
-    vector<pair<double, Position>> pairsOfPositionsAndDistSq{};
-    Position n  = Position{curX, curY+1};
-    Position nw = Position{curX + 1, curY + 1};
-    Position w  = Position{curX + 1, curY};
-    Position sw = Position{curX + 1, curY - 1};
-    Position s  = Position{curX, curY - 1};
-    Position se = Position{curX - 1, curY - 1};
-    Position e  = Position{curX - 1, curY};
-    Position ne = Position{curX - 1, curY + 1};
+    FuturePositions positions{};
+    fillFuturePositions(position, positions);
+    return vector<Position>(positions.get().begin(), positions.get().end());
+}
 
-    // Calculate distance to each of the new Positions.
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(n, _targetPosition), n}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(nw, _targetPosition), nw}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(w, _targetPosition), w}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(sw, _targetPosition), sw}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(s, _targetPosition), s}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(se, _targetPosition), se}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(e, _targetPosition), e}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(ne, _targetPosition), ne}); 
-   
-    // Remove Positions that are outside of the Board. 
-    vector<pair<double,Position>> netPositionPairs{};
-    for (const auto& p: pairsOfPositionsAndDistSq)
+void PositionManager_Diagonal::fillFuturePositions(Position position, FuturePositions& positions)
+{
+    positions.clear();
+    if (position == _targetPosition)
     {
-        Position pos = p.second;
-
-        if (pos.getX() >= _boardMinX &&
-            pos.getX() <= _boardMaxX &&
-            pos.getY() >= _boardMinY &&
-            pos.getY() <= _boardMaxY)
-        {
-            netPositionPairs.push_back(p);
-        }
+        return;
     }
 
-    // Sort the vector by closest to _targetPosition.
-    sort(netPositionPairs.begin(), netPositionPairs.end(), [](const pair<double, Position>& a, const pair<double, Position>& b){return a.first < b.first;});
-
-    random_device rd;
-    mt19937 g(rd());
-
-    for(const auto& p : netPositionPairs)
-    {
-        returnedPositions.push_back(p.second);
-    }
+    // Rank the Positions adjacent to @position by closest to _targetPosition, leaving out Positions outside of the Board.
+    NeighbourRanker::Ranking ranking = NeighbourRanker::rankBySector(
+        position,
+        _targetPosition,
+        NeighbourRanker::Bounds{_boardMinX, _boardMaxX, _boardMinY, _boardMaxY},
+        directionTable);
 
     // Shuffle positions after the 3rd position.
-    if (returnedPositions.size() > 3)
-    {
-        shuffle(returnedPositions.begin()+3, returnedPositions.end(), g);
-    }
+    NeighbourRanker::shuffleAfter(ranking, 3, Util::getGenerator());
 
-    return returnedPositions;
-    
+    NeighbourRanker::getPositions(position, ranking, directions, positions);
 }
 
 bool PositionManager_Diagonal::atEnd(Position position) const
@@ -110,12 +82,14 @@ Rectangle PositionManager_Diagonal::getTargetRect() const
     return Rectangle{_targetPosition, _targetPosition};
 }
 
-double PositionManager_Diagonal::getDistSquared(Position a, Position b)
+optional<PositionManager::RankingRule> PositionManager_Diagonal::getRankingRule() const
 {
-    double x = std::abs(static_cast<double>(a.getX()) - b.getX());
-    double y = std::abs(static_cast<double>(a.getY()) - b.getY());
-
-    return (x * x) + (y * y);
+    return RankingRule{
+        &directionTable,
+        NeighbourRanker::Bounds{_boardMinX, _boardMaxX, _boardMinY, _boardMaxY},
+        _targetPosition,
+        nullptr,
+        3};
 }
 
 bool PositionManager_Diagonal::isValid(Position& p) const
@@ -33,6 +33,11 @@ class PositionManager_Diagonal : public PositionManager
     */
     std::vector<Position> getFuturePositions(Position position) override;
 
+    /*
+    Same as getFuturePositions(), without allocating.
+    */
+    void fillFuturePositions(Position position, FuturePositions& positions) override;
+
     
     /*
     If @position is within the topLeft corner and botRight corner of the end rectangle given in the constructor, then returns true.  Otherwise returns false. 'Within' means inclusively in the x and y ranges of the end rectangle's top left and bottom right corners.
@@ -51,6 +56,11 @@ class PositionManager_Diagonal : public PositionManager
     */
     Rectangle getTargetRect() const override;
 
+    /*
+    Returns a RankingRule that heads straight for the target Position.
+    */
+    std::optional<RankingRule> getRankingRule() const override;
+
 
     private:
 
@@ -64,7 +74,6 @@ class PositionManager_Diagonal : public PositionManager
     int _boardMaxY = 0;
 
     std::vector<std::pair<int, int>> pastPositions{};
-    double getDistSquared(Position a, Position b);
     bool isValid(Position& p) const;
 }; 
 
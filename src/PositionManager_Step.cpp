@@ -1,8 +1,21 @@
 #include "PositionManager_Step.h"
-#include <random>
+#include <cmath>
+#include "NeighbourRanker.h"
+#include "Util.h"
 
 using namespace std;
 
+namespace
+{
+    // n, nw, w, sw, s, se, e, ne. Of two Positions as close to the target, the first in this order comes first.
+    constexpr NeighbourRanker::Directions directions{
+        {0, 1, 1, 1, 0, -1, -1, -1},
+        {-1, -1, 0, 1, 1, 1, 0, -1}};
+
+    // The order of the directions for a target in each sector, worked out by the compiler.
+    constexpr NeighbourRanker::DirectionTable directionTable = NeighbourRanker::makeDirectionTable(directions);
+}
+
 PositionManager_Step::PositionManager_Step(
     Position finalTarget,
     int boardMinX,
@@ -17,63 +30,38 @@ PositionManager_Step::PositionManager_Step(
 {}
 
 vector<Position> PositionManager_Step::getFuturePositions(Position position)
+{
+    FuturePositions positions{};
+    fillFuturePositions(position, positions);
+    return vector<Position>(positions.get().begin(), positions.get().end());
+}
+
+void PositionManager_Step::fillFuturePositions(Position position, FuturePositions& positions)
 {
     if (!isValid(position))
     {
        throw invalid_argument(invalidPositionErrorString(position));
     }    
 
+    positions.clear();
     if (atEnd(position))
     {
-        return vector<Position>{};
+        return;
     }
 
     setCurrentTarget(position);
     
-    int pX = position.getX();
-    int pY = position.getY();
-
-    // Populate pairsOfPositionsAndDistSq with Positions that are adjacent to @position.
-    // The distance is the distance from _curTarget to @position.
-    vector<pair<double, Position>> pairsOfPositionsAndDistSq{};
-    Position n  = Position{pX, pY-1};
-    Position nw = Position{pX + 1, pY - 1};
-    Position w  = Position{pX + 1, pY};
-    Position sw = Position{pX + 1, pY + 1};
-    Position s  = Position{pX, pY + 1};
-    Position se = Position{pX - 1, pY + 1};
-    Position e  = Position{pX - 1, pY};
-    Position ne = Position{pX - 1, pY - 1};
-    Position target = _curTarget;
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(n, target), n}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(nw, target), nw}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(w, target), w}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(sw, target), sw}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(s, target), s}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(se, target), se}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(e, target), e}); 
-    pairsOfPositionsAndDistSq.push_back({getDistSquared(ne, target), ne}); 
-
-    // Sort the pairs of positions and distances.
-    sort(pairsOfPositionsAndDistSq.begin(), pairsOfPositionsAndDistSq.end(), [](const pair<double, Position>& a, const pair<double, Position>& b){return a.first < b.first;});
-
-    // Remove and Positions that are invalid
-    vector<Position> netPositions{};
-    for (const auto& p: pairsOfPositionsAndDistSq)
-    {
-        Position pos = p.second;
-        if(isValid(pos))
-        {
-            netPositions.push_back(pos);
-        }
-    }
+    // Rank the Positions adjacent to @position by their distance to _curTarget, leaving out invalid Positions.
+    NeighbourRanker::Ranking ranking = NeighbourRanker::rankBySector(
+        position,
+        _curTarget,
+        NeighbourRanker::Bounds{_boardMinX, _boardMaxX, _boardMinY, _boardMaxY},
+        directionTable);
 
     // Shuffle the Positions after index 2.
-    random_device rd;
-    mt19937 g(rd());
-    shuffle(netPositions.begin()+3, netPositions.end(), g);
+    NeighbourRanker::shuffleAfter(ranking, 3, Util::getGenerator());
 
-    return netPositions;
+    NeighbourRanker::getPositions(position, ranking, directions, positions);
 }
 
 bool PositionManager_Step::atEnd(Position curPosition) const
@@ -91,52 +79,54 @@ Rectangle PositionManager_Step::getTargetRect() const
     return Rectangle{_finalTarget, _finalTarget};
 }
 
+optional<PositionManager::RankingRule> PositionManager_Step::getRankingRule() const
+{
+    return RankingRule{
+        &directionTable,
+        NeighbourRanker::Bounds{_boardMinX, _boardMaxX, _boardMinY, _boardMaxY},
+        _finalTarget,
+        &PositionManager_Step::getWaypoint,
+        3};
+}
+
 void PositionManager_Step::setCurrentTarget(Position curPosition)
 {
     // Set a new target if the _curTarget hasn't been set, or 
     // if the box has reached the _curTarget.
     if (_curTarget == Position{-1, -1} || curPosition == _curTarget)
     {
-        int deltaX = _finalTarget.getX() - curPosition.getX();
-        int deltaY = _finalTarget.getY() - curPosition.getY();
-
-        // If the _curTarget is close to the _finalTarget then set the _curTarget to _finalTarget.
-        // Or if target has the same X or Y value as curPosition.
-        if( ( ( (deltaX*deltaX)+(deltaY*deltaY) ) < 100 ) ||
-            deltaX == 0 ||
-            deltaY == 0 )
-        {
-            _curTarget = _finalTarget;
-        }
-        // Else set the _currentTarget to the first Position on the line connecting the curPosition and the _finalTarget.
-        else
-        {  
-            // Move one point over on the x axis and find the corresponding point on the y axis.
-            if(std::abs(deltaX) <= std::abs(deltaY))
-            {
-                int smallDeltaX = (deltaX > 0) ? 1 : -1; 
-                int x = curPosition.getX() + smallDeltaX;
-                double tempY = curPosition.getY() + static_cast<double>(smallDeltaX) * deltaY/deltaX;
-                _curTarget = Position(x, static_cast<int>(round(tempY)));
-            }
-            // Move one point over on the y axis and find the corresponding point on the x axis.
-            else
-            {
-                int smallDeltaY = (deltaY > 0) ? 1 : -1; 
-                int y = curPosition.getY() + smallDeltaY;
-                double tempX = curPosition.getX() + static_cast<double>(smallDeltaY) * deltaX/deltaY;
-                _curTarget = Position(static_cast<int>(round(tempX)), y);
-            }
-        }
+        _curTarget = getWaypoint(curPosition, _finalTarget);
     }
 }
 
-double PositionManager_Step::getDistSquared(Position a, Position b) const
+Position PositionManager_Step::getWaypoint(Position curPosition, Position finalTarget)
 {
-    double x = std::abs(static_cast<double>(a.getX()) - b.getX());
-    double y = std::abs(static_cast<double>(a.getY()) - b.getY());
+    int deltaX = finalTarget.getX() - curPosition.getX();
+    int deltaY = finalTarget.getY() - curPosition.getY();
+
+    // If the current target is close to the final target then set the current target to the final target.
+    // Or if target has the same X or Y value as curPosition.
+    if( ( ( (deltaX*deltaX)+(deltaY*deltaY) ) < 100 ) ||
+        deltaX == 0 ||
+        deltaY == 0 )
+    {
+        return finalTarget;
+    }
 
-    return (x * x) + (y * y);
+    // Else set the current target to the first Position on the line connecting the curPosition and the final target.
+    // Move one point over on the x axis and find the corresponding point on the y axis.
+    if(std::abs(deltaX) <= std::abs(deltaY))
+    {
+        int smallDeltaX = (deltaX > 0) ? 1 : -1; 
+        int x = curPosition.getX() + smallDeltaX;
+        double tempY = curPosition.getY() + static_cast<double>(smallDeltaX) * deltaY/deltaX;
+        return Position(x, static_cast<int>(round(tempY)));
+    }
+    // Move one point over on the y axis and find the corresponding point on the x axis.
+    int smallDeltaY = (deltaY > 0) ? 1 : -1; 
+    int y = curPosition.getY() + smallDeltaY;
+    double tempX = curPosition.getX() + static_cast<double>(smallDeltaY) * deltaX/deltaY;
+    return Position(static_cast<int>(round(tempX)), y);
 }
 
 bool PositionManager_Step::isValid(Position& p) const
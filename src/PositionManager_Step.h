@@ -36,6 +36,11 @@ class PositionManager_Step : public PositionManager
     */
     std::vector<Position> getFuturePositions(Position position) override;
 
+    /*
+    Same as getFuturePositions(), without allocating.
+    */
+    void fillFuturePositions(Position position, FuturePositions& positions) override;
+
     /*
     Returns true if @position is the finalTarget.
     */
@@ -51,6 +56,16 @@ class PositionManager_Step : public PositionManager
     */
     Rectangle getTargetRect() const override;
 
+    /*
+    Returns a RankingRule that heads for the final target through the waypoints of getWaypoint().
+    */
+    std::optional<RankingRule> getRankingRule() const override;
+
+    /*
+    Returns the current target that getFuturePositions() sets for a Box at @position heading for @finalTarget. See getFuturePositions().
+    */
+    static Position getWaypoint(Position position, Position finalTarget);
+
 private:
    
     Position _finalTarget;
@@ -62,7 +77,6 @@ private:
     int _boardMaxY = 0;
 
     void setCurrentTarget(Position curPosition);
-    double getDistSquared(Position a, Position b) const;
     bool isValid(Position& p) const;
     std::string invalidPositionErrorString(Position p) const;
 };
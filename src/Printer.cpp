@@ -7,12 +7,13 @@ using namespace std;
 
 Printer::Printer(SDL_Renderer* renderer): _renderer{renderer} {}
 
-void Printer::receiveAllDropsAllBoxes(unordered_set<Drop> drops, unordered_map<int, BoxInfo> boxes) 
+void Printer::receiveStateAndChanges(const OccupancyGrid& drops, const Frame& frame) 
 {
-    print(drops, boxes);
+    // The whole Board is redrawn every frame, so the Frame is only used for its BoxInfos.
+    print(drops, frame);
 }
 
-void Printer::print(unordered_set<Drop>& drops, unordered_map<int, BoxInfo>& boxes)
+void Printer::print(const OccupancyGrid& drops, const Frame& frame)
 {  
 
     SDL_SetRenderDrawColor(_renderer, 0xFF, 0xFF, 0xFF, 0xFF);
@@ -38,8 +39,8 @@ void Printer::print(unordered_set<Drop>& drops, unordered_map<int, BoxInfo>& box
 
     /* Print Boxes */
     
-    //Group the Drops by their Color and shade. Color is taken from the Drop's group number. Shade is taken from the Drop's level.
-    map<pair<int, int>, unordered_set<Drop>> dropsPerGroupNumberAndShade;
+    //Group the occupied cells by their Color and shade. Color is taken from the Box's group number. Shade is taken from the Box's level.
+    map<pair<int, int>, vector<int>> cellsPerGroupNumberAndShade;
 
     for(auto& colorPerGroupNumber: _colorPerGroupNumber)
     {
@@ -48,37 +49,40 @@ void Printer::print(unordered_set<Drop>& drops, unordered_map<int, BoxInfo>& box
 
         for(int ii=0; ii<numOfShades; ++ii)
         {
-            dropsPerGroupNumberAndShade[{groupNum, ii}] = unordered_set<Drop>{};
+            cellsPerGroupNumberAndShade[{groupNum, ii}] = vector<int>{};
         }
     }
 
-    for (const Drop& drop: drops)
+    for (int cell : drops.getOccupiedCells())
     {
-        int id = drop.getBoxId();
-        int level = boxes.at(id).getLevel();
-        int groupId = boxes.at(id).getGroupId();
+        int id = drops.getBoxId(cell);
+        const BoxInfo& boxInfo = frame.getBoxInfo(id);
+        int level = boxInfo.getLevel();
+        int groupId = boxInfo.getGroupId();
     
         // If the level is greater or equal to the number of shades, then set the shade to the last shade.
         int numOfShades = _colorPerGroupNumber.at(groupId).getNumberOfShades();
         int shade = (level >= numOfShades) ? (numOfShades-1) : (level);
 
-        dropsPerGroupNumberAndShade[{groupId, shade}].insert(std::move(drop));
+        cellsPerGroupNumberAndShade[{groupId, shade}].push_back(cell);
     }
 
-    // Print Drops per their Color and shade.
-    for(auto it=dropsPerGroupNumberAndShade.begin(); it!=dropsPerGroupNumberAndShade.end(); it++)
+    // Print occupied cells per their Color and shade.
+    for(auto it=cellsPerGroupNumberAndShade.begin(); it!=cellsPerGroupNumberAndShade.end(); it++)
     {
         pair<int, int> groupIdAndShade = it->first;
-        unordered_set<Drop>& drops = it->second;
+        const vector<int>& cells = it->second;
         Color color = _colorPerGroupNumber.at(groupIdAndShade.first);
         int shade = groupIdAndShade.second;
-        for(const Drop& drop : drops)
+        for(int cell : cells)
         {
+            const BoxInfo& boxInfo = frame.getBoxInfo(drops.getBoxId(cell));
+            Position position = drops.getPosition(cell);
             SDL_Rect squareRect;
-            squareRect.w = boxes.at(drop.getBoxId()).getWidth();
-            squareRect.h = boxes.at(drop.getBoxId()).getHeight();
-            squareRect.x = drop.getPosition().getX();
-            squareRect.y = drop.getPosition().getY();
+            squareRect.w = boxInfo.getWidth();
+            squareRect.h = boxInfo.getHeight();
+            squareRect.x = position.getX();
+            squareRect.y = position.getY();
             SDL_SetRenderDrawColor(
                 _renderer,
                 color.getRed(shade),
@@ -90,10 +94,20 @@ void Printer::print(unordered_set<Drop>& drops, unordered_map<int, BoxInfo>& box
         
     }
 
+    if (_hud != nullptr)
+    {
+        _hud->render();
+    }
+
     SDL_RenderPresent(_renderer);
 
 }
 
+void Printer::setHud(MetricsHud* hud)
+{
+    _hud = hud;
+}
+
 void Printer::addInOutBoundRectangle(Rectangle rectangle)
 {
     _endRectangles.push_back(rectangle);
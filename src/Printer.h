@@ -4,6 +4,7 @@
 #include <unordered_map>
 
 #include "Color.h"
+#include "MetricsHud.h"
 #include "RecorderListener.h"
 #include "Rectangle.h"
 #include "SDL.h"
@@ -35,10 +36,15 @@ class Printer : public RecorderListener {
     */  
     void setGroupColors(std::unordered_map<int, Color> colorPerGroupNumber);
 
+    /*
+    Draws @hud over the Board on every print. Pass nullptr to stop drawing it. @hud must outlive the Printer or be removed first.
+    */
+    void setHud(MetricsHud* hud);
+
     /*
     Prints Boxes and the in-and-out bound rectangles on the Board.
     */
-    void receiveAllDropsAllBoxes(std::unordered_set<Drop> drops, std::unordered_map<int, BoxInfo> boxes) override;
+    void receiveStateAndChanges(const OccupancyGrid& drops, const Frame& frame) override;
 
 
     private:
@@ -46,8 +52,9 @@ class Printer : public RecorderListener {
     std::unordered_map<int, Color> _colorPerGroupNumber{};
     std::unordered_map<int, int> _numOfShadesPerGroupNumber{}; 
     std::vector<Rectangle> _endRectangles{};
+    MetricsHud* _hud = nullptr;
 
-    void print(std::unordered_set<Drop>& drops, std::unordered_map<int, BoxInfo>& boxes);
+    void print(const OccupancyGrid& drops, const Frame& frame);
     
 };
 
@@ -0,0 +1,168 @@
+#ifndef PROFILEDSHAREDMUTEX__H
+#define PROFILEDSHAREDMUTEX__H
+
+#include <cstdint>
+#include <shared_mutex>
+#include <source_location>
+#include "LockProfiler.h"
+#include "TscClock.h"
+
+/*
+A std::shared_mutex that belongs to a named lock class, like "Board::_mux". Locking it through ProfiledUniqueLock or ProfiledSharedLock records its use in the LockProfiler.
+
+In a build without PLAZA_LOCK_PROFILING it is a plain std::shared_mutex, and the name is dropped. With PLAZA_LOCK_PROFILING it also keeps its lock class id, looked up once at construction.
+
+lock(), unlock(), and the rest are std::shared_mutex's, so std::unique_lock and std::shared_lock still work with it. They are not recorded.
+*/
+class ProfiledSharedMutex
+{
+    public:
+
+    /*
+    @name is the lock class. It must be a string literal or otherwise outlive the LockProfiler.
+    */
+    explicit ProfiledSharedMutex(const char* name)
+#ifdef PLAZA_LOCK_PROFILING
+    :   _lockClassId{LockProfiler::getLockClassId(name)}
+#endif
+    {
+        (void)name;
+    }
+
+    ProfiledSharedMutex() = delete;
+    ProfiledSharedMutex(const ProfiledSharedMutex& o) = delete;
+    ProfiledSharedMutex(ProfiledSharedMutex&& o) noexcept = delete;
+    ProfiledSharedMutex& operator=(const ProfiledSharedMutex& o) = delete;
+    ProfiledSharedMutex& operator=(ProfiledSharedMutex&& o) noexcept = delete;
+    ~ProfiledSharedMutex() noexcept = default;
+
+    void lock() { _mutex.lock(); }
+    bool try_lock() { return _mutex.try_lock(); }
+    void unlock() { _mutex.unlock(); }
+    void lock_shared() { _mutex.lock_shared(); }
+    bool try_lock_shared() { return _mutex.try_lock_shared(); }
+    void unlock_shared() { _mutex.unlock_shared(); }
+
+#ifdef PLAZA_LOCK_PROFILING
+    int getLockClassId() const
+    {
+        return _lockClassId;
+    }
+#endif
+
+
+    private:
+
+    std::shared_mutex _mutex;
+#ifdef PLAZA_LOCK_PROFILING
+    const int _lockClassId;
+#endif
+};
+
+/*
+Locks a ProfiledSharedMutex exclusively from its construction to its destruction, like a std::unique_lock.
+
+With PLAZA_LOCK_PROFILING it first tries the lock. If the lock is taken, it waits for it and the wait is recorded as contended, against the call site that constructed the ProfiledUniqueLock. The time the lock is held is recorded at destruction.
+*/
+class ProfiledUniqueLock
+{
+    public:
+
+    explicit ProfiledUniqueLock(
+        ProfiledSharedMutex& mutex,
+        const std::source_location& site = std::source_location::current())
+    :   _mutex{mutex}
+    {
+#ifdef PLAZA_LOCK_PROFILING
+        uint64_t waitTicks = 0;
+        bool contended = !_mutex.try_lock();
+        if (contended)
+        {
+            uint64_t waitStart = TscClock::now();
+            _mutex.lock();
+            waitTicks = TscClock::now() - waitStart;
+        }
+        LockProfiler::recordAcquisition(_mutex.getLockClassId(), LockMode::exclusive, waitTicks, contended, site);
+        _acquired = TscClock::now();
+#else
+        (void)site;
+        _mutex.lock();
+#endif
+    }
+
+    ProfiledUniqueLock() = delete;
+    ProfiledUniqueLock(const ProfiledUniqueLock& o) = delete;
+    ProfiledUniqueLock(ProfiledUniqueLock&& o) noexcept = delete;
+    ProfiledUniqueLock& operator=(const ProfiledUniqueLock& o) = delete;
+    ProfiledUniqueLock& operator=(ProfiledUniqueLock&& o) noexcept = delete;
+
+    ~ProfiledUniqueLock() noexcept
+    {
+#ifdef PLAZA_LOCK_PROFILING
+        LockProfiler::recordHold(_mutex.getLockClassId(), LockMode::exclusive, TscClock::now() - _acquired);
+#endif
+        _mutex.unlock();
+    }
+
+
+    private:
+
+    ProfiledSharedMutex& _mutex;
+#ifdef PLAZA_LOCK_PROFILING
+    uint64_t _acquired = 0;
+#endif
+};
+
+/*
+Locks a ProfiledSharedMutex shared from its construction to its destruction, like a std::shared_lock. It records the same as ProfiledUniqueLock, under LockMode::shared.
+*/
+class ProfiledSharedLock
+{
+    public:
+
+    explicit ProfiledSharedLock(
+        ProfiledSharedMutex& mutex,
+        const std::source_location& site = std::source_location::current())
+    :   _mutex{mutex}
+    {
+#ifdef PLAZA_LOCK_PROFILING
+        uint64_t waitTicks = 0;
+        bool contended = !_mutex.try_lock_shared();
+        if (contended)
+        {
+            uint64_t waitStart = TscClock::now();
+            _mutex.lock_shared();
+            waitTicks = TscClock::now() - waitStart;
+        }
+        LockProfiler::recordAcquisition(_mutex.getLockClassId(), LockMode::shared, waitTicks, contended, site);
+        _acquired = TscClock::now();
+#else
+        (void)site;
+        _mutex.lock_shared();
+#endif
+    }
+
+    ProfiledSharedLock() = delete;
+    ProfiledSharedLock(const ProfiledSharedLock& o) = delete;
+    ProfiledSharedLock(ProfiledSharedLock&& o) noexcept = delete;
+    ProfiledSharedLock& operator=(const ProfiledSharedLock& o) = delete;
+    ProfiledSharedLock& operator=(ProfiledSharedLock&& o) noexcept = delete;
+
+    ~ProfiledSharedLock() noexcept
+    {
+#ifdef PLAZA_LOCK_PROFILING
+        LockProfiler::recordHold(_mutex.getLockClassId(), LockMode::shared, TscClock::now() - _acquired);
+#endif
+        _mutex.unlock_shared();
+    }
+
+
+    private:
+
+    ProfiledSharedMutex& _mutex;
+#ifdef PLAZA_LOCK_PROFILING
+    uint64_t _acquired = 0;
+#endif
+};
+
+#endif
@@ -3,31 +3,20 @@
 
 using namespace std;
 
-Recorder::Recorder()
+Recorder::Recorder(int width, int height): _drops{width, height}
 {}
 
-void Recorder::receiveChanges(
-        unordered_set<Drop> changedDrops,
-        std::unordered_map<int, BoxInfo> boxes)
+void Recorder::receiveChanges(const shared_ptr<const Frame>& frame)
 {
-    for (const auto& drop: changedDrops)
+    // Update only the cells that have changed. A Drop with MoveType::left empties its cell.
+    for (const auto& drop: frame->getChangedDrops())
     {
-        // If a Drop with drop's Position exists in _drops, then delete the Drop in _drops.
-        if (_drops.find(drop) != _drops.end())
-        {
-            _drops.erase(drop);
-        }
-
-        // If drop is not MoveType::left, then save it in _drops.
-        if(drop.getMoveType() != MoveType::left)
-        {   
-            _drops.insert(drop);
-        }
+        _drops.update(drop);
     }
     
     for (RecorderListener* listener : _listeners)
     {
-        listener->receiveAllDropsAllBoxes(_drops, boxes);
+        listener->receiveStateAndChanges(_drops, *frame);
     }
 }
 
@@ -2,8 +2,8 @@
 #define RECORDER__H 
 
 #include <vector>
-#include <unordered_set>
 #include "BoardListener.h"
+#include "OccupancyGrid.h"
 #include "RecorderListener.h"
 
 /*
@@ -13,7 +13,11 @@ class Recorder : public BoardListener
 
     public:
   
-    Recorder();
+    /*
+    @width and @height are the width and height of the Board that Recorder listens to.
+    */
+    Recorder(int width, int height);
+    Recorder() = delete;
     Recorder(const Recorder& o) = delete;
     Recorder(Recorder&& o) = delete;
     Recorder& operator=(const Recorder& o) = delete;
@@ -21,19 +25,17 @@ class Recorder : public BoardListener
     ~Recorder() noexcept = default; 
 
     /*
-    Keeps a running unordered_set of the Drops that currently contain Boxes. (In this sense it contains a tally of the Boxes that are on the Board.) When it receives the changedDrops it updates this set by removing Drops that no long contain a Box and updates the Drops that have changed. (Maybe their MoveType or level has changed.) There is no processing of the Boxes received. The running set of the Drops and the received Boxes are then broadcasted out to its RecorderListeners.
+    Keeps a running OccupancyGrid of the Drops that currently contain Boxes. (In this sense it contains a tally of the Boxes that are on the Board.) When it receives a Frame it updates only the cells of the Frame's changed Drops, so the work done is proportional to the number of changes, not to the size of the Board. There is no processing of the Boxes received. The OccupancyGrid and the Frame are then passed by reference to its RecorderListeners.
     */
-    void receiveChanges(
-        std::unordered_set<Drop> changedDrops,
-        std::unordered_map<int, BoxInfo> boxes) override;
+    void receiveChanges(const std::shared_ptr<const Frame>& frame) override;
 
     void registerListener(RecorderListener* listener);
 
 
     private:
 
-    // _drops only saves Drops that do not have MoveType::left. _drops represents all the Drops on the Board that have a Box. When a Box leaves a Drop, Recorder receives a Drop with a MoveType::left and the Drop is removed from _drops.
-    std::unordered_set<Drop> _drops{}; 
+    // _drops only contains Drops that do not have MoveType::left. _drops represents all the Drops on the Board that have a Box. When a Box leaves a Drop, Recorder receives a Drop with a MoveType::left and that cell is emptied in _drops.
+    OccupancyGrid _drops;
     std::vector<RecorderListener*> _listeners;
 
 };
@@ -1,21 +1,22 @@
 #ifndef RECORDERLISTENER__H
 #define RECORDERLISTENER__H
 
-#include <unordered_map>
-#include <unordered_set>
-#include "BoxInfo.h"
-#include "Drop.h"
+#include "Frame.h"
+#include "OccupancyGrid.h"
 
 class RecorderListener 
 {
     public:
     
+    virtual ~RecorderListener() = default;
+
     /*
-    Receives all the Drops that contain Boxes and all the Boxes, even Boxes that have not entered the Board or have been taken off the Board.
+    Receives a read-only view of the current state and the changes since the last call.
+
+    @drops holds every Position that contains a Box. It belongs to the Recorder and is only valid during this call.
+    @frame is the Board's Frame. Its changed Drops are only the Drops that have changed since the last call. A Drop with MoveType::left means its Position no longer contains a Box. Its BoxInfos hold all the Boxes, even Boxes that have not entered the Board or have been taken off the Board.
     */
-    virtual void receiveAllDropsAllBoxes(std::unordered_set<Drop> drops,
-                                         std::unordered_map<int, BoxInfo> boxes) = 0;
+    virtual void receiveStateAndChanges(const OccupancyGrid& drops, const Frame& frame) = 0;
 };
 
 #endif
-
@@ -0,0 +1,80 @@
+#include "RunStatistics.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+RunStatistics::RunStatistics(int boxCount)
+:   _boxes(boxCount)
+{}
+
+void RunStatistics::receiveTransition(const SpotTransition& transition)
+{
+    if (transition.boxId < 0 || transition.boxId >= static_cast<int>(_boxes.size()))
+    {
+        throw invalid_argument("RunStatistics has no Box with boxId " + to_string(transition.boxId) + ".");
+    }
+
+    if (transition.isCollision())
+    {
+        _collisions.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    BoxRecord& box = _boxes[transition.boxId];
+    MoveType type = transition.getMoveType();
+    if (type == MoveType::to_arrive)
+    {
+        _moves.fetch_add(1, memory_order_relaxed);
+        if (box.entered == -1)
+        {
+            box.entered = transition.timestamp;
+        }
+        ++box.spots;
+    }
+    else if (type == MoveType::left)
+    {
+        --box.spots;
+        if (box.spots == 0)
+        {
+            box.exited = transition.timestamp;
+            _exited.fetch_add(1, memory_order_relaxed);
+        }
+    }
+}
+
+long RunStatistics::getMoves() const
+{
+    return _moves.load(memory_order_relaxed);
+}
+
+long RunStatistics::getCollisions() const
+{
+    return _collisions.load(memory_order_relaxed);
+}
+
+double RunStatistics::getCollisionRate() const
+{
+    long moves = getMoves();
+    long collisions = getCollisions();
+    return (moves + collisions == 0) ? 0.0 : static_cast<double>(collisions) / static_cast<double>(moves + collisions);
+}
+
+int RunStatistics::getExitedCount() const
+{
+    return _exited.load(memory_order_relaxed);
+}
+
+vector<int64_t> RunStatistics::getTimesToExit() const
+{
+    vector<int64_t> times{};
+    for (const BoxRecord& box : _boxes)
+    {
+        if (box.exited != -1)
+        {
+            times.push_back(box.exited - box.entered);
+        }
+    }
+    return times;
+}
@@ -0,0 +1,65 @@
+#ifndef RUNSTATISTICS__H
+#define RUNSTATISTICS__H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "TransitionListener.h"
+
+/*
+Counts what happens during a run from the Board's SpotTransitions: moves, collisions, and how long each Box spends on the Board.
+
+A move is a successful MoveType::to_arrive, so adding a Box and moving it one Position are each one move. A collision is a refused change. A Box enters the Board with its first move and exits when it leaves its last Spot. Its time to exit is the time between the two.
+
+The Boxes must have the boxIds 0 to boxCount - 1. Each Box's own transitions come from its own thread, so the per-Box records need no locks. Only the counters are shared, and they are relaxed atomics.
+*/
+class RunStatistics : public TransitionListener
+{
+    public:
+
+    explicit RunStatistics(int boxCount);
+    RunStatistics() = delete;
+    RunStatistics(const RunStatistics& o) = delete;
+    RunStatistics(RunStatistics&& o) noexcept = delete;
+    RunStatistics& operator=(const RunStatistics& o) = delete;
+    RunStatistics& operator=(RunStatistics&& o) noexcept = delete;
+    ~RunStatistics() noexcept = default;
+
+    void receiveTransition(const SpotTransition& transition) override;
+
+    long getMoves() const;
+    long getCollisions() const;
+
+    /*
+    Returns the share of MoveType::to_arrive attempts that were refused, or 0 if there were none.
+    */
+    double getCollisionRate() const;
+
+    /*
+    Returns the number of Boxes that have entered and left the Board. Can be called while Boxes move.
+    */
+    int getExitedCount() const;
+
+    /*
+    Returns the time to exit in nanoseconds of every Box that has exited, in boxId order. Only call this once the Boxes have stopped moving.
+    */
+    std::vector<int64_t> getTimesToExit() const;
+
+
+    private:
+
+    struct BoxRecord
+    {
+        int64_t entered = -1;
+        int64_t exited = -1;
+        // The number of Spots the Box holds. It holds two in the middle of a move.
+        int spots = 0;
+    };
+
+    std::vector<BoxRecord> _boxes;
+    std::atomic<long> _moves{0};
+    std::atomic<long> _collisions{0};
+    std::atomic<int> _exited{0};
+};
+
+#endif
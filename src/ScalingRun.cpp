@@ -0,0 +1,221 @@
+#include "ScalingRun.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+#include "Board.h"
+#include "LockstepEngine.h"
+#include "MainSetup.h"
+#include "Recorder.h"
+#include "RunStatistics.h"
+#include "Threader.h"
+
+using namespace std;
+
+ScalingRun::Result ScalingRun::run(const Point& point, chrono::milliseconds timeLimit)
+{
+    if (point.width < 120 || point.height < 120)
+    {
+        throw invalid_argument("A ScalingRun Board must be at least 120 x 120.");
+    }
+    vector<Rectangle> inOutBoundRectangles = MainSetup::getInOutBoundRectangles(point.width, point.height);
+    if (point.batchCount < 1 || point.batchCount > static_cast<int>(inOutBoundRectangles.size()))
+    {
+        throw invalid_argument(
+            "A ScalingRun needs between 1 and " + to_string(inOutBoundRectangles.size()) + " batches.");
+    }
+    if (point.boxCount < point.batchCount || point.boxCount % point.batchCount != 0)
+    {
+        throw invalid_argument("A ScalingRun's Box count must be a positive multiple of its batch count.");
+    }
+
+    resetPeakRss();
+
+    int boxesPerBatch = point.boxCount / point.batchCount;
+    vector<Box> boxes{};
+    for (int batch=0; batch<point.batchCount; ++batch)
+    {
+        MainSetup::addAGroupOfBoxes(boxes, batch * boxesPerBatch, batch % 4, boxesPerBatch);
+    }
+
+    Board board{point.width, point.height, std::move(boxes)};
+    RunStatistics statistics{point.boxCount};
+    board.registerTransitionListener(&statistics);
+    Recorder recorder{point.width, point.height};
+    board.registerListener(&recorder);
+
+    auto start = chrono::steady_clock::now();
+    auto deadline = start + timeLimit;
+    auto end = start;
+    long agentSteps = 0;
+    int workers = 0;
+    Threader threader{};
+    if (point.backend == ExecutionBackend::lockstep)
+    {
+        workers = (point.workers > 0) ? point.workers : max(1, static_cast<int>(thread::hardware_concurrency()));
+        LockstepEngine engine{
+            board,
+            threader.planBatches(boxesPerBatch, point.batchCount, inOutBoundRectangles, point.width, point.height),
+            workers,
+            static_cast<uint32_t>(chrono::steady_clock::now().time_since_epoch().count()),
+            point.tileSize};
+
+        // Broadcasts about as often as the threads backend below, between ticks.
+        auto lastBroadcast = start;
+        engine.run(numeric_limits<long>::max(), [&board, &lastBroadcast, deadline](long){
+            auto now = chrono::steady_clock::now();
+            if (now - lastBroadcast >= chrono::milliseconds(16))
+            {
+                board.sendStateAndChanges();
+                lastBroadcast = now;
+            }
+            return now < deadline;
+        });
+        end = chrono::steady_clock::now();
+        agentSteps = engine.getStats().agentSteps;
+    }
+    else
+    {
+        bool running = true;
+        vector<unique_ptr<thread>> threads{};
+        threader.populateThreads(
+            threads,
+            boxesPerBatch,
+            point.batchCount,
+            inOutBoundRectangles,
+            board,
+            running);
+
+        while (statistics.getExitedCount() < point.boxCount && chrono::steady_clock::now() < deadline)
+        {
+            this_thread::sleep_for(chrono::milliseconds(16));
+            board.sendStateAndChanges();
+        }
+        end = chrono::steady_clock::now();
+
+        running = false;
+        for (auto& t : threads)
+        {
+            t->join();
+        }
+
+        // Every pass of funcMoveBox()'s loop records one deciding time.
+        for (const auto& group : board.getLatencies().getHistograms())
+        {
+            agentSteps += static_cast<long>(group.second[static_cast<int>(StepPhase::deciding)].getCount());
+        }
+    }
+
+    Result result{};
+    result.point = point;
+    result.point.workers = workers;
+    result.seconds = chrono::duration<double>(end - start).count();
+    result.moves = statistics.getMoves();
+    result.movesPerSecond = (result.seconds > 0) ? static_cast<double>(result.moves) / result.seconds : 0.0;
+    result.agentSteps = agentSteps;
+    result.agentStepsPerSecond = (result.seconds > 0) ? static_cast<double>(agentSteps) / result.seconds : 0.0;
+    result.collisionRate = statistics.getCollisionRate();
+    result.peakRssKb = getPeakRssKb();
+
+    vector<int64_t> times = statistics.getTimesToExit();
+    result.exitedCount = static_cast<int>(times.size());
+    result.meanTimeToExitMs = 0.0;
+    result.p99TimeToExitMs = 0.0;
+    if (!times.empty())
+    {
+        sort(times.begin(), times.end());
+        double sum = 0.0;
+        for (int64_t time : times)
+        {
+            sum += static_cast<double>(time);
+        }
+        result.meanTimeToExitMs = sum / static_cast<double>(times.size()) / 1e6;
+        // The smallest time that at least 99% of the exited Boxes are at or under.
+        size_t p99 = (times.size() * 99 + 99) / 100 - 1;
+        result.p99TimeToExitMs = static_cast<double>(times[p99]) / 1e6;
+    }
+    return result;
+}
+
+void ScalingRun::writeCsvHeader(ostream& out)
+{
+    out << "width,height,boxes,batches,backend,workers,tile_size,seconds,moves,moves_per_second,"
+        << "agent_steps,agent_steps_per_second,collision_rate,"
+        << "exited,mean_time_to_exit_ms,p99_time_to_exit_ms,peak_rss_kb\n";
+}
+
+void ScalingRun::writeCsvRow(ostream& out, const Result& result)
+{
+    out << result.point.width << ","
+        << result.point.height << ","
+        << result.point.boxCount << ","
+        << result.point.batchCount << ","
+        << toString(result.point.backend) << ","
+        << result.point.workers << ","
+        << result.point.tileSize << ","
+        << result.seconds << ","
+        << result.moves << ","
+        << result.movesPerSecond << ","
+        << result.agentSteps << ","
+        << result.agentStepsPerSecond << ","
+        << result.collisionRate << ","
+        << result.exitedCount << ","
+        << result.meanTimeToExitMs << ","
+        << result.p99TimeToExitMs << ","
+        << result.peakRssKb << "\n";
+}
+
+string ScalingRun::toString(ExecutionBackend backend)
+{
+    switch (backend)
+    {
+        case ExecutionBackend::threads:
+            return "threads";
+        case ExecutionBackend::lockstep:
+            return "lockstep";
+    }
+    return "unknown";
+}
+
+ExecutionBackend ScalingRun::toExecutionBackend(const string& name)
+{
+    if (name == "threads")
+    {
+        return ExecutionBackend::threads;
+    }
+    if (name == "lockstep")
+    {
+        return ExecutionBackend::lockstep;
+    }
+    throw invalid_argument("There is no ExecutionBackend named " + name + ".");
+}
+
+void ScalingRun::resetPeakRss()
+{
+    // Writing 5 to clear_refs resets VmHWM (Linux 4.0 and later).
+    ofstream clearRefs{"/proc/self/clear_refs"};
+    clearRefs << "5";
+}
+
+long ScalingRun::getPeakRssKb()
+{
+    ifstream status{"/proc/self/status"};
+    string line{};
+    while (getline(status, line))
+    {
+        if (line.rfind("VmHWM:", 0) == 0)
+        {
+            return stol(line.substr(6));
+        }
+    }
+
+    // No /proc: fall back to the peak of the whole process.
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
@@ -0,0 +1,82 @@
+#ifndef SCALINGRUN__H
+#define SCALINGRUN__H
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include "ExecutionBackend.h"
+
+/*
+Runs the simulation without a window and measures it, for scaling curves over Board size, Box count, batch count, ExecutionBackend, and worker count.
+
+A run is set up the way main.cpp sets up the application: the Boxes are split into batches, and each batch starts at one of MainSetup's in-out-bound Rectangles and heads for another. The Board broadcasts to a Recorder about 60 times a second, as it would to the Printer. The run ends when every Box has exited or the time limit is reached.
+
+An agent step is one decision by one Box: a pass of the loop in Threader::funcMoveBox() for the threads backend, and a proposal in a tick for the lockstep backend.
+*/
+class ScalingRun
+{
+    public:
+
+    struct Point
+    {
+        int width;
+        int height;
+        int boxCount;
+        int batchCount;
+        ExecutionBackend backend;
+        // The lockstep backend's worker threads. 0 uses one per hardware thread. The threads backend ignores it.
+        int workers = 0;
+        // The lockstep backend's tile size. 0 splits its work by Box. See LockstepEngine.
+        int tileSize = 0;
+    };
+
+    struct Result
+    {
+        // The Point run, with the lockstep backend's actual worker count. 0 for the threads backend.
+        Point point;
+        double seconds;
+        long moves;
+        double movesPerSecond;
+        long agentSteps;
+        double agentStepsPerSecond;
+        double collisionRate;
+        int exitedCount;
+        double meanTimeToExitMs;
+        double p99TimeToExitMs;
+        long peakRssKb;
+    };
+
+    ScalingRun() = delete;
+
+    /*
+    Runs @point until all its Boxes have exited or @timeLimit has passed. Boxes still on the Board at the time limit are stopped and are left out of the time to exit.
+
+    Throws an invalid_argument exception if @point's Board is too small for the in-out-bound Rectangles (under 120 x 120), if @point's batchCount is not between 1 and the number of Rectangles, or if boxCount is not a positive multiple of batchCount.
+    */
+    static Result run(const Point& point, std::chrono::milliseconds timeLimit);
+
+    static void writeCsvHeader(std::ostream& out);
+    static void writeCsvRow(std::ostream& out, const Result& result);
+
+    static std::string toString(ExecutionBackend backend);
+
+    /*
+    Throws an invalid_argument exception if @name is not the name of an ExecutionBackend.
+    */
+    static ExecutionBackend toExecutionBackend(const std::string& name);
+
+
+    private:
+
+    /*
+    Resets the process's peak resident set size, so the next read only covers what follows. Does nothing where the kernel does not support it.
+    */
+    static void resetPeakRss();
+
+    /*
+    Returns the peak resident set size in kilobytes.
+    */
+    static long getPeakRssKb();
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "SharedBoardExporter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "Frame.h"
+#include "MoveType.h"
+
+using namespace std;
+
+SharedBoardExporter::SharedBoardExporter(const string& name, int width, int height, int boxCount)
+:   _name{name}
+{
+    if (width < 1 || height < 1 || boxCount < 0)
+    {
+        throw invalid_argument("SharedBoardExporter needs a Board of at least 1 x 1 and a box count of at least 0.");
+    }
+    SharedBoardHeader layout = makeSharedBoardHeader(width, height, boxCount);
+    _size = static_cast<size_t>(layout.size);
+
+    // Start from a new segment, so a reader never sees a header from an earlier run with this run's tables.
+    shm_unlink(_name.c_str());
+    int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd == -1)
+    {
+        throw runtime_error("SharedBoardExporter can not create " + _name + ": " + strerror(errno));
+    }
+    if (ftruncate(fd, static_cast<off_t>(_size)) == -1)
+    {
+        int error = errno;
+        close(fd);
+        shm_unlink(_name.c_str());
+        throw runtime_error("SharedBoardExporter can not size " + _name + ": " + strerror(error));
+    }
+    void* memory = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(_name.c_str());
+        throw runtime_error("SharedBoardExporter can not map " + _name + ": " + strerror(errno));
+    }
+
+    char* base = static_cast<char*>(memory);
+    _header = reinterpret_cast<SharedBoardHeader*>(base);
+    _cells = reinterpret_cast<int32_t*>(base + layout.cellsOffset);
+    _types = reinterpret_cast<uint8_t*>(base + layout.typesOffset);
+    _boxes = reinterpret_cast<SharedBoxEntry*>(base + layout.boxesOffset);
+
+    // The new segment is zero filled. Empty cells have a boxId of -1.
+    int cells = width * height;
+    for (int cell=0; cell<cells; ++cell)
+    {
+        _cells[cell] = -1;
+        _types[cell] = static_cast<uint8_t>(MoveType::left);
+    }
+
+    *_header = layout;
+    _header->version = sharedBoardVersion;
+    _header->frameSequence = -1;
+
+    // The magic is written last. A reader that sees it sees a complete header.
+    atomic_thread_fence(memory_order_release);
+    memcpy(_header->magic, sharedBoardMagic, sizeof(sharedBoardMagic));
+}
+
+SharedBoardExporter::~SharedBoardExporter() noexcept
+{
+    munmap(_header, _size);
+    shm_unlink(_name.c_str());
+}
+
+void SharedBoardExporter::receiveChanges(const shared_ptr<const Frame>& frame)
+{
+    const vector<BoxInfo>& boxInfos = frame->getBoxInfos();
+    if (static_cast<int>(boxInfos.size()) > _header->boxCount)
+    {
+        throw invalid_argument("The Frame has " + to_string(boxInfos.size()) + " Boxes, but SharedBoardExporter has room for " + to_string(_header->boxCount) + ".");
+    }
+
+    // Seqlock: odd while writing.
+    atomic_ref<uint64_t> sequence{_header->sequence};
+    uint64_t start = sequence.load(memory_order_relaxed);
+    sequence.store(start + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    int width = _header->width;
+    for (const Drop& drop : frame->getChangedDrops())
+    {
+        Position position = drop.getPosition();
+        int cell = position.getY() * width + position.getX();
+        bool left = (drop.getMoveType() == MoveType::left);
+        atomic_ref<int32_t>{_cells[cell]}.store(left ? -1 : drop.getBoxId(), memory_order_relaxed);
+        atomic_ref<uint8_t>{_types[cell]}.store(static_cast<uint8_t>(drop.getMoveType()), memory_order_relaxed);
+    }
+
+    for (size_t ii=0; ii<boxInfos.size(); ++ii)
+    {
+        atomic_ref<int32_t>{_boxes[ii].id}.store(boxInfos[ii].getId(), memory_order_relaxed);
+        atomic_ref<int32_t>{_boxes[ii].groupId}.store(boxInfos[ii].getGroupId(), memory_order_relaxed);
+        atomic_ref<int32_t>{_boxes[ii].level}.store(boxInfos[ii].getLevel(), memory_order_relaxed);
+    }
+    atomic_ref<int64_t>{_header->frameSequence}.store(frame->getSequence(), memory_order_relaxed);
+
+    sequence.store(start + 2, memory_order_release);
+}
+
+const string& SharedBoardExporter::getName() const
+{
+    return _name;
+}
@@ -0,0 +1,55 @@
+#ifndef SHAREDBOARDEXPORTER__H
+#define SHAREDBOARDEXPORTER__H
+
+#include <cstdint>
+#include <string>
+#include "BoardListener.h"
+#include "SharedBoardLayout.h"
+
+/*
+Publishes the Board's occupancy and the Boxes' levels in a POSIX shared-memory segment, so another process can watch a live run. See SharedBoardLayout.h for the segment's layout.
+
+For each Frame, only the cells of the Frame's changed Drops are rewritten, along with the box table. Readers never make the exporter wait; a reader that overlaps a write notices through the seqlock and reads again.
+
+Only one thread may call receiveChanges() at a time. The Board calls it from sendStateAndChanges(), which it does not enter from two threads at once. Wrapping the exporter in an AsyncBoardListener takes the writing off of the Board's broadcasting thread.
+*/
+class SharedBoardExporter : public BoardListener
+{
+    public:
+
+    /*
+    Creates the shared-memory segment @name (for example "/plazawalk"), replacing one that already exists, and marks every cell empty. Throws a runtime_error if the segment can not be created.
+
+    @boxCount is the number of Boxes in the Board's Frames.
+    */
+    SharedBoardExporter(const std::string& name, int width, int height, int boxCount);
+    SharedBoardExporter() = delete;
+    SharedBoardExporter(const SharedBoardExporter& o) = delete;
+    SharedBoardExporter(SharedBoardExporter&& o) noexcept = delete;
+    SharedBoardExporter& operator=(const SharedBoardExporter& o) = delete;
+    SharedBoardExporter& operator=(SharedBoardExporter&& o) noexcept = delete;
+
+    /*
+    Unmaps and removes the segment. Readers that still have it mapped keep their mapping.
+    */
+    ~SharedBoardExporter() noexcept;
+
+    /*
+    Writes @frame's changed Drops and BoxInfos to the segment. Throws an invalid_argument exception if @frame has more Boxes than the segment has room for.
+    */
+    void receiveChanges(const std::shared_ptr<const Frame>& frame) override;
+
+    const std::string& getName() const;
+
+
+    private:
+
+    const std::string _name;
+    SharedBoardHeader* _header = nullptr;
+    int32_t* _cells = nullptr;
+    uint8_t* _types = nullptr;
+    SharedBoxEntry* _boxes = nullptr;
+    size_t _size = 0;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef SHAREDBOARDLAYOUT__H
+#define SHAREDBOARDLAYOUT__H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+Layout of the POSIX shared-memory segment that SharedBoardExporter writes and SharedBoardReader reads.
+
+The segment starts with a SharedBoardHeader, followed by three tables at the offsets given in the header:
+    cells     int32 per cell, the boxId in the cell or -1 if the cell is empty. Cell y * width + x is Position {x, y}.
+    types     uint8 per cell, the MoveType in the cell (MoveType::left if the cell is empty).
+    boxes     SharedBoxEntry per Box, in the order of the Frame's BoxInfos.
+
+sequence is a seqlock. The writer makes it odd before it changes anything and even again when it is done. A reader remembers an even sequence, reads, and then checks that sequence has not changed. If it has, the reader read a mix of two Frames and must read again.
+
+All fields after the header are read and written as relaxed atomics (std::atomic_ref), so a reader racing the writer is well defined; the seqlock tells the reader whether what it read belongs together.
+*/
+constexpr char sharedBoardMagic[8] = {'P', 'W', 'S', 'H', 'A', 'R', 'E', '\0'};
+constexpr uint32_t sharedBoardVersion = 1;
+
+struct SharedBoardHeader
+{
+    char magic[8];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t boxCount;
+    alignas(8) uint64_t sequence;
+    int64_t frameSequence;
+    uint64_t cellsOffset;
+    uint64_t typesOffset;
+    uint64_t boxesOffset;
+    uint64_t size;
+};
+
+struct SharedBoxEntry
+{
+    int32_t id;
+    int32_t groupId;
+    int32_t level;
+};
+
+/*
+Returns the offsets of the tables and the total size of a segment for a @width x @height Board with @boxCount Boxes.
+*/
+inline SharedBoardHeader makeSharedBoardHeader(int width, int height, int boxCount)
+{
+    SharedBoardHeader header{};
+    header.width = width;
+    header.height = height;
+    header.boxCount = boxCount;
+
+    uint64_t cells = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    header.cellsOffset = (sizeof(SharedBoardHeader) + 63) / 64 * 64;
+    header.typesOffset = (header.cellsOffset + cells * sizeof(int32_t) + 63) / 64 * 64;
+    header.boxesOffset = (header.typesOffset + cells * sizeof(uint8_t) + 63) / 64 * 64;
+    header.size = header.boxesOffset + static_cast<uint64_t>(boxCount) * sizeof(SharedBoxEntry);
+    return header;
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include "SharedBoardReader.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+    // atomic_ref needs a non-const object. The segment is mapped read-only, and only loads are made through these.
+    template<typename T>
+    T loadRelaxed(const T& value)
+    {
+        return atomic_ref<T>{const_cast<T&>(value)}.load(memory_order_relaxed);
+    }
+}
+
+SharedBoardReader::SharedBoardReader(const string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1)
+    {
+        throw runtime_error("SharedBoardReader can not open " + name + ": " + strerror(errno));
+    }
+    struct stat status{};
+    if (fstat(fd, &status) == -1 || static_cast<size_t>(status.st_size) < sizeof(SharedBoardHeader))
+    {
+        close(fd);
+        throw invalid_argument(name + " is too small to be a SharedBoardExporter segment.");
+    }
+    _size = static_cast<size_t>(status.st_size);
+    void* memory = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        throw runtime_error("SharedBoardReader can not map " + name + ": " + strerror(errno));
+    }
+
+    const char* base = static_cast<const char*>(memory);
+    _header = reinterpret_cast<const SharedBoardHeader*>(base);
+    atomic_thread_fence(memory_order_acquire);
+    if (memcmp(_header->magic, sharedBoardMagic, sizeof(sharedBoardMagic)) != 0 ||
+        _header->version != sharedBoardVersion ||
+        _header->size > _size)
+    {
+        munmap(memory, _size);
+        throw invalid_argument(name + " is not a SharedBoardExporter segment of version " + to_string(sharedBoardVersion) + ".");
+    }
+    _cells = reinterpret_cast<const int32_t*>(base + _header->cellsOffset);
+    _types = reinterpret_cast<const uint8_t*>(base + _header->typesOffset);
+    _boxes = reinterpret_cast<const SharedBoxEntry*>(base + _header->boxesOffset);
+}
+
+SharedBoardReader::~SharedBoardReader() noexcept
+{
+    munmap(const_cast<SharedBoardHeader*>(_header), _size);
+}
+
+int SharedBoardReader::getWidth() const
+{
+    return _header->width;
+}
+
+int SharedBoardReader::getHeight() const
+{
+    return _header->height;
+}
+
+int SharedBoardReader::getBoxCount() const
+{
+    return _header->boxCount;
+}
+
+uint64_t SharedBoardReader::beginRead() const
+{
+    atomic_ref<uint64_t> sequence{const_cast<uint64_t&>(_header->sequence)};
+    uint64_t value = sequence.load(memory_order_acquire);
+    while (value & 1)
+    {
+        this_thread::yield();
+        value = sequence.load(memory_order_acquire);
+    }
+    return value;
+}
+
+bool SharedBoardReader::endRead(uint64_t sequence) const
+{
+    atomic_thread_fence(memory_order_acquire);
+    return loadRelaxed(_header->sequence) == sequence;
+}
+
+long SharedBoardReader::getFrameSequence() const
+{
+    return static_cast<long>(loadRelaxed(_header->frameSequence));
+}
+
+int SharedBoardReader::getBoxId(int cell) const
+{
+    return loadRelaxed(_cells[cell]);
+}
+
+MoveType SharedBoardReader::getMoveType(int cell) const
+{
+    return static_cast<MoveType>(loadRelaxed(_types[cell]));
+}
+
+int SharedBoardReader::getBoxIdAt(int index) const
+{
+    return loadRelaxed(_boxes[index].id);
+}
+
+int SharedBoardReader::getGroupIdAt(int index) const
+{
+    return loadRelaxed(_boxes[index].groupId);
+}
+
+int SharedBoardReader::getLevelAt(int index) const
+{
+    return loadRelaxed(_boxes[index].level);
+}
@@ -0,0 +1,84 @@
+#ifndef SHAREDBOARDREADER__H
+#define SHAREDBOARDREADER__H
+
+#include <cstdint>
+#include <string>
+#include "MoveType.h"
+#include "SharedBoardLayout.h"
+
+/*
+Maps a segment written by SharedBoardExporter, read-only, and reads the Board from it in place. See SharedBoardLayout.h for the layout.
+
+Reading makes no system calls and copies nothing. A consistent read looks like this:
+
+    while (true)
+    {
+        uint64_t sequence = reader.beginRead();
+        ... read cells and boxes with the getters ...
+        if (reader.endRead(sequence))
+        {
+            break;
+        }
+    }
+
+If endRead() returns false, the exporter wrote a Frame during the read, and what was read must be thrown away.
+*/
+class SharedBoardReader
+{
+    public:
+
+    /*
+    Maps the shared-memory segment @name. Throws a runtime_error if the segment does not exist, and an invalid_argument exception if it is not a SharedBoardExporter segment of this version.
+    */
+    explicit SharedBoardReader(const std::string& name);
+    SharedBoardReader() = delete;
+    SharedBoardReader(const SharedBoardReader& o) = delete;
+    SharedBoardReader(SharedBoardReader&& o) noexcept = delete;
+    SharedBoardReader& operator=(const SharedBoardReader& o) = delete;
+    SharedBoardReader& operator=(SharedBoardReader&& o) noexcept = delete;
+    ~SharedBoardReader() noexcept;
+
+    int getWidth() const;
+    int getHeight() const;
+    int getBoxCount() const;
+
+    /*
+    Waits until the exporter is not writing and returns the seqlock sequence to pass to endRead().
+    */
+    uint64_t beginRead() const;
+
+    /*
+    Returns true if nothing was written since beginRead() returned @sequence.
+    */
+    bool endRead(uint64_t sequence) const;
+
+    /*
+    Returns the sequence number of the last Frame written, or -1 if no Frame has been written.
+    */
+    long getFrameSequence() const;
+
+    /*
+    Returns the boxId in @cell, or -1 if @cell is empty.
+    */
+    int getBoxId(int cell) const;
+
+    MoveType getMoveType(int cell) const;
+
+    /*
+    The id, groupId, and level of the Box at @index of the box table.
+    */
+    int getBoxIdAt(int index) const;
+    int getGroupIdAt(int index) const;
+    int getLevelAt(int index) const;
+
+
+    private:
+
+    const SharedBoardHeader* _header = nullptr;
+    const int32_t* _cells = nullptr;
+    const uint8_t* _types = nullptr;
+    const SharedBoxEntry* _boxes = nullptr;
+    size_t _size = 0;
+};
+
+#endif
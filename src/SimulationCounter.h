@@ -0,0 +1,26 @@
+#ifndef SIMULATIONCOUNTER__H
+#define SIMULATIONCOUNTER__H
+
+/*
+The events SimulationMetrics counts.
+changeSpotSucceeded and changeSpotFailed count every Board::changeSpot() call.
+collisions counts the failed calls that raised the Boxes' levels, that is a Box running into another.
+entryRetries counts the times a Box waiting to enter the Board was held back, by its Decider or by an occupied Spot.
+deciderNoMove counts the times a Decider did not pick any Position to move to.
+diagonalMoves and lateralMoves count successful moves.
+boxesEntered and boxesExited count Boxes added to and removed from the Board.
+*/
+enum class SimulationCounter{
+    changeSpotSucceeded=0,
+    changeSpotFailed=1,
+    collisions=2,
+    entryRetries=3,
+    deciderNoMove=4,
+    diagonalMoves=5,
+    lateralMoves=6,
+    boxesEntered=7,
+    boxesExited=8};
+
+constexpr int simulationCounterCount = 9;
+
+#endif
@@ -0,0 +1,122 @@
+#include "SimulationMetrics.h"
+
+using namespace std;
+
+uint64_t SimulationMetrics::Snapshot::get(SimulationCounter counter) const
+{
+    return counts[static_cast<size_t>(counter)];
+}
+
+SimulationMetrics::SimulationMetrics()
+:   _start{chrono::steady_clock::now()}
+{}
+
+void SimulationMetrics::count(SimulationCounter counter, uint64_t amount)
+{
+    // Only this thread writes to its shard, so a load and a store are enough.
+    atomic<uint64_t>& value = _shards.getForThisThread().counts[static_cast<size_t>(counter)];
+    value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+SimulationMetrics::Snapshot SimulationMetrics::getSnapshot() const
+{
+    Snapshot snapshot{};
+    snapshot.seconds = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+
+    _shards.visitAll([&snapshot](const vector<unique_ptr<Shard>>& shards){
+        for (const auto& shard : shards)
+        {
+            for (size_t ii=0; ii<snapshot.counts.size(); ++ii)
+            {
+                snapshot.counts[ii] += shard->counts[ii].load(memory_order_relaxed);
+            }
+        }
+    });
+    return snapshot;
+}
+
+string SimulationMetrics::getName(SimulationCounter counter)
+{
+    switch (counter)
+    {
+        case SimulationCounter::changeSpotSucceeded:
+            return "change_spot_succeeded";
+        case SimulationCounter::changeSpotFailed:
+            return "change_spot_failed";
+        case SimulationCounter::collisions:
+            return "collisions";
+        case SimulationCounter::entryRetries:
+            return "entry_retries";
+        case SimulationCounter::deciderNoMove:
+            return "decider_no_move";
+        case SimulationCounter::diagonalMoves:
+            return "diagonal_moves";
+        case SimulationCounter::lateralMoves:
+            return "lateral_moves";
+        case SimulationCounter::boxesEntered:
+            return "boxes_entered";
+        case SimulationCounter::boxesExited:
+            return "boxes_exited";
+    }
+    return "unknown";
+}
+
+double SimulationMetrics::getRate(const Snapshot& before, const Snapshot& after, SimulationCounter counter)
+{
+    double seconds = after.seconds - before.seconds;
+    if (seconds <= 0.0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(after.get(counter) - before.get(counter)) / seconds;
+}
+
+vector<string> SimulationMetrics::getSummaryLines(const Snapshot& before, const Snapshot& after)
+{
+    auto format = [](double value){
+        return to_string(static_cast<long>(value + 0.5));
+    };
+
+    double diagonal = getRate(before, after, SimulationCounter::diagonalMoves);
+    double lateral = getRate(before, after, SimulationCounter::lateralMoves);
+    uint64_t entered = after.get(SimulationCounter::boxesEntered);
+    uint64_t exited = after.get(SimulationCounter::boxesExited);
+
+    vector<string> lines{};
+    lines.push_back("moves/s " + format(diagonal + lateral) + " (diagonal " + format(diagonal) + ", lateral " + format(lateral) + ")");
+    lines.push_back("collisions/s " + format(getRate(before, after, SimulationCounter::collisions)));
+    lines.push_back("entry retries/s " + format(getRate(before, after, SimulationCounter::entryRetries)) +
+        ", no move/s " + format(getRate(before, after, SimulationCounter::deciderNoMove)));
+    lines.push_back("on board " + to_string(entered - exited) + ", exited " + to_string(exited));
+    return lines;
+}
+
+void SimulationMetrics::writeCsvHeader(ostream& out)
+{
+    out << "seconds";
+    for (int ii=0; ii<simulationCounterCount; ++ii)
+    {
+        out << "," << getName(static_cast<SimulationCounter>(ii));
+    }
+    out << "\n";
+}
+
+void SimulationMetrics::writeCsvRow(ostream& out, const Snapshot& snapshot)
+{
+    out << snapshot.seconds;
+    for (uint64_t value : snapshot.counts)
+    {
+        out << "," << value;
+    }
+    out << "\n";
+}
+
+void SimulationMetrics::writeJson(ostream& out, const Snapshot& snapshot)
+{
+    out << "{\"seconds\":" << snapshot.seconds;
+    for (int ii=0; ii<simulationCounterCount; ++ii)
+    {
+        out << ",\"" << getName(static_cast<SimulationCounter>(ii)) << "\":" << snapshot.counts[ii];
+    }
+    out << "}\n";
+}
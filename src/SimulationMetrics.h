@@ -0,0 +1,87 @@
+#ifndef SIMULATIONMETRICS__H
+#define SIMULATIONMETRICS__H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "SimulationCounter.h"
+#include "ThreadShards.h"
+
+/*
+Counts SimulationCounter events while Boxes move. Board owns one, and Board, Mover, and Threader::funcMoveBox() count into it.
+
+Counting has to be cheap, since changeSpot() counts on every call. Each thread counts into its own shard, which no other thread writes to, so counting is a relaxed load and store without a lock or a shared cache line. Only the first count from a new thread takes a lock, to find that thread's shard. Shards come from ThreadShards, so a thread that exits leaves its shard, and its counts, to the next new thread.
+
+getSnapshot() may be called at any time. It adds up the shards. A Snapshot is not taken atomically across counters, so counters that are counted together may be off by the few counts in flight.
+*/
+class SimulationMetrics
+{
+    public:
+
+    struct Snapshot
+    {
+        // Seconds since the SimulationMetrics was created.
+        double seconds;
+        std::array<uint64_t, simulationCounterCount> counts;
+
+        uint64_t get(SimulationCounter counter) const;
+    };
+
+    SimulationMetrics();
+    SimulationMetrics(const SimulationMetrics& o) = delete;
+    SimulationMetrics(SimulationMetrics&& o) noexcept = delete;
+    SimulationMetrics& operator=(const SimulationMetrics& o) = delete;
+    SimulationMetrics& operator=(SimulationMetrics&& o) noexcept = delete;
+    ~SimulationMetrics() noexcept = default;
+
+    /*
+    Adds @amount to @counter.
+    */
+    void count(SimulationCounter counter, uint64_t amount = 1);
+
+    Snapshot getSnapshot() const;
+
+    /*
+    Returns a name like "collisions", used as the CSV column and JSON key.
+    */
+    static std::string getName(SimulationCounter counter);
+
+    /*
+    Returns how many times per second @counter was counted between @before and @after.
+    */
+    static double getRate(const Snapshot& before, const Snapshot& after, SimulationCounter counter);
+
+    /*
+    Returns a few short lines for a HUD: the rates between @before and @after, and the totals at @after.
+    */
+    static std::vector<std::string> getSummaryLines(const Snapshot& before, const Snapshot& after);
+
+    /*
+    CSV columns are seconds followed by every counter, in SimulationCounter order.
+    */
+    static void writeCsvHeader(std::ostream& out);
+    static void writeCsvRow(std::ostream& out, const Snapshot& snapshot);
+
+    /*
+    Writes @snapshot as one JSON object on one line.
+    */
+    static void writeJson(std::ostream& out, const Snapshot& snapshot);
+
+
+    private:
+
+    struct alignas(64) Shard
+    {
+        std::array<std::atomic<uint64_t>, simulationCounterCount> counts{};
+    };
+
+    const std::chrono::steady_clock::time_point _start;
+
+    ThreadShards<Shard> _shards{};
+};
+
+#endif
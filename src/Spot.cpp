@@ -28,8 +28,12 @@ Position Spot::getPosition() const
 
 pair<int, bool> Spot::changeNote(BoardNote incomingNote)
 {
-    unique_lock<shared_mutex> lock(_mm);
+    ProfiledUniqueLock lock(_mm);
+    return changeOwnedNote(incomingNote);
+}
 
+pair<int, bool> Spot::changeOwnedNote(BoardNote incomingNote)
+{
     int incomingBoxId = incomingNote.getBoxId();
     MoveType incomingType  = incomingNote.getType();
     
@@ -105,7 +109,12 @@ pair<int, bool> Spot::changeNote(BoardNote incomingNote)
 
 BoardNote Spot::getBoardNote() const
 {
-    shared_lock<shared_mutex> lock(_mm);
+    ProfiledSharedLock lock(_mm);
+    return BoardNote{_boxId, _type};
+}
+
+BoardNote Spot::getOwnedBoardNote() const
+{
     return BoardNote{_boxId, _type};
 }
 
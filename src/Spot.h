@@ -1,10 +1,10 @@
 #ifndef SPOT__H 
 #define SPOT__H
 
-#include <shared_mutex>
 #include <vector>
 #include "BoardNote.h"
 #include "Position.h"
+#include "ProfiledSharedMutex.h"
 #include "SpotListener.h"
 #include "MoveType.h"
 
@@ -30,6 +30,11 @@ class Spot
     */
     BoardNote getBoardNote() const;
 
+    /*
+    Same as getBoardNote(), but without locking the Spot. Only for a caller that owns the Spot: no other thread may change it until getOwnedBoardNote() returns.
+    */
+    BoardNote getOwnedBoardNote() const;
+
     /* Updates the Spot with the @boardNotes's boxId and MoveType.
 
     changeNote() is thread safe, only one thread can access this method at one time.
@@ -48,6 +53,11 @@ class Spot
     */
     std::pair<int, bool> changeNote(BoardNote note);
 
+    /*
+    Same as changeNote(), but without locking the Spot. Only for a caller that owns the Spot: no other thread may read or change it until changeOwnedNote() returns.
+    */
+    std::pair<int, bool> changeOwnedNote(BoardNote note);
+
     void registerListener(SpotListener* listener);
 
 
@@ -56,7 +66,7 @@ class Spot
     const Position _position;
     int _boxId = -1;
     MoveType _type = MoveType::left;
-    mutable std::shared_mutex _mm;
+    mutable ProfiledSharedMutex _mm{"Spot::_mm"};
     
     std::string _stateString = "-1, MoveType::left";
 
@@ -0,0 +1,41 @@
+#ifndef SPOTTRANSITION__H
+#define SPOTTRANSITION__H
+
+#include <cstdint>
+#include "MoveType.h"
+
+/*
+One call to Board's changeSpot(). Either the Spot at {x, y} was changed to @boxId and @type, or the change was refused because another Box was already at the Spot (a collision).
+
+@timestamp is in nanoseconds since the Board was constructed.
+@otherBoxId is the boxId that was at the Spot before the call, -1 if the Spot was empty. For a collision it is the Box that was run into.
+@upLevel is the upLevel argument of changeSpot(). A collision only raises the two Boxes' levels if upLevel is set.
+
+SpotTransition has a fixed size and no pointers, so it can be copied into buffers and written to disk as is.
+*/
+struct SpotTransition
+{
+    int64_t timestamp;
+    int32_t boxId;
+    int32_t otherBoxId;
+    uint16_t x;
+    uint16_t y;
+    uint8_t type;
+    uint8_t collision;
+    uint8_t upLevel;
+    uint8_t reserved;
+
+    MoveType getMoveType() const
+    {
+        return static_cast<MoveType>(type);
+    }
+
+    bool isCollision() const
+    {
+        return collision != 0;
+    }
+};
+
+static_assert(sizeof(SpotTransition) == 24, "SpotTransition is written to disk as a 24 byte record.");
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef STEPPHASE__H
+#define STEPPHASE__H
+
+/*
+Where a Box's time goes, as recorded by PhaseLatencies.
+waitingToEnter is the time from a Box's thread starting until the Box is added to the Board.
+deciding is one call to Decider::getNext().
+blocked is the time from a Box first failing to move, because its Decider chose no Position or the chosen Spot was taken, until its next move.
+holdingTwoSpots is the time a move holds both the old and the new Spot, from Mover::moveBox()'s to_arrive until its left.
+changeSpotLockWait is the time Board::changeSpot() waits for the Board's lock. It is only recorded in a build configured with -DPLAZA_LOCK_WAIT_LATENCIES=ON, see PhaseLatencies::recordsChangeSpotLockWait().
+*/
+enum class StepPhase{
+    waitingToEnter=0,
+    deciding=1,
+    blocked=2,
+    holdingTwoSpots=3,
+    changeSpotLockWait=4};
+
+constexpr int stepPhaseCount = 5;
+
+#endif
@@ -0,0 +1,126 @@
+#include "StreamSocket.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+    sockaddr_un makeUnixAddress(const string& path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw invalid_argument("The Unix socket path " + path + " is too long.");
+        }
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
+
+    sockaddr_in makeTcpAddress(const string& hostAndPort)
+    {
+        size_t colon = hostAndPort.rfind(':');
+        if (colon == string::npos)
+        {
+            throw invalid_argument(hostAndPort + " is neither a Unix socket path nor host:port.");
+        }
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(stoi(hostAndPort.substr(colon + 1))));
+        if (inet_pton(AF_INET, hostAndPort.substr(0, colon).c_str(), &address.sin_addr) != 1)
+        {
+            throw invalid_argument(hostAndPort + " does not have an IPv4 host.");
+        }
+        return address;
+    }
+
+    [[noreturn]] void fail(int fd, const string& what, const string& address)
+    {
+        int error = errno;
+        if (fd != -1)
+        {
+            close(fd);
+        }
+        throw runtime_error("Can not " + what + " " + address + ": " + strerror(error));
+    }
+}
+
+int StreamSocket::listenOn(const string& address, int& port)
+{
+    int fd = -1;
+    if (!address.empty() && address[0] == '/')
+    {
+        sockaddr_un unixAddress = makeUnixAddress(address);
+        unlink(address.c_str());
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1 || bind(fd, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) == -1)
+        {
+            fail(fd, "bind to", address);
+        }
+        port = -1;
+    }
+    else
+    {
+        sockaddr_in tcpAddress = makeTcpAddress(address);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (fd == -1 ||
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == -1 ||
+            bind(fd, reinterpret_cast<sockaddr*>(&tcpAddress), sizeof(tcpAddress)) == -1)
+        {
+            fail(fd, "bind to", address);
+        }
+        socklen_t length = sizeof(tcpAddress);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&tcpAddress), &length);
+        port = ntohs(tcpAddress.sin_port);
+    }
+
+    if (listen(fd, 16) == -1)
+    {
+        fail(fd, "listen on", address);
+    }
+    setNonBlocking(fd);
+    return fd;
+}
+
+int StreamSocket::connectTo(const string& address)
+{
+    int fd = -1;
+    if (!address.empty() && address[0] == '/')
+    {
+        sockaddr_un unixAddress = makeUnixAddress(address);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1 || connect(fd, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) == -1)
+        {
+            fail(fd, "connect to", address);
+        }
+    }
+    else
+    {
+        sockaddr_in tcpAddress = makeTcpAddress(address);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd == -1 || connect(fd, reinterpret_cast<sockaddr*>(&tcpAddress), sizeof(tcpAddress)) == -1)
+        {
+            fail(fd, "connect to", address);
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return fd;
+}
+
+void StreamSocket::setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
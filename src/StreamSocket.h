@@ -0,0 +1,31 @@
+#ifndef STREAMSOCKET__H
+#define STREAMSOCKET__H
+
+#include <string>
+
+/*
+Opens the sockets used by FrameStreamServer and FrameStreamClient.
+
+An address that starts with '/' is a Unix socket path. Any other address is "host:port" for TCP, for example "127.0.0.1:7000". Port 0 asks for any free port.
+*/
+class StreamSocket
+{
+public:
+
+    /*
+    Returns a non-blocking socket listening on @address. @port is set to the TCP port that was bound, or -1 for a Unix socket. An existing Unix socket file at @address is replaced. Throws a runtime_error if the socket can not be opened, and an invalid_argument exception if @address can not be parsed.
+    */
+    static int listenOn(const std::string& address, int& port);
+
+    /*
+    Returns a blocking socket connected to @address. Throws like listenOn().
+    */
+    static int connectTo(const std::string& address);
+
+    /*
+    Makes @fd non-blocking.
+    */
+    static void setNonBlocking(int fd);
+};
+
+#endif
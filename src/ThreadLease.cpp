@@ -0,0 +1,64 @@
+#include "ThreadLease.h"
+
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    struct Registry
+    {
+        mutex mux;
+        vector<uint32_t> freeIndexes{};
+        uint32_t nextIndex = 0;
+        uint64_t nextGeneration = 1;
+    };
+
+    Registry& getRegistry()
+    {
+        // Never destroyed, so threads that outlive main() can still hand their index back.
+        static Registry* registry = new Registry{};
+        return *registry;
+    }
+
+    // Hands the thread's index back to the Registry when the thread exits.
+    struct IndexReturner
+    {
+        uint32_t index = 0;
+
+        ~IndexReturner()
+        {
+            Registry& registry = getRegistry();
+            lock_guard<mutex> lock(registry.mux);
+            registry.freeIndexes.push_back(index);
+        }
+    };
+}
+
+void ThreadLease::take()
+{
+    Registry& registry = getRegistry();
+    {
+        lock_guard<mutex> lock(registry.mux);
+        if (registry.freeIndexes.empty())
+        {
+            if (registry.nextIndex == maxThreads)
+            {
+                throw runtime_error("ThreadLease can not give out more than " + to_string(maxThreads) + " indexes at one time.");
+            }
+            _current.index = registry.nextIndex++;
+        }
+        else
+        {
+            _current.index = registry.freeIndexes.back();
+            registry.freeIndexes.pop_back();
+        }
+        _current.generation = registry.nextGeneration++;
+    }
+
+    thread_local IndexReturner returner{};
+    returner.index = _current.index;
+}
@@ -0,0 +1,45 @@
+#ifndef THREADLEASE__H
+#define THREADLEASE__H
+
+#include <cstdint>
+
+/*
+A small index that the current thread holds for as long as it runs, used by ThreadShards to find the thread's shard without a lock.
+
+Indexes are handed out from 0 up, and a thread's index is handed to the next new thread once it exits, so they stay below the number of threads alive at one time. The generation tells apart the threads that held the same index; no two threads ever get the same generation.
+*/
+class ThreadLease
+{
+    public:
+
+    // The most threads that can hold a ThreadLease at one time.
+    static constexpr uint32_t maxThreads = 65536;
+
+    uint32_t index = 0;
+    // 0 until the thread takes its lease.
+    uint64_t generation = 0;
+
+    /*
+    Returns the current thread's lease, taking one on the first call. Throws a runtime_error if maxThreads threads already hold one.
+    */
+    static const ThreadLease& getForThisThread()
+    {
+        if (_current.generation == 0)
+        {
+            take();
+        }
+        return _current;
+    }
+
+
+    private:
+
+    // Trivial, so reading it costs no more than any other thread_local variable. It is handed back by a separate thread_local object, which only the first call creates.
+    static thread_local ThreadLease _current;
+
+    static void take();
+};
+
+inline thread_local ThreadLease ThreadLease::_current{};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef THREADSHARDS__H
+#define THREADSHARDS__H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "ThreadLease.h"
+
+/*
+One Shard per thread for an owner like SimulationMetrics or NoteAccountant, so each thread can count or append into its own Shard without a lock.
+
+A thread finds its Shard through its ThreadLease index, in a table that only that thread writes to. Only a thread's first call takes a lock. When a thread exits, its Shard goes to the next thread that gets its index, so an owner keeps at most one Shard per thread alive at one time, however many threads come and go. The Shard keeps what the exited thread left in it, unless @reuseShard clears it.
+
+visitAll() reads the Shards under the same lock, and may be called at any time.
+*/
+template <typename Shard>
+class ThreadShards
+{
+    public:
+
+    using MakeShard = std::function<std::unique_ptr<Shard>()>;
+    using ReuseShard = std::function<void(Shard&)>;
+
+    /*
+    @makeShard creates the Shard of a thread that gets an index no thread has had before. By default it makes a value-initialised Shard.
+    @reuseShard, if set, is called with an exited thread's Shard before the next thread gets it. It is called while holding the lock visitAll() takes.
+    */
+    explicit ThreadShards(
+        MakeShard makeShard = []{ return std::make_unique<Shard>(); },
+        ReuseShard reuseShard = {})
+    :   _makeShard{std::move(makeShard)},
+        _reuseShard{std::move(reuseShard)}
+    {}
+    ThreadShards(const ThreadShards& o) = delete;
+    ThreadShards(ThreadShards&& o) noexcept = delete;
+    ThreadShards& operator=(const ThreadShards& o) = delete;
+    ThreadShards& operator=(ThreadShards&& o) noexcept = delete;
+
+    ~ThreadShards() noexcept
+    {
+        for (std::atomic<Slot*>& block : _blocks)
+        {
+            delete[] block.load(std::memory_order_relaxed);
+        }
+    }
+
+    /*
+    Returns the current thread's Shard. Throws a runtime_error if the thread can not get a ThreadLease.
+    */
+    Shard& getForThisThread()
+    {
+        const ThreadLease& lease = ThreadLease::getForThisThread();
+        const Slot* block = _blocks[lease.index / blockSize].load(std::memory_order_acquire);
+        if (block != nullptr)
+        {
+            const Slot& slot = block[lease.index % blockSize];
+            if (slot.generation == lease.generation)
+            {
+                return *slot.shard;
+            }
+        }
+        return claim(lease);
+    }
+
+    /*
+    Calls @visitor with every Shard made so far, as a const std::vector<std::unique_ptr<Shard>>&, while holding the lock.
+    */
+    template <typename Visitor>
+    void visitAll(Visitor&& visitor) const
+    {
+        std::lock_guard<std::mutex> lock(_mux);
+        visitor(_shards);
+    }
+
+    /*
+    Like the const visitAll(), for a @visitor that changes the Shards in ways their threads allow.
+    */
+    template <typename Visitor>
+    void visitAll(Visitor&& visitor)
+    {
+        std::lock_guard<std::mutex> lock(_mux);
+        visitor(_shards);
+    }
+
+
+    private:
+
+    // Only the thread that holds the index writes to its Slot. A Slot only changes threads through ThreadLease, which hands the index over under a lock.
+    struct Slot
+    {
+        Shard* shard = nullptr;
+        // The ThreadLease generation of the thread the Shard was last given to.
+        uint64_t generation = 0;
+    };
+
+    // Slots are allocated in blocks, so an owner only pays for the indexes its threads use.
+    static constexpr size_t blockSize = 64;
+    static constexpr size_t blockCount = ThreadLease::maxThreads / blockSize;
+
+    const MakeShard _makeShard;
+    const ReuseShard _reuseShard;
+
+    std::array<std::atomic<Slot*>, blockCount> _blocks{};
+    std::vector<std::unique_ptr<Shard>> _shards{};
+    mutable std::mutex _mux;
+
+    Shard& claim(const ThreadLease& lease)
+    {
+        std::lock_guard<std::mutex> lock(_mux);
+        std::atomic<Slot*>& block = _blocks[lease.index / blockSize];
+        if (block.load(std::memory_order_relaxed) == nullptr)
+        {
+            // Released, so a thread that finds the block also finds its empty Slots.
+            block.store(new Slot[blockSize]{}, std::memory_order_release);
+        }
+
+        Slot& slot = block.load(std::memory_order_relaxed)[lease.index % blockSize];
+        if (slot.shard == nullptr)
+        {
+            _shards.push_back(_makeShard());
+            slot.shard = _shards.back().get();
+        }
+        else if (_reuseShard)
+        {
+            _reuseShard(*slot.shard);
+        }
+        slot.generation = lease.generation;
+        return *slot.shard;
+    }
+};
+
+#endif
@@ -9,6 +9,8 @@
 #include "PositionManager_Down.h"
 #include "PositionManager_Step.h"
 #include "PositionManager_Up.h"
+#include "Tracer.h"
+#include "TscClock.h"
 #include "Util.h"
 
 using namespace std;
@@ -23,53 +25,91 @@ void Threader::funcMoveBox(
         unique_ptr<PositionManager> posManager,
         unique_ptr<Decider> decider,
         unique_ptr<Mover> mover,
+        PositionManagerType pmt,
+        DeciderType dt,
         bool& breaker
 )
 {  
     Position curPosition = position;
+    int boxId = mover->getBoxId();
+    PhaseLatencies& latencies = board.getLatencies();
+    latencies.setGroupForThisThread(dt, pmt);
 
     /* Move Box on to @board. */
+    uint64_t enterStart = TscClock::now();
+    DoorwayFlow& doorwayFlow = board.getDoorwayFlow();
+    doorwayFlow.startWaiting(position);
     int n = 1;
     while(breaker)
     {
+        PLAZA_TRACE_SPAN("enter attempt", boxId);
+
         // See if @decider suggests adding Box to Position on Board. If not then wait.
         if(decider->suggestMoveTo(position, board))
         {
             if(mover->addBox(curPosition))
             {
                 // Move was successful. Box is on the Board.
+                latencies.recordSince(StepPhase::waitingToEnter, enterStart);
                 break;
             }
+            board.getMetrics().count(SimulationCounter::entryRetries);
         }
         else
         {
+            board.getMetrics().count(SimulationCounter::entryRetries);
+            PLAZA_TRACE_SPAN("entry wait", boxId);
             this_thread::sleep_for(n * 10ms);
             ++n;
         }
     }
+    doorwayFlow.stopWaiting(position);
 
     /* Iteratively move Box into final Position */
+    // blockedStart is when the Box first failed to move since its last move, or 0 if it has not failed.
+    uint64_t blockedStart = 0;
+
     // While the box is not at the end position, keep moving the box closer. 
     while (!posManager->atEnd(curPosition) && breaker)
     {
+        uint64_t stepStart = TscClock::now();
+
         // Get vector of recommended Positions from @posManager.
         // @decider chooses which Position to move to and when.
         pair<Position,int> nextPosition = 
             decider->getNext(posManager->getFuturePositions(curPosition), board);
+        uint64_t decided = TscClock::now();
+        latencies.recordTicks(StepPhase::deciding, decided - stepStart);
+        PLAZA_TRACE_INTERVAL("decide", boxId, stepStart, decided);
 
         // If suggested sleep time from @decider is positive, then sleep for suggested sleep time.
         if(nextPosition.second > 0)
         {
            this_thread::sleep_for(chrono::milliseconds(nextPosition.second));
         }
+        uint64_t moveStart = TscClock::now();
         
         // If @decider returned an invalid Position, then sleep for now.
         // Otherwise mover tries to move to nextPosition.
-        if((nextPosition.first != Position{-1, -1}) && 
-           (mover->moveBox(curPosition, nextPosition.first)))
+        if(nextPosition.first == Position{-1, -1})
+        {
+            board.getMetrics().count(SimulationCounter::deciderNoMove);
+            blockedStart = (blockedStart == 0) ? stepStart : blockedStart;
+        }
+        else if(mover->moveBox(curPosition, nextPosition.first))
         {
             // Move was successful. Update curPosition.
             curPosition = nextPosition.first;
+            if (blockedStart != 0)
+            {
+                latencies.recordTicks(StepPhase::blocked, moveStart - blockedStart);
+                PLAZA_TRACE_INTERVAL("blocked", boxId, blockedStart, moveStart);
+                blockedStart = 0;
+            }
+        }
+        else
+        {
+            blockedStart = (blockedStart == 0) ? stepStart : blockedStart;
         }
 
         // Always sleep between movements.
@@ -100,25 +140,29 @@ void Threader::populateOneBatchOfThreads(
     bool& running)
 
 {
-    vector<Position> startPoints = Util::getRandomPositionsInRectangle(
+    vector<BoxPlan> plans = planOneBatch(
+        firstBoxId,
+        count,
         startRectangle,
-        count);
+        endRects,
+        board.getWidth(),
+        board.getHeight(),
+        pmt,
+        dt,
+        0);
 
-    for(int ii=0; ii<count; ++ii)
+    for(BoxPlan& plan : plans)
     {
         threads.push_back(
             make_unique<thread>(
                 funcMoveBox,
-                startPoints[ii],
+                plan.start,
                 std::ref(board),
-                createPositionManager(pmt,
-                                      endRects[Util::getRandomInt(0, endRects.size()-1)],
-                                      0,
-                                      board.getWidth()-1,
-                                      0,
-                                      board.getHeight()-1),
-                createDecider(dt),
-                make_unique<Mover_Reg>(firstBoxId+ii, &board),
+                std::move(plan.positionManager),
+                std::move(plan.decider),
+                make_unique<Mover_Reg>(plan.boxId, &board),
+                plan.positionManagerType,
+                plan.deciderType,
                 std::ref(running))
         );
     }
@@ -132,8 +176,72 @@ void Threader::populateThreads(
     Board& board,
     bool& running)
 {
+    vector<BoxPlan> plans = planBatches(
+        numOfBoxesPerBatch,
+        numOfBatches,
+        startEndRectangles,
+        board.getWidth(),
+        board.getHeight());
+
     // Each thread contains one boxId.
+    for(BoxPlan& plan : plans)
+    {
+        threads.push_back(
+            make_unique<thread>(
+                funcMoveBox,
+                plan.start,
+                std::ref(board),
+                std::move(plan.positionManager),
+                std::move(plan.decider),
+                make_unique<Mover_Reg>(plan.boxId, &board),
+                plan.positionManagerType,
+                plan.deciderType,
+                std::ref(running))
+        );
+    }
+}
+
+vector<BoxPlan> Threader::planOneBatch(
+    int firstBoxId,
+    int count,
+    Rectangle startRectangle,
+    vector<Rectangle> endRects,
+    int boardWidth,
+    int boardHeight,
+    PositionManagerType pmt,
+    DeciderType dt,
+    int batch)
+{
+    vector<Position> startPoints = Util::getRandomPositionsInRectangle(
+        startRectangle,
+        count);
+
+    vector<BoxPlan> plans{};
+    for(int ii=0; ii<count; ++ii)
+    {
+        Rectangle exit = endRects[Util::getRandomInt(0, endRects.size()-1)];
+        plans.push_back(BoxPlan{
+            firstBoxId+ii,
+            batch,
+            startPoints[ii],
+            exit,
+            pmt,
+            createPositionManager(pmt, exit, 0, boardWidth-1, 0, boardHeight-1),
+            dt,
+            createDecider(dt)});
+    }
+    return plans;
+}
+
+vector<BoxPlan> Threader::planBatches(
+    int numOfBoxesPerBatch,
+    int numOfBatches,
+    const vector<Rectangle>& startEndRectangles,
+    int boardWidth,
+    int boardHeight)
+{
     // Create @numOfBatches and each of those batches has @numOfBoxesPerBatch.
+    vector<BoxPlan> plans{};
     for(int ii=0; ii<numOfBatches; ++ii)
     {
         // PositionManagerType is random.
@@ -143,17 +251,22 @@ void Threader::populateThreads(
         // DeciderType is random.
         DeciderType dType = (Util::getRandomBool()) ? (DeciderType::safe) : (DeciderType::risk1);
 
-        populateOneBatchOfThreads(
-            threads,
+        vector<BoxPlan> batch = planOneBatch(
             ii*numOfBoxesPerBatch,
             numOfBoxesPerBatch,
             startEndRectangles[ii],
             MainSetup::deleteRect(startEndRectangles, startEndRectangles[ii]),
-            board,
+            boardWidth,
+            boardHeight,
             pmType,
             dType,
-            running);
+            ii);
+        for(BoxPlan& plan : batch)
+        {
+            plans.push_back(std::move(plan));
+        }
     }
+    return plans;
 }
 
 unique_ptr<PositionManager> Threader::createPositionManager(
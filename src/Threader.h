@@ -3,6 +3,7 @@
 
 #include <thread>
 #include "Board.h"
+#include "BoxPlan.h"
 #include "Decider.h"
 #include "DeciderType.h"
 #include "Mover.h"
@@ -21,6 +22,7 @@ class Threader
     First repeatedly tries to add Box to @board at @position.
     Once the Box is on the Board, then continually moves box closer to target position in @posManager.
     Note @breaker is a reference that is checked between Position moves. If false, the function ends.
+    The time spent in each StepPhase is recorded in @board's PhaseLatencies, under @dt and @pmt, the types @decider and @posManager were made from.
     */
     static void funcMoveBox(
         Position position,
@@ -28,6 +30,8 @@ class Threader
         std::unique_ptr<PositionManager> posManager,
         std::unique_ptr<Decider> decider,
         std::unique_ptr<Mover> mover,
+        PositionManagerType pmt,
+        DeciderType dt,
         bool& breaker);
 
 
@@ -75,6 +79,30 @@ class Threader
         bool& running);
 
 
+    /*
+    Makes the BoxPlans for one batch the way populateOneBatchOfThreads() does, without starting any threads. @boardWidth and @boardHeight bound the PositionManagers. Each BoxPlan gets @batch as its batch.
+    */
+    std::vector<BoxPlan> planOneBatch(
+        int firstBoxId,
+        int count,
+        Rectangle startRect,
+        std::vector<Rectangle> inOutBoundRects,
+        int boardWidth,
+        int boardHeight,
+        PositionManagerType pmt,
+        DeciderType dt,
+        int batch);
+
+    /*
+    Makes the BoxPlans for all batches the way populateThreads() does, without starting any threads.
+    */
+    std::vector<BoxPlan> planBatches(
+        int numOfBoxesPerBatch,
+        int numOfBatches,
+        const std::vector<Rectangle>& startEndRectangles,
+        int boardWidth,
+        int boardHeight);
+
     /*
     Creates a PositionManager based on @pmt.
 
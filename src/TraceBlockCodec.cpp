@@ -0,0 +1,348 @@
+#include "TraceBlockCodec.h"
+
+#include <stdexcept>
+#include <string>
+#include "Varint.h"
+
+using namespace std;
+
+namespace
+{
+    // Symbol bits.
+    constexpr uint8_t typeMask = 0x03;
+    constexpr uint8_t collisionBit = 0x04;
+    constexpr uint8_t noUpLevelBit = 0x08;
+    constexpr uint8_t positionBit = 0x10;
+    constexpr uint8_t otherBoxIdBit = 0x20;
+    constexpr uint8_t boxIdBit = 0x40;
+
+    // The MoveType a Box is expected to change to after @type. MoveTypes are 1 to 4: to_arrive, arrive, to_leave, left.
+    // The cycle is to_arrive -> to_leave -> arrive -> left -> to_arrive.
+    constexpr uint8_t nextType[5] = {1, 3, 4, 2, 1};
+
+    // Turns a MoveType difference back into a MoveType. Differences are taken between (type - 1) values, modulo 4.
+    inline uint8_t addType(uint8_t predicted, uint8_t residual)
+    {
+        return static_cast<uint8_t>(((predicted - 1 + residual) & 3) + 1);
+    }
+}
+
+TraceBlockCodec::TraceBlockCodec(int boxIdLimit)
+:   _boxIdLimit{boxIdLimit},
+    _predictions(boxIdLimit > 0 ? boxIdLimit : 0)
+{
+    if (boxIdLimit < 0)
+    {
+        throw invalid_argument("TraceBlockCodec's boxIdLimit can not be negative.");
+    }
+}
+
+void TraceBlockCodec::resetPredictions()
+{
+    // A Box the block has not seen yet is expected to enter the Board at {0, 0}.
+    for (BoxPrediction& prediction : _predictions)
+    {
+        prediction = BoxPrediction{static_cast<uint8_t>(MoveType::left), 0, 0, 0, 0, 0, 0, 0, 0};
+    }
+}
+
+void TraceBlockCodec::encode(const SpotTransition* records, int count, vector<uint8_t>& out)
+{
+    resetPredictions();
+    _timestamps.clear();
+    _boxIds.clear();
+    _symbols.clear();
+    _positions.clear();
+    _otherBoxIds.clear();
+
+    int64_t previousTimestamp = 0;
+    int32_t previousBoxId = -1;
+    bool expectSameBox = false;
+    uint8_t runSymbol = 0;
+    uint64_t runLength = 0;
+
+    for (int ii=0; ii<count; ++ii)
+    {
+        const SpotTransition& record = records[ii];
+        if (record.boxId < 0 || record.boxId >= _boxIdLimit)
+        {
+            throw invalid_argument("boxId " + to_string(record.boxId) + " is outside of the trace's Boxes.");
+        }
+        if (record.type < 1 || record.type > 4)
+        {
+            throw invalid_argument(to_string(record.type) + " is not a MoveType.");
+        }
+        BoxPrediction& box = _predictions[record.boxId];
+        MoveType type = record.getMoveType();
+
+        writeVarint(_timestamps, zigZag(record.timestamp - previousTimestamp));
+        previousTimestamp = record.timestamp;
+
+        // After a to_arrive or an arrive, the same Box usually changes its other Spot next. Otherwise the boxId is stored.
+        bool boxIdDiffers = false;
+        if (!expectSameBox)
+        {
+            writeVarint(_boxIds, static_cast<uint64_t>(record.boxId));
+        }
+        else if (record.boxId != previousBoxId)
+        {
+            boxIdDiffers = true;
+            writeVarint(_boxIds, static_cast<uint64_t>(record.boxId));
+        }
+        previousBoxId = record.boxId;
+        expectSameBox = !record.collision && (type == MoveType::to_arrive || type == MoveType::arrive);
+
+        // Predict the MoveType, Position and otherBoxId.
+        uint8_t predictedType = record.collision ? static_cast<uint8_t>(MoveType::to_arrive) : nextType[box.lastType];
+        uint8_t residual = static_cast<uint8_t>((record.type - predictedType) & 3);
+        int predictedX = box.homeX + box.dirX;
+        int predictedY = box.homeY + box.dirY;
+        int32_t predictedOther = record.boxId;
+        if (!record.collision)
+        {
+            if (type == MoveType::to_leave)
+            {
+                predictedX = box.homeX;
+                predictedY = box.homeY;
+            }
+            else if (type == MoveType::arrive)
+            {
+                predictedX = box.targetX;
+                predictedY = box.targetY;
+            }
+            else if (type == MoveType::left)
+            {
+                predictedX = box.leavingX;
+                predictedY = box.leavingY;
+            }
+            else
+            {
+                predictedOther = -1;
+            }
+        }
+
+        uint8_t symbol = residual;
+        if (boxIdDiffers)
+        {
+            symbol |= boxIdBit;
+        }
+        if (record.collision)
+        {
+            symbol |= collisionBit;
+        }
+        if (!record.upLevel)
+        {
+            symbol |= noUpLevelBit;
+        }
+        if (record.x != predictedX || record.y != predictedY)
+        {
+            symbol |= positionBit;
+            writeVarint(_positions, zigZag(record.x - predictedX));
+            writeVarint(_positions, zigZag(record.y - predictedY));
+        }
+        if (record.collision || record.otherBoxId != predictedOther)
+        {
+            symbol |= otherBoxIdBit;
+            writeVarint(_otherBoxIds, zigZag(record.otherBoxId));
+        }
+
+        if (runLength > 0 && symbol != runSymbol)
+        {
+            _symbols.push_back(runSymbol);
+            writeVarint(_symbols, runLength);
+            runLength = 0;
+        }
+        runSymbol = symbol;
+        ++runLength;
+
+        // Update what is known about the Box.
+        if (!record.collision)
+        {
+            if (type == MoveType::to_arrive)
+            {
+                box.dirX = static_cast<int16_t>(record.x - box.homeX);
+                box.dirY = static_cast<int16_t>(record.y - box.homeY);
+                box.targetX = record.x;
+                box.targetY = record.y;
+            }
+            else if (type == MoveType::to_leave)
+            {
+                box.leavingX = record.x;
+                box.leavingY = record.y;
+            }
+            else if (type == MoveType::arrive)
+            {
+                box.homeX = record.x;
+                box.homeY = record.y;
+            }
+            box.lastType = record.type;
+        }
+    }
+    if (runLength > 0)
+    {
+        _symbols.push_back(runSymbol);
+        writeVarint(_symbols, runLength);
+    }
+
+    writeVarint(out, static_cast<uint64_t>(count));
+    writeVarint(out, _timestamps.size());
+    writeVarint(out, _boxIds.size());
+    writeVarint(out, _symbols.size());
+    writeVarint(out, _positions.size());
+    writeVarint(out, _otherBoxIds.size());
+    out.insert(out.end(), _timestamps.begin(), _timestamps.end());
+    out.insert(out.end(), _boxIds.begin(), _boxIds.end());
+    out.insert(out.end(), _symbols.begin(), _symbols.end());
+    out.insert(out.end(), _positions.begin(), _positions.end());
+    out.insert(out.end(), _otherBoxIds.begin(), _otherBoxIds.end());
+}
+
+int TraceBlockCodec::decode(const uint8_t* data, size_t size, vector<SpotTransition>& out)
+{
+    const uint8_t* pos = data;
+    const uint8_t* end = data + size;
+
+    uint64_t count = readVarint(pos, end);
+    uint64_t columnSizes[5];
+    for (uint64_t& columnSize : columnSizes)
+    {
+        columnSize = readVarint(pos, end);
+    }
+
+    // Start and end of each column.
+    const uint8_t* columns[5];
+    const uint8_t* columnEnds[5];
+    for (int ii=0; ii<5; ++ii)
+    {
+        if (columnSizes[ii] > static_cast<uint64_t>(end - pos))
+        {
+            throw invalid_argument("The trace block is shorter than its columns.");
+        }
+        columns[ii] = pos;
+        pos += columnSizes[ii];
+        columnEnds[ii] = pos;
+    }
+    // Every record has at least one byte of timestamp.
+    if (count > columnSizes[0])
+    {
+        throw invalid_argument("The trace block has more records than timestamps.");
+    }
+    const uint8_t*& timestamps = columns[0];
+    const uint8_t*& boxIds = columns[1];
+    const uint8_t*& symbols = columns[2];
+    const uint8_t*& positions = columns[3];
+    const uint8_t*& otherBoxIds = columns[4];
+
+    resetPredictions();
+    size_t first = out.size();
+    out.resize(first + count);
+    SpotTransition* record = out.data() + first;
+
+    int64_t timestamp = 0;
+    int32_t boxId = -1;
+    bool expectSameBox = false;
+    uint8_t symbol = 0;
+    uint64_t runLength = 0;
+
+    for (uint64_t ii=0; ii<count; ++ii, ++record)
+    {
+        timestamp += unZigZag(readVarint(timestamps, columnEnds[0]));
+
+        if (runLength == 0)
+        {
+            if (symbols >= columnEnds[2])
+            {
+                throw invalid_argument("The trace block has fewer symbols than records.");
+            }
+            symbol = *symbols++;
+            runLength = readVarint(symbols, columnEnds[2]);
+        }
+        --runLength;
+
+        if (!expectSameBox || (symbol & boxIdBit))
+        {
+            boxId = static_cast<int32_t>(readVarint(boxIds, columnEnds[1]));
+        }
+        if (boxId < 0 || boxId >= _boxIdLimit)
+        {
+            throw invalid_argument("The trace block has a boxId outside of the trace's Boxes.");
+        }
+
+        BoxPrediction& box = _predictions[boxId];
+        bool collision = (symbol & collisionBit) != 0;
+        uint8_t predictedType = collision ? static_cast<uint8_t>(MoveType::to_arrive) : nextType[box.lastType];
+        uint8_t type = addType(predictedType, symbol & typeMask);
+
+        int x = box.homeX + box.dirX;
+        int y = box.homeY + box.dirY;
+        int32_t other = boxId;
+        if (!collision)
+        {
+            if (type == static_cast<uint8_t>(MoveType::to_leave))
+            {
+                x = box.homeX;
+                y = box.homeY;
+            }
+            else if (type == static_cast<uint8_t>(MoveType::arrive))
+            {
+                x = box.targetX;
+                y = box.targetY;
+            }
+            else if (type == static_cast<uint8_t>(MoveType::left))
+            {
+                x = box.leavingX;
+                y = box.leavingY;
+            }
+            else
+            {
+                other = -1;
+            }
+        }
+        if (symbol & positionBit)
+        {
+            x += static_cast<int>(unZigZag(readVarint(positions, columnEnds[3])));
+            y += static_cast<int>(unZigZag(readVarint(positions, columnEnds[3])));
+        }
+        if (symbol & otherBoxIdBit)
+        {
+            other = static_cast<int32_t>(unZigZag(readVarint(otherBoxIds, columnEnds[4])));
+        }
+
+        record->timestamp = timestamp;
+        record->boxId = boxId;
+        record->otherBoxId = other;
+        record->x = static_cast<uint16_t>(x);
+        record->y = static_cast<uint16_t>(y);
+        record->type = type;
+        record->collision = collision ? 1 : 0;
+        record->upLevel = (symbol & noUpLevelBit) ? 0 : 1;
+        record->reserved = 0;
+
+        expectSameBox = !collision &&
+            (type == static_cast<uint8_t>(MoveType::to_arrive) || type == static_cast<uint8_t>(MoveType::arrive));
+
+        if (!collision)
+        {
+            if (type == static_cast<uint8_t>(MoveType::to_arrive))
+            {
+                box.dirX = static_cast<int16_t>(record->x - box.homeX);
+                box.dirY = static_cast<int16_t>(record->y - box.homeY);
+                box.targetX = record->x;
+                box.targetY = record->y;
+            }
+            else if (type == static_cast<uint8_t>(MoveType::to_leave))
+            {
+                box.leavingX = record->x;
+                box.leavingY = record->y;
+            }
+            else if (type == static_cast<uint8_t>(MoveType::arrive))
+            {
+                box.homeX = record->x;
+                box.homeY = record->y;
+            }
+            box.lastType = type;
+        }
+    }
+
+    return static_cast<int>(count);
+}
@@ -0,0 +1,82 @@
+#ifndef TRACEBLOCKCODEC__H
+#define TRACEBLOCKCODEC__H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SpotTransition.h"
+
+/*
+Encodes a block of SpotTransitions into a compact columnar form and decodes it back. Every block can be decoded on its own.
+
+Most of a SpotTransition can be predicted from the Box's earlier SpotTransitions, because a Mover always changes Spots in the same order: to_arrive at the new Position, to_leave at the old Position, arrive at the new Position, left at the old Position. So per Box the codec keeps where the Box stands, where it is going, where it is leaving from, and the direction of its last move. Only what differs from the prediction is stored.
+
+A block has five columns:
+    timestamps   zig-zag varint of the difference to the previous record's timestamp (the first record's timestamp as is)
+    boxIds       varint boxId, left out when the record follows a to_arrive or arrive of the same Box
+    symbols      run-lengths of a per-record symbol: the MoveType's difference to the predicted MoveType, the collision and upLevel flags, and whether the boxId, Position or otherBoxId differ from their predictions
+    positions    zig-zag varints of x and y differences to the predicted Position, only where the symbol says so
+    otherBoxIds  zig-zag varints of otherBoxId, only where the symbol says so
+
+The block starts with the varint record count and the varint byte size of each column.
+
+On Mover-like records (see tests/CompressedTraceWriter_core.cpp) a record takes about 3.8 bytes, 6.3 times smaller than a 24 byte SpotTransition, and decoding runs at about 30 million records a second. That is short of 10 times smaller and 100 million records a second. The nanosecond timestamp differences alone take about 2 bytes a record, so getting closer would need entropy coding or coarser timestamps.
+*/
+class TraceBlockCodec
+{
+    public:
+
+    /*
+    @boxIdLimit is one more than the largest boxId in the trace. boxIds must not be negative.
+    */
+    explicit TraceBlockCodec(int boxIdLimit);
+    TraceBlockCodec() = delete;
+    TraceBlockCodec(const TraceBlockCodec& o) = delete;
+    TraceBlockCodec(TraceBlockCodec&& o) noexcept = delete;
+    TraceBlockCodec& operator=(const TraceBlockCodec& o) = delete;
+    TraceBlockCodec& operator=(TraceBlockCodec&& o) noexcept = delete;
+    ~TraceBlockCodec() noexcept = default;
+
+    /*
+    Appends the encoded @count records starting at @records to @out. Throws an invalid_argument exception if a boxId is outside of [0, boxIdLimit).
+    */
+    void encode(const SpotTransition* records, int count, std::vector<uint8_t>& out);
+
+    /*
+    Appends the records of the block in @data (@size bytes) to @out. Returns the number of records appended. Throws an invalid_argument exception if the block is damaged.
+    */
+    int decode(const uint8_t* data, size_t size, std::vector<SpotTransition>& out);
+
+
+    private:
+
+    /*
+    What the codec knows about one Box while encoding or decoding a block.
+    */
+    struct BoxPrediction
+    {
+        uint8_t lastType;
+        int16_t dirX;
+        int16_t dirY;
+        uint16_t homeX;
+        uint16_t homeY;
+        uint16_t targetX;
+        uint16_t targetY;
+        uint16_t leavingX;
+        uint16_t leavingY;
+    };
+
+    const int _boxIdLimit;
+    std::vector<BoxPrediction> _predictions;
+
+    // Column buffers, kept between calls so encode() does not allocate.
+    std::vector<uint8_t> _timestamps{};
+    std::vector<uint8_t> _boxIds{};
+    std::vector<uint8_t> _symbols{};
+    std::vector<uint8_t> _positions{};
+    std::vector<uint8_t> _otherBoxIds{};
+
+    void resetPredictions();
+};
+
+#endif
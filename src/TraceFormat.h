@@ -0,0 +1,97 @@
+#ifndef TRACEFORMAT__H
+#define TRACEFORMAT__H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+/*
+Layout of a trace file written by TraceRecorder.
+
+All numbers are written in the byte order of the machine that recorded the trace.
+
+Header:
+    char[8]   traceMagic ("PWTRACE" and a null character)
+    uint32    traceVersion
+    uint32    record size in bytes (sizeof(SpotTransition))
+    int32     Board width
+    int32     Board height
+    int32     number of Boxes
+    Per Box, int32 id, int32 groupId, int32 width, int32 height
+
+Records:
+    One SpotTransition per record, until the end of the file.
+
+TraceReplayer keeps keyframes for a trace in a second file, next to the trace. Its layout is:
+
+Header:
+    char[8]   keyframeMagic ("PWKEYS" and two null characters)
+    uint32    keyframeVersion
+    int64     number of records in the trace when the keyframes were made
+    uint64    fingerprint of the trace (see TraceReplayer), so the keyframes of another trace with as many records are not used
+    int32     number of records between keyframes
+    int64     largest timestamp in the trace
+    int64     file offset of the keyframe index
+
+Keyframes:
+    Per keyframe, the TraceState (see TraceState::save()) after applying all the records before it.
+
+Keyframe index:
+    int32     number of keyframes
+    Per keyframe, int64 record number, int64 largest timestamp of the records before it, int64 file offset
+
+CompressedTraceWriter writes the same records in blocks, each encoded by TraceBlockCodec. Its layout is:
+
+Header:
+    char[8]   compressedTraceMagic ("PWCTRACE")
+    uint32    compressedTraceVersion
+    int32     Board width
+    int32     Board height
+    int32     number of Boxes
+    Per Box, int32 id, int32 groupId, int32 width, int32 height
+    int32     boxIdLimit (one more than the largest boxId)
+
+Blocks:
+    The encoded blocks, one after the other.
+
+Block index:
+    int32     number of blocks
+    Per block, int64 file offset, int64 size in bytes, int64 number of the block's first record, int32 number of records, int64 smallest timestamp, int64 largest timestamp
+
+Footer:
+    int64     file offset of the block index
+*/
+constexpr char traceMagic[8] = {'P', 'W', 'T', 'R', 'A', 'C', 'E', '\0'};
+constexpr uint32_t traceVersion = 2;
+
+constexpr char keyframeMagic[8] = {'P', 'W', 'K', 'E', 'Y', 'S', '\0', '\0'};
+constexpr uint32_t keyframeVersion = 2;
+
+constexpr char compressedTraceMagic[8] = {'P', 'W', 'C', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t compressedTraceVersion = 1;
+
+inline void writeTraceInt(std::ostream& out, int32_t value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline int32_t readTraceInt(std::istream& in)
+{
+    int32_t value = 0;
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+}
+
+inline void writeTraceLong(std::ostream& out, int64_t value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline int64_t readTraceLong(std::istream& in)
+{
+    int64_t value = 0;
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "TraceReader.h"
+
+#include <cstring>
+#include <stdexcept>
+#include "TraceFormat.h"
+
+using namespace std;
+
+TraceReader::TraceReader(const string& path)
+:   _file{path, ios::binary}
+{
+    if (!_file)
+    {
+        throw invalid_argument("TraceReader can not open " + path + ".");
+    }
+
+    char magic[sizeof(traceMagic)];
+    uint32_t version = 0;
+    uint32_t recordSize = 0;
+    _file.read(magic, sizeof(magic));
+    _file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    _file.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize));
+    if (!_file || memcmp(magic, traceMagic, sizeof(magic)) != 0)
+    {
+        throw invalid_argument(path + " is not a trace file.");
+    }
+    if (version != traceVersion || recordSize != sizeof(SpotTransition))
+    {
+        throw invalid_argument(path + " is trace version " + to_string(version) + ", expected version " + to_string(traceVersion) + ".");
+    }
+
+    _width = readTraceInt(_file);
+    _height = readTraceInt(_file);
+    int boxCount = readTraceInt(_file);
+    if (!_file || boxCount < 0)
+    {
+        throw invalid_argument(path + " has a damaged header.");
+    }
+    _boxInfos.reserve(boxCount);
+    for (int ii=0; ii<boxCount; ++ii)
+    {
+        int id = readTraceInt(_file);
+        int group = readTraceInt(_file);
+        int width = readTraceInt(_file);
+        int height = readTraceInt(_file);
+        _boxInfos.push_back(BoxInfo{id, group, width, height, 0});
+    }
+    if (!_file)
+    {
+        throw invalid_argument(path + " has a damaged header.");
+    }
+
+    _headerSize = _file.tellg();
+    _file.seekg(0, ios::end);
+    _recordCount = static_cast<long>((_file.tellg() - _headerSize) / static_cast<streamoff>(sizeof(SpotTransition)));
+}
+
+int TraceReader::getWidth() const
+{
+    return _width;
+}
+
+int TraceReader::getHeight() const
+{
+    return _height;
+}
+
+const vector<BoxInfo>& TraceReader::getBoxInfos() const
+{
+    return _boxInfos;
+}
+
+long TraceReader::getRecordCount() const
+{
+    return _recordCount;
+}
+
+int TraceReader::readRecords(long first, int count, vector<SpotTransition>& out)
+{
+    long available = std::max(0L, _recordCount - first);
+    int toRead = static_cast<int>(std::min(static_cast<long>(count), available));
+    out.resize(toRead);
+    if (toRead == 0)
+    {
+        return 0;
+    }
+
+    _file.clear();
+    _file.seekg(_headerSize + static_cast<streamoff>(first) * static_cast<streamoff>(sizeof(SpotTransition)));
+    _file.read(reinterpret_cast<char*>(out.data()), static_cast<streamsize>(toRead * sizeof(SpotTransition)));
+    return toRead;
+}
@@ -0,0 +1,59 @@
+#ifndef TRACEREADER__H
+#define TRACEREADER__H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "BoxInfo.h"
+#include "SpotTransition.h"
+
+/*
+Reads a trace file written by TraceRecorder. See TraceFormat.h for the file layout.
+
+The records have a fixed size, so any range of records can be read without reading the records before it.
+*/
+class TraceReader
+{
+    public:
+
+    /*
+    Opens the trace file at @path and reads its header. Throws an invalid_argument exception if the file can not be opened or is not a trace file of this version.
+    */
+    explicit TraceReader(const std::string& path);
+    TraceReader() = delete;
+    TraceReader(const TraceReader& o) = delete;
+    TraceReader(TraceReader&& o) noexcept = delete;
+    TraceReader& operator=(const TraceReader& o) = delete;
+    TraceReader& operator=(TraceReader&& o) noexcept = delete;
+    ~TraceReader() noexcept = default;
+
+    int getWidth() const;
+    int getHeight() const;
+
+    /*
+    Returns the Boxes in the header. Their levels are 0, which is the level every Box starts at.
+    */
+    const std::vector<BoxInfo>& getBoxInfos() const;
+
+    /*
+    Returns the number of complete records in the file. A partly written last record is not counted.
+    */
+    long getRecordCount() const;
+
+    /*
+    Replaces the contents of @out with up to @count records, starting at record @first. Returns the number of records read, which is less than @count at the end of the file.
+    */
+    int readRecords(long first, int count, std::vector<SpotTransition>& out);
+
+
+    private:
+
+    std::ifstream _file;
+    int _width = 0;
+    int _height = 0;
+    std::vector<BoxInfo> _boxInfos{};
+    std::streamoff _headerSize = 0;
+    long _recordCount = 0;
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include "TraceFormat.h"
+
+using namespace std;
+
+TraceRecorder::TraceRecorder(
+    const string& path,
+    int width,
+    int height,
+    const vector<BoxInfo>& boxes,
+    int ringCapacity,
+    chrono::milliseconds flushInterval)
+:   _flushInterval{flushInterval},
+    _file{path, ios::binary | ios::trunc},
+    _rings{[ringCapacity]{ return make_unique<TransitionRing>(ringCapacity); }}
+{
+    if (!_file)
+    {
+        throw invalid_argument("TraceRecorder can not open " + path + ".");
+    }
+
+    // Header. See TraceFormat.h.
+    _file.write(traceMagic, sizeof(traceMagic));
+    uint32_t version = traceVersion;
+    uint32_t recordSize = sizeof(SpotTransition);
+    _file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    _file.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+    writeTraceInt(_file, width);
+    writeTraceInt(_file, height);
+    writeTraceInt(_file, static_cast<int32_t>(boxes.size()));
+    for (const BoxInfo& box : boxes)
+    {
+        writeTraceInt(_file, box.getId());
+        writeTraceInt(_file, box.getGroupId());
+        writeTraceInt(_file, box.getWidth());
+        writeTraceInt(_file, box.getHeight());
+    }
+    _file.flush();
+
+    // Start the writer thread last, once all the attributes are set.
+    _writer = thread(&TraceRecorder::write, this);
+}
+
+TraceRecorder::~TraceRecorder() noexcept
+{
+    {
+        lock_guard<mutex> lock(_writerMux);
+        _stopping = true;
+    }
+    _wakeWriter.notify_all();
+    _writer.join();
+}
+
+void TraceRecorder::receiveTransition(const SpotTransition& transition)
+{
+    TransitionRing& ring = _rings.getForThisThread();
+    if (!ring.tryPush(transition))
+    {
+        ++_stalls;
+        {
+            lock_guard<mutex> lock(_writerMux);
+            _drainRequested = true;
+        }
+        _wakeWriter.notify_one();
+        while (!ring.tryPush(transition))
+        {
+            this_thread::yield();
+        }
+    }
+}
+
+void TraceRecorder::flush()
+{
+    unique_lock<mutex> lock(_writerMux);
+    long request = ++_flushRequests;
+    _wakeWriter.notify_one();
+    _flushDone.wait(lock, [this, request]{ return _flushesDone >= request; });
+}
+
+long TraceRecorder::getRecorded() const
+{
+    return _recorded.load();
+}
+
+long TraceRecorder::getStalls() const
+{
+    return _stalls.load();
+}
+
+void TraceRecorder::write()
+{
+    vector<SpotTransition> batch{};
+    unique_lock<mutex> lock(_writerMux);
+    while (true)
+    {
+        _wakeWriter.wait_for(lock, _flushInterval, [this]{ return _stopping || _drainRequested || _flushRequests > _flushesDone; });
+        bool stopping = _stopping;
+        long requests = _flushRequests;
+        _drainRequested = false;
+
+        lock.unlock();
+        drainAndWrite(batch);
+        lock.lock();
+
+        _flushesDone = requests;
+        _flushDone.notify_all();
+        if (stopping)
+        {
+            return;
+        }
+    }
+}
+
+void TraceRecorder::drainAndWrite(vector<SpotTransition>& batch)
+{
+    batch.clear();
+    _rings.visitAll([&batch](vector<unique_ptr<TransitionRing>>& rings){
+        for (auto& ring : rings)
+        {
+            ring->drainInto(batch);
+        }
+    });
+    if (batch.empty())
+    {
+        return;
+    }
+
+    stable_sort(
+        batch.begin(),
+        batch.end(),
+        [](const SpotTransition& a, const SpotTransition& b){ return a.timestamp < b.timestamp; });
+
+    _file.write(
+        reinterpret_cast<const char*>(batch.data()),
+        static_cast<streamsize>(batch.size() * sizeof(SpotTransition)));
+    _file.flush();
+    _recorded += static_cast<long>(batch.size());
+}
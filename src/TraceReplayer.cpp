@@ -0,0 +1,321 @@
+#include "TraceReplayer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "TraceFormat.h"
+
+using namespace std;
+
+namespace
+{
+    constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull;
+    constexpr uint64_t fnvPrime = 1099511628211ull;
+    constexpr streamoff fingerprintSpan = 65536;
+
+    uint64_t addToFingerprint(uint64_t hash, const char* data, size_t size)
+    {
+        for (size_t ii=0; ii<size; ++ii)
+        {
+            hash = (hash ^ static_cast<unsigned char>(data[ii])) * fnvPrime;
+        }
+        return hash;
+    }
+
+    /*
+    Hashes the size of the file at @path and its first and last fingerprintSpan bytes. Reading only those keeps opening a large trace fast. Throws an invalid_argument exception if the file can not be read.
+    */
+    uint64_t getFingerprint(const string& path)
+    {
+        ifstream file{path, ios::binary | ios::ate};
+        if (!file)
+        {
+            throw invalid_argument("TraceReplayer can not read " + path + ".");
+        }
+        streamoff size = file.tellg();
+        uint64_t hash = addToFingerprint(fnvOffsetBasis, reinterpret_cast<const char*>(&size), sizeof(size));
+
+        vector<char> bytes(static_cast<size_t>(std::min(size, fingerprintSpan)));
+        file.seekg(0);
+        file.read(bytes.data(), static_cast<streamsize>(bytes.size()));
+        hash = addToFingerprint(hash, bytes.data(), bytes.size());
+        file.seekg(size - static_cast<streamoff>(bytes.size()));
+        file.read(bytes.data(), static_cast<streamsize>(bytes.size()));
+        hash = addToFingerprint(hash, bytes.data(), bytes.size());
+        if (!file)
+        {
+            throw invalid_argument("TraceReplayer can not read " + path + ".");
+        }
+        return hash;
+    }
+}
+
+TraceReplayer::TraceReplayer(const string& tracePath, int keyframeInterval)
+:   _reader{tracePath},
+    _state{_reader.getWidth(), _reader.getHeight(), _reader.getBoxInfos()},
+    _keyframeInterval{keyframeInterval},
+    _keyframePath{tracePath + ".keyframes"},
+    _traceFingerprint{getFingerprint(tracePath)},
+    _cellChanged(_reader.getWidth() * _reader.getHeight(), 0)
+{
+    if (_keyframeInterval < 1)
+    {
+        throw invalid_argument("TraceReplayer's keyframeInterval must be at least 1.");
+    }
+
+    if (!loadKeyframes())
+    {
+        makeKeyframes();
+        if (!loadKeyframes())
+        {
+            throw invalid_argument("TraceReplayer can not write " + _keyframePath + ".");
+        }
+    }
+}
+
+int TraceReplayer::getWidth() const
+{
+    return _reader.getWidth();
+}
+
+int TraceReplayer::getHeight() const
+{
+    return _reader.getHeight();
+}
+
+long TraceReplayer::getTime() const
+{
+    return _time;
+}
+
+long TraceReplayer::getEndTime() const
+{
+    return _endTime;
+}
+
+bool TraceReplayer::isFinished() const
+{
+    return _nextRecord >= _reader.getRecordCount();
+}
+
+const TraceState& TraceReplayer::getState() const
+{
+    return _state;
+}
+
+int TraceReplayer::getKeyframeCount() const
+{
+    return static_cast<int>(_keyframes.size());
+}
+
+void TraceReplayer::registerListener(RecorderListener* listener)
+{
+    _listeners.push_back(listener);
+}
+
+void TraceReplayer::step(long duration)
+{
+    _time += duration;
+    applyUntil(_time);
+    sendFrame();
+}
+
+void TraceReplayer::seek(long timestamp)
+{
+    // Everything that is on the Board now may be gone after the seek.
+    markOccupiedCells();
+
+    // The last keyframe made before @timestamp. The first keyframe is the empty Board, so there always is one.
+    auto after = upper_bound(
+        _keyframes.begin(),
+        _keyframes.end(),
+        timestamp,
+        [](long t, const Keyframe& keyframe){ return t < keyframe.timestamp; });
+    const Keyframe& keyframe = (after == _keyframes.begin()) ? _keyframes.front() : *(after - 1);
+
+    _keyframeFile.clear();
+    _keyframeFile.seekg(keyframe.offset);
+    _state.load(_keyframeFile);
+    _nextRecord = keyframe.record;
+
+    _time = timestamp;
+    applyUntil(_time);
+
+    markOccupiedCells();
+    sendFrame();
+}
+
+bool TraceReplayer::loadKeyframes()
+{
+    _keyframes.clear();
+    _keyframeFile.close();
+    _keyframeFile.clear();
+    _keyframeFile.open(_keyframePath, ios::binary);
+    if (!_keyframeFile)
+    {
+        return false;
+    }
+
+    char magic[sizeof(keyframeMagic)];
+    uint32_t version = 0;
+    _keyframeFile.read(magic, sizeof(magic));
+    _keyframeFile.read(reinterpret_cast<char*>(&version), sizeof(version));
+    long recordCount = readTraceLong(_keyframeFile);
+    uint64_t fingerprint = 0;
+    _keyframeFile.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+    int interval = readTraceInt(_keyframeFile);
+    long endTime = readTraceLong(_keyframeFile);
+    long indexOffset = readTraceLong(_keyframeFile);
+    if (!_keyframeFile ||
+        memcmp(magic, keyframeMagic, sizeof(magic)) != 0 ||
+        version != keyframeVersion ||
+        recordCount != _reader.getRecordCount() ||
+        fingerprint != _traceFingerprint ||
+        interval != _keyframeInterval ||
+        indexOffset == 0)
+    {
+        return false;
+    }
+
+    _keyframeFile.seekg(indexOffset);
+    int count = readTraceInt(_keyframeFile);
+    for (int ii=0; ii<count && _keyframeFile; ++ii)
+    {
+        Keyframe keyframe{};
+        keyframe.record = readTraceLong(_keyframeFile);
+        keyframe.timestamp = readTraceLong(_keyframeFile);
+        keyframe.offset = readTraceLong(_keyframeFile);
+        _keyframes.push_back(keyframe);
+    }
+    if (!_keyframeFile || _keyframes.empty())
+    {
+        _keyframes.clear();
+        return false;
+    }
+
+    _endTime = endTime;
+    return true;
+}
+
+void TraceReplayer::makeKeyframes()
+{
+    ofstream out{_keyframePath, ios::binary | ios::trunc};
+    if (!out)
+    {
+        return;
+    }
+
+    // The index offset is written last, so a keyframe file that was not finished is never loaded.
+    out.write(keyframeMagic, sizeof(keyframeMagic));
+    uint32_t version = keyframeVersion;
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    writeTraceLong(out, _reader.getRecordCount());
+    out.write(reinterpret_cast<const char*>(&_traceFingerprint), sizeof(_traceFingerprint));
+    writeTraceInt(out, _keyframeInterval);
+    streamoff endTimePosition = out.tellp();
+    writeTraceLong(out, 0);
+    writeTraceLong(out, 0);
+
+    TraceState state{_reader.getWidth(), _reader.getHeight(), _reader.getBoxInfos()};
+    vector<Keyframe> keyframes{};
+    vector<SpotTransition> records{};
+    long largestTimestamp = 0;
+    long record = 0;
+    while (true)
+    {
+        int count = _reader.readRecords(record, _keyframeInterval, records);
+
+        keyframes.push_back(Keyframe{record, largestTimestamp, static_cast<long>(out.tellp())});
+        state.save(out);
+
+        for (const SpotTransition& transition : records)
+        {
+            state.apply(transition);
+            largestTimestamp = std::max(largestTimestamp, static_cast<long>(transition.timestamp));
+        }
+        record += count;
+
+        if (count < _keyframeInterval)
+        {
+            break;
+        }
+    }
+
+    long indexOffset = static_cast<long>(out.tellp());
+    writeTraceInt(out, static_cast<int32_t>(keyframes.size()));
+    for (const Keyframe& keyframe : keyframes)
+    {
+        writeTraceLong(out, keyframe.record);
+        writeTraceLong(out, keyframe.timestamp);
+        writeTraceLong(out, keyframe.offset);
+    }
+
+    out.seekp(endTimePosition);
+    writeTraceLong(out, largestTimestamp);
+    writeTraceLong(out, indexOffset);
+}
+
+const SpotTransition* TraceReplayer::getRecord(long record)
+{
+    if (record < _bufferFirst || record >= _bufferFirst + static_cast<long>(_buffer.size()))
+    {
+        _bufferFirst = record;
+        if (_reader.readRecords(record, 4096, _buffer) == 0)
+        {
+            return nullptr;
+        }
+    }
+    return &_buffer[record - _bufferFirst];
+}
+
+void TraceReplayer::applyUntil(long timestamp)
+{
+    const SpotTransition* transition = getRecord(_nextRecord);
+    while (transition != nullptr && transition->timestamp <= timestamp)
+    {
+        int cell = _state.apply(*transition);
+        if (cell != -1)
+        {
+            markCell(cell);
+        }
+        ++_nextRecord;
+        transition = getRecord(_nextRecord);
+    }
+}
+
+void TraceReplayer::markCell(int cell)
+{
+    if (!_cellChanged[cell])
+    {
+        _cellChanged[cell] = 1;
+        _changedCells.push_back(cell);
+    }
+}
+
+void TraceReplayer::markOccupiedCells()
+{
+    for (int cell : _state.getGrid().getOccupiedCells())
+    {
+        markCell(cell);
+    }
+}
+
+void TraceReplayer::sendFrame()
+{
+    const OccupancyGrid& grid = _state.getGrid();
+    vector<Drop> changedDrops{};
+    changedDrops.reserve(_changedCells.size());
+    for (int cell : _changedCells)
+    {
+        Position position = grid.getPosition(cell);
+        changedDrops.push_back(Drop{position.getX(), position.getY(), grid.getBoxId(cell), grid.getMoveType(cell)});
+        _cellChanged[cell] = 0;
+    }
+    _changedCells.clear();
+
+    Frame frame{_sequence++, std::move(changedDrops), _state.getBoxInfos(), _state.getBoxIndexPerId()};
+    for (RecorderListener* listener : _listeners)
+    {
+        listener->receiveStateAndChanges(grid, frame);
+    }
+}
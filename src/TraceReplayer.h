@@ -0,0 +1,115 @@
+#ifndef TRACEREPLAYER__H
+#define TRACEREPLAYER__H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "RecorderListener.h"
+#include "TraceReader.h"
+#include "TraceState.h"
+
+/*
+Plays back a trace file written by TraceRecorder, without running the simulation.
+
+TraceReplayer rebuilds the Board's occupancy and the Boxes' levels from the trace's SpotTransitions and sends them to its RecorderListeners, the same way Recorder does during a live run. Time in the replay is the trace's time: nanoseconds since the recorded Board was constructed. The caller decides how fast that time passes by how much it steps forward, so a replay can run at any speed.
+
+To make seeking fast, TraceReplayer saves a keyframe (the full TraceState) every so many records in a file next to the trace, named the trace's path plus ".keyframes". The keyframes are made once, by reading the whole trace, the first time a trace is replayed. After that seek() loads the nearest keyframe before the requested time and applies only the records after it.
+
+Records are applied in file order. TraceRecorder writes records in time order within each flush, so a record can be a few milliseconds out of order.
+*/
+class TraceReplayer
+{
+    public:
+
+    /*
+    Opens the trace at @tracePath and loads its keyframes, making the keyframe file if it is missing or was made for a different trace, judged by the record count and a fingerprint of the trace's size, start, and end. Throws an invalid_argument exception if the trace can not be read or the keyframe file can not be written.
+
+    @keyframeInterval is the number of records between keyframes.
+    */
+    explicit TraceReplayer(const std::string& tracePath, int keyframeInterval = 65536);
+    TraceReplayer() = delete;
+    TraceReplayer(const TraceReplayer& o) = delete;
+    TraceReplayer(TraceReplayer&& o) noexcept = delete;
+    TraceReplayer& operator=(const TraceReplayer& o) = delete;
+    TraceReplayer& operator=(TraceReplayer&& o) noexcept = delete;
+    ~TraceReplayer() noexcept = default;
+
+    int getWidth() const;
+    int getHeight() const;
+
+    /*
+    Returns the current replay time in nanoseconds.
+    */
+    long getTime() const;
+
+    /*
+    Returns the largest timestamp in the trace.
+    */
+    long getEndTime() const;
+
+    /*
+    Returns true once every record in the trace has been applied.
+    */
+    bool isFinished() const;
+
+    const TraceState& getState() const;
+
+    int getKeyframeCount() const;
+
+    void registerListener(RecorderListener* listener);
+
+    /*
+    Moves the replay time forward by @duration nanoseconds, applies every record up to the new time, and sends one Frame with the changes to the RecorderListeners.
+    */
+    void step(long duration);
+
+    /*
+    Moves the replay time to @timestamp, forwards or backwards, and sends one Frame to the RecorderListeners. The Frame's changed Drops cover every Position that was occupied before or after the seek.
+    */
+    void seek(long timestamp);
+
+
+    private:
+
+    struct Keyframe
+    {
+        long record;
+        long timestamp;
+        long offset;
+    };
+
+    TraceReader _reader;
+    TraceState _state;
+    const int _keyframeInterval;
+    const std::string _keyframePath;
+    // FNV-1a over the trace's size and its first and last 64 KiB, which hold the header and the first and last records.
+    const uint64_t _traceFingerprint;
+    std::ifstream _keyframeFile;
+    std::vector<Keyframe> _keyframes{};
+    long _endTime = 0;
+
+    std::vector<RecorderListener*> _listeners{};
+
+    long _time = 0;
+    long _nextRecord = 0;
+    long _sequence = 0;
+
+    // _buffer holds the records starting at record _bufferFirst.
+    std::vector<SpotTransition> _buffer{};
+    long _bufferFirst = 0;
+
+    // Cells changed since the last Frame was sent.
+    std::vector<char> _cellChanged{};
+    std::vector<int> _changedCells{};
+
+    bool loadKeyframes();
+    void makeKeyframes();
+    const SpotTransition* getRecord(long record);
+    void applyUntil(long timestamp);
+    void markCell(int cell);
+    void markOccupiedCells();
+    void sendFrame();
+};
+
+#endif
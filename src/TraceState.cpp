@@ -0,0 +1,134 @@
+#include "TraceState.h"
+
+#include <stdexcept>
+#include "TraceFormat.h"
+
+using namespace std;
+
+TraceState::TraceState(int width, int height, const vector<BoxInfo>& boxInfos)
+:   _grid{width, height},
+    _boxInfos{boxInfos},
+    _levels(boxInfos.size(), 0)
+{
+    auto boxIndexPerId = make_shared<unordered_map<int, int>>();
+    for (int ii=0; ii<static_cast<int>(boxInfos.size()); ++ii)
+    {
+        boxIndexPerId->insert({boxInfos[ii].getId(), ii});
+    }
+    _boxIndexPerId = std::move(boxIndexPerId);
+}
+
+int TraceState::apply(const SpotTransition& transition)
+{
+    if (transition.isCollision())
+    {
+        if (transition.upLevel)
+        {
+            auto box = _boxIndexPerId->find(transition.boxId);
+            auto other = _boxIndexPerId->find(transition.otherBoxId);
+            if (box != _boxIndexPerId->end())
+            {
+                ++_levels[box->second];
+            }
+            if (other != _boxIndexPerId->end())
+            {
+                ++_levels[other->second];
+            }
+        }
+        return -1;
+    }
+
+    Position position{transition.x, transition.y};
+    MoveType type = transition.getMoveType();
+    if (type == MoveType::left && _grid.getDropAt(position).getBoxId() != transition.boxId)
+    {
+        return -1;
+    }
+    _grid.update(Drop{position.getX(), position.getY(), transition.boxId, type});
+    return position.getY() * _grid.getWidth() + position.getX();
+}
+
+void TraceState::clear()
+{
+    vector<int> occupiedCells = _grid.getOccupiedCells();
+    for (int cell : occupiedCells)
+    {
+        Position position = _grid.getPosition(cell);
+        _grid.update(Drop{position.getX(), position.getY(), -1, MoveType::left});
+    }
+    fill(_levels.begin(), _levels.end(), 0);
+}
+
+const OccupancyGrid& TraceState::getGrid() const
+{
+    return _grid;
+}
+
+int TraceState::getLevel(int boxId) const
+{
+    return _levels[_boxIndexPerId->at(boxId)];
+}
+
+vector<BoxInfo> TraceState::getBoxInfos() const
+{
+    vector<BoxInfo> boxInfos{};
+    boxInfos.reserve(_boxInfos.size());
+    for (int ii=0; ii<static_cast<int>(_boxInfos.size()); ++ii)
+    {
+        const BoxInfo& info = _boxInfos[ii];
+        boxInfos.push_back(BoxInfo{info.getId(), info.getGroupId(), info.getWidth(), info.getHeight(), _levels[ii]});
+    }
+    return boxInfos;
+}
+
+const shared_ptr<const unordered_map<int, int>>& TraceState::getBoxIndexPerId() const
+{
+    return _boxIndexPerId;
+}
+
+void TraceState::save(ostream& out) const
+{
+    writeTraceInt(out, static_cast<int32_t>(_levels.size()));
+    for (int level : _levels)
+    {
+        writeTraceInt(out, level);
+    }
+
+    const vector<int>& occupiedCells = _grid.getOccupiedCells();
+    writeTraceInt(out, static_cast<int32_t>(occupiedCells.size()));
+    for (int cell : occupiedCells)
+    {
+        writeTraceInt(out, cell);
+        writeTraceInt(out, _grid.getBoxId(cell));
+        writeTraceInt(out, static_cast<int32_t>(_grid.getMoveType(cell)));
+    }
+}
+
+void TraceState::load(istream& in)
+{
+    clear();
+
+    int levelCount = readTraceInt(in);
+    if (levelCount != static_cast<int>(_levels.size()))
+    {
+        throw invalid_argument("The saved TraceState has " + to_string(levelCount) + " Boxes, expected " + to_string(_levels.size()) + ".");
+    }
+    for (int& level : _levels)
+    {
+        level = readTraceInt(in);
+    }
+
+    int occupiedCount = readTraceInt(in);
+    for (int ii=0; ii<occupiedCount; ++ii)
+    {
+        int cell = readTraceInt(in);
+        int boxId = readTraceInt(in);
+        MoveType type = static_cast<MoveType>(readTraceInt(in));
+        Position position = _grid.getPosition(cell);
+        _grid.update(Drop{position.getX(), position.getY(), boxId, type});
+    }
+    if (!in)
+    {
+        throw invalid_argument("The saved TraceState is incomplete.");
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef TRACESTATE__H
+#define TRACESTATE__H
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include "BoxInfo.h"
+#include "OccupancyGrid.h"
+#include "SpotTransition.h"
+
+/*
+The Board's occupancy and the Boxes' levels, rebuilt by applying SpotTransitions from a trace one at a time.
+
+Applying is lenient, so a trace whose records are slightly out of order still gives a sensible state: a MoveType::left only empties a cell if the cell still holds that Box.
+*/
+class TraceState
+{
+    public:
+
+    /*
+    @boxInfos are the Boxes in the trace's header. All levels start at 0.
+    */
+    TraceState(int width, int height, const std::vector<BoxInfo>& boxInfos);
+    TraceState() = delete;
+    TraceState(const TraceState& o) = delete;
+    TraceState(TraceState&& o) noexcept = delete;
+    TraceState& operator=(const TraceState& o) = delete;
+    TraceState& operator=(TraceState&& o) noexcept = delete;
+    ~TraceState() noexcept = default;
+
+    /*
+    Applies @transition. Returns the cell that changed, or -1 if no cell changed (a collision only changes levels). Throws an invalid_argument exception if @transition's Position is not on the Board.
+    */
+    int apply(const SpotTransition& transition);
+
+    /*
+    Empties the Board and sets all levels back to 0.
+    */
+    void clear();
+
+    const OccupancyGrid& getGrid() const;
+
+    /*
+    Returns the level of the Box with id @boxId. Throws an out_of_range exception if there is no such Box.
+    */
+    int getLevel(int boxId) const;
+
+    /*
+    Returns a BoxInfo per Box, with the Box's current level.
+    */
+    std::vector<BoxInfo> getBoxInfos() const;
+
+    /*
+    Returns the map of boxId to index in getBoxInfos().
+    */
+    const std::shared_ptr<const std::unordered_map<int, int>>& getBoxIndexPerId() const;
+
+    /*
+    Writes the levels and the occupied cells to @out, so they can be restored with load().
+    */
+    void save(std::ostream& out) const;
+
+    /*
+    Replaces the current state with one written by save().
+    */
+    void load(std::istream& in);
+
+
+    private:
+
+    OccupancyGrid _grid;
+    const std::vector<BoxInfo> _boxInfos;
+    std::shared_ptr<const std::unordered_map<int, int>> _boxIndexPerId;
+    std::vector<int> _levels{};
+};
+
+#endif
@@ -0,0 +1,200 @@
+#include "Tracer.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include "ThreadShards.h"
+
+using namespace std;
+
+atomic<bool> Tracer::_recording{false};
+
+namespace
+{
+    struct Span
+    {
+        const char* name;
+        int lane;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    // Spans are stored in fixed size chunks, so appending never moves a Span that writeJson() may be reading.
+    struct Chunk
+    {
+        static constexpr size_t capacity = 4096;
+        Span spans[capacity];
+        atomic<Chunk*> next{nullptr};
+    };
+
+    // Written by one thread only. size is published after the Span is written, so writeJson() reads only finished Spans.
+    struct Buffer
+    {
+        Chunk* head = nullptr;
+        Chunk* tail = nullptr;
+        atomic<size_t> size{0};
+        // The Registry's run when this Buffer was last emptied.
+        uint64_t run = 0;
+
+        ~Buffer()
+        {
+            clear();
+        }
+
+        void clear()
+        {
+            Chunk* chunk = head;
+            while (chunk != nullptr)
+            {
+                Chunk* next = chunk->next.load(memory_order_relaxed);
+                delete chunk;
+                chunk = next;
+            }
+            head = nullptr;
+            tail = nullptr;
+            size.store(0, memory_order_relaxed);
+        }
+    };
+
+    struct Registry
+    {
+        // Held by writeJson() while it reads the Buffers, and by a thread while it empties its Buffer.
+        mutex mux;
+        ThreadShards<Buffer> buffers{};
+        // Counts the calls to start().
+        atomic<uint64_t> run{0};
+        atomic<uint64_t> startTicks{0};
+        atomic<uint64_t> stopTicks{UINT64_MAX};
+    };
+
+    Registry& getRegistry()
+    {
+        // Never destroyed, so threads that outlive main() can still record.
+        static Registry* registry = new Registry{};
+        return *registry;
+    }
+
+    Buffer& getBufferForThisThread()
+    {
+        Registry& registry = getRegistry();
+        Buffer& buffer = registry.buffers.getForThisThread();
+        uint64_t run = registry.run.load(memory_order_relaxed);
+        if (buffer.run != run)
+        {
+            // The thread's first span since start(). The Spans of earlier runs, its own or an exited thread's, are dropped.
+            lock_guard<mutex> lock(registry.mux);
+            buffer.clear();
+            buffer.run = run;
+        }
+        return buffer;
+    }
+}
+
+void Tracer::start()
+{
+    Registry& registry = getRegistry();
+    registry.run.fetch_add(1, memory_order_relaxed);
+    registry.stopTicks.store(UINT64_MAX, memory_order_relaxed);
+    registry.startTicks.store(TscClock::now(), memory_order_relaxed);
+    _recording.store(true, memory_order_release);
+}
+
+void Tracer::stop()
+{
+    _recording.store(false, memory_order_release);
+    getRegistry().stopTicks.store(TscClock::now(), memory_order_relaxed);
+}
+
+void Tracer::record(const char* name, int lane, uint64_t startTicks, uint64_t endTicks)
+{
+    Buffer& buffer = getBufferForThisThread();
+    size_t size = buffer.size.load(memory_order_relaxed);
+    size_t slot = size % Chunk::capacity;
+    if (slot == 0)
+    {
+        Chunk* chunk = new Chunk{};
+        if (buffer.tail == nullptr)
+        {
+            // writeJson() only reads head once size is above zero, which is published below.
+            buffer.head = chunk;
+        }
+        else
+        {
+            buffer.tail->next.store(chunk, memory_order_release);
+        }
+        buffer.tail = chunk;
+    }
+    buffer.tail->spans[slot] = Span{name, lane, startTicks, endTicks};
+    buffer.size.store(size + 1, memory_order_release);
+}
+
+void Tracer::writeJson(ostream& out)
+{
+    Registry& registry = getRegistry();
+    uint64_t startTicks = registry.startTicks.load(memory_order_relaxed);
+    uint64_t stopTicks = registry.stopTicks.load(memory_order_relaxed);
+    double microsecondsPerTick = TscClock::getNanosecondsPerTick() / 1000.0;
+
+    vector<Span> spans{};
+    {
+        lock_guard<mutex> lock(registry.mux);
+        registry.buffers.visitAll([startTicks, stopTicks, &spans](const vector<unique_ptr<Buffer>>& buffers){
+            for (const auto& buffer : buffers)
+            {
+                size_t size = buffer->size.load(memory_order_acquire);
+                const Chunk* chunk = (size > 0) ? buffer->head : nullptr;
+                for (size_t ii=0; ii<size; ++ii)
+                {
+                    if (ii > 0 && ii % Chunk::capacity == 0)
+                    {
+                        chunk = chunk->next.load(memory_order_acquire);
+                    }
+                    const Span& span = chunk->spans[ii % Chunk::capacity];
+                    if (span.start >= startTicks && span.end <= stopTicks)
+                    {
+                        spans.push_back(span);
+                    }
+                }
+            }
+        });
+    }
+    sort(spans.begin(), spans.end(), [](const Span& a, const Span& b){
+        return a.start < b.start;
+    });
+
+    // Boxes are one process and the Board another, so the viewer groups them apart.
+    auto getPid = [](int lane){ return (lane == boardLane) ? 1 : 2; };
+    auto getTid = [](int lane){ return (lane == boardLane) ? 0 : lane; };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Board\"}},\n";
+    out << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"Boxes\"}},\n";
+    out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"sendStateAndChanges\"}}";
+
+    set<int> lanes{};
+    for (const Span& span : spans)
+    {
+        if (span.lane != boardLane && lanes.insert(span.lane).second)
+        {
+            out << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":2,\"tid\":" << span.lane
+                << ",\"args\":{\"name\":\"Box " << span.lane << "\"}}";
+        }
+    }
+
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out.setf(ios::fixed);
+    out.precision(3);
+    for (const Span& span : spans)
+    {
+        double ts = static_cast<double>(span.start - startTicks) * microsecondsPerTick;
+        double dur = static_cast<double>(span.end - span.start) * microsecondsPerTick;
+        out << ",\n{\"ph\":\"X\",\"name\":\"" << span.name << "\",\"pid\":" << getPid(span.lane)
+            << ",\"tid\":" << getTid(span.lane) << ",\"ts\":" << ts << ",\"dur\":" << dur << "}";
+    }
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,120 @@
+#ifndef TRACER__H
+#define TRACER__H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include "TscClock.h"
+
+/*
+Records timed spans, like a Box's move or a Board broadcast, and writes them as Chrome trace-event JSON, which Perfetto (ui.perfetto.dev) and chrome://tracing open.
+
+Every span belongs to a lane. A Box's spans use its boxId as the lane, so each Box gets its own track in the viewer. boardLane is the Board's own track, for sendStateAndChanges().
+
+Spans are added through the PLAZA_TRACE_SPAN and PLAZA_TRACE_INTERVAL macros. They are compiled out unless PLAZA_TRACING is defined (cmake -DPLAZA_TRACING=ON), so a normal build pays nothing. With PLAZA_TRACING, a span costs two TscClock reads and an append to the current thread's buffer, and only while the Tracer is started.
+
+Each thread appends to its own buffer, which no other thread writes to. Buffers come from ThreadShards, so the buffer of a thread that exits goes to the next new thread, and a run that starts a thread per Box keeps only as many buffers as there were threads at one time. A thread's first span after each start() takes a lock, to drop what its buffer holds from earlier runs. writeJson() may be called while threads are still recording; it writes the spans that were finished by then.
+*/
+class Tracer
+{
+    public:
+
+    static constexpr int boardLane = -1;
+
+    Tracer() = delete;
+
+    /*
+    Returns true if the PLAZA_TRACE macros record spans in this build.
+    */
+    static constexpr bool isCompiledIn()
+    {
+#ifdef PLAZA_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*
+    Starts recording. writeJson() only writes spans that start after the latest start(). Each thread's buffer is emptied before its first span in the new run.
+    */
+    static void start();
+
+    /*
+    Stops recording. Spans still open are dropped.
+    */
+    static void stop();
+
+    static bool isRecording()
+    {
+        return _recording.load(std::memory_order_relaxed);
+    }
+
+    /*
+    Records a span on @lane from @startTicks to @endTicks, both from TscClock::now(). @name must be a string literal or otherwise outlive the Tracer.
+    */
+    static void record(const char* name, int lane, uint64_t startTicks, uint64_t endTicks);
+
+    /*
+    Writes the recorded spans, and a name for every lane, as Chrome trace-event JSON. Times are in microseconds from start().
+    */
+    static void writeJson(std::ostream& out);
+
+
+    private:
+
+    static std::atomic<bool> _recording;
+};
+
+/*
+Records a span from its construction to its destruction. Use it through PLAZA_TRACE_SPAN.
+*/
+class TraceSpan
+{
+    public:
+
+    TraceSpan(const char* name, int lane)
+    :   _name{name},
+        _lane{lane},
+        _start{Tracer::isRecording() ? TscClock::now() : 0}
+    {}
+
+    TraceSpan() = delete;
+    TraceSpan(const TraceSpan& o) = delete;
+    TraceSpan(TraceSpan&& o) noexcept = delete;
+    TraceSpan& operator=(const TraceSpan& o) = delete;
+    TraceSpan& operator=(TraceSpan&& o) noexcept = delete;
+
+    ~TraceSpan() noexcept
+    {
+        if (_start != 0 && Tracer::isRecording())
+        {
+            Tracer::record(_name, _lane, _start, TscClock::now());
+        }
+    }
+
+
+    private:
+
+    const char* _name;
+    const int _lane;
+    const uint64_t _start;
+};
+
+#define PLAZA_TRACE_CONCAT_INNER(a, b) a##b
+#define PLAZA_TRACE_CONCAT(a, b) PLAZA_TRACE_CONCAT_INNER(a, b)
+
+#ifdef PLAZA_TRACING
+// Records a span named @name on @lane until the end of the enclosing scope.
+#define PLAZA_TRACE_SPAN(name, lane) TraceSpan PLAZA_TRACE_CONCAT(plazaTraceSpan, __LINE__){name, lane}
+// Records a span named @name on @lane between two TscClock::now() values.
+#define PLAZA_TRACE_INTERVAL(name, lane, startTicks, endTicks) \
+    do { if (Tracer::isRecording()) { Tracer::record(name, lane, startTicks, endTicks); } } while (false)
+#else
+// The arguments are not evaluated, but still count as used.
+#define PLAZA_TRACE_SPAN(name, lane) do { (void)sizeof(name); (void)sizeof(lane); } while (false)
+#define PLAZA_TRACE_INTERVAL(name, lane, startTicks, endTicks) \
+    do { (void)sizeof(name); (void)sizeof(lane); (void)sizeof(startTicks); (void)sizeof(endTicks); } while (false)
+#endif
+
+#endif
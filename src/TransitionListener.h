@@ -0,0 +1,20 @@
+#ifndef TRANSITIONLISTENER__H
+#define TRANSITIONLISTENER__H
+
+#include "SpotTransition.h"
+
+/*
+Receives every successful change to a Spot and every collision from the Board, as they happen.
+
+receiveTransition() is called from the mover threads, inside Board's changeSpot(), so many threads call it at the same time. It must be thread safe and cheap.
+*/
+class TransitionListener
+{
+    public:
+
+    virtual ~TransitionListener() = default;
+
+    virtual void receiveTransition(const SpotTransition& transition) = 0;
+};
+
+#endif
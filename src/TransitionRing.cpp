@@ -0,0 +1,56 @@
+#include "TransitionRing.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    size_t roundUpToPowerOfTwo(int capacity)
+    {
+        if (capacity < 1)
+        {
+            throw invalid_argument("TransitionRing's capacity must be at least 1.");
+        }
+        size_t size = 1;
+        while (size < static_cast<size_t>(capacity))
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+}
+
+TransitionRing::TransitionRing(int capacity)
+:   _slots(roundUpToPowerOfTwo(capacity)),
+    _mask{_slots.size() - 1}
+{}
+
+int TransitionRing::getCapacity() const
+{
+    return static_cast<int>(_slots.size());
+}
+
+bool TransitionRing::tryPush(const SpotTransition& transition)
+{
+    size_t head = _head.load(memory_order_relaxed);
+    if (head - _tail.load(memory_order_acquire) == _slots.size())
+    {
+        return false;
+    }
+    _slots[head & _mask] = transition;
+    _head.store(head + 1, memory_order_release);
+    return true;
+}
+
+int TransitionRing::drainInto(vector<SpotTransition>& out)
+{
+    size_t tail = _tail.load(memory_order_relaxed);
+    size_t head = _head.load(memory_order_acquire);
+    for (size_t ii = tail; ii != head; ++ii)
+    {
+        out.push_back(_slots[ii & _mask]);
+    }
+    _tail.store(head, memory_order_release);
+    return static_cast<int>(head - tail);
+}
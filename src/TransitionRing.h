@@ -0,0 +1,52 @@
+#ifndef TRANSITIONRING__H
+#define TRANSITIONRING__H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "SpotTransition.h"
+
+/*
+A fixed size, lock-free queue of SpotTransitions with exactly one producer thread and one consumer thread.
+
+The producer calls tryPush() and the consumer calls drainInto(). Neither call waits on the other.
+*/
+class TransitionRing
+{
+    public:
+
+    /*
+    @capacity is rounded up to a power of two. It must be at least 1.
+    */
+    explicit TransitionRing(int capacity);
+    TransitionRing() = delete;
+    TransitionRing(const TransitionRing& o) = delete;
+    TransitionRing(TransitionRing&& o) noexcept = delete;
+    TransitionRing& operator=(const TransitionRing& o) = delete;
+    TransitionRing& operator=(TransitionRing&& o) noexcept = delete;
+    ~TransitionRing() noexcept = default;
+
+    int getCapacity() const;
+
+    /*
+    Adds @transition to the queue. Returns false, without adding @transition, if the queue is full. Only called from the producer thread.
+    */
+    bool tryPush(const SpotTransition& transition);
+
+    /*
+    Moves every SpotTransition in the queue to the end of @out, oldest first. Returns the number moved. Only called from the consumer thread.
+    */
+    int drainInto(std::vector<SpotTransition>& out);
+
+
+    private:
+
+    std::vector<SpotTransition> _slots;
+    const size_t _mask;
+
+    // _head and _tail only ever increase. They are kept on separate cache lines so the producer and consumer don't slow each other down.
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<size_t> _tail{0};
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "TscClock.h"
+
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    using HighResolutionTime = chrono::time_point<chrono::high_resolution_clock>;
+
+    // A tick count and the time it was read at, plus the tick rate.
+    struct Calibration
+    {
+        uint64_t ticks;
+        HighResolutionTime time;
+        double nanosecondsPerTick;
+    };
+
+    /*
+    Reads the tick count and high_resolution_clock together. The time is taken halfway between two tick reads. Of several tries, the one with the two tick reads closest together is kept, so a try that was interrupted is not used.
+    */
+    pair<uint64_t, HighResolutionTime> readBoth()
+    {
+        pair<uint64_t, HighResolutionTime> best{};
+        uint64_t bestGap = UINT64_MAX;
+        for (int ii=0; ii<16; ++ii)
+        {
+            uint64_t before = TscClock::now();
+            HighResolutionTime time = chrono::high_resolution_clock::now();
+            uint64_t after = TscClock::now();
+            if (after - before < bestGap)
+            {
+                bestGap = after - before;
+                best = {before + (after - before) / 2, time};
+            }
+        }
+        return best;
+    }
+
+    Calibration calibrate()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        auto start = readBoth();
+        this_thread::sleep_for(chrono::milliseconds(10));
+        auto end = readBoth();
+        double nanoseconds = chrono::duration<double, nano>(end.second - start.second).count();
+        double ticks = static_cast<double>(end.first - start.first);
+        return Calibration{end.first, end.second, (ticks > 0) ? nanoseconds / ticks : 1.0};
+#else
+        // Ticks are high_resolution_clock's own counts.
+        return Calibration{
+            0,
+            HighResolutionTime{},
+            chrono::duration<double, nano>(chrono::high_resolution_clock::duration{1}).count()};
+#endif
+    }
+
+    const Calibration& getCalibration()
+    {
+        static const Calibration calibration = calibrate();
+        return calibration;
+    }
+}
+
+chrono::time_point<chrono::high_resolution_clock> TscClock::toTimePoint(uint64_t ticks)
+{
+    const Calibration& calibration = getCalibration();
+    // Ticks may be from before the calibration, so the difference is signed.
+    double difference = static_cast<double>(static_cast<int64_t>(ticks - calibration.ticks));
+    auto offset = chrono::duration<double, nano>(difference * calibration.nanosecondsPerTick);
+    return calibration.time + chrono::duration_cast<chrono::high_resolution_clock::duration>(offset);
+}
+
+double TscClock::getNanosecondsPerTick()
+{
+    return getCalibration().nanosecondsPerTick;
+}
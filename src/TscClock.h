@@ -0,0 +1,48 @@
+#ifndef TSCCLOCK__H
+#define TSCCLOCK__H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+A cheap timestamp source for code that runs inside the Board's locks.
+
+now() reads the processor's time stamp counter on x86, which costs a few nanoseconds and no system call. On other processors it falls back to high_resolution_clock. Ticks are turned into high_resolution_clock time points afterwards with toTimePoint(), away from the hot path.
+
+The tick rate is measured once per process, over about 10 milliseconds, the first time toTimePoint() is called. It assumes an invariant time stamp counter that is in step on every core, as on any recent x86 processor.
+*/
+class TscClock
+{
+    public:
+
+    TscClock() = delete;
+
+    /*
+    Returns the current time in ticks.
+    */
+    static uint64_t now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(
+            std::chrono::high_resolution_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /*
+    Returns the high_resolution_clock time point of @ticks, a value returned by now().
+    */
+    static std::chrono::time_point<std::chrono::high_resolution_clock> toTimePoint(uint64_t ticks);
+
+    /*
+    Returns how many nanoseconds one tick lasts.
+    */
+    static double getNanosecondsPerTick();
+};
+
+#endif
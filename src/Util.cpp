@@ -2,16 +2,34 @@
 
 using namespace std;
 
+namespace
+{
+    // One generator per thread, seeded from random_device, so Box threads never share one. setSeed() makes the calling thread's sequence repeatable.
+    mt19937& threadGenerator()
+    {
+        thread_local mt19937 generator{random_device{}()};
+        return generator;
+    }
+}
+
+void Util::setSeed(uint32_t seed)
+{
+    threadGenerator().seed(seed);
+}
+
+mt19937& Util::getGenerator()
+{
+    return threadGenerator();
+}
+
 int  Util::getRandomInt(int start, int end)
 {
     int min = std::min(start, end);
     int max = std::max(start, end);
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
     std::uniform_int_distribution<std::mt19937::result_type> distribution(min, max);
    
-    return distribution(gen);
+    return distribution(getGenerator());
 
 }
 vector<int> Util::getRandomInt(int start, int end, int count)
@@ -19,9 +37,8 @@ vector<int> Util::getRandomInt(int start, int end, int count)
     int min = std::min(start, end);
     int max = std::max(start, end);
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
     std::uniform_int_distribution<std::mt19937::result_type> distribution(min, max);
+    std::mt19937& gen = getGenerator();
    
     vector<int> randomInts{};
     for(int ii=0; ii<count; ++ii)
@@ -33,10 +50,8 @@ vector<int> Util::getRandomInt(int start, int end, int count)
 
 bool Util::getRandomBool()
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
     std::uniform_int_distribution<std::mt19937::result_type> distribution(0, 1);
-    return static_cast<bool>(distribution(gen));
+    return static_cast<bool>(distribution(getGenerator()));
 }
 
 vector<Position> Util::getRandomPositionsInRectangle(Rectangle rectangle, int count)
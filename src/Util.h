@@ -1,6 +1,7 @@
 #ifndef UTIL__H
 #define UTIL__H
 
+#include <cstdint>
 #include <random>
 #include <vector>
 #include "Position.h"
@@ -10,6 +11,16 @@ class Util
 {
 public:
 
+    /*
+    Seeds the random numbers of the calling thread. Each thread has its own generator, seeded from std::random_device until setSeed() is called, so a single threaded run can be repeated exactly by seeding it first.
+    */
+    static void setSeed(uint32_t seed);
+
+    /*
+    Returns the calling thread's random number generator. The other methods draw from it.
+    */
+    static std::mt19937& getGenerator();
+
     /*
     Returns a random int in the range [@start, @end].
     */
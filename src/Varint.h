@@ -0,0 +1,62 @@
+#ifndef VARINT__H
+#define VARINT__H
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/*
+Variable-length integers: 7 bits per byte, lowest bits first, high bit set on every byte but the last. Small numbers take one byte.
+
+Signed numbers are zig-zag mapped first (0, -1, 1, -2, ... become 0, 1, 2, 3, ...), so small negative numbers are small too.
+*/
+
+inline uint64_t zigZag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t unZigZag(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline void writeVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+/*
+Reads a varint at @pos and moves @pos past it. Throws an invalid_argument exception if the varint runs past @end, or if it is longer than the 10 bytes a uint64_t needs.
+*/
+inline uint64_t readVarint(const uint8_t*& pos, const uint8_t* end)
+{
+    if (pos < end && *pos < 0x80)
+    {
+        return *pos++;
+    }
+    uint64_t value = 0;
+    int shift = 0;
+    while (pos < end)
+    {
+        if (shift >= 64)
+        {
+            throw std::invalid_argument("The data holds a varint of more than 10 bytes.");
+        }
+        uint8_t byte = *pos++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (byte < 0x80)
+        {
+            return value;
+        }
+        shift += 7;
+    }
+    throw std::invalid_argument("The data ends inside of a varint.");
+}
+
+#endif
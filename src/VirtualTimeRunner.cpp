@@ -0,0 +1,195 @@
+#include "VirtualTimeRunner.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+VirtualTimeRunner::VirtualTimeRunner(Board& board, vector<BoxPlan>&& plans)
+:   _board{board}
+{
+    _agents.reserve(plans.size());
+    for (BoxPlan& plan : plans)
+    {
+        Position start = plan.start;
+        _agents.push_back(Agent{std::move(plan), Phase::entering, start, start, 1, -1, -1});
+    }
+
+    // Every Box tries to enter at time 0, in BoxPlan order.
+    for (int agent=0; agent<static_cast<int>(_agents.size()); ++agent)
+    {
+        schedule(agent, Phase::entering, 0);
+    }
+}
+
+long VirtualTimeRunner::run(long limitMs)
+{
+    while (!_events.empty() && _events.top().time <= limitMs)
+    {
+        Event event = _events.top();
+        _events.pop();
+        _now = event.time;
+        ++_eventCount;
+        act(event.agent);
+    }
+
+    if (_exitedCount == static_cast<int>(_agents.size()))
+    {
+        return _now;
+    }
+    _now = limitMs;
+    return limitMs;
+}
+
+long VirtualTimeRunner::getNow() const
+{
+    return _now;
+}
+
+int VirtualTimeRunner::getBoxCount() const
+{
+    return static_cast<int>(_agents.size());
+}
+
+int VirtualTimeRunner::getExitedCount() const
+{
+    return _exitedCount;
+}
+
+long VirtualTimeRunner::getEventCount() const
+{
+    return _eventCount;
+}
+
+const BoxPlan& VirtualTimeRunner::getPlan(int index) const
+{
+    return _agents.at(index).plan;
+}
+
+long VirtualTimeRunner::getEntryTime(int index) const
+{
+    return _agents.at(index).entered;
+}
+
+long VirtualTimeRunner::getExitTime(int index) const
+{
+    return _agents.at(index).exited;
+}
+
+void VirtualTimeRunner::schedule(int agent, Phase phase, long delayMs)
+{
+    _agents[agent].phase = phase;
+    _events.push(Event{_now + delayMs, _sequence++, agent});
+}
+
+void VirtualTimeRunner::act(int agent)
+{
+    Agent& a = _agents[agent];
+    int boxId = a.plan.boxId;
+
+    switch (a.phase)
+    {
+        case Phase::entering:
+            // Threader::funcMoveBox(): ask the Decider, then Mover::addBox().
+            if (a.plan.decider->suggestMoveTo(a.current, _board))
+            {
+                if (_board.changeSpot(a.current, BoardNote{boxId, MoveType::to_arrive}, false))
+                {
+                    a.entered = _now;
+                    _board.getMetrics().count(SimulationCounter::boxesEntered);
+                    schedule(agent, Phase::finishingEntry, 5);
+                }
+                else
+                {
+                    _board.getMetrics().count(SimulationCounter::entryRetries);
+                    schedule(agent, Phase::entering, 1);
+                }
+            }
+            else
+            {
+                _board.getMetrics().count(SimulationCounter::entryRetries);
+                schedule(agent, Phase::entering, a.entryWaits * 10);
+                ++a.entryWaits;
+            }
+            break;
+
+        case Phase::finishingEntry:
+            _board.changeSpot(a.current, BoardNote{boxId, MoveType::arrive}, true);
+            step(agent);
+            break;
+
+        case Phase::stepping:
+            step(agent);
+            break;
+
+        case Phase::attempting:
+            attempt(agent);
+            break;
+
+        case Phase::finishingMove:
+            // The second half of Mover::moveBox().
+            _board.changeSpot(a.next, BoardNote{boxId, MoveType::arrive}, true);
+            _board.changeSpot(a.current, BoardNote{boxId, MoveType::left}, true);
+            a.current = a.next;
+            schedule(agent, Phase::stepping, 10);
+            break;
+
+        case Phase::exited:
+            throw logic_error("VirtualTimeRunner scheduled a Box that has already exited.");
+    }
+}
+
+void VirtualTimeRunner::step(int agent)
+{
+    Agent& a = _agents[agent];
+
+    // One pass of the loop in Threader::funcMoveBox(), up to its sleeps.
+    if (a.plan.positionManager->atEnd(a.current))
+    {
+        _board.changeSpot(a.current, BoardNote{a.plan.boxId, MoveType::to_leave}, true);
+        _board.changeSpot(a.current, BoardNote{a.plan.boxId, MoveType::left}, true);
+        _board.getMetrics().count(SimulationCounter::boxesExited);
+        a.phase = Phase::exited;
+        a.exited = _now;
+        ++_exitedCount;
+        return;
+    }
+
+    pair<Position, int> next = a.plan.decider->getNext(
+        a.plan.positionManager->getFuturePositions(a.current),
+        _board);
+    a.next = next.first;
+    if (next.second > 0)
+    {
+        schedule(agent, Phase::attempting, next.second);
+    }
+    else
+    {
+        attempt(agent);
+    }
+}
+
+void VirtualTimeRunner::attempt(int agent)
+{
+    Agent& a = _agents[agent];
+    int boxId = a.plan.boxId;
+
+    // The first half of Mover::moveBox().
+    if (a.next == Position{-1, -1})
+    {
+        _board.getMetrics().count(SimulationCounter::deciderNoMove);
+        schedule(agent, Phase::stepping, 10);
+    }
+    else if (_board.changeSpot(a.next, BoardNote{boxId, MoveType::to_arrive}, true))
+    {
+        _board.changeSpot(a.current, BoardNote{boxId, MoveType::to_leave}, true);
+        int deltaX = a.current.getX() - a.next.getX();
+        int deltaY = a.current.getY() - a.next.getY();
+        bool diagonal = ((deltaX * deltaX) + (deltaY * deltaY)) == 2;
+        _board.getMetrics().count(diagonal ? SimulationCounter::diagonalMoves : SimulationCounter::lateralMoves);
+        schedule(agent, Phase::finishingMove, diagonal ? 10 : 14);
+    }
+    else
+    {
+        schedule(agent, Phase::stepping, 10);
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef VIRTUALTIMERUNNER__H
+#define VIRTUALTIMERUNNER__H
+
+#include <queue>
+#include <vector>
+#include "Board.h"
+#include "BoxPlan.h"
+
+/*
+Runs Boxes on a Board in virtual time, on the calling thread, instead of one thread per Box.
+
+Each Box follows the same steps as Threader::funcMoveBox() with a Mover_Reg, and every sleep in those steps becomes a wait in virtual milliseconds: 5 to add a Box, 10 for a diagonal move, 14 for a lateral move, 10 between moves, the Decider's suggested wait, and n * 10 when the Decider keeps a Box from entering. Where funcMoveBox() retries adding a Box right away, the virtual Box retries 1ms later, since it would otherwise never let time pass.
+
+Boxes act in order of their virtual time, and Boxes acting at the same time act in the order they were scheduled, so a run depends only on its BoxPlans and the random numbers drawn by their PositionManagers and Deciders. Seed Util first to make a run repeatable. A run takes as long as the work it does, not as long as the virtual time it covers.
+*/
+class VirtualTimeRunner
+{
+    public:
+
+    /*
+    @board must contain a Box for every BoxPlan's boxId, and none of them may be on @board yet.
+    */
+    VirtualTimeRunner(Board& board, std::vector<BoxPlan>&& plans);
+    VirtualTimeRunner() = delete;
+    VirtualTimeRunner(const VirtualTimeRunner& o) = delete;
+    VirtualTimeRunner(VirtualTimeRunner&& o) noexcept = delete;
+    VirtualTimeRunner& operator=(const VirtualTimeRunner& o) = delete;
+    VirtualTimeRunner& operator=(VirtualTimeRunner&& o) noexcept = delete;
+    ~VirtualTimeRunner() noexcept = default;
+
+    /*
+    Runs until every Box has exited or the virtual time reaches @limitMs. Returns the virtual time at which the last Box exited, or @limitMs if some Boxes had not exited by then. Can be called again with a later limit to continue.
+    */
+    long run(long limitMs);
+
+    /*
+    Returns the current virtual time in milliseconds.
+    */
+    long getNow() const;
+
+    int getBoxCount() const;
+    int getExitedCount() const;
+
+    /*
+    Returns the number of steps the Boxes have taken, for measuring the runner itself.
+    */
+    long getEventCount() const;
+
+    const BoxPlan& getPlan(int index) const;
+
+    /*
+    Returns the virtual time at which the Box of BoxPlan @index was added to the Board, or -1 if it has not been added.
+    */
+    long getEntryTime(int index) const;
+
+    /*
+    Returns the virtual time at which the Box of BoxPlan @index left the Board at its exit, or -1 if it has not exited.
+    */
+    long getExitTime(int index) const;
+
+
+    private:
+
+    enum class Phase{entering, finishingEntry, stepping, attempting, finishingMove, exited};
+
+    struct Agent
+    {
+        BoxPlan plan;
+        Phase phase;
+        Position current;
+        Position next;
+        // Counts the waits before entering. Each wait is 10ms longer than the one before.
+        int entryWaits;
+        long entered;
+        long exited;
+    };
+
+    struct Event
+    {
+        long time;
+        long sequence;
+        int agent;
+
+        bool operator>(const Event& o) const
+        {
+            return (time != o.time) ? (time > o.time) : (sequence > o.sequence);
+        }
+    };
+
+    Board& _board;
+    std::vector<Agent> _agents{};
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> _events{};
+    long _now = 0;
+    long _sequence = 0;
+    long _eventCount = 0;
+    int _exitedCount = 0;
+
+    void schedule(int agent, Phase phase, long delayMs);
+    void act(int agent);
+    void step(int agent);
+    void attempt(int agent);
+};
+
+#endif
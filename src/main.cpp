@@ -1,15 +1,29 @@
+#include <fstream>
+#include <iostream>
 #include <thread>
 
 #include <SDL.h>
 #include <SDL_ttf.h>
 
+#include "AsyncBoardListener.h"
 #include "BoardProxy.h"
 #include "BroadcastAgent.h"
 #include "Box.h"
+#include "CellHeatmap.h"
+#include "FrameStreamServer.h"
+#include "HeatmapExporter.h"
+#include "LatencyLogger.h"
+#include "LockProfiler.h"
 #include "MainSetup.h"
+#include "MetricsHud.h"
+#include "MetricsLogger.h"
 #include "Printer.h"
 #include "Recorder.h"
+#include "SharedBoardExporter.h"
 #include "Threader.h"
+#include "TraceRecorder.h"
+#include "TraceReplayer.h"
+#include "Tracer.h"
 
 
 // Define screen dimensions
@@ -24,12 +38,118 @@ void quitTTFandSDL()
     SDL_Quit();
 }
 
+/*
+Plays back the trace at @tracePath on @printer until the window is closed. @speed is how many seconds of the trace are played per second. Playback starts @seekSeconds into the trace.
+*/
+void replay(const string& tracePath, double speed, double seekSeconds, Printer& printer)
+{
+    TraceReplayer replayer{tracePath};
+    replayer.registerListener(&printer);
+    replayer.seek(static_cast<long>(seekSeconds * 1e9));
+
+    bool running = true;
+    auto lastStep = chrono::steady_clock::now();
+    while(running)
+    {
+        SDL_Event e;
+        if (SDL_PollEvent(&e) != 0 && e.type == SDL_QUIT)
+        {
+            running = false;
+        }
+
+        this_thread::sleep_for(chrono::milliseconds{16});
+        auto now = chrono::steady_clock::now();
+        replayer.step(static_cast<long>(chrono::duration<double, nano>(now - lastStep).count() * speed));
+        lastStep = now;
+    }
+}
+
 int main(int argc, char* argv[])
 {
-    // Unused argc, argv
-    (void) argc;
-    (void) argv;
-    
+    // Optional "--trace <file>" records every Spot transition to <file>.
+    // Optional "--shm <name>" publishes the Board in the shared-memory segment <name> for SharedBoardViewer and other external readers.
+    // Optional "--stream <address>" streams the Board to FrameStreamClients on a Unix socket (an address starting with '/') or on TCP ("host:port").
+    // Optional "--metrics <file>" writes the Board's SimulationMetrics to <file> every second, as JSON lines if <file> ends in ".json" and as CSV otherwise.
+    // Optional "--latencies <file>" writes the Boxes' StepPhase percentiles per DeciderType and PositionManagerType to <file> as CSV every five seconds.
+    // Optional "--chrome-trace <file>" writes each Box's timeline and the Board's broadcasts to <file> as Chrome trace-event JSON for Perfetto. The spans are only recorded in a build configured with -DPLAZA_TRACING=ON.
+    // Optional "--lock-report <file>" writes the LockProfiler's contention report to <file> at shutdown. A build configured with -DPLAZA_LOCK_PROFILING=ON writes the report to standard output at shutdown if no <file> is given.
+    // Optional "--heatmap <prefix>" counts traversals, collisions, and dwell time per Position and writes them at shutdown to <prefix>-<layer>.csv grids and <prefix>-<layer>.ppm images, with the in-bound and out-bound Rectangles outlined.
+    // Optional "--doorways <file>" writes the entries, exits, rates, and queue lengths of every in-bound and out-bound Rectangle to <file> as CSV at shutdown.
+    // Optional "--hud" draws the SimulationMetrics over the Board.
+    // Optional "--replay <file>" plays back a recorded trace instead of running the simulation. With it, "--speed <x>" plays the trace x times faster and "--seek <seconds>" starts the playback that many seconds in.
+    string tracePath{};
+    string replayPath{};
+    string sharedMemoryName{};
+    string streamAddress{};
+    string metricsPath{};
+    string latenciesPath{};
+    string chromeTracePath{};
+    string lockReportPath{};
+    string heatmapPrefix{};
+    string doorwaysPath{};
+    bool showHud = false;
+    double replaySpeed = 1.0;
+    double replaySeek = 0.0;
+    for (int ii=1; ii+1<argc; ++ii)
+    {
+        string option{argv[ii]};
+        if (option == "--trace")
+        {
+            tracePath = argv[ii+1];
+        }
+        else if (option == "--shm")
+        {
+            sharedMemoryName = argv[ii+1];
+        }
+        else if (option == "--stream")
+        {
+            streamAddress = argv[ii+1];
+        }
+        else if (option == "--metrics")
+        {
+            metricsPath = argv[ii+1];
+        }
+        else if (option == "--latencies")
+        {
+            latenciesPath = argv[ii+1];
+        }
+        else if (option == "--chrome-trace")
+        {
+            chromeTracePath = argv[ii+1];
+        }
+        else if (option == "--lock-report")
+        {
+            lockReportPath = argv[ii+1];
+        }
+        else if (option == "--heatmap")
+        {
+            heatmapPrefix = argv[ii+1];
+        }
+        else if (option == "--doorways")
+        {
+            doorwaysPath = argv[ii+1];
+        }
+        else if (option == "--replay")
+        {
+            replayPath = argv[ii+1];
+        }
+        else if (option == "--speed")
+        {
+            replaySpeed = stod(argv[ii+1]);
+        }
+        else if (option == "--seek")
+        {
+            replaySeek = stod(argv[ii+1]);
+        }
+    }
+    for (int ii=1; ii<argc; ++ii)
+    {
+        if (string{argv[ii]} == "--hud")
+        {
+            showHud = true;
+        }
+    }
+
     // Initialize SDL2 and SDL2_ttf
     if(SDL_Init(SDL_INIT_VIDEO) < 0)
     {
@@ -86,16 +206,58 @@ int main(int argc, char* argv[])
     MainSetup::addAGroupOfBoxes(boxes, 600, 2, 400);
     MainSetup::addAGroupOfBoxes(boxes, 1000, 3, 400);
     
+    // The trace file's header describes the Boxes, so collect their BoxInfos before the Board takes them.
+    vector<BoxInfo> boxInfos{};
+    for (const Box& box : boxes)
+    {
+        boxInfos.push_back(box.getInfo());
+    }
+
     // Create Board
     Board board{SCREEN_WIDTH, SCREEN_HEIGHT, std::move(boxes)};
+    board.getDoorwayFlow().setDoorways(inOutBoundRectangles);
+
+    // Create TraceRecorder if a trace file was requested. It must be registered before the Boxes start moving.
+    unique_ptr<TraceRecorder> traceRecorder{};
+    if (!tracePath.empty())
+    {
+        traceRecorder = make_unique<TraceRecorder>(tracePath, SCREEN_WIDTH, SCREEN_HEIGHT, boxInfos);
+        board.registerTransitionListener(traceRecorder.get());
+    }
+
+    // Create CellHeatmap if requested. Like the TraceRecorder, it must be registered before the Boxes start moving.
+    unique_ptr<CellHeatmap> cellHeatmap{};
+    if (!heatmapPrefix.empty())
+    {
+        cellHeatmap = make_unique<CellHeatmap>(SCREEN_WIDTH, SCREEN_HEIGHT);
+        board.registerTransitionListener(cellHeatmap.get());
+    }
 
     // Create BroadcastAgent. It will periodically ask Board (via BoardProxy) to send changes to recorder.
     BroadcastAgent broadcastAgent{board.getBoardProxy()};
 
     // Create Recorder, it will listen for changes from Board and send those changes to the printer.
-    Recorder recorder{};
+    Recorder recorder{SCREEN_WIDTH, SCREEN_HEIGHT};
     board.registerListener(&recorder);
 
+    // Create SharedBoardExporter if requested. It writes on its own thread, so a slow write never holds up the broadcast. If it falls behind, Frames are merged.
+    unique_ptr<SharedBoardExporter> sharedBoardExporter{};
+    unique_ptr<AsyncBoardListener> asyncSharedBoardExporter{};
+    if (!sharedMemoryName.empty())
+    {
+        sharedBoardExporter = make_unique<SharedBoardExporter>(sharedMemoryName, SCREEN_WIDTH, SCREEN_HEIGHT, static_cast<int>(boxInfos.size()));
+        asyncSharedBoardExporter = make_unique<AsyncBoardListener>(sharedBoardExporter.get(), 2, BackpressurePolicy::coalesce);
+        board.registerListener(asyncSharedBoardExporter.get());
+    }
+
+    // Create FrameStreamServer if requested. It only encodes each Frame on the broadcast; its own thread does the sending.
+    unique_ptr<FrameStreamServer> frameStreamServer{};
+    if (!streamAddress.empty())
+    {
+        frameStreamServer = make_unique<FrameStreamServer>(streamAddress, SCREEN_WIDTH, SCREEN_HEIGHT);
+        board.registerListener(frameStreamServer.get());
+    }
+
     // Create the printer and have it listen for changes from the recorder.
     Printer printer(renderer);
     recorder.registerListener(&printer);
@@ -111,6 +273,39 @@ int main(int argc, char* argv[])
     // Add the in-bound and out-bound rectangles to printer (where the boxes start and end).
     printer.addInOutBoundRectangles(inOutBoundRectangles);
 
+    if (!replayPath.empty())
+    {
+        replay(replayPath, replaySpeed, replaySeek, printer);
+
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        quitTTFandSDL();
+        return 0;
+    }
+
+    // Create MetricsLogger if requested.
+    unique_ptr<MetricsLogger> metricsLogger{};
+    if (!metricsPath.empty())
+    {
+        metricsLogger = make_unique<MetricsLogger>(board.getMetrics(), metricsPath, chrono::seconds{1});
+    }
+
+    // Create LatencyLogger if requested.
+    unique_ptr<LatencyLogger> latencyLogger{};
+    if (!latenciesPath.empty())
+    {
+        latencyLogger = make_unique<LatencyLogger>(board.getLatencies(), latenciesPath, chrono::seconds{5});
+    }
+
+    // Create MetricsHud if requested and have the printer draw it.
+    unique_ptr<MetricsHud> metricsHud{};
+    if (showHud)
+    {
+        metricsHud = make_unique<MetricsHud>(renderer, "assets/pacifico/Pacifico.ttf", 16, board.getMetrics(), chrono::milliseconds{500});
+        metricsHud->setDoorwayFlow(&board.getDoorwayFlow());
+        printer.setHud(metricsHud.get());
+    }
+
     // Prints empty Board.
     broadcastAgent.requestBroadcast();
 
@@ -122,6 +317,16 @@ int main(int argc, char* argv[])
 
     Threader threader{};
 
+    // Start tracing before the Boxes start moving.
+    if (!chromeTracePath.empty())
+    {
+        if (!Tracer::isCompiledIn())
+        {
+            printf("--chrome-trace needs a build configured with -DPLAZA_TRACING=ON. The trace will be empty.\n");
+        }
+        Tracer::start();
+    }
+
     // Number of Boxes is 200 * 7 same as the number of Boxes in _boxes. 
     threader.populateThreads(
         threads,
@@ -154,6 +359,40 @@ int main(int argc, char* argv[])
         threads[ii]->join();
     }
 
+    if (!chromeTracePath.empty())
+    {
+        Tracer::stop();
+        ofstream chromeTrace{chromeTracePath};
+        Tracer::writeJson(chromeTrace);
+    }
+
+    if (!doorwaysPath.empty())
+    {
+        ofstream doorways{doorwaysPath};
+        DoorwayFlow::writeCsvHeader(doorways);
+        DoorwayFlow::writeCsvRows(doorways, board.getDoorwayFlow().getRates());
+    }
+
+    if (cellHeatmap)
+    {
+        HeatmapExporter::writeFiles(heatmapPrefix, cellHeatmap->getGrid(), inOutBoundRectangles);
+    }
+
+    // The Boxes' threads are joined, so the report is complete.
+    if (!lockReportPath.empty())
+    {
+        ofstream lockReport{lockReportPath};
+        LockProfiler::writeReport(lockReport);
+    }
+    else if (LockProfiler::isCompiledIn())
+    {
+        LockProfiler::writeReport(cout);
+    }
+
+    // The MetricsHud's textures belong to the renderer.
+    printer.setHud(nullptr);
+    metricsHud.reset();
+
     // Destroy renderer
     SDL_DestroyRenderer(renderer);
 
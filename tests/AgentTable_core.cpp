@@ -0,0 +1,94 @@
+#include "catch.hpp"
+#include "../src/AgentTable.h"
+
+using namespace std;
+
+TEST_CASE("AgentTable_core::")
+{
+    SECTION("add() appends an entering row with no next Position.")
+    {
+        AgentTable table{};
+        REQUIRE(0 == table.size());
+
+        REQUIRE(0 == table.add(7, 0, Position{2, 3}, 1, 4));
+        REQUIRE(1 == table.add(9, 1, Position{5, 6}, 0, 2));
+
+        REQUIRE(2 == table.size());
+        REQUIRE(9 == table.getBoxIds()[1]);
+        REQUIRE(1 == table.getPlanIndexes()[1]);
+        REQUIRE(Position{2, 3} == table.getPosition(0));
+        REQUIRE(5 == table.getXs()[1]);
+        REQUIRE(6 == table.getYs()[1]);
+        REQUIRE(Position{-1, -1} == table.getNext(0));
+        REQUIRE(Position{-1, -1} == table.getHeading(0));
+        REQUIRE(1 == table.getTargetIds()[0]);
+        REQUIRE(4 == table.getPolicyIds()[0]);
+        REQUIRE(AgentState::entering == table.getStates()[0]);
+        REQUIRE(0 == table.getRestTicks()[0]);
+        REQUIRE(0 == table.getWaits()[0]);
+        REQUIRE(0 == table.getLevels()[0]);
+        REQUIRE(-1 == table.getActedTicks()[0]);
+    }
+
+    SECTION("The setters and the columns change the same rows.")
+    {
+        AgentTable table{};
+        table.add(7, 0, Position{2, 3}, 0, 0);
+        table.add(9, 1, Position{5, 6}, 0, 0);
+
+        table.setPosition(1, Position{4, 4});
+        table.setNext(1, Position{3, 3});
+        table.setHeading(1, Position{0, 8});
+        table.getStates()[1] = AgentState::onBoard;
+        table.getLevels()[1] = 2;
+
+        REQUIRE(4 == table.getXs()[1]);
+        REQUIRE(4 == table.getYs()[1]);
+        REQUIRE(3 == table.getNextXs()[1]);
+        REQUIRE(3 == table.getNextYs()[1]);
+        REQUIRE(Position{3, 3} == table.getNext(1));
+        REQUIRE(0 == table.getHeadingXs()[1]);
+        REQUIRE(8 == table.getHeadingYs()[1]);
+        REQUIRE(Position{-1, -1} == table.getHeading(0));
+        REQUIRE(AgentState::onBoard == table.getStates()[1]);
+        REQUIRE(2 == table.getLevels()[1]);
+        REQUIRE(Position{2, 3} == table.getPosition(0));
+        REQUIRE(AgentState::entering == table.getStates()[0]);
+    }
+
+    SECTION("compact() removes the exited rows and keeps the others in order.")
+    {
+        AgentTable table{};
+        for (int id=0; id<5; ++id)
+        {
+            table.add(id + 10, id, Position{id, id}, 0, 0);
+        }
+        table.getStates()[0] = AgentState::exited;
+        table.getStates()[2] = AgentState::exited;
+        table.getStates()[3] = AgentState::exiting;
+        table.getActedTicks()[4] = 12;
+
+        vector<int> newRows = table.compact();
+
+        REQUIRE(vector<int>{-1, 0, -1, 1, 2} == newRows);
+        REQUIRE(3 == table.size());
+        REQUIRE(11 == table.getBoxIds()[0]);
+        REQUIRE(13 == table.getBoxIds()[1]);
+        REQUIRE(14 == table.getBoxIds()[2]);
+        REQUIRE(3 == table.getPlanIndexes()[1]);
+        REQUIRE(Position{4, 4} == table.getPosition(2));
+        REQUIRE(AgentState::exiting == table.getStates()[1]);
+        REQUIRE(12 == table.getActedTicks()[2]);
+    }
+
+    SECTION("compact() with no exited rows changes nothing.")
+    {
+        AgentTable table{};
+        table.add(1, 0, Position{0, 0}, 0, 0);
+        table.add(2, 1, Position{1, 0}, 0, 0);
+
+        REQUIRE(vector<int>{0, 1} == table.compact());
+        REQUIRE(2 == table.size());
+        REQUIRE(2 == table.getBoxIds()[1]);
+    }
+}
@@ -0,0 +1,193 @@
+#include "catch.hpp"
+#include "../src/AsyncBoardListener.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+/*
+A BoardListener that saves every Frame it receives and the thread it received it on. While _gateOpen is false, receiveChanges() waits, which lets the tests hold the consumer thread inside the listener and fill the queue.
+*/
+class GatedListener : public BoardListener
+{
+    public:
+
+    void receiveChanges(const shared_ptr<const Frame>& frame) override
+    {
+        unique_lock<mutex> lock(_mux);
+        _entered = true;
+        _enteredCondition.notify_all();
+        _gateCondition.wait(lock, [this]{ return _gateOpen; });
+        _frames.push_back(frame);
+        _threadId = this_thread::get_id();
+    }
+
+    void waitUntilEntered()
+    {
+        unique_lock<mutex> lock(_mux);
+        _enteredCondition.wait(lock, [this]{ return _entered; });
+    }
+
+    void openGate()
+    {
+        lock_guard<mutex> lock(_mux);
+        _gateOpen = true;
+        _gateCondition.notify_all();
+    }
+
+    vector<shared_ptr<const Frame>> _frames{};
+    thread::id _threadId{};
+    bool _gateOpen = false;
+    bool _entered = false;
+
+    private:
+
+    mutex _mux;
+    condition_variable _gateCondition;
+    condition_variable _enteredCondition;
+};
+
+/*
+Opens @listener's gate when it goes out of scope. Declared after the AsyncBoardListener, so a failed REQUIRE does not leave the consumer thread waiting inside the listener while the AsyncBoardListener joins it.
+*/
+class GateOpener
+{
+    public:
+
+    GateOpener(GatedListener& listener): _listener{listener} {}
+    ~GateOpener() { _listener.openGate(); }
+
+    private:
+
+    GatedListener& _listener;
+};
+
+/*
+Returns a Frame with sequence number @sequence that changed the Position {@x, 0} to hold Box @boxId.
+*/
+shared_ptr<const Frame> frameWithDrop(long sequence, int x, int boxId)
+{
+    vector<Drop> drops{};
+    drops.push_back(Drop{x, 0, boxId, MoveType::to_arrive});
+    vector<BoxInfo> boxInfos{};
+    boxInfos.push_back(BoxInfo{boxId, 0, 1, 1, 0});
+    return make_shared<const Frame>(sequence, std::move(drops), std::move(boxInfos));
+}
+
+TEST_CASE("AsyncBoardListener_core::")
+{
+    SECTION("Frames are delivered in order on the consumer thread.")
+    {
+        GatedListener listener{};
+        listener.openGate();
+        AsyncBoardListener async{&listener, 4, BackpressurePolicy::block};
+
+        for (int ii=0; ii<10; ++ii)
+        {
+            async.receiveChanges(frameWithDrop(ii, ii, ii));
+        }
+        async.flush();
+
+        REQUIRE(10 == listener._frames.size());
+        for (int ii=0; ii<10; ++ii)
+        {
+            REQUIRE(ii == listener._frames[ii]->getSequence());
+        }
+        REQUIRE(listener._threadId != this_thread::get_id());
+
+        ListenerStats stats = async.getStats();
+        REQUIRE(10 == stats.getReceived());
+        REQUIRE(10 == stats.getDelivered());
+        REQUIRE(0 == stats.getDropped());
+        REQUIRE(0 == stats.getLag());
+        REQUIRE(0 == stats.getQueueLength());
+    }
+
+    SECTION("BackpressurePolicy::drop_oldest discards the oldest queued Frames when the queue is full.")
+    {
+        GatedListener listener{};
+        AsyncBoardListener async{&listener, 2, BackpressurePolicy::drop_oldest};
+        GateOpener gateOpener{listener};
+
+        // The consumer thread takes Frame 0 and waits inside the listener.
+        async.receiveChanges(frameWithDrop(0, 0, 0));
+        listener.waitUntilEntered();
+
+        // Frames 1 and 2 fill the queue. Frames 3 and 4 push out Frames 1 and 2.
+        for (int ii=1; ii<5; ++ii)
+        {
+            async.receiveChanges(frameWithDrop(ii, ii, ii));
+        }
+
+        ListenerStats stats = async.getStats();
+        REQUIRE(2 == stats.getDropped());
+        REQUIRE(2 == stats.getQueueLength());
+        REQUIRE(5 == stats.getLag());
+
+        listener.openGate();
+        async.flush();
+
+        REQUIRE(3 == listener._frames.size());
+        REQUIRE(0 == listener._frames[0]->getSequence());
+        REQUIRE(3 == listener._frames[1]->getSequence());
+        REQUIRE(4 == listener._frames[2]->getSequence());
+    }
+
+    SECTION("BackpressurePolicy::coalesce merges Frames into the newest queued Frame and no changes are lost.")
+    {
+        GatedListener listener{};
+        AsyncBoardListener async{&listener, 1, BackpressurePolicy::coalesce};
+        GateOpener gateOpener{listener};
+
+        async.receiveChanges(frameWithDrop(0, 0, 0));
+        listener.waitUntilEntered();
+
+        // Frame 1 fills the queue. Frames 2 and 3 are merged into it.
+        for (int ii=1; ii<4; ++ii)
+        {
+            async.receiveChanges(frameWithDrop(ii, ii, ii));
+        }
+
+        REQUIRE(2 == async.getStats().getCoalesced());
+
+        listener.openGate();
+        async.flush();
+
+        REQUIRE(2 == listener._frames.size());
+        const Frame& merged = *listener._frames[1];
+        REQUIRE(3 == merged.getSequence());
+        REQUIRE(3 == merged.getChangedDrops().size());
+        REQUIRE(1 == async.getStats().getMaxQueueLength());
+    }
+
+    SECTION("BackpressurePolicy::block makes the Board's thread wait until there is room in the queue.")
+    {
+        GatedListener listener{};
+        AsyncBoardListener async{&listener, 1, BackpressurePolicy::block};
+        GateOpener gateOpener{listener};
+
+        async.receiveChanges(frameWithDrop(0, 0, 0));
+        listener.waitUntilEntered();
+        async.receiveChanges(frameWithDrop(1, 1, 1));
+
+        // The queue is full, so this thread blocks until the gate is opened.
+        bool sent = false;
+        thread broadcaster([&]{
+            async.receiveChanges(frameWithDrop(2, 2, 2));
+            sent = true;
+        });
+
+        this_thread::sleep_for(20ms);
+        REQUIRE(1 == async.getStats().getQueueLength());
+
+        listener.openGate();
+        broadcaster.join();
+        async.flush();
+
+        REQUIRE(sent);
+        REQUIRE(3 == listener._frames.size());
+        REQUIRE(0 == async.getStats().getDropped());
+    }
+}
@@ -12,9 +12,9 @@ TEST_CASE("BoardProxy_core::")
         {
         public: 
 
-            void receiveChanges(unordered_set<Drop> setOfDropsPerType,
-                                unordered_map<int, BoxInfo> boxesPerId) override
+            void receiveChanges(const shared_ptr<const Frame>& frame) override
             {
+                (void)frame;
                 try
                 {
                     ++_count;
@@ -12,19 +12,17 @@ class TempListener : public BoardListener
 {
     public: 
 
-    void receiveChanges(
-        unordered_set<Drop> drops,
-        unordered_map<int, BoxInfo> boxes) override
+    void receiveChanges(const shared_ptr<const Frame>& frame) override
     {
         _dropsPerPosition.clear();
         _boxes.clear();
 
-        for(const auto& p: boxes)
+        for(const BoxInfo& boxInfo: frame->getBoxInfos())
         {
-            _boxes.insert({p.second.getId(), p.second});
+            _boxes.insert({boxInfo.getId(), boxInfo});
         }
 
-        for(auto& drop : drops)
+        for(auto& drop : frame->getChangedDrops())
         {
             _dropsPerPosition.insert({drop.getPosition(), drop});
         }
@@ -114,6 +112,21 @@ TEST_CASE("Board_core::")
         REQUIRE(boxId_2 == drop2.getBoxId());
     }
 
+    SECTION("changeOwnedSpot() follows the same rules as changeSpot(), and its changes are sent to the BoardListener.")
+    {
+        REQUIRE(board.changeOwnedSpot(posA, BoardNote{boxId_0, MoveType::to_arrive}, true));
+        REQUIRE_FALSE(board.changeOwnedSpot(posA, BoardNote{boxId_1, MoveType::to_arrive}, false));
+        REQUIRE(board.changeOwnedSpot(posA, BoardNote{boxId_0, MoveType::arrive}, true));
+        REQUIRE_THROWS_AS(board.changeOwnedSpot(posA, BoardNote{boxId_0, MoveType::left}, true), invalid_argument);
+        REQUIRE(board.getNoteAt(posA) == BoardNote{boxId_0, MoveType::arrive});
+        REQUIRE(board.getOwnedNoteAt(posA) == BoardNote{boxId_0, MoveType::arrive});
+        REQUIRE(board.getOwnedNoteAt(Position{0, 0}) == BoardNote{-1, MoveType::left});
+
+        board.sendStateAndChanges();
+        REQUIRE(listener._dropsPerPosition.size() == 1);
+        REQUIRE(MoveType::arrive == listener._dropsPerPosition.at(posA).getMoveType());
+    }
+
     SECTION("When changeSpots() is unsuccessful verify 1) changeSpots() returns false and 2) both Boxes' levels go up because upLevel argument is true. ")
     {
         // Add Box0 to posA.
@@ -164,6 +177,25 @@ TEST_CASE("Board_core::")
         REQUIRE(0 == listener._boxes.at(1).getLevel());
     }
 
+    SECTION("recordOwnedCollision() counts a collision and raises both Boxes' levels without changing the Spot.")
+    {
+        // posA is empty, as it is when a Box loses its claim on it before the winner moves in.
+        board.recordOwnedCollision(posA, BoardNote{boxId_1, MoveType::to_arrive}, boxId_0);
+
+        REQUIRE(board.getNoteAt(posA) == BoardNote{-1, MoveType::left});
+        REQUIRE(1 == board.getMetrics().getSnapshot().get(SimulationCounter::collisions));
+        REQUIRE(1 == board.getMetrics().getSnapshot().get(SimulationCounter::changeSpotFailed));
+
+        board.sendStateAndChanges();
+        REQUIRE(listener._dropsPerPosition.empty());
+        REQUIRE(1 == listener._boxes.at(0).getLevel());
+        REQUIRE(1 == listener._boxes.at(1).getLevel());
+        REQUIRE(0 == listener._boxes.at(2).getLevel());
+
+        REQUIRE_THROWS_AS(board.recordOwnedCollision(posA, BoardNote{boxId_1, MoveType::to_arrive}, 100), invalid_argument);
+        REQUIRE_THROWS_AS(board.recordOwnedCollision(Position{20, 5}, BoardNote{boxId_1, MoveType::to_arrive}, boxId_0), invalid_argument);
+    }
+
     SECTION("Verifty adding a BoardNote with an unknown BoxId results in an exception.")
     {
         // Board does not have a Box id of 100.
@@ -210,4 +242,139 @@ TEST_CASE("Board_core::")
         REQUIRE(BoardNote{0, MoveType::arrive}  == callbackNotes[1].second);
     }
 
+    SECTION("Verify every NoteSubscriber at a Position is notified, and an unregistered NoteSubscriber is not.")
+    {
+        NoteAccountant subscriberA{};
+        NoteAccountant subscriberB{};
+        board.registerNoteSubscriber(posA, subscriberA);
+        board.registerNoteSubscriber(posA, subscriberB);
+        // Registering twice has no effect.
+        board.registerNoteSubscriber(posA, subscriberA);
+
+        board.changeSpot(posA, BoardNote{boxId_0, MoveType::to_arrive}, true);
+        REQUIRE(1 == subscriberA.getNotes().size());
+        REQUIRE(1 == subscriberB.getNotes().size());
+
+        board.unregisterNoteSubscriber(posA, subscriberA);
+        board.changeSpot(posA, BoardNote{boxId_0, MoveType::arrive}, true);
+        REQUIRE(1 == subscriberA.getNotes().size());
+        REQUIRE(2 == subscriberB.getNotes().size());
+        REQUIRE(BoardNote{0, MoveType::arrive} == subscriberB.getNotes()[1].second);
+
+        // Once the last NoteSubscriber is gone, the Position is not subscribed to at all.
+        board.unregisterNoteSubscriber(posA, subscriberB);
+        board.unregisterNoteSubscriber(posA, subscriberB);
+        board.changeSpot(posA, BoardNote{boxId_0, MoveType::to_leave}, true);
+        board.changeSpot(posA, BoardNote{boxId_0, MoveType::left}, true);
+        REQUIRE(2 == subscriberB.getNotes().size());
+
+        // Unsuccessful changes are not sent.
+        board.registerNoteSubscriber(posB, subscriberA);
+        board.changeSpot(posB, BoardNote{boxId_1, MoveType::to_arrive}, true);
+        board.changeSpot(posB, BoardNote{boxId_2, MoveType::to_arrive}, false);
+        REQUIRE(2 == subscriberA.getNotes().size());
+    }
+
+    SECTION("Verify a NoteSubscriber can subscribe to every Position on the Board, and Positions off the Board are rejected.")
+    {
+        NoteAccountant subscriber{};
+        for (int y=0; y<20; ++y)
+        {
+            for (int x=0; x<20; ++x)
+            {
+                board.registerNoteSubscriber(Position{x, y}, subscriber);
+            }
+        }
+        board.changeSpot(Position{0, 0}, BoardNote{boxId_0, MoveType::to_arrive}, true);
+        board.changeSpot(Position{19, 19}, BoardNote{boxId_1, MoveType::to_arrive}, true);
+        board.changeSpot(Position{13, 6}, BoardNote{boxId_2, MoveType::to_arrive}, true);
+        REQUIRE(3 == subscriber.getNotes().size());
+
+        REQUIRE_THROWS_AS(board.registerNoteSubscriber(Position{20, 0}, subscriber), invalid_argument);
+        REQUIRE_THROWS_AS(board.registerNoteSubscriber(Position{0, -1}, subscriber), invalid_argument);
+    }
+
+    SECTION("Every BoardListener receives the same Frame, and Frames are numbered in the order they are sent.")
+    {
+        class FrameListener : public BoardListener
+        {
+        public:
+            void receiveChanges(const shared_ptr<const Frame>& frame) override
+            {
+                _frames.push_back(frame);
+            }
+
+            vector<shared_ptr<const Frame>> _frames{};
+        };
+
+        FrameListener listenerA{};
+        FrameListener listenerB{};
+        board.registerListener(&listenerA);
+        board.registerListener(&listenerB);
+
+        board.changeSpot(posA, BoardNote{boxId_0, MoveType::to_arrive}, true);
+        board.sendStateAndChanges();
+        board.sendStateAndChanges();
+
+        REQUIRE(2 == listenerA._frames.size());
+        REQUIRE(2 == listenerB._frames.size());
+        REQUIRE(listenerA._frames[0].get() == listenerB._frames[0].get());
+        REQUIRE(listenerA._frames[1]->getSequence() == listenerA._frames[0]->getSequence() + 1);
+
+        // The first Frame still holds its change after the second Frame was sent.
+        REQUIRE(1 == listenerA._frames[0]->getChangedDrops().size());
+        REQUIRE(listenerA._frames[1]->getChangedDrops().empty());
+        REQUIRE(3 == listenerA._frames[1]->getBoxInfos().size());
+    }
+
+    SECTION("The GridLayout only changes how the Spots are stored: every layout sends the same Drops in the same order.")
+    {
+        class FrameListener : public BoardListener
+        {
+        public:
+            void receiveChanges(const shared_ptr<const Frame>& frame) override
+            {
+                _frames.push_back(frame);
+            }
+
+            vector<shared_ptr<const Frame>> _frames{};
+        };
+
+        // 13 x 11 does not fill whole tiles. The Boxes enter cells in a scattered order, and the Drops come back a row at a time.
+        vector<Position> cells{Position{12, 0}, Position{0, 10}, Position{7, 8}, Position{8, 7}, Position{0, 0}, Position{12, 10}, Position{3, 9}};
+        vector<vector<Drop>> dropsPerLayout{};
+        for (GridLayout layout : {GridLayout::rowMajor, GridLayout::tiled, GridLayout::morton})
+        {
+            vector<Box> layoutBoxes{};
+            for (int id=0; id<static_cast<int>(cells.size()); ++id)
+            {
+                layoutBoxes.push_back(Box{id, id % 4, 1, 1});
+            }
+            Board layoutBoard{13, 11, std::move(layoutBoxes), layout};
+            REQUIRE(layout == layoutBoard.getLayout());
+            FrameListener frames{};
+            layoutBoard.registerListener(&frames);
+
+            for (int id=0; id<static_cast<int>(cells.size()); ++id)
+            {
+                REQUIRE(layoutBoard.changeSpot(cells[id], BoardNote{id, MoveType::to_arrive}, true));
+            }
+            REQUIRE_FALSE(layoutBoard.changeSpot(Position{7, 8}, BoardNote{0, MoveType::to_arrive}, true));
+            for (int id=0; id<static_cast<int>(cells.size()); ++id)
+            {
+                REQUIRE(layoutBoard.getNoteAt(cells[id]) == BoardNote{id, MoveType::to_arrive});
+            }
+            REQUIRE(layoutBoard.getNoteAt(Position{8, 8}) == BoardNote{-1, MoveType::left});
+            layoutBoard.sendStateAndChanges();
+
+            dropsPerLayout.push_back(frames._frames[0]->getChangedDrops());
+        }
+
+        REQUIRE(cells.size() == dropsPerLayout[0].size());
+        REQUIRE(Position{0, 0} == dropsPerLayout[0][0].getPosition());
+        REQUIRE(Position{12, 10} == dropsPerLayout[0].back().getPosition());
+        REQUIRE(dropsPerLayout[0] == dropsPerLayout[1]);
+        REQUIRE(dropsPerLayout[0] == dropsPerLayout[2]);
+    }
+
 }
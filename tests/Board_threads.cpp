@@ -1,5 +1,7 @@
 #include "catch.hpp"
 #include "../src/Board.h"
+#include "../src/NoteAccountant.h"
+#include <atomic>
 #include <thread>
 #include <mutex>
 
@@ -65,10 +67,9 @@ TEST_CASE("Board_threads::")
         public: 
             bool levelsEqual = true;
 
-            void receiveChanges(unordered_set<Drop> setsOfDropsPerType,
-                                unordered_map<int, BoxInfo> boxesPerId) override
+            void receiveChanges(const shared_ptr<const Frame>& frame) override
             {
-                if (boxesPerId.at(0).getLevel() != boxesPerId.at(1).getLevel())
+                if (frame->getBoxInfo(0).getLevel() != frame->getBoxInfo(1).getLevel())
                 {
                     levelsEqual = false;
                 }
@@ -119,10 +120,10 @@ TEST_CASE("Board_threads::")
             mutex _mutex;
             bool changeIsComplete = true;
 
-            void receiveChanges(unordered_set<Drop> drops, std::unordered_map<int, BoxInfo> boxes) override
+            void receiveChanges(const shared_ptr<const Frame>& frame) override
             {
                 lock_guard<mutex> gl(_mutex);                
-                for (auto& drop : drops)
+                for (auto& drop : frame->getChangedDrops())
                 {
                     if (drop.getMoveType() == MoveType::left &&
                         drop.getBoxId() != -1)
@@ -160,4 +161,42 @@ TEST_CASE("Board_threads::")
         REQUIRE(listener.changeIsComplete);
 
     }
+
+    /*
+    NoteSubscribers are registered and unregistered on one thread while another thread keeps moving a Box in and out of the subscribed Position. Once unregisterNoteSubscriber() returns the NoteSubscriber receives nothing more, so its count can be read without a race.
+    */
+    SECTION("NoteSubscribers can be registered and unregistered while Boxes move.")
+    {
+        vector<Box> boxes{Box{0, 0, 1, 1}};
+        Board board{20, 20, std::move(boxes)};
+        Position posA{3, 4};
+
+        atomic<bool> done{false};
+        std::thread mover([&board, &done, posA]{
+            while (!done)
+            {
+                board.changeSpot(posA, BoardNote{0, MoveType::to_arrive}, false);
+                board.changeSpot(posA, BoardNote{0, MoveType::arrive}, false);
+                board.changeSpot(posA, BoardNote{0, MoveType::to_leave}, false);
+                board.changeSpot(posA, BoardNote{0, MoveType::left}, false);
+            }
+        });
+
+        long total = 0;
+        for (int ii=0; ii<200; ++ii)
+        {
+            NoteAccountant subscriber{};
+            board.registerNoteSubscriber(posA, subscriber);
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            board.unregisterNoteSubscriber(posA, subscriber);
+            size_t count = subscriber.getNotes().size();
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            REQUIRE(count == subscriber.getNotes().size());
+            total += static_cast<long>(count);
+        }
+        done = true;
+        mover.join();
+
+        REQUIRE(total > 0);
+    }
 }
@@ -0,0 +1,104 @@
+#include "catch.hpp"
+#include "../src/Board.h"
+#include "../src/CellHeatmap.h"
+
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    SpotTransition makeTransition(int64_t timestamp, int boxId, int x, int y, MoveType type, bool collision)
+    {
+        SpotTransition transition{};
+        transition.timestamp = timestamp;
+        transition.boxId = boxId;
+        transition.otherBoxId = -1;
+        transition.x = static_cast<uint16_t>(x);
+        transition.y = static_cast<uint16_t>(y);
+        transition.type = static_cast<uint8_t>(type);
+        transition.collision = collision ? 1 : 0;
+        transition.upLevel = 1;
+        return transition;
+    }
+}
+
+TEST_CASE("CellHeatmap_core::")
+{
+    SECTION("Throws if the width, height, or shardCount is not positive")
+    {
+        REQUIRE_THROWS_AS((CellHeatmap{0, 10}), invalid_argument);
+        REQUIRE_THROWS_AS((CellHeatmap{10, -1}), invalid_argument);
+        REQUIRE_THROWS_AS((CellHeatmap{10, 10, 0}), invalid_argument);
+    }
+
+    SECTION("Counts traversals, collisions, and dwell time per cell")
+    {
+        CellHeatmap heatmap{5, 4};
+        heatmap.receiveTransition(makeTransition(100, 0, 2, 3, MoveType::to_arrive, false));
+        heatmap.receiveTransition(makeTransition(200, 0, 2, 3, MoveType::arrive, false));
+        heatmap.receiveTransition(makeTransition(300, 1, 2, 3, MoveType::to_arrive, true));
+        heatmap.receiveTransition(makeTransition(400, 1, 2, 3, MoveType::to_arrive, true));
+        heatmap.receiveTransition(makeTransition(500, 0, 2, 3, MoveType::to_leave, false));
+        heatmap.receiveTransition(makeTransition(2000000200, 0, 2, 3, MoveType::left, false));
+
+        // A Box that leaves without having arrived adds no dwell time.
+        heatmap.receiveTransition(makeTransition(600, 2, 0, 0, MoveType::to_arrive, false));
+        heatmap.receiveTransition(makeTransition(700, 2, 0, 0, MoveType::left, false));
+
+        CellHeatmap::Grid grid = heatmap.getGrid();
+        REQUIRE(grid.width == 5);
+        REQUIRE(grid.height == 4);
+        REQUIRE(grid.get(HeatmapLayer::traversals, 2, 3) == 1.0);
+        REQUIRE(grid.get(HeatmapLayer::collisions, 2, 3) == 2.0);
+        REQUIRE(grid.get(HeatmapLayer::dwellSeconds, 2, 3) == Approx(2.0));
+        REQUIRE(grid.get(HeatmapLayer::traversals, 0, 0) == 0.0);
+        REQUIRE(grid.get(HeatmapLayer::dwellSeconds, 0, 0) == 0.0);
+        REQUIRE(grid.get(HeatmapLayer::traversals, 3, 2) == 0.0);
+    }
+
+    SECTION("Adds up the counts of many threads")
+    {
+        CellHeatmap heatmap{3, 3, 2};
+        vector<thread> threads{};
+        for (int ii=0; ii<4; ++ii)
+        {
+            threads.emplace_back([&heatmap](){
+                for (int jj=0; jj<1000; ++jj)
+                {
+                    heatmap.receiveTransition(makeTransition(jj, 0, 1, 1, MoveType::arrive, false));
+                    heatmap.receiveTransition(makeTransition(jj, 1, 1, 2, MoveType::to_arrive, true));
+                }
+            });
+        }
+        for (thread& t : threads)
+        {
+            t.join();
+        }
+
+        CellHeatmap::Grid grid = heatmap.getGrid();
+        REQUIRE(grid.get(HeatmapLayer::traversals, 1, 1) == 4000.0);
+        REQUIRE(grid.get(HeatmapLayer::collisions, 1, 2) == 4000.0);
+    }
+
+    SECTION("Counts the Board's changeSpot() calls")
+    {
+        vector<Box> boxes{};
+        boxes.push_back(Box{0, 0, 1, 1});
+        boxes.push_back(Box{1, 0, 1, 1});
+        Board board{10, 10, std::move(boxes)};
+        CellHeatmap heatmap{10, 10};
+        board.registerTransitionListener(&heatmap);
+
+        board.changeSpot(Position{3, 4}, BoardNote{0, MoveType::to_arrive}, true);
+        board.changeSpot(Position{3, 4}, BoardNote{0, MoveType::arrive}, true);
+        board.changeSpot(Position{3, 4}, BoardNote{1, MoveType::to_arrive}, true);
+        board.changeSpot(Position{3, 4}, BoardNote{0, MoveType::to_leave}, true);
+        board.changeSpot(Position{3, 4}, BoardNote{0, MoveType::left}, true);
+
+        CellHeatmap::Grid grid = heatmap.getGrid();
+        REQUIRE(grid.get(HeatmapLayer::traversals, 3, 4) == 1.0);
+        REQUIRE(grid.get(HeatmapLayer::collisions, 3, 4) == 1.0);
+        REQUIRE(grid.get(HeatmapLayer::dwellSeconds, 3, 4) >= 0.0);
+    }
+}
@@ -0,0 +1,284 @@
+#include "catch.hpp"
+#include "../src/Board.h"
+#include "../src/CompressedTraceReader.h"
+#include "../src/CompressedTraceWriter.h"
+#include "../src/TraceFormat.h"
+#include "../src/TraceReader.h"
+#include "../src/TraceRecorder.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <queue>
+#include <random>
+
+using namespace std;
+
+/*
+Makes SpotTransitions the way Movers do: @numOfBoxes Boxes each enter a 600 x 600 Board and then take @movesPerBox steps. Each step is to_arrive and to_leave, then 10 to 14 ms later arrive and left, then a 10 ms rest. A Box usually keeps its direction. About one step in fifty first runs into another Box. Records are in timestamp order.
+*/
+vector<SpotTransition> makeMoverLikeTransitions(int numOfBoxes, int movesPerBox)
+{
+    struct Walker
+    {
+        int x;
+        int y;
+        int dirX;
+        int dirY;
+        int movesLeft;
+        int phase;
+    };
+
+    mt19937 gen(7);
+    uniform_int_distribution<int> coordinate(1, 598);
+    uniform_int_distribution<int> direction(-1, 1);
+    uniform_int_distribution<int> percent(0, 99);
+    uniform_int_distribution<int> jitter(0, 2'000'000);
+    uniform_int_distribution<int> otherBox(0, numOfBoxes - 1);
+
+    vector<Walker> walkers{};
+    using Event = pair<int64_t, int>;
+    priority_queue<Event, vector<Event>, greater<Event>> events{};
+    for (int id=0; id<numOfBoxes; ++id)
+    {
+        walkers.push_back(Walker{coordinate(gen), coordinate(gen), 1, 0, movesPerBox, -1});
+        events.push({static_cast<int64_t>(id) * 50'000, id});
+    }
+
+    vector<SpotTransition> records{};
+    auto add = [&records](int64_t t, int id, int other, int x, int y, MoveType type, bool collision, bool upLevel)
+    {
+        SpotTransition record{};
+        record.timestamp = t;
+        record.boxId = id;
+        record.otherBoxId = other;
+        record.x = static_cast<uint16_t>(x);
+        record.y = static_cast<uint16_t>(y);
+        record.type = static_cast<uint8_t>(type);
+        record.collision = collision ? 1 : 0;
+        record.upLevel = upLevel ? 1 : 0;
+        records.push_back(record);
+    };
+
+    while (!events.empty())
+    {
+        auto [t, id] = events.top();
+        events.pop();
+        Walker& w = walkers[id];
+
+        if (w.phase == -1)
+        {
+            add(t, id, -1, w.x, w.y, MoveType::to_arrive, false, false);
+            add(t + 5'000'000, id, id, w.x, w.y, MoveType::arrive, false, true);
+            w.phase = 0;
+            events.push({t + 15'000'000 + jitter(gen), id});
+        }
+        else if (w.phase == 0)
+        {
+            if (w.movesLeft == 0)
+            {
+                add(t, id, id, w.x, w.y, MoveType::to_leave, false, true);
+                add(t + 150, id, id, w.x, w.y, MoveType::left, false, true);
+                continue;
+            }
+            if (percent(gen) < 20)
+            {
+                w.dirX = direction(gen);
+                w.dirY = direction(gen);
+                if (w.dirX == 0 && w.dirY == 0)
+                {
+                    w.dirX = 1;
+                }
+            }
+            int newX = std::clamp(w.x + w.dirX, 0, 599);
+            int newY = std::clamp(w.y + w.dirY, 0, 599);
+            if (percent(gen) < 2)
+            {
+                add(t, id, otherBox(gen), newX, newY, MoveType::to_arrive, true, true);
+                events.push({t + 10'000'000 + jitter(gen), id});
+                continue;
+            }
+            add(t, id, -1, newX, newY, MoveType::to_arrive, false, true);
+            add(t + 200, id, id, w.x, w.y, MoveType::to_leave, false, true);
+            w.phase = 1;
+            events.push({t + 10'000'000 + jitter(gen), id});
+            w.dirX = newX - w.x;
+            w.dirY = newY - w.y;
+        }
+        else
+        {
+            add(t, id, id, w.x + w.dirX, w.y + w.dirY, MoveType::arrive, false, true);
+            add(t + 150, id, id, w.x, w.y, MoveType::left, false, true);
+            w.x += w.dirX;
+            w.y += w.dirY;
+            --w.movesLeft;
+            w.phase = 0;
+            events.push({t + 10'000'000 + jitter(gen), id});
+        }
+    }
+
+    stable_sort(
+        records.begin(),
+        records.end(),
+        [](const SpotTransition& a, const SpotTransition& b){ return a.timestamp < b.timestamp; });
+    return records;
+}
+
+bool sameRecords(const vector<SpotTransition>& a, const vector<SpotTransition>& b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(SpotTransition)) == 0;
+}
+
+vector<BoxInfo> makeBoxInfos(int numOfBoxes)
+{
+    vector<BoxInfo> infos{};
+    for (int id=0; id<numOfBoxes; ++id)
+    {
+        infos.push_back(BoxInfo{id, id % 4, 1, 1, 0});
+    }
+    return infos;
+}
+
+TEST_CASE("CompressedTraceWriter_core::")
+{
+    string tracePath = (filesystem::temp_directory_path() / "CompressedTraceWriter_core.trace").string();
+    string compressedPath = tracePath + ".compressed";
+
+    SECTION("A trace recorded from a Board round-trips through compress()")
+    {
+        vector<Box> boxes{};
+        boxes.push_back(Box{0, 0, 1, 1});
+        boxes.push_back(Box{3, 2, 1, 1});
+        vector<BoxInfo> infos{boxes[0].getInfo(), boxes[1].getInfo()};
+        Board board{8, 8, std::move(boxes)};
+        {
+            TraceRecorder recorder{tracePath, 8, 8, infos};
+            board.registerTransitionListener(&recorder);
+            board.changeSpot(Position{0, 0}, BoardNote{0, MoveType::to_arrive}, false);
+            board.changeSpot(Position{0, 0}, BoardNote{0, MoveType::arrive}, true);
+            board.changeSpot(Position{1, 0}, BoardNote{3, MoveType::to_arrive}, false);
+            board.changeSpot(Position{1, 0}, BoardNote{3, MoveType::arrive}, true);
+            board.changeSpot(Position{1, 0}, BoardNote{0, MoveType::to_arrive}, true);
+            board.changeSpot(Position{1, 1}, BoardNote{0, MoveType::to_arrive}, true);
+            board.changeSpot(Position{0, 0}, BoardNote{0, MoveType::to_leave}, true);
+            board.changeSpot(Position{1, 1}, BoardNote{0, MoveType::arrive}, true);
+            board.changeSpot(Position{0, 0}, BoardNote{0, MoveType::left}, true);
+        }
+
+        CompressedTraceWriter::compress(tracePath, compressedPath, 4);
+
+        vector<SpotTransition> original{};
+        TraceReader reader{tracePath};
+        reader.readRecords(0, 100, original);
+
+        CompressedTraceReader compressed{compressedPath};
+        REQUIRE(8 == compressed.getWidth());
+        REQUIRE(2 == compressed.getBoxInfos().size());
+        REQUIRE(3 == compressed.getBoxInfos()[1].getId());
+        REQUIRE(9 == compressed.getRecordCount());
+        REQUIRE(3 == compressed.getBlockCount());
+
+        vector<SpotTransition> decoded{};
+        REQUIRE(9 == compressed.readRange(0, INT64_MAX, decoded));
+        REQUIRE(sameRecords(original, decoded));
+        REQUIRE(decoded[4].isCollision());
+        REQUIRE(3 == decoded[4].otherBoxId);
+    }
+
+    SECTION("Benchmark: 1400 Mover-like Boxes round-trip, with size and decode speed")
+    {
+        int numOfBoxes = 1400;
+        vector<SpotTransition> records = makeMoverLikeTransitions(numOfBoxes, 150);
+
+        TraceBlockCodec codec{numOfBoxes};
+        int blockSize = 65536;
+        vector<vector<uint8_t>> blocks{};
+        size_t compressedBytes = 0;
+        for (size_t first=0; first<records.size(); first+=blockSize)
+        {
+            int count = static_cast<int>(std::min(records.size() - first, static_cast<size_t>(blockSize)));
+            blocks.push_back({});
+            codec.encode(records.data() + first, count, blocks.back());
+            compressedBytes += blocks.back().size();
+        }
+
+        vector<SpotTransition> decoded{};
+        decoded.reserve(records.size());
+        int rounds = 3;
+        auto start = chrono::steady_clock::now();
+        for (int round=0; round<rounds; ++round)
+        {
+            decoded.clear();
+            for (const vector<uint8_t>& block : blocks)
+            {
+                codec.decode(block.data(), block.size(), decoded);
+            }
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        REQUIRE(sameRecords(records, decoded));
+
+        double ratio = static_cast<double>(records.size() * sizeof(SpotTransition)) / static_cast<double>(compressedBytes);
+        double eventsPerSecond = static_cast<double>(records.size()) * rounds / seconds;
+        WARN("TraceBlockCodec: " << records.size() << " records, "
+            << static_cast<double>(compressedBytes) / static_cast<double>(records.size()) << " bytes per record, "
+            << ratio << "x smaller than fixed-width records, decoded at "
+            << eventsPerSecond / 1e6 << "M records/s");
+
+        REQUIRE(ratio > 5.0);
+    }
+
+    SECTION("Reading a time range only decodes the blocks that overlap it")
+    {
+        vector<SpotTransition> records = makeMoverLikeTransitions(50, 20);
+        {
+            CompressedTraceWriter writer{compressedPath, 600, 600, makeBoxInfos(50), 200};
+            for (const SpotTransition& record : records)
+            {
+                writer.append(record);
+            }
+        }
+
+        CompressedTraceReader reader{compressedPath};
+        REQUIRE(static_cast<long>(records.size()) == reader.getRecordCount());
+
+        int64_t from = records[records.size() / 2].timestamp;
+        int64_t to = from + 20'000'000;
+        vector<SpotTransition> expected{};
+        for (const SpotTransition& record : records)
+        {
+            if (record.timestamp >= from && record.timestamp <= to)
+            {
+                expected.push_back(record);
+            }
+        }
+
+        vector<SpotTransition> decoded{};
+        reader.readRange(from, to, decoded);
+        REQUIRE(sameRecords(expected, decoded));
+        REQUIRE(reader.getBlocksDecoded() <= 3);
+        REQUIRE(reader.getBlockCount() > 10);
+    }
+
+    SECTION("A block with a varint longer than 10 bytes is refused")
+    {
+        // A record count whose continuation bits never end.
+        vector<uint8_t> block(12, 0xff);
+        block.push_back(0x01);
+        TraceBlockCodec codec{4};
+        vector<SpotTransition> decoded{};
+        REQUIRE_THROWS_AS(codec.decode(block.data(), block.size(), decoded), invalid_argument);
+    }
+
+    SECTION("A file that was not closed is refused")
+    {
+        {
+            ofstream file{compressedPath, ios::binary | ios::trunc};
+            file.write(compressedTraceMagic, sizeof(compressedTraceMagic));
+        }
+        REQUIRE_THROWS_AS(CompressedTraceReader{compressedPath}, invalid_argument);
+    }
+
+    filesystem::remove(compressedPath);
+    filesystem::remove(tracePath);
+}
@@ -26,6 +26,16 @@ TEST_CASE("Decider_Safe_core::")
             REQUIRE_FALSE(decider.suggestMoveTo(positionA, board));
         }
 
+        SECTION("An owned BoardView, read without the Board's locks, gives the same decisions.")
+        {
+            BoardView owned = BoardView::owned(board);
+            vector<Position> possiblePositions = {positionA, Position{5, 4}};
+
+            REQUIRE_FALSE(decider.suggestMoveTo(positionA, owned));
+            REQUIRE(decider.suggestMoveTo(Position{5, 4}, owned));
+            REQUIRE(decider.getNext(possiblePositions, owned) == decider.getNext(possiblePositions, board));
+        }
+
         SECTION("Verify getNext(possiblePositions) returns the first possiblePosition whose MoveType is MoveType::left and returns a time-to-arrival of 0.")
         {
             // The first possiblePosition is positionA, which has a MoveType of MoveType::to_arrive. It is not returned.
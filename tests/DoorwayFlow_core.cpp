@@ -0,0 +1,106 @@
+#include "catch.hpp"
+#include "../src/Board.h"
+#include "../src/DoorwayFlow.h"
+#include "../src/Mover_Reg.h"
+
+#include <sstream>
+
+using namespace std;
+
+TEST_CASE("DoorwayFlow_core::")
+{
+    vector<Rectangle> doorways{
+        Rectangle{Position{0, 0}, Position{9, 9}},
+        Rectangle{Position{20, 0}, Position{29, 9}}};
+
+    SECTION("Throws if the window is not positive")
+    {
+        REQUIRE_THROWS_AS(DoorwayFlow{chrono::milliseconds{0}}, invalid_argument);
+    }
+
+    SECTION("A Position belongs to the first doorway it is inside of")
+    {
+        DoorwayFlow flow{};
+        REQUIRE(flow.getDoorway(Position{5, 5}) == -1);
+
+        flow.setDoorways(doorways);
+        REQUIRE(flow.getDoorway(Position{5, 5}) == 0);
+        REQUIRE(flow.getDoorway(Position{29, 9}) == 1);
+        REQUIRE(flow.getDoorway(Position{15, 5}) == -1);
+    }
+
+    SECTION("Counts entries and exits per doorway, with rates over the window")
+    {
+        DoorwayFlow flow{chrono::seconds{2}};
+        flow.setDoorways(doorways);
+        DoorwayFlow::Clock::time_point start = DoorwayFlow::Clock::now();
+
+        flow.recordEntry(Position{1, 1}, start);
+        flow.recordEntry(Position{2, 2}, start + 500ms);
+        flow.recordEntry(Position{3, 3}, start + 3s);
+        flow.recordExit(Position{25, 5}, start + 3s);
+        flow.recordExit(Position{25, 5}, start + 3500ms);
+        // Outside of every doorway.
+        flow.recordEntry(Position{15, 5}, start + 3s);
+
+        vector<DoorwayFlow::Rates> rates = flow.getRates(start + 4s);
+        REQUIRE(rates.size() == 2);
+        REQUIRE(rates[0].rectangle == doorways[0]);
+        REQUIRE(rates[0].entries == 3);
+        REQUIRE(rates[0].exits == 0);
+        // Only the entry at 3 s is in the last 2 s.
+        REQUIRE(rates[0].entriesPerSecond == Approx(0.5));
+        REQUIRE(rates[1].entries == 0);
+        REQUIRE(rates[1].exits == 2);
+        REQUIRE(rates[1].exitsPerSecond == Approx(1.0));
+    }
+
+    SECTION("Keeps the current and longest queue of Boxes waiting to enter")
+    {
+        DoorwayFlow flow{};
+        flow.setDoorways(doorways);
+        flow.startWaiting(Position{1, 1});
+        flow.startWaiting(Position{2, 2});
+        flow.startWaiting(Position{3, 3});
+        flow.stopWaiting(Position{1, 1});
+        flow.startWaiting(Position{21, 1});
+        flow.stopWaiting(Position{15, 5});
+
+        vector<DoorwayFlow::Rates> rates = flow.getRates();
+        REQUIRE(rates[0].waiting == 2);
+        REQUIRE(rates[0].maxWaiting == 3);
+        REQUIRE(rates[1].waiting == 1);
+        REQUIRE(rates[1].maxWaiting == 1);
+
+        vector<string> lines = DoorwayFlow::getSummaryLines(rates);
+        REQUIRE(lines.size() == 2);
+        REQUIRE(lines[0] == "door 0 in/s 0.0, out/s 0.0, waiting 2 (max 3)");
+    }
+
+    SECTION("Mover's addBox() and removeBox() count entries and exits")
+    {
+        vector<Box> boxes{};
+        boxes.push_back(Box{0, 0, 1, 1});
+        Board board{30, 30, std::move(boxes)};
+        board.getDoorwayFlow().setDoorways(doorways);
+
+        Mover_Reg mover{0, &board};
+        REQUIRE(mover.addBox(Position{4, 4}));
+        REQUIRE(mover.moveBox(Position{4, 4}, Position{5, 5}));
+        REQUIRE(mover.removeBox(Position{5, 5}));
+
+        vector<DoorwayFlow::Rates> rates = board.getDoorwayFlow().getRates();
+        REQUIRE(rates[0].entries == 1);
+        REQUIRE(rates[0].exits == 1);
+        REQUIRE(rates[1].entries == 0);
+
+        stringstream csv{};
+        DoorwayFlow::writeCsvHeader(csv);
+        DoorwayFlow::writeCsvRows(csv, rates);
+        string line{};
+        getline(csv, line);
+        REQUIRE(line.rfind("doorway,", 0) == 0);
+        getline(csv, line);
+        REQUIRE(line.rfind("0,0,0,9,9,1,1,", 0) == 0);
+    }
+}
@@ -0,0 +1,135 @@
+#include "catch.hpp"
+#include "../src/EvacuationBenchmark.h"
+
+#include <sstream>
+
+using namespace std;
+
+TEST_CASE("EvacuationBenchmark_core::")
+{
+    SECTION("A small run clears the Board and reports its metrics")
+    {
+        EvacuationBenchmark::Scenario scenario{};
+        scenario.width = 150;
+        scenario.height = 130;
+        scenario.boxesPerBatch = 2;
+
+        EvacuationBenchmark::Result result = EvacuationBenchmark::run(scenario, 7);
+        REQUIRE(result.seed == 7);
+        REQUIRE(result.boxCount == 14);
+        REQUIRE(result.exitedCount == 14);
+        // clearance, mean and p90 per batch, and throughput per exit.
+        REQUIRE(result.metrics.size() == 1 + 7 * 2 + 7);
+        REQUIRE(result.metrics[0].name == "clearance_ms");
+        REQUIRE(result.metrics[0].value > 0);
+
+        double perSecond = 0.0;
+        for (const EvacuationBenchmark::Metric& metric : result.metrics)
+        {
+            if (metric.name.rfind("exit", 0) == 0)
+            {
+                REQUIRE(metric.higherIsBetter);
+                perSecond += metric.value;
+            }
+            else
+            {
+                REQUIRE_FALSE(metric.higherIsBetter);
+                REQUIRE(metric.value <= result.metrics[0].value);
+            }
+        }
+        REQUIRE(perSecond == Approx(14 / (result.metrics[0].value / 1000.0)));
+
+        EvacuationBenchmark::Result again = EvacuationBenchmark::run(scenario, 7);
+        REQUIRE(again.metrics[0].value == result.metrics[0].value);
+    }
+
+    SECTION("Results are summarized per metric")
+    {
+        EvacuationBenchmark::Result a{1, 1, 1, {{"clearance_ms", 100.0, false}, {"exit0_boxes_per_s", 4.0, true}}, 0.0, 0};
+        EvacuationBenchmark::Result b{2, 1, 1, {{"clearance_ms", 110.0, false}, {"exit0_boxes_per_s", 2.0, true}}, 0.0, 0};
+        vector<EvacuationBenchmark::Baseline> baselines = EvacuationBenchmark::summarize({a, b});
+
+        REQUIRE(baselines.size() == 2);
+        REQUIRE(baselines[0].name == "clearance_ms");
+        REQUIRE(baselines[0].mean == Approx(105.0));
+        REQUIRE(baselines[0].stddev == Approx(7.0710678));
+        REQUIRE(baselines[0].samples == 2);
+        REQUIRE(baselines[1].higherIsBetter);
+
+        EvacuationBenchmark::Result c{3, 1, 1, {{"other", 1.0, false}, {"exit0_boxes_per_s", 2.0, true}}, 0.0, 0};
+        REQUIRE_THROWS_AS(EvacuationBenchmark::summarize({a, c}), invalid_argument);
+    }
+
+    SECTION("Only significant worsening counts as a regression")
+    {
+        vector<EvacuationBenchmark::Baseline> baseline{
+            {"clearance_ms", 1000.0, 10.0, 10, false},
+            {"exit0_boxes_per_s", 5.0, 0.1, 10, true}};
+
+        // Slower by 10%, far outside the noise.
+        vector<EvacuationBenchmark::Baseline> slower{
+            {"clearance_ms", 1100.0, 10.0, 10, false},
+            {"exit0_boxes_per_s", 5.0, 0.1, 10, true}};
+        vector<EvacuationBenchmark::Regression> regressions = EvacuationBenchmark::compare(baseline, slower, 0.03);
+        REQUIRE(regressions.size() == 1);
+        REQUIRE(regressions[0].name == "clearance_ms");
+        REQUIRE(regressions[0].worsening == Approx(0.1));
+        REQUIRE(regressions[0].t > 10);
+
+        // Better in both directions.
+        vector<EvacuationBenchmark::Baseline> faster{
+            {"clearance_ms", 900.0, 10.0, 10, false},
+            {"exit0_boxes_per_s", 6.0, 0.1, 10, true}};
+        REQUIRE(EvacuationBenchmark::compare(baseline, faster, 0.03).empty());
+
+        // Lower throughput is worse.
+        vector<EvacuationBenchmark::Baseline> lessThroughput{
+            {"clearance_ms", 1000.0, 10.0, 10, false},
+            {"exit0_boxes_per_s", 4.5, 0.1, 10, true}};
+        regressions = EvacuationBenchmark::compare(baseline, lessThroughput, 0.03);
+        REQUIRE(regressions.size() == 1);
+        REQUIRE(regressions[0].name == "exit0_boxes_per_s");
+
+        // 5% worse, but the samples are too noisy to tell.
+        vector<EvacuationBenchmark::Baseline> noisy{
+            {"clearance_ms", 1050.0, 200.0, 3, false}};
+        REQUIRE(EvacuationBenchmark::compare(baseline, noisy, 0.03).empty());
+
+        // Significant, but smaller than the threshold.
+        vector<EvacuationBenchmark::Baseline> slightly{
+            {"clearance_ms", 1020.0, 1.0, 10, false}};
+        REQUIRE(EvacuationBenchmark::compare(baseline, slightly, 0.03).empty());
+
+        // Without any variance, the change alone decides.
+        vector<EvacuationBenchmark::Baseline> exactBefore{{"clearance_ms", 1000.0, 0.0, 1, false}};
+        vector<EvacuationBenchmark::Baseline> exactAfter{{"clearance_ms", 1050.0, 0.0, 1, false}};
+        REQUIRE(EvacuationBenchmark::compare(exactBefore, exactAfter, 0.03).size() == 1);
+
+        // Metrics without a baseline are skipped.
+        vector<EvacuationBenchmark::Baseline> unknown{{"batch9_mean_ms", 1.0e9, 0.0, 1, false}};
+        REQUIRE(EvacuationBenchmark::compare(baseline, unknown, 0.03).empty());
+    }
+
+    SECTION("Baselines are written and read back")
+    {
+        vector<EvacuationBenchmark::Baseline> baselines{
+            {"clearance_ms", 1234.5, 12.25, 8, false},
+            {"exit3_boxes_per_s", 0.75, 0.125, 8, true}};
+        stringstream stream{};
+        EvacuationBenchmark::writeBaselines(stream, baselines);
+        vector<EvacuationBenchmark::Baseline> read = EvacuationBenchmark::readBaselines(stream);
+
+        REQUIRE(read.size() == 2);
+        REQUIRE(read[0].name == "clearance_ms");
+        REQUIRE(read[0].mean == Approx(1234.5));
+        REQUIRE(read[0].stddev == Approx(12.25));
+        REQUIRE(read[0].samples == 8);
+        REQUIRE_FALSE(read[0].higherIsBetter);
+        REQUIRE(read[1].higherIsBetter);
+
+        stringstream broken{"clearance_ms 12 oops 8 lower\n"};
+        REQUIRE_THROWS_AS(EvacuationBenchmark::readBaselines(broken), invalid_argument);
+        stringstream direction{"clearance_ms 12 1 8 sideways\n"};
+        REQUIRE_THROWS_AS(EvacuationBenchmark::readBaselines(direction), invalid_argument);
+    }
+}
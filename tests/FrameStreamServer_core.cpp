@@ -0,0 +1,192 @@
+#include "catch.hpp"
+#include "../src/Frame.h"
+#include "../src/FrameStreamClient.h"
+#include "../src/FrameStreamServer.h"
+
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+Returns a Unix socket path that no other test run uses.
+*/
+string makeStreamPath(const string& test)
+{
+    return "/tmp/plazawalk_" + test + "_" + to_string(getpid()) + ".sock";
+}
+
+/*
+Waits until @server has accepted @count clients.
+*/
+void waitForClients(const FrameStreamServer& server, int count)
+{
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+    while (server.getClientCount() != count && chrono::steady_clock::now() < deadline)
+    {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    REQUIRE(count == server.getClientCount());
+}
+
+/*
+Receives messages until @client has Frame @sequence.
+*/
+void receiveUntil(FrameStreamClient& client, long sequence)
+{
+    while (client.getState().getFrameSequence() < sequence)
+    {
+        REQUIRE(client.receive(chrono::seconds(10)));
+    }
+}
+
+/*
+Frame k on a @width x @height Board: Box (k + cell) % boxCount arrives in every cell where (k + cell) % 3 == 0, and every other cell is left.
+*/
+shared_ptr<const Frame> makeFullFrame(int k, int width, int height, int boxCount)
+{
+    vector<Drop> drops{};
+    for (int cell=0; cell<width * height; ++cell)
+    {
+        MoveType type = ((k + cell) % 3 == 0) ? MoveType::arrive : MoveType::left;
+        drops.push_back(Drop{cell % width, cell / width, (k + cell) % boxCount, type});
+    }
+    vector<BoxInfo> boxes{};
+    for (int id=0; id<boxCount; ++id)
+    {
+        boxes.push_back(BoxInfo{id, id % 2, 1, 1, k % 5});
+    }
+    return make_shared<const Frame>(k, std::move(drops), std::move(boxes));
+}
+
+/*
+Returns true if @state has Frame @k made by makeFullFrame().
+*/
+bool matchesFullFrame(const FrameStreamState& state, int k, int width, int height, int boxCount)
+{
+    if (state.getFrameSequence() != k || state.getBoxCount() != boxCount)
+    {
+        return false;
+    }
+    for (int cell=0; cell<width * height; ++cell)
+    {
+        int expected = ((k + cell) % 3 == 0) ? (k + cell) % boxCount : -1;
+        if (state.getBoxId(cell) != expected)
+        {
+            return false;
+        }
+    }
+    for (int ii=0; ii<boxCount; ++ii)
+    {
+        if (state.getLevelAt(ii) != k % 5)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("FrameStreamServer_core::")
+{
+    SECTION("Two clients on a Unix socket end up with the server's Board")
+    {
+        string path = makeStreamPath("unix");
+        FrameStreamServer server{path, 4, 3};
+        REQUIRE(-1 == server.getPort());
+        FrameStreamClient clientA{path};
+        FrameStreamClient clientB{path};
+        waitForClients(server, 2);
+
+        vector<Drop> drops{};
+        drops.push_back(Drop{1, 1, 7, MoveType::arrive});
+        drops.push_back(Drop{3, 2, 9, MoveType::to_arrive});
+        vector<BoxInfo> boxes{BoxInfo{7, 0, 1, 1, 2}, BoxInfo{9, 1, 1, 1, 0}};
+        server.receiveChanges(make_shared<const Frame>(0, std::move(drops), std::move(boxes)));
+
+        vector<Drop> moving{};
+        moving.push_back(Drop{1, 1, 7, MoveType::left});
+        moving.push_back(Drop{2, 1, 7, MoveType::arrive});
+        vector<BoxInfo> sameBoxes{BoxInfo{7, 0, 1, 1, 3}, BoxInfo{9, 1, 1, 1, 0}};
+        server.receiveChanges(make_shared<const Frame>(1, std::move(moving), std::move(sameBoxes)));
+
+        for (FrameStreamClient* client : {&clientA, &clientB})
+        {
+            receiveUntil(*client, 1);
+            const FrameStreamState& state = client->getState();
+            REQUIRE(4 == state.getWidth());
+            REQUIRE(3 == state.getHeight());
+            REQUIRE(-1 == state.getBoxId(1 * 4 + 1));
+            REQUIRE(7 == state.getBoxId(1 * 4 + 2));
+            REQUIRE(MoveType::arrive == state.getMoveType(1 * 4 + 2));
+            REQUIRE(9 == state.getBoxId(2 * 4 + 3));
+            REQUIRE(MoveType::to_arrive == state.getMoveType(2 * 4 + 3));
+            REQUIRE(2 == state.getBoxCount());
+            REQUIRE(3 == state.getLevelAt(0));
+            REQUIRE(1 == state.getGroupIdAt(1));
+        }
+        REQUIRE(0 == server.getResyncCount());
+    }
+
+    SECTION("A client that connects late starts from a keyframe of the current Board")
+    {
+        FrameStreamServer server{"127.0.0.1:0", 30, 20};
+        REQUIRE(server.getPort() > 0);
+        string address = "127.0.0.1:" + to_string(server.getPort());
+
+        FrameStreamClient early{address};
+        waitForClients(server, 1);
+        for (int k=0; k<5; ++k)
+        {
+            server.receiveChanges(makeFullFrame(k, 30, 20, 7));
+        }
+
+        FrameStreamClient late{address};
+        waitForClients(server, 2);
+        server.receiveChanges(makeFullFrame(5, 30, 20, 7));
+
+        receiveUntil(early, 5);
+        receiveUntil(late, 5);
+        REQUIRE(matchesFullFrame(early.getState(), 5, 30, 20, 7));
+        REQUIRE(matchesFullFrame(late.getState(), 5, 30, 20, 7));
+        REQUIRE(1 == late.getKeyframeCount());
+        REQUIRE(2 == late.getMessageCount());
+    }
+
+    SECTION("A slow client is resynced or dropped and never holds up the other clients")
+    {
+        string path = makeStreamPath("slow");
+        int width = 100;
+        int height = 100;
+        int frames = 200;
+        FrameStreamServer server{path, width, height, 256 * 1024};
+        FrameStreamClient slow{path};
+        FrameStreamClient fast{path};
+        waitForClients(server, 2);
+
+        thread reader([&fast, frames]{ receiveUntil(fast, frames - 1); });
+        for (int k=0; k<frames; ++k)
+        {
+            server.receiveChanges(makeFullFrame(k, width, height, 50));
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        reader.join();
+        REQUIRE(matchesFullFrame(fast.getState(), frames - 1, width, height, 50));
+
+        // Each Frame changes every cell, so the slow client's queue overflows many times over.
+        REQUIRE(server.getResyncCount() + server.getDroppedCount() > 0);
+
+        // Whatever the slow client still gets leaves it with either the last Frame or a closed connection.
+        bool closed = false;
+        try
+        {
+            while (slow.getState().getFrameSequence() < frames - 1 && slow.receive(chrono::seconds(10)))
+            {}
+        }
+        catch (const runtime_error&)
+        {
+            closed = true;
+        }
+        REQUIRE((closed || matchesFullFrame(slow.getState(), frames - 1, width, height, 50)));
+        REQUIRE(closed == (server.getDroppedCount() == 1));
+    }
+}
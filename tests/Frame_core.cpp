@@ -0,0 +1,77 @@
+#include "catch.hpp"
+#include "../src/Frame.h"
+
+using namespace std;
+
+TEST_CASE("Frame_core::")
+{
+    SECTION("Frame returns the changed Drops and BoxInfos it was constructed with.")
+    {
+        vector<Drop> changedDrops{};
+        changedDrops.push_back(Drop{1, 2, 7, MoveType::to_arrive});
+        changedDrops.push_back(Drop{3, 4, -1, MoveType::left});
+
+        vector<BoxInfo> boxInfos{};
+        boxInfos.push_back(BoxInfo{7, 0, 3, 3, 2});
+        boxInfos.push_back(BoxInfo{9, 1, 3, 3, 0});
+
+        Frame frame{5, std::move(changedDrops), std::move(boxInfos)};
+
+        REQUIRE(5 == frame.getSequence());
+        REQUIRE(2 == frame.getChangedDrops().size());
+        REQUIRE(Drop{1, 2} == frame.getChangedDrops()[0]);
+        REQUIRE(MoveType::left == frame.getChangedDrops()[1].getMoveType());
+
+        REQUIRE(2 == frame.getBoxInfos().size());
+        REQUIRE(BoxInfo{7, 0, 3, 3, 2} == frame.getBoxInfo(7));
+        REQUIRE(BoxInfo{9, 1, 3, 3, 0} == frame.getBoxInfo(9));
+        REQUIRE(frame.hasBox(9));
+        REQUIRE_FALSE(frame.hasBox(8));
+        REQUIRE_THROWS(frame.getBoxInfo(8));
+    }
+
+    SECTION("Frames can share one boxId to index map.")
+    {
+        vector<BoxInfo> boxInfosA{};
+        boxInfosA.push_back(BoxInfo{4, 0, 3, 3, 0});
+        Frame frameA{0, vector<Drop>{}, std::move(boxInfosA)};
+
+        vector<BoxInfo> boxInfosB{};
+        boxInfosB.push_back(BoxInfo{4, 0, 3, 3, 1});
+        Frame frameB{1, vector<Drop>{}, std::move(boxInfosB), frameA.getBoxIndexPerId()};
+
+        REQUIRE(frameA.getBoxIndexPerId() == frameB.getBoxIndexPerId());
+        REQUIRE(0 == frameA.getBoxInfo(4).getLevel());
+        REQUIRE(1 == frameB.getBoxInfo(4).getLevel());
+    }
+
+    SECTION("coalesce() keeps the newer Drop for a Position both Frames changed and all other Drops.")
+    {
+        vector<Drop> olderDrops{};
+        olderDrops.push_back(Drop{0, 0, 1, MoveType::to_arrive});
+        olderDrops.push_back(Drop{1, 0, 2, MoveType::to_arrive});
+        vector<BoxInfo> olderBoxInfos{};
+        olderBoxInfos.push_back(BoxInfo{1, 0, 3, 3, 0});
+        Frame older{3, std::move(olderDrops), std::move(olderBoxInfos)};
+
+        vector<Drop> newerDrops{};
+        newerDrops.push_back(Drop{0, 0, 1, MoveType::arrive});
+        newerDrops.push_back(Drop{2, 0, 3, MoveType::to_arrive});
+        vector<BoxInfo> newerBoxInfos{};
+        newerBoxInfos.push_back(BoxInfo{1, 0, 3, 3, 4});
+        Frame newer{4, std::move(newerDrops), std::move(newerBoxInfos)};
+
+        shared_ptr<const Frame> merged = Frame::coalesce(older, newer);
+
+        REQUIRE(4 == merged->getSequence());
+        REQUIRE(3 == merged->getChangedDrops().size());
+        REQUIRE(4 == merged->getBoxInfo(1).getLevel());
+        for (const Drop& drop : merged->getChangedDrops())
+        {
+            if (drop == Drop{0, 0})
+            {
+                REQUIRE(MoveType::arrive == drop.getMoveType());
+            }
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "catch.hpp"
+#include "../src/GridIndex.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+TEST_CASE("GridIndex_core::")
+{
+    SECTION("Every layout gives each cell of the padded grid its own index below getIndexCount().")
+    {
+        for (GridLayout layout : {GridLayout::rowMajor, GridLayout::tiled, GridLayout::morton})
+        {
+            GridIndex gridIndex{13, 11, layout};
+            vector<int> cellsPerIndex(gridIndex.getIndexCount(), 0);
+            for (int y=0; y<gridIndex.getPaddedHeight(); ++y)
+            {
+                for (int x=0; x<gridIndex.getPaddedWidth(); ++x)
+                {
+                    int index = gridIndex.getIndex(x, y);
+                    REQUIRE(index >= 0);
+                    REQUIRE(index < gridIndex.getIndexCount());
+                    ++cellsPerIndex[index];
+                }
+            }
+            REQUIRE(vector<int>(gridIndex.getIndexCount(), 1) == cellsPerIndex);
+        }
+    }
+
+    SECTION("rowMajor is not padded, and the tiled layouts round up to whole 8 x 8 tiles.")
+    {
+        GridIndex rowMajor{13, 11, GridLayout::rowMajor};
+        REQUIRE(13 * 11 == rowMajor.getIndexCount());
+        REQUIRE(2 * 13 + 5 == rowMajor.getIndex(5, 2));
+
+        GridIndex tiled{13, 11, GridLayout::tiled};
+        REQUIRE(16 == tiled.getPaddedWidth());
+        REQUIRE(16 == tiled.getPaddedHeight());
+        REQUIRE(256 == tiled.getIndexCount());
+        REQUIRE(GridLayout::tiled == tiled.getLayout());
+    }
+
+    SECTION("tiled keeps the cells of a tile together, a row at a time, and the tiles in rows.")
+    {
+        GridIndex gridIndex{16, 16, GridLayout::tiled};
+        REQUIRE(0 == gridIndex.getIndex(0, 0));
+        REQUIRE(7 == gridIndex.getIndex(7, 0));
+        REQUIRE(8 == gridIndex.getIndex(0, 1));
+        REQUIRE(63 == gridIndex.getIndex(7, 7));
+        REQUIRE(64 == gridIndex.getIndex(8, 0));
+        REQUIRE(128 == gridIndex.getIndex(0, 8));
+    }
+
+    SECTION("morton puts the cells of a tile in Z-order.")
+    {
+        GridIndex gridIndex{16, 16, GridLayout::morton};
+        REQUIRE(0 == gridIndex.getIndex(0, 0));
+        REQUIRE(1 == gridIndex.getIndex(1, 0));
+        REQUIRE(2 == gridIndex.getIndex(0, 1));
+        REQUIRE(3 == gridIndex.getIndex(1, 1));
+        REQUIRE(4 == gridIndex.getIndex(2, 0));
+        REQUIRE(12 == gridIndex.getIndex(2, 2));
+        REQUIRE(63 == gridIndex.getIndex(7, 7));
+        REQUIRE(64 == gridIndex.getIndex(8, 0));
+        REQUIRE(128 + 3 == gridIndex.getIndex(1, 9));
+    }
+
+    SECTION("Layouts convert to their names and back, and an unknown name throws.")
+    {
+        for (GridLayout layout : {GridLayout::rowMajor, GridLayout::tiled, GridLayout::morton})
+        {
+            REQUIRE(layout == GridIndex::toGridLayout(GridIndex::toString(layout)));
+        }
+        REQUIRE("row-major" == GridIndex::toString(GridLayout::rowMajor));
+        REQUIRE_THROWS_AS(GridIndex::toGridLayout("hilbert"), invalid_argument);
+        REQUIRE_THROWS_AS(GridIndex(-1, 4, GridLayout::tiled), invalid_argument);
+    }
+}
@@ -0,0 +1,90 @@
+#include "catch.hpp"
+#include "../src/HeatmapExporter.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace
+{
+    CellHeatmap::Grid makeGrid()
+    {
+        // 3 x 2 cells with traversals 0..5, row by row.
+        CellHeatmap::Grid grid{};
+        grid.width = 3;
+        grid.height = 2;
+        for (vector<double>& layer : grid.layers)
+        {
+            layer.assign(6, 0.0);
+        }
+        for (int cell=0; cell<6; ++cell)
+        {
+            grid.layers[static_cast<size_t>(HeatmapLayer::traversals)][cell] = cell;
+        }
+        grid.layers[static_cast<size_t>(HeatmapLayer::dwellSeconds)][4] = 1.5;
+        return grid;
+    }
+
+    array<uint8_t, 3> getPixel(const string& ppm, size_t headerSize, int width, int x, int y)
+    {
+        size_t at = headerSize + static_cast<size_t>(y * width + x) * 3;
+        return array<uint8_t, 3>{
+            static_cast<uint8_t>(ppm[at]),
+            static_cast<uint8_t>(ppm[at + 1]),
+            static_cast<uint8_t>(ppm[at + 2])};
+    }
+}
+
+TEST_CASE("HeatmapExporter_core::")
+{
+    SECTION("writeCsv() writes one line per row of the Board")
+    {
+        stringstream csv{};
+        HeatmapExporter::writeCsv(csv, makeGrid(), HeatmapLayer::traversals);
+        REQUIRE(csv.str() == "0,1,2\n3,4,5\n");
+
+        stringstream dwell{};
+        HeatmapExporter::writeCsv(dwell, makeGrid(), HeatmapLayer::dwellSeconds);
+        REQUIRE(dwell.str() == "0,0,0\n0,1.5,0\n");
+    }
+
+    SECTION("writePpm() writes empty cells black, the busiest white, and outlines in cyan")
+    {
+        string header = "P6\n3 2\n255\n";
+
+        stringstream plain{};
+        HeatmapExporter::writePpm(plain, makeGrid(), HeatmapLayer::traversals);
+        string ppm = plain.str();
+        REQUIRE(ppm.size() == header.size() + 3 * 2 * 3);
+        REQUIRE(ppm.substr(0, header.size()) == header);
+        REQUIRE(getPixel(ppm, header.size(), 3, 0, 0) == array<uint8_t, 3>{0, 0, 0});
+        REQUIRE(getPixel(ppm, header.size(), 3, 2, 1) == array<uint8_t, 3>{255, 255, 255});
+        // Busier cells are at least as bright.
+        REQUIRE(getPixel(ppm, header.size(), 3, 1, 0)[0] > 0);
+        REQUIRE(getPixel(ppm, header.size(), 3, 1, 0)[0] <= getPixel(ppm, header.size(), 3, 2, 0)[0]);
+
+        stringstream outlined{};
+        HeatmapExporter::writePpm(outlined, makeGrid(), HeatmapLayer::traversals, {Rectangle{Position{1, 0}, Position{1, 5}}});
+        ppm = outlined.str();
+        REQUIRE(getPixel(ppm, header.size(), 3, 1, 0) == array<uint8_t, 3>{0, 255, 255});
+        REQUIRE(getPixel(ppm, header.size(), 3, 1, 1) == array<uint8_t, 3>{0, 255, 255});
+        REQUIRE(getPixel(ppm, header.size(), 3, 0, 1) == getPixel(plain.str(), header.size(), 3, 0, 1));
+    }
+
+    SECTION("writeFiles() writes a CSV grid and an image per layer")
+    {
+        string prefix = (filesystem::temp_directory_path() / "HeatmapExporter_core").string();
+        HeatmapExporter::writeFiles(prefix, makeGrid());
+        for (string name : {"traversals", "collisions", "dwell_seconds"})
+        {
+            REQUIRE(filesystem::exists(prefix + "-" + name + ".csv"));
+            REQUIRE(filesystem::exists(prefix + "-" + name + ".ppm"));
+            filesystem::remove(prefix + "-" + name + ".csv");
+            filesystem::remove(prefix + "-" + name + ".ppm");
+        }
+
+        REQUIRE_THROWS_AS(HeatmapExporter::writeFiles("/nonexistent-directory/heatmap", makeGrid()), runtime_error);
+    }
+}
@@ -0,0 +1,101 @@
+#include "catch.hpp"
+#include "../src/LatencyHistogram.h"
+
+#include <random>
+
+using namespace std;
+
+TEST_CASE("LatencyHistogram_core::")
+{
+    SECTION("Buckets cover every value, in order, without gaps")
+    {
+        REQUIRE(LatencyHistogram::getBucket(0) == 0);
+        REQUIRE(LatencyHistogram::getBucket(15) == 15);
+        REQUIRE(LatencyHistogram::getBucket(16) == 16);
+        REQUIRE(LatencyHistogram::getBucket(UINT64_MAX) == LatencyHistogram::bucketCount - 1);
+
+        for (int bucket=0; bucket<LatencyHistogram::bucketCount - 1; ++bucket)
+        {
+            uint64_t top = LatencyHistogram::getBucketTop(bucket);
+            REQUIRE(LatencyHistogram::getBucket(top) == bucket);
+            REQUIRE(LatencyHistogram::getBucket(top + 1) == bucket + 1);
+        }
+
+        // A bucket is at most 1/16 of its values wide.
+        for (uint64_t value : {100ull, 1000ull, 12345ull, 10000000ull, 123456789012ull})
+        {
+            int bucket = LatencyHistogram::getBucket(value);
+            uint64_t bottom = LatencyHistogram::getBucketTop(bucket - 1) + 1;
+            uint64_t top = LatencyHistogram::getBucketTop(bucket);
+            REQUIRE(bottom <= value);
+            REQUIRE(value <= top);
+            REQUIRE(static_cast<double>(top - bottom + 1) <= static_cast<double>(bottom) / 16.0 + 1.0);
+        }
+    }
+
+    SECTION("Percentiles are within a bucket of the exact values")
+    {
+        LatencyHistogram histogram{};
+        REQUIRE(histogram.getCount() == 0);
+        REQUIRE(histogram.getPercentile(0.5) == 0);
+        REQUIRE(histogram.getMean() == 0.0);
+
+        // 1 to 100000 nanoseconds, once each.
+        for (uint64_t value=1; value<=100000; ++value)
+        {
+            histogram.record(value);
+        }
+        REQUIRE(histogram.getCount() == 100000);
+        REQUIRE(histogram.getMax() == 100000);
+        REQUIRE(histogram.getMean() == Approx(50000.5));
+
+        for (double fraction : {0.5, 0.9, 0.99, 0.999})
+        {
+            double exact = fraction * 100000.0;
+            double reported = static_cast<double>(histogram.getPercentile(fraction));
+            REQUIRE(reported >= exact);
+            REQUIRE(reported <= exact * 1.07);
+        }
+        REQUIRE(histogram.getPercentile(1.0) == 100000);
+        REQUIRE(histogram.getPercentile(0.0) == 1);
+    }
+
+    SECTION("Merging is the same as recording everything in one histogram")
+    {
+        mt19937 generator{7};
+        exponential_distribution<double> distribution{1.0 / 20000.0};
+
+        LatencyHistogram a{};
+        LatencyHistogram b{};
+        LatencyHistogram all{};
+        for (int ii=0; ii<20000; ++ii)
+        {
+            uint64_t value = static_cast<uint64_t>(distribution(generator));
+            ((ii % 3 == 0) ? a : b).record(value);
+            all.record(value);
+        }
+
+        a.merge(b);
+        REQUIRE(a.getCount() == all.getCount());
+        REQUIRE(a.getMax() == all.getMax());
+        REQUIRE(a.getMean() == Approx(all.getMean()));
+        for (double fraction : {0.5, 0.99, 0.999})
+        {
+            REQUIRE(a.getPercentile(fraction) == all.getPercentile(fraction));
+        }
+    }
+
+    SECTION("Can be built from bucket counts")
+    {
+        array<uint64_t, LatencyHistogram::bucketCount> counts{};
+        counts[LatencyHistogram::getBucket(1000)] = 3;
+        counts[LatencyHistogram::getBucket(5000)] = 1;
+        LatencyHistogram histogram{counts, 8000.0, 5000};
+
+        REQUIRE(histogram.getCount() == 4);
+        REQUIRE(histogram.getMean() == Approx(2000.0));
+        REQUIRE(histogram.getMax() == 5000);
+        REQUIRE(histogram.getPercentile(0.5) == LatencyHistogram::getBucketTop(LatencyHistogram::getBucket(1000)));
+        REQUIRE(histogram.getPercentile(1.0) == 5000);
+    }
+}
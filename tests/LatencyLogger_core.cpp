@@ -0,0 +1,48 @@
+#include "catch.hpp"
+#include "../src/LatencyLogger.h"
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+
+TEST_CASE("LatencyLogger_core::")
+{
+    SECTION("Writes rows at the interval and a last set when destroyed")
+    {
+        string path = "LatencyLogger_core_test.csv";
+        PhaseLatencies latencies{};
+        latencies.setGroupForThisThread(DeciderType::safe, PositionManagerType::up);
+        int written = 0;
+        {
+            LatencyLogger logger{latencies, path, chrono::milliseconds{20}};
+            latencies.record(StepPhase::waitingToEnter, 2000000);
+            this_thread::sleep_for(chrono::milliseconds{100});
+            written = logger.getWrittenCount();
+        }
+        REQUIRE(written >= 1);
+
+        ifstream in{path};
+        vector<string> lines{};
+        string line{};
+        while (getline(in, line))
+        {
+            lines.push_back(line);
+        }
+        // The header, then per write a row for the group and a row for the DeciderType.
+        REQUIRE(lines.size() >= 5);
+        REQUIRE(lines[0].rfind("seconds,decider,", 0) == 0);
+        REQUIRE(lines[lines.size() - 2].find(",safe,up,waiting_to_enter,1,2000,") != string::npos);
+        REQUIRE(lines.back().find(",safe,all,waiting_to_enter,1,2000,") != string::npos);
+        remove(path.c_str());
+    }
+
+    SECTION("Rejects a bad path or interval")
+    {
+        PhaseLatencies latencies{};
+        REQUIRE_THROWS_AS(LatencyLogger(latencies, "no_such_directory/latencies.csv", chrono::seconds{1}), runtime_error);
+        REQUIRE_THROWS_AS(LatencyLogger(latencies, "LatencyLogger_core_test.csv", chrono::milliseconds{0}), invalid_argument);
+        remove("LatencyLogger_core_test.csv");
+    }
+}
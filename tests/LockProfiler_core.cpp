@@ -0,0 +1,203 @@
+#include "catch.hpp"
+#include "../src/LockProfiler.h"
+#include "../src/ProfiledSharedMutex.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    uint64_t toTicks(double nanoseconds)
+    {
+        return static_cast<uint64_t>(nanoseconds / TscClock::getNanosecondsPerTick());
+    }
+
+    LockProfiler::LockClassStats getStats(const string& name)
+    {
+        for (const LockProfiler::LockClassStats& stats : LockProfiler::getLockClassStats())
+        {
+            if (stats.name == name)
+            {
+                return stats;
+            }
+        }
+        return LockProfiler::LockClassStats{};
+    }
+}
+
+TEST_CASE("LockProfiler_core::")
+{
+    SECTION("Registering the same name twice returns the same lock class id")
+    {
+        string name{"LockProfiler_core::same"};
+        int id = LockProfiler::getLockClassId("LockProfiler_core::same");
+        REQUIRE(LockProfiler::getLockClassId(name.c_str()) == id);
+        REQUIRE(LockProfiler::getLockClassId("LockProfiler_core::other") != id);
+    }
+
+    SECTION("Counts acquisitions and contended acquisitions per lock class and LockMode")
+    {
+        int id = LockProfiler::getLockClassId("LockProfiler_core::counts");
+        source_location site = source_location::current();
+        LockProfiler::recordAcquisition(id, LockMode::exclusive, 0, false, site);
+        LockProfiler::recordAcquisition(id, LockMode::exclusive, toTicks(50000.0), true, site);
+        LockProfiler::recordAcquisition(id, LockMode::shared, 0, false, site);
+        LockProfiler::recordHold(id, LockMode::shared, toTicks(2000.0));
+
+        LockProfiler::LockClassStats stats = getStats("LockProfiler_core::counts");
+        const LockProfiler::ModeStats& exclusive = stats.modes[static_cast<int>(LockMode::exclusive)];
+        const LockProfiler::ModeStats& shared = stats.modes[static_cast<int>(LockMode::shared)];
+        REQUIRE(exclusive.acquisitions == 2);
+        REQUIRE(exclusive.contended == 1);
+        REQUIRE(exclusive.waits.getCount() == 2);
+        REQUIRE(exclusive.waits.getMax() > 45000);
+        REQUIRE(exclusive.waits.getMax() < 55000);
+        REQUIRE(exclusive.holds.getCount() == 0);
+        REQUIRE(shared.acquisitions == 1);
+        REQUIRE(shared.contended == 0);
+        REQUIRE(shared.holds.getCount() == 1);
+    }
+
+    SECTION("Merges the recordings of threads that have exited")
+    {
+        int id = LockProfiler::getLockClassId("LockProfiler_core::threads");
+        for (int ii=0; ii<3; ++ii)
+        {
+            thread t{[id](){
+                for (int jj=0; jj<100; ++jj)
+                {
+                    LockProfiler::recordAcquisition(id, LockMode::shared, 0, false, source_location::current());
+                    LockProfiler::recordHold(id, LockMode::shared, 10);
+                }
+            }};
+            t.join();
+        }
+
+        LockProfiler::LockClassStats stats = getStats("LockProfiler_core::threads");
+        REQUIRE(stats.modes[static_cast<int>(LockMode::shared)].acquisitions == 300);
+        REQUIRE(stats.modes[static_cast<int>(LockMode::shared)].holds.getCount() == 300);
+    }
+
+    SECTION("Lists contended call sites by total wait, longest first")
+    {
+        int id = LockProfiler::getLockClassId("LockProfiler_core::sites");
+        source_location shortSite = source_location::current();
+        source_location longSite = source_location::current();
+        LockProfiler::recordAcquisition(id, LockMode::exclusive, toTicks(1000000000.0), true, longSite);
+        LockProfiler::recordAcquisition(id, LockMode::exclusive, toTicks(400000000.0), true, shortSite);
+        LockProfiler::recordAcquisition(id, LockMode::exclusive, toTicks(400000000.0), true, shortSite);
+
+        vector<LockProfiler::SiteStats> sites{};
+        for (const LockProfiler::SiteStats& site : LockProfiler::getTopSites(1000))
+        {
+            if (site.lockClass == "LockProfiler_core::sites")
+            {
+                sites.push_back(site);
+            }
+        }
+        REQUIRE(sites.size() == 2);
+        REQUIRE(sites[0].lockClass == "LockProfiler_core::sites");
+        REQUIRE(sites[0].line == static_cast<int>(longSite.line()));
+        REQUIRE(sites[0].contended == 1);
+        REQUIRE(sites[1].line == static_cast<int>(shortSite.line()));
+        REQUIRE(sites[1].contended == 2);
+        REQUIRE(sites[1].totalWaitNanoseconds < sites[0].totalWaitNanoseconds);
+    }
+
+    SECTION("Adds up a call site's waits over the threads that contended there")
+    {
+        int id = LockProfiler::getLockClassId("LockProfiler_core::siteThreads");
+        source_location site = source_location::current();
+        vector<thread> threads{};
+        for (int ii=0; ii<4; ++ii)
+        {
+            threads.push_back(thread{[id, site, ii](){
+                for (int jj=0; jj<10; ++jj)
+                {
+                    LockProfiler::recordAcquisition(id, LockMode::shared, toTicks(1000000.0 * (ii + 1)), true, site);
+                }
+            }});
+        }
+        for (thread& t : threads)
+        {
+            t.join();
+        }
+
+        vector<LockProfiler::SiteStats> sites{};
+        for (const LockProfiler::SiteStats& stats : LockProfiler::getTopSites(1000))
+        {
+            if (stats.lockClass == "LockProfiler_core::siteThreads")
+            {
+                sites.push_back(stats);
+            }
+        }
+        REQUIRE(sites.size() == 1);
+        REQUIRE(sites[0].mode == LockMode::shared);
+        REQUIRE(sites[0].line == static_cast<int>(site.line()));
+        REQUIRE(sites[0].contended == 40);
+        // 10 waits each of 1, 2, 3, and 4 ms.
+        REQUIRE(sites[0].totalWaitNanoseconds == Approx(100000000.0).epsilon(0.01));
+        REQUIRE(sites[0].maxWaitNanoseconds > 3900000);
+        REQUIRE(sites[0].maxWaitNanoseconds < 4100000);
+    }
+
+    SECTION("writeReport() writes a row per lock class and LockMode, and the call sites")
+    {
+        int id = LockProfiler::getLockClassId("LockProfiler_core::report");
+        LockProfiler::recordAcquisition(id, LockMode::exclusive, toTicks(2000000000.0), true, source_location::current());
+
+        stringstream report{};
+        report.precision(9);
+        LockProfiler::writeReport(report);
+        string text = report.str();
+        // The stream's format is left as it was.
+        REQUIRE(report.precision() == 9);
+        REQUIRE((report.flags() & ios::floatfield) == ios::fmtflags{});
+
+        REQUIRE(text.find("Lock contention report") == 0);
+        size_t row = text.find("LockProfiler_core::report ");
+        REQUIRE(row != string::npos);
+        string rowText = text.substr(row, text.find('\n', row) - row);
+        REQUIRE(rowText.find(" exclusive ") != string::npos);
+        REQUIRE(text.find("Top contending call sites") != string::npos);
+        REQUIRE(text.find("LockProfiler_core.cpp:") != string::npos);
+    }
+
+    SECTION("ProfiledUniqueLock excludes every other lock, ProfiledSharedLock only excludes unique ones")
+    {
+        ProfiledSharedMutex mutex{"LockProfiler_core::guards"};
+        // A thread may not try a lock it already holds, so another thread tries.
+        auto canLock = [&mutex](bool shared){
+            bool locked = false;
+            thread t{[&mutex, &locked, shared](){
+                locked = shared ? mutex.try_lock_shared() : mutex.try_lock();
+                if (locked)
+                {
+                    shared ? mutex.unlock_shared() : mutex.unlock();
+                }
+            }};
+            t.join();
+            return locked;
+        };
+        {
+            ProfiledSharedLock lock{mutex};
+            REQUIRE_FALSE(canLock(false));
+            REQUIRE(canLock(true));
+        }
+        {
+            ProfiledUniqueLock lock{mutex};
+            REQUIRE_FALSE(canLock(true));
+        }
+        REQUIRE(canLock(false));
+
+        if (LockProfiler::isCompiledIn())
+        {
+            LockProfiler::LockClassStats stats = getStats("LockProfiler_core::guards");
+            REQUIRE(stats.modes[static_cast<int>(LockMode::exclusive)].acquisitions == 1);
+            REQUIRE(stats.modes[static_cast<int>(LockMode::exclusive)].holds.getCount() == 1);
+            REQUIRE(stats.modes[static_cast<int>(LockMode::shared)].acquisitions == 1);
+        }
+    }
+}
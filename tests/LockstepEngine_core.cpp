@@ -0,0 +1,369 @@
+#include "catch.hpp"
+#include "../src/LockstepEngine.h"
+#include "../src/MainSetup.h"
+#include "../src/RunStatistics.h"
+#include "../src/Threader.h"
+#include "../src/Util.h"
+
+using namespace std;
+
+namespace
+{
+    // Steps straight towards one Position and is at its end there.
+    class PositionManager_Fixed : public PositionManager
+    {
+        public:
+
+        explicit PositionManager_Fixed(Position target) : _target{target} {}
+
+        vector<Position> getFuturePositions(Position position) override
+        {
+            int deltaX = (_target.getX() > position.getX()) - (_target.getX() < position.getX());
+            int deltaY = (_target.getY() > position.getY()) - (_target.getY() < position.getY());
+            return vector<Position>{Position{position.getX() + deltaX, position.getY() + deltaY}};
+        }
+
+        bool atEnd(Position position) const override
+        {
+            return position == _target;
+        }
+
+        Rectangle getEndRect() const override
+        {
+            return Rectangle{_target, _target};
+        }
+
+        Rectangle getTargetRect() const override
+        {
+            return Rectangle{_target, _target};
+        }
+
+        private:
+
+        Position _target;
+    };
+
+    // Keeps the last Frame.
+    class FrameListener : public BoardListener
+    {
+        public:
+
+        void receiveChanges(const shared_ptr<const Frame>& frame) override
+        {
+            _frame = frame;
+        }
+
+        shared_ptr<const Frame> _frame{};
+    };
+
+    // Always enters and always takes the first Position, without waiting.
+    class Decider_First : public Decider
+    {
+        public:
+
+        bool suggestMoveTo(Position position, const BoardView& board) override
+        {
+            (void)position;
+            (void)board;
+            return true;
+        }
+
+        pair<Position, int> getNext(span<const Position> possiblePositions, const BoardView& board) override
+        {
+            (void)board;
+            return {possiblePositions.empty() ? Position{-1, -1} : possiblePositions[0], 0};
+        }
+    };
+
+    // Forwards to another PositionManager, but hides its RankingRule, so the engine has to ask it.
+    class PositionManager_Opaque : public PositionManager
+    {
+        public:
+
+        explicit PositionManager_Opaque(unique_ptr<PositionManager> inner) : _inner{std::move(inner)} {}
+
+        vector<Position> getFuturePositions(Position position) override
+        {
+            return _inner->getFuturePositions(position);
+        }
+
+        void fillFuturePositions(Position position, FuturePositions& positions) override
+        {
+            _inner->fillFuturePositions(position, positions);
+        }
+
+        bool atEnd(Position position) const override
+        {
+            return _inner->atEnd(position);
+        }
+
+        Rectangle getEndRect() const override
+        {
+            return _inner->getEndRect();
+        }
+
+        Rectangle getTargetRect() const override
+        {
+            return _inner->getTargetRect();
+        }
+
+        private:
+
+        unique_ptr<PositionManager> _inner;
+    };
+
+    // Forwards to another Decider, but hides its DeciderType, so the engine has to ask it.
+    class Decider_Opaque : public Decider
+    {
+        public:
+
+        explicit Decider_Opaque(unique_ptr<Decider> inner) : _inner{std::move(inner)} {}
+
+        bool suggestMoveTo(Position position, const BoardView& board) override
+        {
+            return _inner->suggestMoveTo(position, board);
+        }
+
+        pair<Position, int> getNext(span<const Position> possiblePositions, const BoardView& board) override
+        {
+            return _inner->getNext(possiblePositions, board);
+        }
+
+        private:
+
+        unique_ptr<Decider> _inner;
+    };
+
+    BoxPlan makeFixedPlan(int boxId, Position start, Position target)
+    {
+        return BoxPlan{
+            boxId,
+            0,
+            start,
+            Rectangle{target, target},
+            PositionManagerType::diagonal,
+            make_unique<PositionManager_Fixed>(target),
+            DeciderType::safe,
+            make_unique<Decider_First>()};
+    }
+
+    struct SmallRun
+    {
+        long ticks;
+        int exitedCount;
+        vector<long> exitTicks;
+    };
+
+    /*
+    @opaque hides the PositionManagers' RankingRules and the Deciders' DeciderTypes from the engine.
+    */
+    SmallRun runSmall(uint32_t seed, int workerCount, int tileSize = 0, bool opaque = false)
+    {
+        Util::setSeed(seed);
+        vector<Box> boxes{};
+        MainSetup::addAGroupOfBoxes(boxes, 0, 0, 14);
+        Board board{150, 130, std::move(boxes)};
+
+        Threader threader{};
+        vector<Rectangle> rects = MainSetup::getInOutBoundRectangles(150, 130);
+        vector<BoxPlan> plans = threader.planBatches(2, 7, rects, 150, 130);
+        if (opaque)
+        {
+            for (BoxPlan& plan : plans)
+            {
+                plan.positionManager = make_unique<PositionManager_Opaque>(std::move(plan.positionManager));
+                plan.decider = make_unique<Decider_Opaque>(std::move(plan.decider));
+            }
+        }
+        LockstepEngine engine{board, std::move(plans), workerCount, seed, tileSize};
+        for (uint8_t policyId : engine.getAgents().getPolicyIds())
+        {
+            REQUIRE((policyId == 0) == opaque);
+        }
+
+        SmallRun result{};
+        result.ticks = engine.run(100000);
+        result.exitedCount = engine.getExitedCount();
+        for (int ii=0; ii<engine.getBoxCount(); ++ii)
+        {
+            result.exitTicks.push_back(engine.getExitTick(ii));
+        }
+        return result;
+    }
+}
+
+TEST_CASE("LockstepEngine_core::")
+{
+    SECTION("Every Box reaches its exit and leaves the Board")
+    {
+        SmallRun run = runSmall(3, 2);
+
+        REQUIRE(run.exitedCount == 14);
+        for (long exitTick : run.exitTicks)
+        {
+            REQUIRE(exitTick > 0);
+            REQUIRE(exitTick < run.ticks);
+        }
+    }
+
+    SECTION("The same seed and worker count give the same run")
+    {
+        SmallRun first = runSmall(11, 3);
+        SmallRun second = runSmall(11, 3);
+
+        REQUIRE(first.ticks == second.ticks);
+        REQUIRE(first.exitedCount == second.exitedCount);
+        REQUIRE(first.exitTicks == second.exitTicks);
+    }
+
+    SECTION("Steering the Boxes from the AgentTable gives the same run as asking their PositionManagers and Deciders")
+    {
+        for (int tileSize : {0, 8})
+        {
+            SmallRun fromTable = runSmall(17, 2, tileSize);
+            SmallRun asked = runSmall(17, 2, tileSize, true);
+
+            REQUIRE(fromTable.exitedCount == 14);
+            REQUIRE(fromTable.ticks == asked.ticks);
+            REQUIRE(fromTable.exitTicks == asked.exitTicks);
+        }
+    }
+
+    SECTION("Two Boxes claiming the same cell: the lowest boxId moves, the other tries again")
+    {
+        for (int workerCount : {1, 2})
+        {
+            vector<Box> boxes{};
+            MainSetup::addAGroupOfBoxes(boxes, 0, 0, 2);
+            Board board{5, 5, std::move(boxes)};
+            RunStatistics statistics{2};
+            board.registerTransitionListener(&statistics);
+            FrameListener listener{};
+            board.registerListener(&listener);
+
+            vector<BoxPlan> plans{};
+            plans.push_back(makeFixedPlan(1, Position{1, 2}, Position{1, 1}));
+            plans.push_back(makeFixedPlan(0, Position{1, 0}, Position{1, 1}));
+            LockstepEngine engine{board, std::move(plans), workerCount, 7};
+
+            // Tick 0 both enter, tick 1 both claim {1, 1}, tick 2 Box 0 exits from it, tick 3 Box 1 moves there, tick 4 Box 1 exits.
+            REQUIRE(engine.run(100) == 5);
+            LockstepEngine::Stats stats = engine.getStats();
+            REQUIRE(stats.ticks == 5);
+            REQUIRE(stats.entries == 2);
+            REQUIRE(stats.conflicts == 1);
+            REQUIRE(stats.blocked == 1);
+            REQUIRE(stats.moves == 2);
+            REQUIRE(stats.exits == 2);
+            REQUIRE(stats.agentSteps == 8);
+            REQUIRE(engine.getEntryTick(0) == 0);
+            REQUIRE(engine.getEntryTick(1) == 0);
+            REQUIRE(engine.getExitTick(1) == 2);
+            REQUIRE(engine.getExitTick(0) == 4);
+            REQUIRE(board.getNoteAt(Position{1, 1}).getBoxId() == -1);
+
+            // Box 1 ran into Box 0 twice, losing its claim in tick 1 and finding {1, 1} taken in tick 2, as a Mover would have.
+            REQUIRE(board.getMetrics().getSnapshot().get(SimulationCounter::collisions) == 2);
+            REQUIRE(statistics.getCollisions() == 2);
+            board.sendStateAndChanges();
+            REQUIRE(listener._frame->getBoxInfo(0).getLevel() == 2);
+            REQUIRE(listener._frame->getBoxInfo(1).getLevel() == 2);
+        }
+    }
+
+    SECTION("Exited Boxes are compacted out of the AgentTable between ticks")
+    {
+        for (int tileSize : {0, 2})
+        {
+            vector<Box> boxes{};
+            MainSetup::addAGroupOfBoxes(boxes, 0, 0, 2);
+            Board board{5, 5, std::move(boxes)};
+
+            vector<BoxPlan> plans{};
+            plans.push_back(makeFixedPlan(1, Position{1, 2}, Position{1, 1}));
+            plans.push_back(makeFixedPlan(0, Position{1, 0}, Position{1, 1}));
+            LockstepEngine engine{board, std::move(plans), 1, 7, tileSize};
+
+            const AgentTable& agents = engine.getAgents();
+            REQUIRE(agents.size() == 2);
+            REQUIRE(agents.getTargetIds()[0] == agents.getTargetIds()[1]);
+            REQUIRE(engine.getTarget(agents.getTargetIds()[0]) == Rectangle{Position{1, 1}, Position{1, 1}});
+
+            vector<int> rowCounts{};
+            engine.run(100, [&rowCounts, &agents](long){ rowCounts.push_back(agents.size()); return true; });
+
+            // Box 0 exits in tick 2, after which Box 1 is the only row left, and Box 1 exits in the last tick.
+            REQUIRE(rowCounts[1] == 2);
+            REQUIRE(rowCounts[2] == 1);
+            REQUIRE(agents.size() == 0);
+            REQUIRE(engine.getExitedCount() == 2);
+            REQUIRE(engine.getExitTick(1) == 2);
+        }
+    }
+
+    SECTION("Split by tile, every Box reaches its exit, and the worker count does not change the run")
+    {
+        SmallRun first = runSmall(13, 1, 8);
+        SmallRun second = runSmall(13, 3, 8);
+
+        REQUIRE(first.exitedCount == 14);
+        REQUIRE(first.ticks == second.ticks);
+        REQUIRE(first.exitTicks == second.exitTicks);
+    }
+
+    SECTION("Split by tile, a Box crossing into another tile is handed over and acts once per tick")
+    {
+        for (int workerCount : {1, 2})
+        {
+            vector<Box> boxes{};
+            MainSetup::addAGroupOfBoxes(boxes, 0, 0, 2);
+            Board board{6, 6, std::move(boxes)};
+
+            // Box 0 crosses into a tile of a later colour, Box 1 into a tile of an earlier colour.
+            vector<BoxPlan> plans{};
+            plans.push_back(makeFixedPlan(0, Position{0, 0}, Position{3, 0}));
+            plans.push_back(makeFixedPlan(1, Position{3, 2}, Position{0, 2}));
+            LockstepEngine engine{board, std::move(plans), workerCount, 7, 2};
+
+            REQUIRE(engine.getTileSize() == 2);
+            REQUIRE(engine.run(100) == 5);
+            LockstepEngine::Stats stats = engine.getStats();
+            REQUIRE(stats.moves == 6);
+            REQUIRE(stats.handoffs == 2);
+            REQUIRE(stats.conflicts == 0);
+            REQUIRE(engine.getExitTick(0) == 4);
+            REQUIRE(engine.getExitTick(1) == 4);
+        }
+    }
+
+    SECTION("A run stops at its limit or when afterTick() returns false, and can be continued")
+    {
+        Util::setSeed(5);
+        vector<Box> boxes{};
+        MainSetup::addAGroupOfBoxes(boxes, 0, 0, 14);
+        Board board{150, 130, std::move(boxes)};
+
+        Threader threader{};
+        vector<Rectangle> rects = MainSetup::getInOutBoundRectangles(150, 130);
+        LockstepEngine engine{board, threader.planBatches(2, 7, rects, 150, 130), 2, 5};
+
+        REQUIRE(engine.run(2) == 2);
+        REQUIRE(engine.getExitedCount() == 0);
+        long lastTick = 0;
+        REQUIRE(engine.run(100000, [&lastTick](long tick){ lastTick = tick; return tick < 6; }) == 6);
+        REQUIRE(lastTick == 6);
+        REQUIRE(engine.run(100000) > 6);
+        REQUIRE(engine.getExitedCount() == 14);
+        REQUIRE(engine.getStats().agentSteps >= engine.getStats().moves);
+        REQUIRE(engine.getStats().getAgentStepsPerSecond() > 0);
+    }
+
+    SECTION("Needs at least one worker, and tiles of at least 2 x 2 cells")
+    {
+        vector<Box> boxes{};
+        Board board{5, 5, std::move(boxes)};
+        REQUIRE_THROWS_AS(LockstepEngine(board, vector<BoxPlan>{}, 0, 1), invalid_argument);
+        REQUIRE_THROWS_AS(LockstepEngine(board, vector<BoxPlan>{}, 1, 1, 1), invalid_argument);
+        REQUIRE_THROWS_AS(LockstepEngine(board, vector<BoxPlan>{}, 1, 1, -2), invalid_argument);
+    }
+}
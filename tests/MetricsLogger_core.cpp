@@ -0,0 +1,72 @@
+#include "catch.hpp"
+#include "../src/MetricsLogger.h"
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    vector<string> readLines(const string& path)
+    {
+        ifstream in{path};
+        vector<string> lines{};
+        string line{};
+        while (getline(in, line))
+        {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+}
+
+TEST_CASE("MetricsLogger_core::")
+{
+    SECTION("Writes CSV rows at the interval and a last row when destroyed")
+    {
+        string path = "MetricsLogger_core_test.csv";
+        SimulationMetrics metrics{};
+        int written = 0;
+        {
+            MetricsLogger logger{metrics, path, chrono::milliseconds{20}};
+            metrics.count(SimulationCounter::boxesEntered, 3);
+            this_thread::sleep_for(chrono::milliseconds{110});
+            metrics.count(SimulationCounter::boxesExited, 2);
+            written = logger.getWrittenCount();
+        }
+        REQUIRE(written >= 1);
+
+        vector<string> lines = readLines(path);
+        REQUIRE(lines.size() >= 3);
+        REQUIRE(lines[0].rfind("seconds,", 0) == 0);
+        // The last row has the final counts: entered then exited are the last two columns.
+        REQUIRE(lines.back().substr(lines.back().size() - 4) == ",3,2");
+        remove(path.c_str());
+    }
+
+    SECTION("Writes JSON lines to a .json file")
+    {
+        string path = "MetricsLogger_core_test.json";
+        SimulationMetrics metrics{};
+        {
+            MetricsLogger logger{metrics, path, chrono::seconds{60}};
+            metrics.count(SimulationCounter::collisions);
+        }
+
+        vector<string> lines = readLines(path);
+        REQUIRE(lines.size() == 1);
+        REQUIRE(lines[0].front() == '{');
+        REQUIRE(lines[0].find("\"collisions\":1") != string::npos);
+        remove(path.c_str());
+    }
+
+    SECTION("Rejects a bad path or interval")
+    {
+        SimulationMetrics metrics{};
+        REQUIRE_THROWS_AS(MetricsLogger(metrics, "no_such_directory/metrics.csv", chrono::seconds{1}), runtime_error);
+        REQUIRE_THROWS_AS(MetricsLogger(metrics, "MetricsLogger_core_test.csv", chrono::milliseconds{0}), invalid_argument);
+        remove("MetricsLogger_core_test.csv");
+    }
+}
@@ -13,19 +13,17 @@ class TempListener : public BoardListener
 {
     public: 
 
-    void receiveChanges(
-        unordered_set<Drop> drops,
-        unordered_map<int, BoxInfo> boxes) override
+    void receiveChanges(const shared_ptr<const Frame>& frame) override
     {
         _dropsPerPosition.clear();
         _boxes.clear();
 
-        for(const auto& p: boxes)
+        for(const BoxInfo& boxInfo: frame->getBoxInfos())
         {
-            _boxes.insert({p.second.getId(), p.second});
+            _boxes.insert({boxInfo.getId(), boxInfo});
         }
 
-        for(auto& drop : drops)
+        for(auto& drop : frame->getChangedDrops())
         {
             _dropsPerPosition.insert({drop.getPosition(), drop});
         }
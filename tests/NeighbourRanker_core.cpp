@@ -0,0 +1,226 @@
+#include "catch.hpp"
+#include "../src/NeighbourRanker.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    // PositionManager_Step's n, nw, w, sw, s, se, e, ne.
+    constexpr NeighbourRanker::Directions directions{
+        {0, 1, 1, 1, 0, -1, -1, -1},
+        {-1, -1, 0, 1, 1, 1, 0, -1}};
+
+    // PositionManager_Diagonal's, with y the other way up.
+    constexpr NeighbourRanker::Directions diagonalDirections{
+        {0, 1, 1, 1, 0, -1, -1, -1},
+        {1, 1, 0, -1, -1, -1, 0, 1}};
+
+    // The order NeighbourRanker promises: the Positions on the Board by squared distance, and equal distances in direction order. The PositionManagers used std::sort before, which left equal distances in no particular order.
+    vector<Position> rankBySorting(
+        Position position,
+        Position target,
+        const NeighbourRanker::Bounds& bounds,
+        const NeighbourRanker::Directions& directions = ::directions)
+    {
+        vector<pair<long, Position>> pairs{};
+        for (int d=0; d<NeighbourRanker::directionCount; ++d)
+        {
+            Position p{position.getX() + directions.dxs[d], position.getY() + directions.dys[d]};
+            if (p.getX() >= bounds.minX && p.getX() <= bounds.maxX && p.getY() >= bounds.minY && p.getY() <= bounds.maxY)
+            {
+                long x = p.getX() - target.getX();
+                long y = p.getY() - target.getY();
+                pairs.push_back({x * x + y * y, p});
+            }
+        }
+        stable_sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b){ return a.first < b.first; });
+
+        vector<Position> positions{};
+        for (const auto& p : pairs)
+        {
+            positions.push_back(p.second);
+        }
+        return positions;
+    }
+}
+
+TEST_CASE("NeighbourRanker_core::")
+{
+    NeighbourRanker::Bounds bounds{0, 9, 0, 7};
+
+    SECTION("Neighbours are ranked nearest first, and ties go to the earlier direction.")
+    {
+        // The target is 4 cells along x: {+1, 0} is nearest, then {+1, -1} and {+1, +1} (tied), then {0, -1} and {0, +1} (tied), and {-1, 0} before {-1, +1} and {-1, -1} (tied).
+        NeighbourRanker::Ranking ranking = NeighbourRanker::rank(Position{4, 4}, Position{8, 4}, bounds, directions);
+
+        REQUIRE(8 == ranking.getCount());
+        REQUIRE(0xFF == ranking.validMask);
+        REQUIRE(2 == ranking.getDirection(0));
+        REQUIRE(1 == ranking.getDirection(1));
+        REQUIRE(3 == ranking.getDirection(2));
+        REQUIRE(0 == ranking.getDirection(3));
+        REQUIRE(4 == ranking.getDirection(4));
+        REQUIRE(6 == ranking.getDirection(5));
+        REQUIRE(5 == ranking.getDirection(6));
+        REQUIRE(7 == ranking.getDirection(7));
+    }
+
+    SECTION("Neighbours off the Board are left out and ranked last.")
+    {
+        NeighbourRanker::Ranking ranking = NeighbourRanker::rank(Position{0, 0}, Position{0, 0}, bounds, directions);
+
+        REQUIRE(3 == ranking.getCount());
+        // w, sw and s are the only neighbours of the top left corner.
+        REQUIRE(0b00011100 == ranking.validMask);
+        vector<Position> positions = NeighbourRanker::getPositions(Position{0, 0}, ranking, directions);
+        REQUIRE(vector<Position>{Position{1, 0}, Position{0, 1}, Position{1, 1}} == positions);
+    }
+
+    SECTION("Ranking many agents at once gives the same order as sorting each agent by distance, with ties in direction order.")
+    {
+        mt19937 random{5};
+        const int count = 53;
+        vector<int32_t> xs{}, ys{}, targetXs{}, targetYs{};
+        for (int ii=0; ii<count; ++ii)
+        {
+            xs.push_back(static_cast<int32_t>(random() % 10));
+            ys.push_back(static_cast<int32_t>(random() % 8));
+            targetXs.push_back(static_cast<int32_t>(random() % 10));
+            targetYs.push_back(static_cast<int32_t>(random() % 8));
+        }
+        vector<NeighbourRanker::Ranking> rankings(count);
+        NeighbourRanker::rank(xs, ys, targetXs, targetYs, bounds, directions, rankings);
+
+        for (int ii=0; ii<count; ++ii)
+        {
+            Position position{xs[ii], ys[ii]};
+            Position target{targetXs[ii], targetYs[ii]};
+            NeighbourRanker::Ranking one = NeighbourRanker::rank(position, target, bounds, directions);
+            REQUIRE(one.order == rankings[ii].order);
+            REQUIRE(one.validMask == rankings[ii].validMask);
+            REQUIRE(rankBySorting(position, target, bounds) == NeighbourRanker::getPositions(position, rankings[ii], directions));
+        }
+    }
+
+    SECTION("shuffleAfter() keeps the top directions and draws as shuffling the Positions would.")
+    {
+        NeighbourRanker::Ranking ranking = NeighbourRanker::rank(Position{4, 4}, Position{8, 6}, bounds, directions);
+        vector<Position> positions = NeighbourRanker::getPositions(Position{4, 4}, ranking, directions);
+
+        mt19937 first{11};
+        mt19937 second{11};
+        NeighbourRanker::shuffleAfter(ranking, 3, first);
+        shuffle(positions.begin() + 3, positions.end(), second);
+
+        REQUIRE(positions == NeighbourRanker::getPositions(Position{4, 4}, ranking, directions));
+        REQUIRE(first() == second());
+    }
+
+    SECTION("shuffleAfter() does nothing when there are no more than the kept directions.")
+    {
+        NeighbourRanker::Ranking ranking = NeighbourRanker::rank(Position{9, 7}, Position{0, 0}, bounds, directions);
+        NeighbourRanker::Ranking shuffled = ranking;
+        mt19937 generator{11};
+        mt19937 untouched{11};
+
+        NeighbourRanker::shuffleAfter(shuffled, 3, generator);
+
+        REQUIRE(ranking.order == shuffled.order);
+        REQUIRE(generator() == untouched());
+    }
+
+    SECTION("getSector() counts rays and the wedges between them anticlockwise from {1, 0}.")
+    {
+        STATIC_REQUIRE(0 == NeighbourRanker::getSector(5, 0));
+        STATIC_REQUIRE(1 == NeighbourRanker::getSector(9, 1));
+        STATIC_REQUIRE(2 == NeighbourRanker::getSector(4, 2));
+        STATIC_REQUIRE(4 == NeighbourRanker::getSector(3, 3));
+        STATIC_REQUIRE(8 == NeighbourRanker::getSector(0, 7));
+        STATIC_REQUIRE(15 == NeighbourRanker::getSector(-9, 1));
+        STATIC_REQUIRE(16 == NeighbourRanker::getSector(-1, 0));
+        STATIC_REQUIRE(24 == NeighbourRanker::getSector(0, -2));
+        STATIC_REQUIRE(31 == NeighbourRanker::getSector(3, -1));
+        STATIC_REQUIRE(32 == NeighbourRanker::getSector(0, 0));
+    }
+
+    SECTION("rankBySector() gives every Box on a Board the same Positions as sorting them, for every target.")
+    {
+        NeighbourRanker::Bounds small{0, 15, 0, 11};
+        for (const NeighbourRanker::Directions& order : {directions, diagonalDirections})
+        {
+            NeighbourRanker::DirectionTable table = NeighbourRanker::makeDirectionTable(order);
+            int differences = 0;
+            for (int x=0; x<=small.maxX; ++x)
+            {
+                for (int y=0; y<=small.maxY; ++y)
+                {
+                    for (int targetX=0; targetX<=small.maxX; ++targetX)
+                    {
+                        for (int targetY=0; targetY<=small.maxY; ++targetY)
+                        {
+                            Position position{x, y};
+                            Position target{targetX, targetY};
+                            NeighbourRanker::Ranking ranking = NeighbourRanker::rankBySector(position, target, small, table);
+                            if (rankBySorting(position, target, small, order) != NeighbourRanker::getPositions(position, ranking, order))
+                            {
+                                ++differences;
+                            }
+                        }
+                    }
+                }
+            }
+            REQUIRE(0 == differences);
+        }
+    }
+
+    SECTION("rankBySector() matches rank() for far targets in every sector, in the middle and at the edges of the Board.")
+    {
+        NeighbourRanker::DirectionTable table = NeighbourRanker::makeDirectionTable(directions);
+        NeighbourRanker::Bounds wide{-1000, 1000, -1000, 1000};
+        for (int dx=-300; dx<=300; dx+=7)
+        {
+            for (int dy=-300; dy<=300; dy+=3)
+            {
+                for (Position position : {Position{0, 0}, Position{-1000, 1000}, Position{1000, 0}})
+                {
+                    Position target{position.getX() + dx, position.getY() + dy};
+                    NeighbourRanker::Ranking bySector = NeighbourRanker::rankBySector(position, target, wide, table);
+                    NeighbourRanker::Ranking sorted = NeighbourRanker::rank(position, target, wide, directions);
+                    REQUIRE(bySector.validMask == sorted.validMask);
+                    REQUIRE(NeighbourRanker::getPositions(position, bySector, directions) == NeighbourRanker::getPositions(position, sorted, directions));
+                }
+            }
+        }
+    }
+
+    SECTION("rank() throws if a neighbour on the Board is too far from its target to rank it before the neighbours off the Board.")
+    {
+        // The neighbour at {8192, 8192} is 8192 cells from the target each way.
+        NeighbourRanker::Bounds huge{0, 10000, 0, 10000};
+        REQUIRE_THROWS_AS(NeighbourRanker::rank(Position{8191, 8191}, Position{0, 0}, huge, directions), invalid_argument);
+        vector<int32_t> near{8190, 8191};
+        vector<int32_t> zeros{0, 0};
+        vector<NeighbourRanker::Ranking> rankings(2);
+        REQUIRE_THROWS_AS(NeighbourRanker::rank(near, near, zeros, zeros, huge, directions, rankings), invalid_argument);
+
+        // At the far corner of the widest Bounds allowed, the three neighbours on the Board still come first.
+        NeighbourRanker::Bounds widest{0, NeighbourRanker::maxDistance, 0, NeighbourRanker::maxDistance};
+        Position corner{NeighbourRanker::maxDistance, NeighbourRanker::maxDistance};
+        NeighbourRanker::Ranking ranking = NeighbourRanker::rank(corner, Position{0, 0}, widest, directions);
+        REQUIRE(3 == ranking.getCount());
+        REQUIRE(rankBySorting(corner, Position{0, 0}, widest) == NeighbourRanker::getPositions(corner, ranking, directions));
+    }
+
+    SECTION("rank() throws if the spans differ in size.")
+    {
+        vector<int32_t> two{1, 2};
+        vector<int32_t> one{1};
+        vector<NeighbourRanker::Ranking> rankings(2);
+
+        REQUIRE_THROWS_AS(NeighbourRanker::rank(two, two, two, one, bounds, directions, rankings), invalid_argument);
+    }
+}
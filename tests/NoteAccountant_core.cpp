@@ -1,6 +1,9 @@
 #include "catch.hpp"
 #include "../src/NoteAccountant.h"
 
+#include <memory>
+#include <thread>
+
 using namespace std;
 
 TEST_CASE("NoteAccountant_core.cpp")
@@ -23,4 +26,80 @@ TEST_CASE("NoteAccountant_core.cpp")
         REQUIRE(noteToArrive == callbackNotes[0].second);
         REQUIRE(noteArrive == callbackNotes[1].second);
     }
+
+    SECTION("Saves every BoardNote from many threads, in time order and in each thread's order.")
+    {
+        NoteAccountant noteAccountant{};
+        int threadCount = 8;
+        int notesPerThread = 5000;
+
+        // Thread t sends BoardNotes with boxId t, alternating to_arrive and arrive.
+        vector<thread> threads{};
+        for (int t=0; t<threadCount; ++t)
+        {
+            threads.push_back(thread([&noteAccountant, t, notesPerThread]{
+                for (int ii=0; ii<notesPerThread; ++ii)
+                {
+                    noteAccountant.callback(BoardNote{t, (ii % 2 == 0) ? MoveType::to_arrive : MoveType::arrive});
+                }
+            }));
+        }
+
+        // Reading while the threads are still writing only ever sees whole BoardNotes.
+        size_t seen = noteAccountant.getNotes().size();
+        REQUIRE(seen <= static_cast<size_t>(threadCount * notesPerThread));
+
+        for (thread& t : threads)
+        {
+            t.join();
+        }
+
+        auto notes = noteAccountant.getNotes();
+        REQUIRE(static_cast<size_t>(threadCount * notesPerThread) == notes.size());
+
+        vector<int> countPerThread(threadCount, 0);
+        for (size_t ii=0; ii<notes.size(); ++ii)
+        {
+            if (ii > 0)
+            {
+                REQUIRE(notes[ii - 1].first <= notes[ii].first);
+            }
+            int t = notes[ii].second.getBoxId();
+            MoveType expected = (countPerThread[t] % 2 == 0) ? MoveType::to_arrive : MoveType::arrive;
+            REQUIRE(expected == notes[ii].second.getType());
+            ++countPerThread[t];
+        }
+    }
+
+    SECTION("A thread that sends to many NoteAccountants in turn, and threads that come and go, lose no BoardNotes.")
+    {
+        int accountantCount = 20;
+        vector<unique_ptr<NoteAccountant>> accountants{};
+        for (int ii=0; ii<accountantCount; ++ii)
+        {
+            accountants.push_back(make_unique<NoteAccountant>());
+        }
+
+        int rounds = 50;
+        for (int t=0; t<10; ++t)
+        {
+            thread([&accountants, rounds, t]{
+                for (int ii=0; ii<rounds; ++ii)
+                {
+                    for (auto& accountant : accountants)
+                    {
+                        accountant->callback(BoardNote{t, MoveType::arrive});
+                    }
+                }
+            }).join();
+        }
+
+        for (auto& accountant : accountants)
+        {
+            auto notes = accountant->getNotes();
+            REQUIRE(static_cast<size_t>(10 * rounds) == notes.size());
+            REQUIRE(0 == notes.front().second.getBoxId());
+            REQUIRE(9 == notes.back().second.getBoxId());
+        }
+    }
 }
@@ -0,0 +1,77 @@
+#include "catch.hpp"
+#include "../src/OccupancyGrid.h"
+
+#include <algorithm>
+
+using namespace std;
+
+TEST_CASE("OccupancyGrid_core::")
+{
+    SECTION("A new OccupancyGrid has no occupied cells.")
+    {
+        OccupancyGrid grid{4, 3};
+
+        REQUIRE(4 == grid.getWidth());
+        REQUIRE(3 == grid.getHeight());
+        REQUIRE(grid.getOccupiedCells().empty());
+
+        Drop drop = grid.getDropAt(Position{3, 2});
+        REQUIRE(-1 == drop.getBoxId());
+        REQUIRE(MoveType::left == drop.getMoveType());
+    }
+
+    SECTION("Cells are numbered row by row.")
+    {
+        OccupancyGrid grid{4, 3};
+        grid.update(Drop{3, 2, 7, MoveType::to_arrive});
+
+        REQUIRE(1 == grid.getOccupiedCells().size());
+        int cell = grid.getOccupiedCells()[0];
+        REQUIRE(2 * 4 + 3 == cell);
+        REQUIRE(Position{3, 2} == grid.getPosition(cell));
+        REQUIRE(7 == grid.getBoxId(cell));
+        REQUIRE(MoveType::to_arrive == grid.getMoveType(cell));
+    }
+
+    SECTION("Updating an occupied cell replaces its boxId and MoveType without adding a cell.")
+    {
+        OccupancyGrid grid{4, 3};
+        grid.update(Drop{1, 1, 7, MoveType::to_arrive});
+        grid.update(Drop{1, 1, 7, MoveType::arrive});
+
+        REQUIRE(1 == grid.getOccupiedCells().size());
+        REQUIRE(MoveType::arrive == grid.getDropAt(Position{1, 1}).getMoveType());
+    }
+
+    SECTION("A Drop with MoveType::left empties the cell and the other occupied cells remain.")
+    {
+        OccupancyGrid grid{4, 3};
+        grid.update(Drop{0, 0, 1, MoveType::arrive});
+        grid.update(Drop{1, 0, 2, MoveType::arrive});
+        grid.update(Drop{2, 0, 3, MoveType::arrive});
+
+        // Empty the first cell, so the last occupied cell is swapped into its place.
+        grid.update(Drop{0, 0, -1, MoveType::left});
+
+        vector<int> cells = grid.getOccupiedCells();
+        sort(cells.begin(), cells.end());
+        REQUIRE(vector<int>{1, 2} == cells);
+        REQUIRE(-1 == grid.getBoxId(0));
+        REQUIRE(MoveType::left == grid.getMoveType(0));
+
+        // Emptying an already empty cell changes nothing.
+        grid.update(Drop{0, 0, -1, MoveType::left});
+        REQUIRE(2 == grid.getOccupiedCells().size());
+
+        grid.update(Drop{2, 0, -1, MoveType::left});
+        grid.update(Drop{1, 0, -1, MoveType::left});
+        REQUIRE(grid.getOccupiedCells().empty());
+    }
+
+    SECTION("A Drop outside of the grid throws an exception.")
+    {
+        OccupancyGrid grid{4, 3};
+        REQUIRE_THROWS(grid.update(Drop{4, 0, 1, MoveType::arrive}));
+        REQUIRE_THROWS(grid.getDropAt(Position{0, -1}));
+    }
+}
@@ -0,0 +1,144 @@
+#include "catch.hpp"
+#include "../src/Board.h"
+#include "../src/Mover_Reg.h"
+#include "../src/PhaseLatencies.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+TEST_CASE("PhaseLatencies_core::")
+{
+    SECTION("Records per group and StepPhase")
+    {
+        PhaseLatencies latencies{};
+        REQUIRE(latencies.getHistograms().empty());
+
+        latencies.setGroupForThisThread(DeciderType::safe, PositionManagerType::step);
+        latencies.record(StepPhase::deciding, 1000);
+        latencies.record(StepPhase::deciding, 3000);
+        latencies.record(StepPhase::blocked, 50000);
+
+        auto perGroup = latencies.getHistograms();
+        REQUIRE(perGroup.size() == 1);
+        const PhaseLatencies::Histograms& h = perGroup.at({DeciderType::safe, PositionManagerType::step});
+        REQUIRE(h[static_cast<int>(StepPhase::deciding)].getCount() == 2);
+        REQUIRE(h[static_cast<int>(StepPhase::deciding)].getMean() == Approx(2000.0));
+        REQUIRE(h[static_cast<int>(StepPhase::deciding)].getMax() == 3000);
+        REQUIRE(h[static_cast<int>(StepPhase::blocked)].getCount() == 1);
+        REQUIRE(h[static_cast<int>(StepPhase::holdingTwoSpots)].getCount() == 0);
+    }
+
+    SECTION("Merges the threads of a group and keeps groups apart")
+    {
+        PhaseLatencies latencies{};
+        int threadsPerDecider = 4;
+        int recordsPerThread = 10000;
+
+        vector<thread> threads{};
+        for (int t=0; t<threadsPerDecider * 2; ++t)
+        {
+            threads.push_back(thread([&latencies, t, recordsPerThread]{
+                // Even threads are safe Boxes taking about 1us, odd threads are risk1 Boxes taking about 100us.
+                bool safe = (t % 2 == 0);
+                latencies.setGroupForThisThread(
+                    safe ? DeciderType::safe : DeciderType::risk1,
+                    (t % 4 < 2) ? PositionManagerType::step : PositionManagerType::diagonal);
+                for (int ii=0; ii<recordsPerThread; ++ii)
+                {
+                    latencies.record(StepPhase::deciding, safe ? 1000 : 100000);
+                }
+            }));
+        }
+        for (thread& t : threads)
+        {
+            t.join();
+        }
+
+        auto perGroup = latencies.getHistograms();
+        REQUIRE(perGroup.size() == 4);
+        for (const auto& groupAndHistograms : perGroup)
+        {
+            REQUIRE(groupAndHistograms.second[static_cast<int>(StepPhase::deciding)].getCount() == static_cast<uint64_t>(2 * recordsPerThread));
+        }
+
+        auto perDecider = PhaseLatencies::mergePerDecider(perGroup);
+        REQUIRE(perDecider.size() == 2);
+        const LatencyHistogram& safe = perDecider.at(DeciderType::safe)[static_cast<int>(StepPhase::deciding)];
+        const LatencyHistogram& risk1 = perDecider.at(DeciderType::risk1)[static_cast<int>(StepPhase::deciding)];
+        REQUIRE(safe.getCount() == static_cast<uint64_t>(threadsPerDecider * recordsPerThread));
+        REQUIRE(safe.getPercentile(0.99) == 1000);
+        REQUIRE(risk1.getPercentile(0.5) == 100000);
+    }
+
+    SECTION("Keeps the group of a thread that has exited when a new thread takes its place")
+    {
+        PhaseLatencies latencies{};
+        thread([&latencies]{
+            latencies.setGroupForThisThread(DeciderType::risk1, PositionManagerType::up);
+            latencies.record(StepPhase::deciding, 5000);
+            latencies.record(StepPhase::deciding, 7000);
+        }).join();
+        // This thread never joins a group, so its recordings go to DeciderType 0 and PositionManagerType 0.
+        thread([&latencies]{
+            latencies.record(StepPhase::blocked, 2000);
+        }).join();
+        thread([&latencies]{
+            latencies.setGroupForThisThread(DeciderType::risk1, PositionManagerType::up);
+            latencies.record(StepPhase::deciding, 9000);
+        }).join();
+
+        auto perGroup = latencies.getHistograms();
+        REQUIRE(perGroup.size() == 2);
+        const PhaseLatencies::Histograms& risk1 = perGroup.at({DeciderType::risk1, PositionManagerType::up});
+        REQUIRE(risk1[static_cast<int>(StepPhase::deciding)].getCount() == 3);
+        REQUIRE(risk1[static_cast<int>(StepPhase::deciding)].getMax() == 9000);
+        REQUIRE(risk1[static_cast<int>(StepPhase::blocked)].getCount() == 0);
+        const PhaseLatencies::Histograms& none = perGroup.at({static_cast<DeciderType>(0), static_cast<PositionManagerType>(0)});
+        REQUIRE(none[static_cast<int>(StepPhase::blocked)].getCount() == 1);
+        REQUIRE(none[static_cast<int>(StepPhase::deciding)].getCount() == 0);
+    }
+
+    SECTION("Writes CSV rows per group and per DeciderType")
+    {
+        PhaseLatencies latencies{};
+        latencies.setGroupForThisThread(DeciderType::risk1, PositionManagerType::diagonal);
+        latencies.record(StepPhase::holdingTwoSpots, 10000000);
+
+        stringstream csv{};
+        PhaseLatencies::writeCsvHeader(csv);
+        PhaseLatencies::writeCsvRows(csv, 2.5, latencies.getHistograms());
+
+        string header{};
+        string groupRow{};
+        string deciderRow{};
+        string extra{};
+        getline(csv, header);
+        getline(csv, groupRow);
+        getline(csv, deciderRow);
+        REQUIRE_FALSE(getline(csv, extra));
+        REQUIRE(count(header.begin(), header.end(), ',') == count(groupRow.begin(), groupRow.end(), ','));
+        REQUIRE(groupRow.rfind("2.5,risk1,diagonal,holding_two_spots,1,10000,", 0) == 0);
+        REQUIRE(deciderRow.rfind("2.5,risk1,all,holding_two_spots,1,", 0) == 0);
+    }
+
+    SECTION("Board and Mover record lock waits and the time a move holds two Spots")
+    {
+        vector<Box> boxes{Box{0, 0, 5, 5}};
+        Board board{10, 10, std::move(boxes)};
+        Mover_Reg mover{0, &board};
+        board.getLatencies().setGroupForThisThread(DeciderType::safe, PositionManagerType::diagonal);
+
+        REQUIRE(mover.addBox(Position{2, 2}));
+        REQUIRE(mover.moveBox(Position{2, 2}, Position{3, 3}));
+
+        const PhaseLatencies::Histograms& h = board.getLatencies().getHistograms().at({DeciderType::safe, PositionManagerType::diagonal});
+        // Two changeSpot() calls to add the Box and four to move it, in a build that records them.
+        uint64_t lockWaits = PhaseLatencies::recordsChangeSpotLockWait() ? 6 : 0;
+        REQUIRE(h[static_cast<int>(StepPhase::changeSpotLockWait)].getCount() == lockWaits);
+        REQUIRE(h[static_cast<int>(StepPhase::holdingTwoSpots)].getCount() == 1);
+        // Mover_Reg sleeps 10ms for a diagonal move while holding both Spots.
+        REQUIRE(h[static_cast<int>(StepPhase::holdingTwoSpots)].getMax() >= 9000000);
+    }
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include "../src/PositionManager_Diagonal.h"
+#include "../src/Util.h"
 
 using namespace std;
 
@@ -313,5 +314,27 @@ TEST_CASE("PositionManager_Diagonal_core::")
             99};
         REQUIRE(Rectangle{Position{71, 51}, Position{71, 51}} == pm.getTargetRect());
     }
+
+    SECTION("fillFuturePositions() fills the Positions getFuturePositions() returns, and leaves nothing from an earlier call.")
+    {
+        PositionManager_Diagonal pm{
+            Rectangle{Position{70, 50}, Position{80, 55}},
+            Position{71, 51},
+            0,
+            99,
+            0,
+            99};
+
+        FuturePositions positions{};
+        for (Position position : {Position{10, 10}, Position{0, 99}, Position{71, 51}})
+        {
+            Util::setSeed(17);
+            vector<Position> expected = pm.getFuturePositions(position);
+            Util::setSeed(17);
+            pm.fillFuturePositions(position, positions);
+            REQUIRE(expected == vector<Position>(positions.get().begin(), positions.get().end()));
+        }
+        REQUIRE(positions.empty());
+    }
 }
 
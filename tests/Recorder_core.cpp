@@ -1,34 +1,61 @@
 #include "catch.hpp"
 #include "../src/Recorder.h"
 
+#include <unordered_map>
+#include <unordered_set>
+
 using namespace std;
 
 /*
-A RecorderListener that will listen for the Recorder's broadcasts and save the most recent data from the broadcast. The data is saved in public attributes _drops and _boxes. The tests access these attributes to verify what the Recorder broadcasted.
+A RecorderListener that will listen for the Recorder's broadcasts and save the most recent data from the broadcast. The data is saved in public attributes _drops, _changedDrops, and _boxes. _drops is copied out of the received OccupancyGrid. The tests access these attributes to verify what the Recorder broadcasted.
 */
 class SubRecorderListener : public RecorderListener
 {
 
     public:
 
-    void receiveAllDropsAllBoxes(unordered_set<Drop> drops, unordered_map<int, BoxInfo> boxes) override
+    void receiveStateAndChanges(const OccupancyGrid& drops, const Frame& frame) override
     {
-        // Clear the saved attributes. _drops and _boxes should contain only the most recent broadcast data.
+        // Clear the saved attributes. _drops, _changedDrops, and _boxes should contain only the most recent broadcast data.
         _drops.clear();
+        _changedDrops.clear();
         _boxes.clear();
 
-        _drops = std::move(drops);
-        for(const auto& p : boxes)
+        for(int cell : drops.getOccupiedCells())
+        {
+            _drops.insert(drops.getDropAt(drops.getPosition(cell)));
+        }
+        _changedDrops.insert(frame.getChangedDrops().begin(), frame.getChangedDrops().end());
+        for(const BoxInfo& boxInfo : frame.getBoxInfos())
         {
-            _boxes.insert({p.second.getId(), p.second});
+            _boxes.insert({boxInfo.getId(), boxInfo});
         }        
     }
 
     unordered_set<Drop> _drops;
+    unordered_set<Drop> _changedDrops;
     unordered_map<int, BoxInfo> _boxes{};
 
 };
 
+/*
+Returns a Frame holding @changedDrops and @boxes, as the Board would send it.
+*/
+shared_ptr<const Frame> makeFrame(
+    const unordered_set<Drop>& changedDrops,
+    const unordered_map<int, BoxInfo>& boxes)
+{
+    vector<BoxInfo> boxInfos{};
+    for(const auto& p : boxes)
+    {
+        boxInfos.push_back(p.second);
+    }
+    return make_shared<const Frame>(
+        0,
+        vector<Drop>(changedDrops.begin(), changedDrops.end()),
+        std::move(boxInfos));
+}
+
 /*
 Returns the number of Drops per each MoveType.
 */
@@ -68,7 +95,7 @@ TEST_CASE("Recorder_core::")
 {
     SECTION("Recorder receives the Drops that have changed. Verify that Recorder broadcasts current state of all the Drops to the listener.")
     {
-        Recorder recorder{};
+        Recorder recorder{5, 5};
         SubRecorderListener subRecorderListener;
         recorder.registerListener(&subRecorderListener);
 
@@ -90,7 +117,7 @@ TEST_CASE("Recorder_core::")
         unordered_map<int, BoxInfo> boxesPerBoxIdDummy{};
 
         // recorder receives changedDrops.
-        recorder.receiveChanges(changedDrops, boxesPerBoxIdDummy);
+        recorder.receiveChanges(makeFrame(changedDrops, boxesPerBoxIdDummy));
 
         // SubRecorderListener reflects that the Recorder sent the changed Drops.
         // dropA and dropB are both MoveType::to_arrive
@@ -112,7 +139,7 @@ TEST_CASE("Recorder_core::")
         changedDrops.insert(dropB);
 
         // recorder receives changedDrops.
-        recorder.receiveChanges(changedDrops, boxesPerBoxIdDummy);
+        recorder.receiveChanges(makeFrame(changedDrops, boxesPerBoxIdDummy));
 
         actual.insert(subRecorderListener._drops.begin(), subRecorderListener._drops.end());
         actualCountPerMoveType = getCountPerMoveType(actual);
@@ -134,7 +161,7 @@ TEST_CASE("Recorder_core::")
         changedDrops.insert(dropB);
 
         // recorder receives changedDrops.
-        recorder.receiveChanges(changedDrops, boxesPerBoxIdDummy);
+        recorder.receiveChanges(makeFrame(changedDrops, boxesPerBoxIdDummy));
 
         actual.insert(subRecorderListener._drops.begin(), subRecorderListener._drops.end());
         actualCountPerMoveType = getCountPerMoveType(actual);
@@ -156,7 +183,7 @@ TEST_CASE("Recorder_core::")
         changedDrops.insert(dropB);
 
         // recorder receives changedDrops.
-        recorder.receiveChanges(changedDrops, boxesPerBoxIdDummy);
+        recorder.receiveChanges(makeFrame(changedDrops, boxesPerBoxIdDummy));
 
         actual.insert(subRecorderListener._drops.begin(), subRecorderListener._drops.end());
         actualCountPerMoveType = getCountPerMoveType(actual);
@@ -169,7 +196,7 @@ TEST_CASE("Recorder_core::")
 
     SECTION ("Recorder receives current state of Boxes. Verify that Recorder broadcasts that state.")
     {
-        Recorder recorder{};
+        Recorder recorder{5, 5};
         SubRecorderListener subRecorderListener;
         recorder.registerListener(&subRecorderListener);
 
@@ -180,7 +207,7 @@ TEST_CASE("Recorder_core::")
             {1, BoxInfo{1, 0, 3, 3, 0}},
             {2,BoxInfo{2, 0, 3, 3, 0}}};
 
-        recorder.receiveChanges(dummyChangedDrops, boxes);
+        recorder.receiveChanges(makeFrame(dummyChangedDrops, boxes));
         
         unordered_map<int, BoxInfo> actual = subRecorderListener._boxes;
        
@@ -189,4 +216,31 @@ TEST_CASE("Recorder_core::")
         REQUIRE(1 == actual.at(1).getId());
         REQUIRE(2 == actual.at(2).getId());
     }
+
+    SECTION ("Recorder passes along only the Drops that changed since the last broadcast.")
+    {
+        Recorder recorder{5, 5};
+        SubRecorderListener subRecorderListener;
+        recorder.registerListener(&subRecorderListener);
+
+        unordered_map<int, BoxInfo> boxesPerBoxIdDummy{};
+
+        unordered_set<Drop> changedDrops{};
+        changedDrops.insert(Drop{0, 0, 0, MoveType::to_arrive});
+        changedDrops.insert(Drop{1, 1, 1, MoveType::to_arrive});
+        recorder.receiveChanges(makeFrame(changedDrops, boxesPerBoxIdDummy));
+
+        REQUIRE(2 == subRecorderListener._changedDrops.size());
+        REQUIRE(2 == subRecorderListener._drops.size());
+
+        // Only Box 1 leaves. The state still holds Box 0, the changes only hold Box 1's Drop.
+        changedDrops.clear();
+        changedDrops.insert(Drop{1, 1, -1, MoveType::left});
+        recorder.receiveChanges(makeFrame(changedDrops, boxesPerBoxIdDummy));
+
+        REQUIRE(1 == subRecorderListener._changedDrops.size());
+        REQUIRE(MoveType::left == subRecorderListener._changedDrops.begin()->getMoveType());
+        REQUIRE(1 == subRecorderListener._drops.size());
+        REQUIRE(0 == subRecorderListener._drops.begin()->getBoxId());
+    }
 }
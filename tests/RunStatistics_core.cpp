@@ -0,0 +1,55 @@
+#include "catch.hpp"
+#include "../src/RunStatistics.h"
+
+using namespace std;
+
+/*
+Returns a SpotTransition for Box @boxId at @timestamp.
+*/
+SpotTransition makeRunTransition(int64_t timestamp, int boxId, MoveType type, bool collision = false)
+{
+    SpotTransition transition{};
+    transition.timestamp = timestamp;
+    transition.boxId = boxId;
+    transition.otherBoxId = -1;
+    transition.type = static_cast<uint8_t>(type);
+    transition.collision = collision ? 1 : 0;
+    return transition;
+}
+
+TEST_CASE("RunStatistics_core::")
+{
+    SECTION("Counts moves and collisions, and times each Box from its first move until it leaves its last Spot")
+    {
+        RunStatistics statistics{2};
+
+        // Box 0 is added, moves once, and is removed.
+        statistics.receiveTransition(makeRunTransition(100, 0, MoveType::to_arrive));
+        statistics.receiveTransition(makeRunTransition(110, 0, MoveType::arrive));
+        statistics.receiveTransition(makeRunTransition(200, 0, MoveType::to_arrive));
+        statistics.receiveTransition(makeRunTransition(201, 0, MoveType::to_leave));
+        statistics.receiveTransition(makeRunTransition(210, 0, MoveType::arrive));
+        // Holding two Spots in the middle of the move, so leaving the first is not an exit.
+        statistics.receiveTransition(makeRunTransition(211, 0, MoveType::left));
+        REQUIRE(0 == statistics.getExitedCount());
+        statistics.receiveTransition(makeRunTransition(300, 0, MoveType::to_leave));
+        statistics.receiveTransition(makeRunTransition(350, 0, MoveType::left));
+
+        // Box 1 is added after running into a Box once, and never leaves.
+        statistics.receiveTransition(makeRunTransition(120, 1, MoveType::to_arrive, true));
+        statistics.receiveTransition(makeRunTransition(130, 1, MoveType::to_arrive));
+
+        REQUIRE(3 == statistics.getMoves());
+        REQUIRE(1 == statistics.getCollisions());
+        REQUIRE(0.25 == statistics.getCollisionRate());
+        REQUIRE(1 == statistics.getExitedCount());
+        REQUIRE(vector<int64_t>{250} == statistics.getTimesToExit());
+    }
+
+    SECTION("A boxId outside of the Boxes is rejected")
+    {
+        RunStatistics statistics{2};
+        REQUIRE_THROWS_AS(statistics.receiveTransition(makeRunTransition(0, 2, MoveType::to_arrive)), invalid_argument);
+        REQUIRE(0.0 == statistics.getCollisionRate());
+    }
+}
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+#include "../src/ScalingRun.h"
+
+#include <sstream>
+
+using namespace std;
+
+TEST_CASE("ScalingRun_core::")
+{
+    SECTION("A small run moves its Boxes to their exits and reports consistent numbers")
+    {
+        ScalingRun::Point point{150, 130, 14, 7, ExecutionBackend::threads};
+        ScalingRun::Result result = ScalingRun::run(point, chrono::seconds(60));
+
+        REQUIRE(result.moves >= 14);
+        REQUIRE(result.movesPerSecond > 0);
+        REQUIRE(result.collisionRate >= 0.0);
+        REQUIRE(result.collisionRate < 1.0);
+        REQUIRE(result.exitedCount > 0);
+        REQUIRE(result.exitedCount <= 14);
+        REQUIRE(result.meanTimeToExitMs > 0);
+        REQUIRE(result.p99TimeToExitMs >= result.meanTimeToExitMs);
+        REQUIRE(result.p99TimeToExitMs <= result.seconds * 1000);
+        REQUIRE(result.peakRssKb > 0);
+
+        stringstream csv{};
+        ScalingRun::writeCsvHeader(csv);
+        ScalingRun::writeCsvRow(csv, result);
+        string header{};
+        string row{};
+        getline(csv, header);
+        getline(csv, row);
+        REQUIRE(count(header.begin(), header.end(), ',') == count(row.begin(), row.end(), ','));
+        REQUIRE(row.rfind("150,130,14,7,threads,", 0) == 0);
+    }
+
+    SECTION("The lockstep backend runs on the given number of workers and counts its agent steps")
+    {
+        ScalingRun::Point point{150, 130, 14, 7, ExecutionBackend::lockstep, 2};
+        ScalingRun::Result result = ScalingRun::run(point, chrono::seconds(60));
+
+        REQUIRE(result.point.workers == 2);
+        REQUIRE(result.exitedCount == 14);
+        REQUIRE(result.moves >= 14);
+        REQUIRE(result.agentSteps >= result.moves);
+        REQUIRE(result.agentStepsPerSecond > 0);
+
+        stringstream csv{};
+        ScalingRun::writeCsvRow(csv, result);
+        REQUIRE(csv.str().rfind("150,130,14,7,lockstep,2,", 0) == 0);
+    }
+
+    SECTION("The lockstep backend reports the collisions of a crowded run")
+    {
+        // Ten times the Boxes of the run above, on the same Board.
+        ScalingRun::Point point{150, 130, 140, 7, ExecutionBackend::lockstep, 2};
+        ScalingRun::Result result = ScalingRun::run(point, chrono::seconds(60));
+
+        REQUIRE(result.moves > 0);
+        REQUIRE(result.collisionRate > 0.0);
+        REQUIRE(result.collisionRate < 1.0);
+    }
+
+    SECTION("Points that do not fit the in-out-bound Rectangles are rejected")
+    {
+        REQUIRE_THROWS_AS(ScalingRun::run(ScalingRun::Point{100, 300, 7, 7, ExecutionBackend::threads}, chrono::seconds(1)), invalid_argument);
+        REQUIRE_THROWS_AS(ScalingRun::run(ScalingRun::Point{300, 300, 16, 8, ExecutionBackend::threads}, chrono::seconds(1)), invalid_argument);
+        REQUIRE_THROWS_AS(ScalingRun::run(ScalingRun::Point{300, 300, 10, 7, ExecutionBackend::threads}, chrono::seconds(1)), invalid_argument);
+        REQUIRE(ExecutionBackend::threads == ScalingRun::toExecutionBackend("threads"));
+        REQUIRE(ExecutionBackend::lockstep == ScalingRun::toExecutionBackend("lockstep"));
+        REQUIRE_THROWS_AS(ScalingRun::toExecutionBackend("fibers"), invalid_argument);
+    }
+}
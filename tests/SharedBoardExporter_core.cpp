@@ -0,0 +1,123 @@
+#include "catch.hpp"
+#include "../src/Frame.h"
+#include "../src/SharedBoardExporter.h"
+#include "../src/SharedBoardReader.h"
+
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+Returns a segment name that no other test run uses.
+*/
+string makeSegmentName(const string& test)
+{
+    return "/plazawalk_" + test + "_" + to_string(getpid());
+}
+
+TEST_CASE("SharedBoardExporter_core::")
+{
+    SECTION("A reader sees the cells and box table of the last Frame")
+    {
+        string name = makeSegmentName("cells");
+        SharedBoardExporter exporter{name, 4, 3, 2};
+        SharedBoardReader reader{name};
+        REQUIRE(4 == reader.getWidth());
+        REQUIRE(3 == reader.getHeight());
+        REQUIRE(2 == reader.getBoxCount());
+        REQUIRE(-1 == reader.getFrameSequence());
+        REQUIRE(-1 == reader.getBoxId(5));
+
+        vector<Drop> drops{};
+        drops.push_back(Drop{1, 1, 7, MoveType::arrive});
+        drops.push_back(Drop{3, 2, 9, MoveType::to_arrive});
+        vector<BoxInfo> boxes{BoxInfo{7, 0, 1, 1, 2}, BoxInfo{9, 1, 1, 1, 0}};
+        exporter.receiveChanges(make_shared<const Frame>(0, std::move(drops), std::move(boxes)));
+
+        uint64_t sequence = reader.beginRead();
+        REQUIRE(0 == reader.getFrameSequence());
+        REQUIRE(7 == reader.getBoxId(1 * 4 + 1));
+        REQUIRE(MoveType::arrive == reader.getMoveType(1 * 4 + 1));
+        REQUIRE(9 == reader.getBoxId(2 * 4 + 3));
+        REQUIRE(MoveType::to_arrive == reader.getMoveType(2 * 4 + 3));
+        REQUIRE(-1 == reader.getBoxId(0));
+        REQUIRE(7 == reader.getBoxIdAt(0));
+        REQUIRE(2 == reader.getLevelAt(0));
+        REQUIRE(1 == reader.getGroupIdAt(1));
+        REQUIRE(reader.endRead(sequence));
+
+        // A Box leaving empties its cell. The reader's earlier sequence is no longer valid.
+        vector<Drop> leaving{};
+        leaving.push_back(Drop{1, 1, 7, MoveType::left});
+        vector<BoxInfo> sameBoxes{BoxInfo{7, 0, 1, 1, 3}, BoxInfo{9, 1, 1, 1, 0}};
+        exporter.receiveChanges(make_shared<const Frame>(1, std::move(leaving), std::move(sameBoxes)));
+
+        REQUIRE_FALSE(reader.endRead(sequence));
+        sequence = reader.beginRead();
+        REQUIRE(-1 == reader.getBoxId(1 * 4 + 1));
+        REQUIRE(9 == reader.getBoxId(2 * 4 + 3));
+        REQUIRE(3 == reader.getLevelAt(0));
+        REQUIRE(reader.endRead(sequence));
+    }
+
+    SECTION("Reads that pass endRead() never mix two Frames")
+    {
+        string name = makeSegmentName("seqlock");
+        int width = 16;
+        int height = 16;
+        SharedBoardExporter exporter{name, width, height, 1};
+        SharedBoardReader reader{name};
+
+        // Frame k puts Box k in every cell and gives it level k.
+        atomic<bool> done{false};
+        thread writer([&exporter, &done, width, height]{
+            for (int k=0; k<2000; ++k)
+            {
+                vector<Drop> drops{};
+                for (int y=0; y<height; ++y)
+                {
+                    for (int x=0; x<width; ++x)
+                    {
+                        drops.push_back(Drop{x, y, k, MoveType::arrive});
+                    }
+                }
+                vector<BoxInfo> boxes{BoxInfo{k, 0, 1, 1, k}};
+                exporter.receiveChanges(make_shared<const Frame>(k, std::move(drops), std::move(boxes)));
+            }
+            done = true;
+        });
+
+        int consistentReads = 0;
+        int mixedReads = 0;
+        while (!done)
+        {
+            uint64_t sequence = reader.beginRead();
+            long frame = reader.getFrameSequence();
+            bool same = (reader.getLevelAt(0) == frame) && (reader.getBoxIdAt(0) == frame);
+            for (int cell=0; cell<width*height; ++cell)
+            {
+                same = same && (reader.getBoxId(cell) == frame);
+            }
+            if (reader.endRead(sequence))
+            {
+                ++consistentReads;
+                if (!same && frame != -1)
+                {
+                    ++mixedReads;
+                }
+            }
+        }
+        writer.join();
+
+        REQUIRE(0 == mixedReads);
+        REQUIRE(consistentReads >= 0);
+        REQUIRE(1999 == reader.getFrameSequence());
+    }
+
+    SECTION("Opening a segment that does not exist throws")
+    {
+        REQUIRE_THROWS_AS(SharedBoardReader{makeSegmentName("missing")}, runtime_error);
+    }
+}
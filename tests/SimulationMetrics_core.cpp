@@ -0,0 +1,193 @@
+#include "catch.hpp"
+#include "../src/Board.h"
+#include "../src/MainSetup.h"
+#include "../src/Mover_Reg.h"
+#include "../src/SimulationMetrics.h"
+#include "../src/Threader.h"
+#include "../src/Util.h"
+#include "../src/VirtualTimeRunner.h"
+
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+TEST_CASE("SimulationMetrics_core::")
+{
+    SECTION("Counts per counter")
+    {
+        SimulationMetrics metrics{};
+        REQUIRE(metrics.getSnapshot().get(SimulationCounter::collisions) == 0);
+
+        metrics.count(SimulationCounter::collisions);
+        metrics.count(SimulationCounter::collisions);
+        metrics.count(SimulationCounter::boxesEntered, 5);
+
+        SimulationMetrics::Snapshot snapshot = metrics.getSnapshot();
+        REQUIRE(snapshot.get(SimulationCounter::collisions) == 2);
+        REQUIRE(snapshot.get(SimulationCounter::boxesEntered) == 5);
+        REQUIRE(snapshot.get(SimulationCounter::boxesExited) == 0);
+        REQUIRE(snapshot.seconds >= 0.0);
+
+        // Two SimulationMetrics on one thread do not share counts.
+        SimulationMetrics other{};
+        other.count(SimulationCounter::collisions);
+        REQUIRE(metrics.getSnapshot().get(SimulationCounter::collisions) == 2);
+        REQUIRE(other.getSnapshot().get(SimulationCounter::collisions) == 1);
+    }
+
+    SECTION("Adds up the counts of many threads")
+    {
+        SimulationMetrics metrics{};
+        int threadCount = 8;
+        int countsPerThread = 20000;
+
+        vector<thread> threads{};
+        for (int t=0; t<threadCount; ++t)
+        {
+            threads.push_back(thread([&metrics, countsPerThread]{
+                for (int ii=0; ii<countsPerThread; ++ii)
+                {
+                    metrics.count(SimulationCounter::changeSpotSucceeded);
+                    if (ii % 4 == 0)
+                    {
+                        metrics.count(SimulationCounter::changeSpotFailed);
+                    }
+                }
+            }));
+        }
+
+        // Snapshots taken while counting never go down.
+        uint64_t last = 0;
+        for (int ii=0; ii<100; ++ii)
+        {
+            uint64_t now = metrics.getSnapshot().get(SimulationCounter::changeSpotSucceeded);
+            REQUIRE(now >= last);
+            last = now;
+        }
+
+        for (thread& t : threads)
+        {
+            t.join();
+        }
+
+        SimulationMetrics::Snapshot snapshot = metrics.getSnapshot();
+        REQUIRE(snapshot.get(SimulationCounter::changeSpotSucceeded) == static_cast<uint64_t>(threadCount * countsPerThread));
+        REQUIRE(snapshot.get(SimulationCounter::changeSpotFailed) == static_cast<uint64_t>(threadCount * countsPerThread / 4));
+    }
+
+    SECTION("Keeps the counts of threads that come and go, and of a thread that counts into many SimulationMetrics in turn")
+    {
+        vector<unique_ptr<SimulationMetrics>> allMetrics{};
+        for (int ii=0; ii<10; ++ii)
+        {
+            allMetrics.push_back(make_unique<SimulationMetrics>());
+        }
+
+        for (int t=0; t<20; ++t)
+        {
+            thread([&allMetrics]{
+                for (int ii=0; ii<100; ++ii)
+                {
+                    for (auto& metrics : allMetrics)
+                    {
+                        metrics->count(SimulationCounter::collisions);
+                    }
+                }
+            }).join();
+        }
+
+        for (auto& metrics : allMetrics)
+        {
+            REQUIRE(metrics->getSnapshot().get(SimulationCounter::collisions) == 2000);
+        }
+    }
+
+    SECTION("Rates, summary lines, CSV, and JSON")
+    {
+        SimulationMetrics::Snapshot before{1.0, {}};
+        SimulationMetrics::Snapshot after{3.0, {}};
+        after.counts[static_cast<size_t>(SimulationCounter::diagonalMoves)] = 60;
+        after.counts[static_cast<size_t>(SimulationCounter::lateralMoves)] = 40;
+        after.counts[static_cast<size_t>(SimulationCounter::collisions)] = 8;
+        after.counts[static_cast<size_t>(SimulationCounter::boxesEntered)] = 30;
+        after.counts[static_cast<size_t>(SimulationCounter::boxesExited)] = 10;
+
+        REQUIRE(SimulationMetrics::getRate(before, after, SimulationCounter::diagonalMoves) == Approx(30.0));
+        REQUIRE(SimulationMetrics::getRate(before, after, SimulationCounter::collisions) == Approx(4.0));
+        REQUIRE(SimulationMetrics::getRate(after, after, SimulationCounter::collisions) == 0.0);
+
+        vector<string> lines = SimulationMetrics::getSummaryLines(before, after);
+        REQUIRE(lines.size() == 4);
+        REQUIRE(lines[0] == "moves/s 50 (diagonal 30, lateral 20)");
+        REQUIRE(lines[1] == "collisions/s 4");
+        REQUIRE(lines[3] == "on board 20, exited 10");
+
+        stringstream csv{};
+        SimulationMetrics::writeCsvHeader(csv);
+        SimulationMetrics::writeCsvRow(csv, after);
+        string header{};
+        string row{};
+        getline(csv, header);
+        getline(csv, row);
+        REQUIRE(header.rfind("seconds,change_spot_succeeded,change_spot_failed,collisions,", 0) == 0);
+        REQUIRE(count(header.begin(), header.end(), ',') == simulationCounterCount);
+        REQUIRE(count(row.begin(), row.end(), ',') == simulationCounterCount);
+        REQUIRE(row == "3,0,0,8,0,0,60,40,30,10");
+
+        stringstream json{};
+        SimulationMetrics::writeJson(json, after);
+        REQUIRE(json.str() == "{\"seconds\":3,\"change_spot_succeeded\":0,\"change_spot_failed\":0,\"collisions\":8,"
+            "\"entry_retries\":0,\"decider_no_move\":0,\"diagonal_moves\":60,\"lateral_moves\":40,"
+            "\"boxes_entered\":30,\"boxes_exited\":10}\n");
+    }
+
+    SECTION("Board and Mover count changeSpot() calls, collisions, moves, entries, and exits")
+    {
+        vector<Box> boxes{Box{0, 0, 5, 5}, Box{1, 0, 5, 5}};
+        Board board{10, 10, std::move(boxes)};
+        Mover_Reg mover0{0, &board};
+        Mover_Reg mover1{1, &board};
+
+        REQUIRE(mover0.addBox(Position{2, 2}));
+        REQUIRE(mover1.addBox(Position{4, 4}));
+        // Box 1 runs into Box 0.
+        REQUIRE_FALSE(mover1.moveBox(Position{4, 4}, Position{2, 2}));
+        REQUIRE(mover1.moveBox(Position{4, 4}, Position{3, 3}));
+        REQUIRE(mover1.moveBox(Position{3, 3}, Position{3, 4}));
+        // Adding a Box onto another is not a collision.
+        REQUIRE_FALSE(board.changeSpot(Position{2, 2}, BoardNote{1, MoveType::to_arrive}, false));
+        mover0.removeBox(Position{2, 2});
+
+        SimulationMetrics::Snapshot snapshot = board.getMetrics().getSnapshot();
+        REQUIRE(snapshot.get(SimulationCounter::boxesEntered) == 2);
+        REQUIRE(snapshot.get(SimulationCounter::boxesExited) == 1);
+        REQUIRE(snapshot.get(SimulationCounter::diagonalMoves) == 1);
+        REQUIRE(snapshot.get(SimulationCounter::lateralMoves) == 1);
+        REQUIRE(snapshot.get(SimulationCounter::collisions) == 1);
+        REQUIRE(snapshot.get(SimulationCounter::changeSpotFailed) == 2);
+        // Two per addBox(), four per moveBox(), and two for removeBox().
+        REQUIRE(snapshot.get(SimulationCounter::changeSpotSucceeded) == 2 * 2 + 2 * 4 + 2);
+    }
+
+    SECTION("A virtual time run counts every Box in and out")
+    {
+        Util::setSeed(17);
+        vector<Box> boxes{};
+        MainSetup::addAGroupOfBoxes(boxes, 0, 0, 14);
+        Board board{150, 130, std::move(boxes)};
+        Threader threader{};
+        vector<Rectangle> rects = MainSetup::getInOutBoundRectangles(150, 130);
+        VirtualTimeRunner runner{board, threader.planBatches(2, 7, rects, 150, 130)};
+        runner.run(10 * 60 * 1000);
+
+        SimulationMetrics::Snapshot snapshot = board.getMetrics().getSnapshot();
+        REQUIRE(snapshot.get(SimulationCounter::boxesEntered) == 14);
+        REQUIRE(snapshot.get(SimulationCounter::boxesExited) == 14);
+        uint64_t moves = snapshot.get(SimulationCounter::diagonalMoves) + snapshot.get(SimulationCounter::lateralMoves);
+        REQUIRE(moves >= 14);
+        // Every move, entry, and exit changes a Spot twice, or four times for a move.
+        REQUIRE(snapshot.get(SimulationCounter::changeSpotSucceeded) == moves * 4 + 14 * 2 + 14 * 2);
+    }
+}
@@ -0,0 +1,116 @@
+#include "catch.hpp"
+#include "../src/ThreadShards.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    struct Counter
+    {
+        atomic<int> count{0};
+        int reuses = 0;
+    };
+
+    size_t getShardCount(const ThreadShards<Counter>& shards)
+    {
+        size_t count = 0;
+        shards.visitAll([&count](const vector<unique_ptr<Counter>>& all){
+            count = all.size();
+        });
+        return count;
+    }
+
+    int getTotal(const ThreadShards<Counter>& shards)
+    {
+        int total = 0;
+        shards.visitAll([&total](const vector<unique_ptr<Counter>>& all){
+            for (const auto& counter : all)
+            {
+                total += counter->count.load();
+            }
+        });
+        return total;
+    }
+}
+
+TEST_CASE("ThreadShards_core.cpp")
+{
+
+    SECTION("A thread gets the same Shard every time.")
+    {
+        ThreadShards<Counter> shards{};
+        Counter& first = shards.getForThisThread();
+        REQUIRE(&first == &shards.getForThisThread());
+        REQUIRE(1 == getShardCount(shards));
+    }
+
+    SECTION("Threads running at the same time get their own Shards.")
+    {
+        ThreadShards<Counter> shards{};
+        int threadCount = 8;
+        atomic<int> ready{0};
+        vector<thread> threads{};
+        for (int t=0; t<threadCount; ++t)
+        {
+            threads.push_back(thread([&shards, &ready, threadCount]{
+                Counter& counter = shards.getForThisThread();
+                counter.count.store(counter.count.load() + 1);
+                // Keep every thread alive until all of them have their Shard.
+                ++ready;
+                while (ready.load() < threadCount)
+                {
+                    this_thread::yield();
+                }
+                REQUIRE(&counter == &shards.getForThisThread());
+            }));
+        }
+        for (thread& t : threads)
+        {
+            t.join();
+        }
+        REQUIRE(static_cast<size_t>(threadCount) == getShardCount(shards));
+        REQUIRE(threadCount == getTotal(shards));
+    }
+
+    SECTION("Threads that run one after the other share one Shard, which keeps their counts.")
+    {
+        ThreadShards<Counter> shards{};
+        for (int t=0; t<100; ++t)
+        {
+            thread([&shards]{
+                Counter& counter = shards.getForThisThread();
+                counter.count.store(counter.count.load() + 1);
+            }).join();
+        }
+        REQUIRE(1 == getShardCount(shards));
+        REQUIRE(100 == getTotal(shards));
+    }
+
+    SECTION("reuseShard is called with an exited thread's Shard before the next thread gets it.")
+    {
+        ThreadShards<Counter> shards{
+            []{ return make_unique<Counter>(); },
+            [](Counter& counter){
+                counter.count.store(0);
+                ++counter.reuses;
+            }};
+        for (int t=0; t<5; ++t)
+        {
+            thread([&shards]{
+                Counter& counter = shards.getForThisThread();
+                REQUIRE(0 == counter.count.load());
+                counter.count.store(7);
+            }).join();
+        }
+        shards.visitAll([](const vector<unique_ptr<Counter>>& all){
+            REQUIRE(1 == all.size());
+            REQUIRE(4 == all[0]->reuses);
+            REQUIRE(7 == all[0]->count.load());
+        });
+    }
+}
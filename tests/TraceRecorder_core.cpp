@@ -0,0 +1,231 @@
+#include "catch.hpp"
+#include "../src/Board.h"
+#include "../src/TraceFormat.h"
+#include "../src/TraceRecorder.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+
+/*
+Reads the trace file at @path. Checks the header against @width, @height and @boxCount and returns the records.
+*/
+vector<SpotTransition> readTrace(const string& path, int width, int height, int boxCount)
+{
+    ifstream file{path, ios::binary};
+    char magic[8];
+    uint32_t version = 0;
+    uint32_t recordSize = 0;
+    int32_t header[3];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    REQUIRE(0 == memcmp(magic, traceMagic, sizeof(magic)));
+    REQUIRE(traceVersion == version);
+    REQUIRE(sizeof(SpotTransition) == recordSize);
+    REQUIRE(width == header[0]);
+    REQUIRE(height == header[1]);
+    REQUIRE(boxCount == header[2]);
+    file.seekg(boxCount * 4 * sizeof(int32_t), ios::cur);
+
+    vector<SpotTransition> records{};
+    SpotTransition record{};
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+    {
+        records.push_back(record);
+    }
+    return records;
+}
+
+vector<Box> makeTraceBoxes(int count)
+{
+    vector<Box> boxes{};
+    for (int ii=0; ii<count; ++ii)
+    {
+        boxes.push_back(Box{ii, 1, 10, 10});
+    }
+    return boxes;
+}
+
+vector<BoxInfo> getInfos(const vector<Box>& boxes)
+{
+    vector<BoxInfo> infos{};
+    for (const Box& box : boxes)
+    {
+        infos.push_back(box.getInfo());
+    }
+    return infos;
+}
+
+TEST_CASE("TraceRecorder_core::")
+{
+    string path = (filesystem::temp_directory_path() / "TraceRecorder_core.trace").string();
+
+    SECTION("Records successful changes and collisions in time order")
+    {
+        vector<Box> boxes = makeTraceBoxes(2);
+        vector<BoxInfo> infos = getInfos(boxes);
+        Board board{10, 10, std::move(boxes)};
+        {
+            TraceRecorder recorder{path, 10, 10, infos};
+            board.registerTransitionListener(&recorder);
+
+            board.changeSpot(Position{3, 4}, BoardNote{0, MoveType::to_arrive}, true);
+            board.changeSpot(Position{3, 4}, BoardNote{0, MoveType::arrive}, true);
+            board.changeSpot(Position{3, 4}, BoardNote{1, MoveType::to_arrive}, true);
+
+            recorder.flush();
+            REQUIRE(3 == recorder.getRecorded());
+        }
+
+        vector<SpotTransition> records = readTrace(path, 10, 10, 2);
+        REQUIRE(3 == records.size());
+
+        REQUIRE(0 == records[0].boxId);
+        REQUIRE(-1 == records[0].otherBoxId);
+        REQUIRE(3 == records[0].x);
+        REQUIRE(4 == records[0].y);
+        REQUIRE(MoveType::to_arrive == records[0].getMoveType());
+        REQUIRE_FALSE(records[0].isCollision());
+
+        REQUIRE(0 == records[1].boxId);
+        REQUIRE(0 == records[1].otherBoxId);
+        REQUIRE(MoveType::arrive == records[1].getMoveType());
+        REQUIRE_FALSE(records[1].isCollision());
+
+        REQUIRE(1 == records[2].boxId);
+        REQUIRE(0 == records[2].otherBoxId);
+        REQUIRE(MoveType::to_arrive == records[2].getMoveType());
+        REQUIRE(records[2].isCollision());
+        REQUIRE(1 == records[2].upLevel);
+
+        REQUIRE(records[0].timestamp <= records[1].timestamp);
+        REQUIRE(records[1].timestamp <= records[2].timestamp);
+    }
+
+    SECTION("Every transition from many threads is written, even when the rings fill up")
+    {
+        int numOfThreads = 4;
+        int movesPerThread = 2000;
+        vector<Box> boxes = makeTraceBoxes(numOfThreads);
+        vector<BoxInfo> infos = getInfos(boxes);
+        Board board{10, 10, std::move(boxes)};
+        long stalls = 0;
+        {
+            // Small rings, and a flush interval the test never reaches, so mover threads have to wait on the writer thread.
+            TraceRecorder recorder{path, 10, 10, infos, 8, chrono::hours{1}};
+            board.registerTransitionListener(&recorder);
+
+            vector<thread> threads{};
+            for (int id=0; id<numOfThreads; ++id)
+            {
+                threads.push_back(thread([&board, id, movesPerThread]{
+                    Position pos{id, 0};
+                    for (int ii=0; ii<movesPerThread/4; ++ii)
+                    {
+                        board.changeSpot(pos, BoardNote{id, MoveType::to_arrive}, true);
+                        board.changeSpot(pos, BoardNote{id, MoveType::arrive}, true);
+                        board.changeSpot(pos, BoardNote{id, MoveType::to_leave}, true);
+                        board.changeSpot(pos, BoardNote{id, MoveType::left}, true);
+                    }
+                }));
+            }
+            for (thread& t : threads)
+            {
+                t.join();
+            }
+            stalls = recorder.getStalls();
+        }
+
+        vector<SpotTransition> records = readTrace(path, 10, 10, numOfThreads);
+        REQUIRE(static_cast<size_t>(numOfThreads * movesPerThread) == records.size());
+        REQUIRE(stalls > 0);
+
+        // Per Box, the MoveTypes are in the order they were made.
+        vector<int> countPerBox(numOfThreads, 0);
+        for (const SpotTransition& record : records)
+        {
+            int count = countPerBox[record.boxId]++;
+            REQUIRE(static_cast<uint8_t>((count % 4) + 1) == record.type);
+            REQUIRE(record.boxId == record.x);
+            REQUIRE_FALSE(record.isCollision());
+        }
+    }
+
+    SECTION("A mover thread never waits while its ring has room")
+    {
+        vector<Box> boxes = makeTraceBoxes(1);
+        vector<BoxInfo> infos = getInfos(boxes);
+        Board board{10, 10, std::move(boxes)};
+        long stalls = 0;
+        {
+            // The ring holds every transition, so the writer thread only runs at destruction.
+            TraceRecorder recorder{path, 10, 10, infos, 1024, chrono::hours{1}};
+            board.registerTransitionListener(&recorder);
+            for (int ii=0; ii<250; ++ii)
+            {
+                board.changeSpot(Position{0, 0}, BoardNote{0, MoveType::to_arrive}, true);
+                board.changeSpot(Position{0, 0}, BoardNote{0, MoveType::arrive}, true);
+                board.changeSpot(Position{0, 0}, BoardNote{0, MoveType::to_leave}, true);
+                board.changeSpot(Position{0, 0}, BoardNote{0, MoveType::left}, true);
+            }
+            stalls = recorder.getStalls();
+        }
+
+        REQUIRE(0 == stalls);
+        REQUIRE(static_cast<size_t>(1000) == readTrace(path, 10, 10, 1).size());
+    }
+
+    SECTION("A thread that exits leaves its ring, and what is in it, to the next thread")
+    {
+        int numOfThreads = 10;
+        vector<Box> boxes = makeTraceBoxes(numOfThreads);
+        vector<BoxInfo> infos = getInfos(boxes);
+        Board board{10, 10, std::move(boxes)};
+        long stalls = 0;
+        {
+            // 40 transitions per thread fit a 64 slot ring, so only threads that share a ring fill it.
+            TraceRecorder recorder{path, 10, 10, infos, 64, chrono::hours{1}};
+            board.registerTransitionListener(&recorder);
+            for (int id=0; id<numOfThreads; ++id)
+            {
+                thread([&board, id]{
+                    for (int ii=0; ii<10; ++ii)
+                    {
+                        board.changeSpot(Position{id, 0}, BoardNote{id, MoveType::to_arrive}, true);
+                        board.changeSpot(Position{id, 0}, BoardNote{id, MoveType::arrive}, true);
+                        board.changeSpot(Position{id, 0}, BoardNote{id, MoveType::to_leave}, true);
+                        board.changeSpot(Position{id, 0}, BoardNote{id, MoveType::left}, true);
+                    }
+                }).join();
+            }
+            stalls = recorder.getStalls();
+        }
+
+        REQUIRE(stalls > 0);
+        vector<SpotTransition> records = readTrace(path, 10, 10, numOfThreads);
+        REQUIRE(static_cast<size_t>(numOfThreads * 40) == records.size());
+        vector<int> countPerBox(numOfThreads, 0);
+        for (const SpotTransition& record : records)
+        {
+            ++countPerBox[record.boxId];
+        }
+        for (int count : countPerBox)
+        {
+            REQUIRE(40 == count);
+        }
+    }
+
+    SECTION("Throws if the file can not be opened")
+    {
+        REQUIRE_THROWS_AS(
+            (TraceRecorder{"/nonexistent_directory/x.trace", 10, 10, {}}),
+            invalid_argument);
+    }
+
+    filesystem::remove(path);
+}
@@ -0,0 +1,205 @@
+#include "catch.hpp"
+#include "../src/Board.h"
+#include "../src/TraceReader.h"
+#include "../src/TraceRecorder.h"
+#include "../src/TraceReplayer.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace std;
+
+/*
+A RecorderListener that saves a copy of what it received last.
+*/
+class ReplayListener : public RecorderListener
+{
+    public:
+
+    void receiveStateAndChanges(const OccupancyGrid& drops, const Frame& frame) override
+    {
+        ++_frameCount;
+        _lastSequence = frame.getSequence();
+        _occupiedCount = static_cast<int>(drops.getOccupiedCells().size());
+        _changedDrops.clear();
+        for (const Drop& drop : frame.getChangedDrops())
+        {
+            _changedDrops.push_back(drop);
+        }
+        _levelOfBox0 = frame.getBoxInfo(0).getLevel();
+    }
+
+    int _frameCount = 0;
+    long _lastSequence = -1;
+    int _occupiedCount = 0;
+    vector<Drop> _changedDrops{};
+    int _levelOfBox0 = -1;
+};
+
+/*
+Records a short run to @path:
+    record 0: Box 0 to_arrive at {1, 1}
+    record 1: Box 0 arrive at {1, 1}
+    record 2: Box 1 to_arrive at {2, 2}
+    record 3: Box 1 runs into Box 0 at {1, 1} (both levels go up)
+    record 4: Box 1 arrive at {2, 2}
+    record 5: Box 0 to_leave at {1, 1}
+    record 6: Box 0 left {1, 1}
+*/
+void recordShortRun(const string& path)
+{
+    vector<Box> boxes{};
+    boxes.push_back(Box{0, 0, 1, 1});
+    boxes.push_back(Box{1, 1, 1, 1});
+    vector<BoxInfo> infos{boxes[0].getInfo(), boxes[1].getInfo()};
+    Board board{5, 5, std::move(boxes)};
+    TraceRecorder recorder{path, 5, 5, infos};
+    board.registerTransitionListener(&recorder);
+
+    board.changeSpot(Position{1, 1}, BoardNote{0, MoveType::to_arrive}, false);
+    board.changeSpot(Position{1, 1}, BoardNote{0, MoveType::arrive}, true);
+    board.changeSpot(Position{2, 2}, BoardNote{1, MoveType::to_arrive}, false);
+    board.changeSpot(Position{1, 1}, BoardNote{1, MoveType::to_arrive}, true);
+    board.changeSpot(Position{2, 2}, BoardNote{1, MoveType::arrive}, true);
+    board.changeSpot(Position{1, 1}, BoardNote{0, MoveType::to_leave}, true);
+    board.changeSpot(Position{1, 1}, BoardNote{0, MoveType::left}, true);
+}
+
+TEST_CASE("TraceReplayer_core::")
+{
+    string path = (filesystem::temp_directory_path() / "TraceReplayer_core.trace").string();
+    string keyframePath = path + ".keyframes";
+    filesystem::remove(keyframePath);
+    recordShortRun(path);
+
+    vector<SpotTransition> records{};
+    {
+        TraceReader reader{path};
+        REQUIRE(5 == reader.getWidth());
+        REQUIRE(5 == reader.getHeight());
+        REQUIRE(2 == reader.getBoxInfos().size());
+        REQUIRE(1 == reader.getBoxInfos()[1].getGroupId());
+        REQUIRE(7 == reader.getRecordCount());
+        REQUIRE(7 == reader.readRecords(0, 100, records));
+    }
+
+    SECTION("Stepping to the end rebuilds occupancy and levels")
+    {
+        TraceReplayer replayer{path, 2};
+        ReplayListener listener{};
+        replayer.registerListener(&listener);
+
+        replayer.step(replayer.getEndTime());
+
+        REQUIRE(replayer.isFinished());
+        REQUIRE(1 == listener._frameCount);
+        REQUIRE(0 == listener._lastSequence);
+        REQUIRE(1 == listener._occupiedCount);
+        REQUIRE(1 == listener._levelOfBox0);
+        REQUIRE(1 == replayer.getState().getLevel(1));
+        REQUIRE(1 == replayer.getState().getGrid().getDropAt(Position{2, 2}).getBoxId());
+        REQUIRE(MoveType::arrive == replayer.getState().getGrid().getDropAt(Position{2, 2}).getMoveType());
+        REQUIRE(-1 == replayer.getState().getGrid().getDropAt(Position{1, 1}).getBoxId());
+
+        // Both changed Positions are in the Frame, with their final state.
+        REQUIRE(2 == listener._changedDrops.size());
+    }
+
+    SECTION("Seeking lands on the same state as stepping")
+    {
+        TraceReplayer replayer{path, 2};
+        ReplayListener listener{};
+        replayer.registerListener(&listener);
+
+        // Keyframes before records 0, 2, 4 and 6.
+        REQUIRE(4 == replayer.getKeyframeCount());
+
+        // Just after the collision.
+        replayer.seek(records[3].timestamp);
+        REQUIRE(records[3].timestamp == replayer.getTime());
+        REQUIRE(2 == listener._occupiedCount);
+        REQUIRE(1 == listener._levelOfBox0);
+        REQUIRE(0 == replayer.getState().getGrid().getDropAt(Position{1, 1}).getBoxId());
+        REQUIRE(MoveType::arrive == replayer.getState().getGrid().getDropAt(Position{1, 1}).getMoveType());
+        REQUIRE(1 == replayer.getState().getGrid().getDropAt(Position{2, 2}).getBoxId());
+        REQUIRE(MoveType::to_arrive == replayer.getState().getGrid().getDropAt(Position{2, 2}).getMoveType());
+
+        // Back to the start, before the collision.
+        replayer.seek(records[1].timestamp);
+        REQUIRE(1 == listener._occupiedCount);
+        REQUIRE(0 == listener._levelOfBox0);
+        REQUIRE_FALSE(replayer.isFinished());
+
+        // The Frame sent by seek() includes the Position that emptied.
+        bool hasEmptied = false;
+        for (const Drop& drop : listener._changedDrops)
+        {
+            if (drop.getPosition() == Position{2, 2})
+            {
+                hasEmptied = (drop.getMoveType() == MoveType::left);
+            }
+        }
+        REQUIRE(hasEmptied);
+
+        // Forward again by stepping.
+        replayer.step(replayer.getEndTime() - replayer.getTime());
+        REQUIRE(replayer.isFinished());
+        REQUIRE(1 == listener._occupiedCount);
+        REQUIRE(3 == listener._frameCount);
+        REQUIRE(2 == listener._lastSequence);
+    }
+
+    SECTION("Keyframes are made once and reused")
+    {
+        {
+            TraceReplayer replayer{path, 2};
+        }
+        REQUIRE(filesystem::exists(keyframePath));
+        auto madeAt = filesystem::last_write_time(keyframePath);
+
+        TraceReplayer replayer{path, 2};
+        REQUIRE(madeAt == filesystem::last_write_time(keyframePath));
+        REQUIRE(4 == replayer.getKeyframeCount());
+
+        // A different keyframe interval makes new keyframes.
+        TraceReplayer other{path, 3};
+        REQUIRE(3 == other.getKeyframeCount());
+    }
+
+    SECTION("Keyframes made for another trace with as many records are made again")
+    {
+        long endTime = 0;
+        {
+            TraceReplayer replayer{path, 2};
+            endTime = replayer.getEndTime();
+        }
+
+        // Move the last record a second later, which leaves the record count as it was.
+        {
+            fstream trace{path, ios::binary | ios::in | ios::out};
+            trace.seekg(-static_cast<streamoff>(sizeof(SpotTransition)), ios::end);
+            SpotTransition last{};
+            trace.read(reinterpret_cast<char*>(&last), sizeof(last));
+            last.timestamp += 1000000000;
+            trace.seekp(-static_cast<streamoff>(sizeof(SpotTransition)), ios::end);
+            trace.write(reinterpret_cast<const char*>(&last), sizeof(last));
+        }
+
+        TraceReplayer replayer{path, 2};
+        REQUIRE(7 == TraceReader{path}.getRecordCount());
+        REQUIRE(endTime + 1000000000 == replayer.getEndTime());
+    }
+
+    SECTION("A file that is not a trace is refused")
+    {
+        REQUIRE_THROWS_AS(TraceReader{keyframePath + ".missing"}, invalid_argument);
+        {
+            ofstream notATrace{keyframePath, ios::binary | ios::trunc};
+            notATrace << "not a trace";
+        }
+        REQUIRE_THROWS_AS(TraceReader{keyframePath}, invalid_argument);
+    }
+
+    filesystem::remove(keyframePath);
+    filesystem::remove(path);
+}
@@ -0,0 +1,134 @@
+#include "catch.hpp"
+#include "../src/Tracer.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    size_t countOf(const string& text, const string& part)
+    {
+        size_t count = 0;
+        for (size_t at = text.find(part); at != string::npos; at = text.find(part, at + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+}
+
+TEST_CASE("Tracer_core::")
+{
+    SECTION("Writes recorded spans as Chrome trace events, one lane per Box")
+    {
+        Tracer::start();
+        uint64_t start = TscClock::now();
+        Tracer::record("move", 7, start, start + 1000);
+        Tracer::record("blocked", 8, start + 10, start + 500);
+        Tracer::record("sendStateAndChanges", Tracer::boardLane, start + 20, start + 30);
+        {
+            TraceSpan span{"enter attempt", 7};
+        }
+        Tracer::stop();
+
+        stringstream json{};
+        Tracer::writeJson(json);
+        string text = json.str();
+
+        REQUIRE(text.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+        REQUIRE(text.substr(text.size() - 4) == "\n]}\n");
+        REQUIRE(countOf(text, "\"ph\":\"X\"") == 4);
+        REQUIRE(countOf(text, "\"name\":\"move\",\"pid\":2,\"tid\":7,") == 1);
+        REQUIRE(countOf(text, "\"name\":\"enter attempt\",\"pid\":2,\"tid\":7,") == 1);
+        REQUIRE(countOf(text, "\"name\":\"blocked\",\"pid\":2,\"tid\":8,") == 1);
+        REQUIRE(countOf(text, "\"name\":\"sendStateAndChanges\",\"pid\":1,\"tid\":0,") == 1);
+        // Each Box lane is named once.
+        REQUIRE(countOf(text, "{\"name\":\"Box 7\"}") == 1);
+        REQUIRE(countOf(text, "{\"name\":\"Box 8\"}") == 1);
+    }
+
+    SECTION("Only spans recorded after the latest start() are written, and none after stop()")
+    {
+        Tracer::start();
+        Tracer::record("old", 1, TscClock::now(), TscClock::now());
+        Tracer::stop();
+
+        Tracer::start();
+        Tracer::record("new", 1, TscClock::now(), TscClock::now());
+        Tracer::stop();
+        {
+            TraceSpan span{"stopped", 1};
+        }
+
+        stringstream json{};
+        Tracer::writeJson(json);
+        REQUIRE(countOf(json.str(), "\"name\":\"old\"") == 0);
+        REQUIRE(countOf(json.str(), "\"name\":\"new\"") == 1);
+        REQUIRE(countOf(json.str(), "\"name\":\"stopped\"") == 0);
+    }
+
+    SECTION("Collects the spans of many threads")
+    {
+        Tracer::start();
+        vector<thread> threads{};
+        for (int t=0; t<4; ++t)
+        {
+            threads.push_back(thread([t]{
+                for (int ii=0; ii<5000; ++ii)
+                {
+                    TraceSpan span{"step", t};
+                }
+            }));
+        }
+        for (thread& t : threads)
+        {
+            t.join();
+        }
+        Tracer::stop();
+
+        stringstream json{};
+        Tracer::writeJson(json);
+        REQUIRE(countOf(json.str(), "\"name\":\"step\"") == 20000);
+    }
+
+    SECTION("Keeps the spans of threads that have exited while the next threads reuse their buffers")
+    {
+        Tracer::start();
+        for (int t=0; t<50; ++t)
+        {
+            thread([t]{
+                TraceSpan span{"exited", t};
+            }).join();
+        }
+        Tracer::stop();
+
+        stringstream json{};
+        Tracer::writeJson(json);
+        REQUIRE(countOf(json.str(), "\"name\":\"exited\"") == 50);
+    }
+
+    SECTION("A buffer taken over by a new thread in a later run starts empty")
+    {
+        // A span stamped well after the next start(), so only emptying the buffer keeps it out of that run.
+        Tracer::start();
+        thread([]{
+            uint64_t later = TscClock::now() + static_cast<uint64_t>(600e9 / TscClock::getNanosecondsPerTick());
+            Tracer::record("stale", 1, later, later);
+        }).join();
+        Tracer::stop();
+
+        Tracer::start();
+        thread([]{
+            Tracer::record("fresh", 1, TscClock::now(), TscClock::now());
+        }).join();
+        // Written before stop(), so the stale span is not cut off by the stop time either.
+        stringstream json{};
+        Tracer::writeJson(json);
+        Tracer::stop();
+
+        REQUIRE(countOf(json.str(), "\"name\":\"fresh\"") == 1);
+        REQUIRE(countOf(json.str(), "\"name\":\"stale\"") == 0);
+    }
+}
@@ -0,0 +1,33 @@
+#include "catch.hpp"
+#include "../src/TscClock.h"
+
+#include <thread>
+
+using namespace std;
+
+TEST_CASE("TscClock_core::")
+{
+    SECTION("Ticks never go backwards and convert to the matching high_resolution_clock time.")
+    {
+        auto before = chrono::high_resolution_clock::now();
+        uint64_t first = TscClock::now();
+        this_thread::sleep_for(chrono::milliseconds(20));
+        uint64_t second = TscClock::now();
+        auto after = chrono::high_resolution_clock::now();
+
+        REQUIRE(second > first);
+        REQUIRE(TscClock::getNanosecondsPerTick() > 0);
+
+        // The calibration may be a little off, and a busy machine may sleep much longer than asked, so the checks allow 10% of the measured time either way.
+        auto wall = chrono::duration_cast<chrono::nanoseconds>(after - before);
+        auto tolerance = wall / 10;
+        auto firstTime = TscClock::toTimePoint(first);
+        auto secondTime = TscClock::toTimePoint(second);
+        REQUIRE(secondTime > firstTime);
+        REQUIRE(firstTime > before - tolerance);
+        REQUIRE(secondTime < after + tolerance);
+        auto elapsed = chrono::duration_cast<chrono::nanoseconds>(secondTime - firstTime);
+        REQUIRE(elapsed >= chrono::milliseconds(18));
+        REQUIRE(elapsed <= wall + tolerance);
+    }
+}
@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include "../src/MainSetup.h"
+#include "../src/Threader.h"
+#include "../src/Util.h"
+#include "../src/VirtualTimeRunner.h"
+
+#include <functional>
+
+using namespace std;
+
+namespace
+{
+    struct SmallRun
+    {
+        long clearance;
+        int exitedCount;
+        vector<long> entryTimes;
+        vector<long> exitTimes;
+    };
+
+    long runForTenMinutes(VirtualTimeRunner& runner)
+    {
+        return runner.run(10 * 60 * 1000);
+    }
+
+    /*
+    Runs 14 Boxes, in 2 batches of 7, through a 150 x 130 Board with @seed. @run drives the VirtualTimeRunner and returns the clearance time.
+    */
+    SmallRun runSmall(uint32_t seed, const function<long(VirtualTimeRunner&)>& run = runForTenMinutes)
+    {
+        Util::setSeed(seed);
+        vector<Box> boxes{};
+        MainSetup::addAGroupOfBoxes(boxes, 0, 0, 14);
+        Board board{150, 130, std::move(boxes)};
+
+        Threader threader{};
+        vector<Rectangle> rects = MainSetup::getInOutBoundRectangles(150, 130);
+        VirtualTimeRunner runner{board, threader.planBatches(2, 7, rects, 150, 130)};
+
+        SmallRun result{};
+        result.clearance = run(runner);
+        result.exitedCount = runner.getExitedCount();
+        for (int ii=0; ii<runner.getBoxCount(); ++ii)
+        {
+            result.entryTimes.push_back(runner.getEntryTime(ii));
+            result.exitTimes.push_back(runner.getExitTime(ii));
+        }
+        return result;
+    }
+}
+
+TEST_CASE("VirtualTimeRunner_core::")
+{
+    SECTION("Every Box reaches its exit and leaves the Board")
+    {
+        SmallRun run = runSmall(3, [](VirtualTimeRunner& runner){
+            REQUIRE(runner.getBoxCount() == 14);
+            REQUIRE(runner.getNow() == 0);
+            long clearance = runForTenMinutes(runner);
+            REQUIRE(clearance == runner.getNow());
+            REQUIRE(runner.getEventCount() > 14);
+            return clearance;
+        });
+
+        REQUIRE(run.exitedCount == 14);
+        for (size_t ii=0; ii<run.exitTimes.size(); ++ii)
+        {
+            REQUIRE(run.entryTimes[ii] >= 0);
+            REQUIRE(run.exitTimes[ii] > run.entryTimes[ii]);
+            REQUIRE(run.exitTimes[ii] <= run.clearance);
+        }
+    }
+
+    SECTION("The same seed gives the same run")
+    {
+        SmallRun first = runSmall(11);
+        SmallRun second = runSmall(11);
+
+        REQUIRE(first.clearance == second.clearance);
+        REQUIRE(first.exitedCount == second.exitedCount);
+        REQUIRE(first.exitTimes == second.exitTimes);
+    }
+
+    SECTION("A run stops at its limit and can be continued")
+    {
+        SmallRun run = runSmall(5, [](VirtualTimeRunner& runner){
+            REQUIRE(runner.run(20) == 20);
+            REQUIRE(runner.getExitedCount() == 0);
+            return runForTenMinutes(runner);
+        });
+
+        REQUIRE(run.clearance > 20);
+        REQUIRE(run.exitedCount == 14);
+    }
+}
@@ -0,0 +1,150 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/EvacuationBenchmark.h"
+#include "../src/GridIndex.h"
+
+using namespace std;
+
+/*
+Runs EvacuationBenchmark over several seeds and compares the results to a stored baseline.
+
+Usage: EvacuationBenchmark [options]
+    --seeds <n>                 seeds to run, 8 by default
+    --first-seed <n>            the first seed, 1 by default; the others follow it
+    --boxes-per-batch <n>       200 by default
+    --batches <n>               between 1 and 7, 7 by default
+    --layout <name>             the Board's GridLayout: row-major, tiled, or morton, row-major by default
+    --baseline <file>           compare against this baseline
+    --threshold <fraction>      smallest worsening counted as a regression, 0.03 by default
+    --write-baseline <file>     write the results as a new baseline
+
+Exits with 1 if any metric regressed. Progress is written to standard error.
+*/
+
+int main(int argc, char* argv[])
+{
+    EvacuationBenchmark::Scenario scenario{};
+    int seedCount = 8;
+    uint32_t firstSeed = 1;
+    double threshold = 0.03;
+    string baselinePath{};
+    string writePath{};
+
+    for (int ii=1; ii+1<argc; ii+=2)
+    {
+        string option{argv[ii]};
+        string value{argv[ii+1]};
+        if (option == "--seeds")
+        {
+            seedCount = stoi(value);
+        }
+        else if (option == "--first-seed")
+        {
+            firstSeed = static_cast<uint32_t>(stoul(value));
+        }
+        else if (option == "--boxes-per-batch")
+        {
+            scenario.boxesPerBatch = stoi(value);
+        }
+        else if (option == "--batches")
+        {
+            scenario.batchCount = stoi(value);
+        }
+        else if (option == "--layout")
+        {
+            scenario.layout = GridIndex::toGridLayout(value);
+        }
+        else if (option == "--baseline")
+        {
+            baselinePath = value;
+        }
+        else if (option == "--threshold")
+        {
+            threshold = stod(value);
+        }
+        else if (option == "--write-baseline")
+        {
+            writePath = value;
+        }
+        else
+        {
+            cerr << "Unknown option " << option << endl;
+            return 1;
+        }
+    }
+
+    vector<EvacuationBenchmark::Baseline> baseline{};
+    if (!baselinePath.empty())
+    {
+        ifstream in{baselinePath};
+        if (!in)
+        {
+            cerr << "Could not open " << baselinePath << endl;
+            return 1;
+        }
+        baseline = EvacuationBenchmark::readBaselines(in);
+    }
+
+    vector<EvacuationBenchmark::Result> results{};
+    for (int ii=0; ii<seedCount; ++ii)
+    {
+        uint32_t seed = firstSeed + static_cast<uint32_t>(ii);
+        cerr << "seed " << seed << " ... " << flush;
+        results.push_back(EvacuationBenchmark::run(scenario, seed));
+        const EvacuationBenchmark::Result& result = results.back();
+        cerr << result.exitedCount << " of " << result.boxCount << " exited, cleared in "
+             << result.metrics[0].value << "ms, " << result.events << " steps in "
+             << result.wallSeconds << "s" << endl;
+    }
+
+    vector<EvacuationBenchmark::Baseline> current = EvacuationBenchmark::summarize(results);
+    cout << left << setw(24) << "metric" << right << setw(14) << "mean" << setw(14) << "stddev";
+    if (!baseline.empty())
+    {
+        cout << setw(14) << "baseline";
+    }
+    cout << "\n";
+    for (const EvacuationBenchmark::Baseline& b : current)
+    {
+        cout << left << setw(24) << b.name << right << setw(14) << b.mean << setw(14) << b.stddev;
+        for (const EvacuationBenchmark::Baseline& before : baseline)
+        {
+            if (before.name == b.name)
+            {
+                cout << setw(14) << before.mean;
+            }
+        }
+        cout << "\n";
+    }
+
+    if (!writePath.empty())
+    {
+        ofstream out{writePath};
+        if (!out)
+        {
+            cerr << "Could not open " << writePath << endl;
+            return 1;
+        }
+        EvacuationBenchmark::writeBaselines(out, current);
+    }
+
+    if (baseline.empty())
+    {
+        return 0;
+    }
+    vector<EvacuationBenchmark::Regression> regressions = EvacuationBenchmark::compare(baseline, current, threshold);
+    for (const EvacuationBenchmark::Regression& r : regressions)
+    {
+        cout << "REGRESSION " << r.name << ": " << r.baselineMean << " -> " << r.currentMean
+             << " (" << (r.worsening * 100.0) << "% worse, t = " << r.t << ")\n";
+    }
+    if (regressions.empty())
+    {
+        cout << "No regressions against " << baselinePath << "\n";
+    }
+    return regressions.empty() ? 0 : 1;
+}
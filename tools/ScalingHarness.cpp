@@ -0,0 +1,178 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/ScalingRun.h"
+
+using namespace std;
+
+/*
+Runs ScalingRun over every combination of the given Board sizes, Box counts, batch counts, ExecutionBackends, and worker counts and writes one CSV row per run.
+
+Usage: ScalingHarness [options]
+    --sizes <WxH,...>        Board sizes, 600x600 by default
+    --boxes <n,...>          Box counts, 1400 by default
+    --batches <n,...>        batch counts, between 1 and 7, 7 by default
+    --backends <name,...>    ExecutionBackends, threads or lockstep, threads by default
+    --workers <n,...>        worker counts for the lockstep backend, 0 (one per hardware thread) by default
+    --tile-sizes <n,...>     tile sizes for the lockstep backend, 0 (split by Box) by default
+    --time-limit <seconds>   longest time one run may take, 120 by default
+    --repeat <n>             runs per combination, 1 by default
+    --csv <file>             where to write the results, standard output by default
+
+Combinations whose Box count is not a multiple of the batch count are skipped. The threads backend ignores the worker counts and tile sizes and runs once per combination. Progress is written to standard error.
+*/
+
+vector<string> split(const string& list)
+{
+    vector<string> items{};
+    stringstream stream{list};
+    string item{};
+    while (getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+vector<int> splitInts(const string& list)
+{
+    vector<int> values{};
+    for (const string& item : split(list))
+    {
+        values.push_back(stoi(item));
+    }
+    return values;
+}
+
+int main(int argc, char* argv[])
+{
+    vector<pair<int, int>> sizes{{600, 600}};
+    vector<int> boxCounts{1400};
+    vector<int> batchCounts{7};
+    vector<ExecutionBackend> backends{ExecutionBackend::threads};
+    vector<int> workerCounts{0};
+    vector<int> tileSizes{0};
+    int timeLimit = 120;
+    int repeat = 1;
+    string csvPath{};
+
+    for (int ii=1; ii+1<argc; ii+=2)
+    {
+        string option{argv[ii]};
+        string value{argv[ii+1]};
+        if (option == "--sizes")
+        {
+            sizes.clear();
+            for (const string& size : split(value))
+            {
+                size_t x = size.find('x');
+                if (x == string::npos)
+                {
+                    cerr << "A size must look like 600x400, not " << size << endl;
+                    return 1;
+                }
+                sizes.push_back({stoi(size.substr(0, x)), stoi(size.substr(x + 1))});
+            }
+        }
+        else if (option == "--boxes")
+        {
+            boxCounts = splitInts(value);
+        }
+        else if (option == "--batches")
+        {
+            batchCounts = splitInts(value);
+        }
+        else if (option == "--backends")
+        {
+            backends.clear();
+            for (const string& name : split(value))
+            {
+                backends.push_back(ScalingRun::toExecutionBackend(name));
+            }
+        }
+        else if (option == "--workers")
+        {
+            workerCounts = splitInts(value);
+        }
+        else if (option == "--tile-sizes")
+        {
+            tileSizes = splitInts(value);
+        }
+        else if (option == "--time-limit")
+        {
+            timeLimit = stoi(value);
+        }
+        else if (option == "--repeat")
+        {
+            repeat = stoi(value);
+        }
+        else if (option == "--csv")
+        {
+            csvPath = value;
+        }
+        else
+        {
+            cerr << "Unknown option " << option << endl;
+            return 1;
+        }
+    }
+
+    ofstream csvFile{};
+    if (!csvPath.empty())
+    {
+        csvFile.open(csvPath);
+        if (!csvFile)
+        {
+            cerr << "Could not open " << csvPath << endl;
+            return 1;
+        }
+    }
+    ostream& csv = csvPath.empty() ? cout : csvFile;
+    ScalingRun::writeCsvHeader(csv);
+
+    for (const auto& size : sizes)
+    {
+        for (int boxCount : boxCounts)
+        {
+            for (int batchCount : batchCounts)
+            {
+                if (batchCount < 1 || boxCount % batchCount != 0)
+                {
+                    cerr << "Skipping " << boxCount << " Boxes in " << batchCount << " batches." << endl;
+                    continue;
+                }
+                for (ExecutionBackend backend : backends)
+                {
+                    bool lockstep = (backend == ExecutionBackend::lockstep);
+                    for (int workers : lockstep ? workerCounts : vector<int>{0})
+                    {
+                        for (int tileSize : lockstep ? tileSizes : vector<int>{0})
+                        {
+                            for (int run=0; run<repeat; ++run)
+                            {
+                                ScalingRun::Point point{
+                                    size.first, size.second, boxCount, batchCount, backend, workers, tileSize};
+                                cerr << size.first << "x" << size.second << ", " << boxCount << " Boxes, "
+                                     << batchCount << " batches, " << ScalingRun::toString(backend) << " ... " << flush;
+                                ScalingRun::Result result = ScalingRun::run(point, chrono::seconds(timeLimit));
+                                cerr << result.movesPerSecond << " moves/s, "
+                                     << result.agentStepsPerSecond << " agent steps/s, "
+                                     << result.exitedCount << " of " << boxCount << " exited" << endl;
+                                ScalingRun::writeCsvRow(csv, result);
+                                csv.flush();
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
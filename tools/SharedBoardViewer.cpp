@@ -0,0 +1,89 @@
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/SharedBoardReader.h"
+
+using namespace std;
+
+/*
+Watches a Board published by SharedBoardExporter from another process.
+
+Usage: SharedBoardViewer <segment name> [interval in ms] [number of reads]
+
+Every interval it reads a consistent snapshot and prints the Frame's sequence number, the number of occupied cells, the number of Boxes on the Board per group, the highest level, and how many reads had to be retried because the exporter was writing.
+*/
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " <segment name> [interval in ms] [number of reads]" << endl;
+        return 1;
+    }
+    string name{argv[1]};
+    int intervalMs = (argc > 2) ? stoi(argv[2]) : 1000;
+    long reads = (argc > 3) ? stol(argv[3]) : -1;
+
+    SharedBoardReader reader{name};
+    int cells = reader.getWidth() * reader.getHeight();
+    cout << name << ": " << reader.getWidth() << " x " << reader.getHeight() << " Board, " << reader.getBoxCount() << " Boxes" << endl;
+
+    // Maps a boxId to its group, filled from the box table.
+    map<int, int> groupPerBoxId{};
+    long retries = 0;
+
+    for (long read=0; reads < 0 || read < reads; ++read)
+    {
+        long frameSequence = -1;
+        int occupied = 0;
+        int maxLevel = 0;
+        map<int, int> boxesPerGroup{};
+
+        while (true)
+        {
+            uint64_t sequence = reader.beginRead();
+
+            frameSequence = reader.getFrameSequence();
+            occupied = 0;
+            maxLevel = 0;
+            boxesPerGroup.clear();
+            for (int index=0; index<reader.getBoxCount(); ++index)
+            {
+                groupPerBoxId[reader.getBoxIdAt(index)] = reader.getGroupIdAt(index);
+                maxLevel = std::max(maxLevel, reader.getLevelAt(index));
+            }
+            for (int cell=0; cell<cells; ++cell)
+            {
+                int boxId = reader.getBoxId(cell);
+                if (boxId != -1)
+                {
+                    ++occupied;
+                    ++boxesPerGroup[groupPerBoxId[boxId]];
+                }
+            }
+
+            if (reader.endRead(sequence))
+            {
+                break;
+            }
+            ++retries;
+        }
+
+        cout << "frame " << frameSequence << ": " << occupied << " occupied cells,";
+        for (const auto& [group, count] : boxesPerGroup)
+        {
+            cout << " group " << group << ": " << count << ",";
+        }
+        cout << " max level " << maxLevel << ", retries " << retries << endl;
+
+        if (reads < 0 || read + 1 < reads)
+        {
+            this_thread::sleep_for(chrono::milliseconds{intervalMs});
+        }
+    }
+
+    return 0;
+}